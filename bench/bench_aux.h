@@ -16,6 +16,19 @@
 #include <light_simd/simd.h>
 #include <cmath>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define LSIMD_BENCH_HAS_PERF
+#endif
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -68,21 +81,886 @@ namespace lsimd
 		__asm__ volatile("" : : "x"(x));
 	}
 
+	/**
+	 * Hides the value of x from the compiler, so that computations 
+	 * with it (e.g. x * 0) are not folded.
+	 */
+	template<typename T>
+	LSIMD_ENSURE_INLINE
+	inline void make_opaque(simd_pack<T, sse_kind>& x)
+	{
+		__asm__ volatile("" : "+x"(x.impl.v));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline void make_opaque(f32& x)
+	{
+		__asm__ volatile("" : "+x"(x));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline void make_opaque(f64& x)
+	{
+		__asm__ volatile("" : "+x"(x));
+	}
+
+#endif
+
+	/********************************************
+	 *
+	 *  Sampling
+	 *
+	 *  A timed loop is split into a number of
+	 *  consecutive samples (of about the same
+	 *  number of runs). The cycles per run of
+	 *  each sample give robust statistics (the
+	 *  median, the MAD and percentiles), which
+	 *  are not skewed by a few samples that are
+	 *  disturbed by other processes.
+	 *
+	 *  The loop is preceded by a warm-up, which
+	 *  goes on (after the given warming times)
+	 *  until the cycles per run of three
+	 *  consecutive chunks of runs are within
+	 *  2% of each other.
+	 *
+	 *  Settings (command line or environment):
+	 *
+	 *  --samples=n   LSIMD_BENCH_SAMPLES  the number of samples (default 32)
+	 *  --cpu=k       LSIMD_BENCH_CPU      pins the process to CPU k
+	 *
+	 ********************************************/
+
+	const unsigned max_tsc_samples = 256;
+
+	struct bench_settings
+	{
+		unsigned num_samples;
+		int cpu;                    // the pinned CPU, or -1
+		double warmup_tol;          // relative spread of settled chunks
+		unsigned max_warmup_chunks;
+
+		bench_settings()
+		: num_samples(32), cpu(-1), warmup_tol(0.02), max_warmup_chunks(32)
+		{
+		}
+	};
+
+	inline bench_settings& bench_config()
+	{
+		static bench_settings s;
+		return s;
+	}
+
+	/**
+	 * Pins the calling process to a CPU.
+	 *
+	 * @return  Whether it succeeded (always false other than on Linux).
+	 */
+	inline bool pin_to_cpu(int cpu)
+	{
+#ifdef LSIMD_BENCH_HAS_PERF
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * The number of TSC ticks per nanosecond, calibrated (once)
+	 * against the monotonic clock over about 20 ms.
+	 */
+	inline double tsc_per_ns()
+	{
+		static double v = 0;
+		if (v > 0) return v;
+
+#ifdef LSIMD_BENCH_HAS_PERF
+		struct timespec t0, t1;
+		clock_gettime(CLOCK_MONOTONIC, &t0);
+		uint64_t c0 = read_tsc();
+
+		double dt;
+		do
+		{
+			clock_gettime(CLOCK_MONOTONIC, &t1);
+			dt = double(t1.tv_sec - t0.tv_sec) * 1.0e9 + double(t1.tv_nsec - t0.tv_nsec);
+		}
+		while (dt < 2.0e7);
+
+		uint64_t c1 = read_tsc();
+		v = double(c1 - c0) / dt;
+#else
+		v = 1.0;
 #endif
+		return v;
+	}
+
+	/**
+	 * The statistics of the cycles per run of a timed loop.
+	 */
+	struct tsc_stats
+	{
+		uint64_t cycles;          // total TSC cycles
+		unsigned repeat_times;
+		unsigned warmup_runs;     // the runs before timing (incl. the detected warm-up)
+		unsigned num_samples;
+
+		double mean;
+		double var;
+		double median;
+		double mad;               // median absolute deviation
+		double p05;
+		double p25;
+		double p75;
+		double p95;
+		double min;
+		double max;
+	};
+
+	// the p-th quantile of sorted x (with linear interpolation)
+	inline double _sorted_quantile(unsigned n, const double *x, double p)
+	{
+		double pos = p * double(n - 1);
+		unsigned i = (unsigned)pos;
+		if (i + 1 >= n) return x[n - 1];
+		return x[i] + (pos - double(i)) * (x[i + 1] - x[i]);
+	}
+
+	/**
+	 * Computes the statistics of n samples (x is reordered).
+	 */
+	inline void compute_tsc_stats(unsigned n, double *x, tsc_stats& st)
+	{
+		st.num_samples = n;
+
+		double sx = 0, sxx = 0;
+		for (unsigned i = 0; i < n; ++i)
+		{
+			sx += x[i];
+			sxx += x[i] * x[i];
+		}
+
+		st.mean = sx / double(n);
+		st.var = n > 1 ? (sxx - sx * st.mean) / double(n - 1) : 0.0;
+		if (st.var < 0) st.var = 0;
+
+		std::sort(x, x + n);
+		st.min = x[0];
+		st.max = x[n - 1];
+		st.median = _sorted_quantile(n, x, 0.50);
+		st.p05 = _sorted_quantile(n, x, 0.05);
+		st.p25 = _sorted_quantile(n, x, 0.25);
+		st.p75 = _sorted_quantile(n, x, 0.75);
+		st.p95 = _sorted_quantile(n, x, 0.95);
+
+		for (unsigned i = 0; i < n; ++i) x[i] = std::fabs(x[i] - st.median);
+		std::sort(x, x + n);
+		st.mad = _sorted_quantile(n, x, 0.50);
+	}
 
+	/**
+	 * Shifts all the statistics of cycles per run by -d
+	 * (e.g. to remove a calibrated overhead).
+	 */
+	inline void subtract_cycles(tsc_stats& st, double d)
+	{
+		st.mean -= d;
+		st.median -= d;
+		st.p05 -= d;
+		st.p25 -= d;
+		st.p75 -= d;
+		st.p95 -= d;
+		st.min -= d;
+		st.max -= d;
+	}
+
+	/**
+	 * Runs op in chunks until the cycles per run of three
+	 * consecutive chunks are within the tolerance.
+	 *
+	 * @return  The number of runs.
+	 */
 	template<class Op>
-	uint64_t tsc_bench(Op op, unsigned warming_times, unsigned repeat_times)
+	unsigned auto_warm_up(Op& op, unsigned chunk)
+	{
+		const bench_settings& cfg = bench_config();
+		double c[3] = { 0, 0, 0 };
+
+		for (unsigned k = 0; k < cfg.max_warmup_chunks; ++k)
+		{
+			uint64_t tic = read_tsc();
+			for (unsigned i = 0; i < chunk; ++i) op.run();
+			uint64_t toc = read_tsc();
+
+			c[0] = c[1];
+			c[1] = c[2];
+			c[2] = double(toc - tic);
+
+			if (k >= 2)
+			{
+				double lo = std::min(c[0], std::min(c[1], c[2]));
+				double hi = std::max(c[0], std::max(c[1], c[2]));
+				if (hi - lo <= cfg.warmup_tol * lo) return (k + 1) * chunk;
+			}
+		}
+
+		return cfg.max_warmup_chunks * chunk;
+	}
+
+	// the timed loop shared by tsc_bench and perf_bench
+	template<class Op, class Monitor>
+	void _sampled_bench(Op& op, unsigned warming_times, unsigned repeat_times,
+			Monitor& mon, tsc_stats& st)
 	{
+		unsigned ns = bench_config().num_samples;
+		if (ns > max_tsc_samples) ns = max_tsc_samples;
+		if (ns > repeat_times) ns = repeat_times;
+		if (ns < 1) ns = 1;
+
+		const unsigned q = repeat_times / ns;
+		const unsigned u = repeat_times % ns;
+
 		for (unsigned i = 0; i < warming_times; ++i) op.run();
+		// chunks of a quarter sample: the warm-up takes at most
+		// max_warmup_chunks / 4 samples
+
+		st.warmup_runs = warming_times + auto_warm_up(op, q >= 4 ? q / 4 : 1);
+		st.repeat_times = repeat_times;
+
+		uint64_t ts[max_tsc_samples + 1];
+
+		mon.start();
+		ts[0] = read_tsc();
+
+		for (unsigned s = 0; s < ns; ++s)
+		{
+			const unsigned rs = q + (s < u ? 1 : 0);
+			for (unsigned i = 0; i < rs; ++i) op.run();
+			ts[s + 1] = read_tsc();
+		}
+
+		mon.stop();
+
+		st.cycles = ts[ns] - ts[0];
+
+		double x[max_tsc_samples];
+		for (unsigned s = 0; s < ns; ++s)
+		{
+			x[s] = double(ts[s + 1] - ts[s]) / double(q + (s < u ? 1 : 0));
+		}
+		compute_tsc_stats(ns, x, st);
+	}
+
+	struct _no_monitor
+	{
+		void start() { }
+		void stop() { }
+	};
+
+	/**
+	 * Times repeat_times runs of op (after warming up), as a number
+	 * of samples.
+	 */
+	template<class Op>
+	tsc_stats tsc_bench(Op op, unsigned warming_times, unsigned repeat_times)
+	{
+		tsc_stats st;
+		_no_monitor mon;
+		_sampled_bench(op, warming_times, repeat_times, mon, st);
+		return st;
+	}
+
+
+	/********************************************
+	 *
+	 *  Hardware counters
+	 *
+	 *  On Linux, perf_bench reads the hardware
+	 *  performance counters (through the
+	 *  perf_event_open system call) around the
+	 *  timed loop, in addition to the TSC.
+	 *
+	 *  Model-specific events, such as the uops
+	 *  dispatched to each port, can be added
+	 *  through the environment variable
+	 *  LSIMD_PERF_RAW, as a comma-separated list
+	 *  of name=code pairs, where code is the raw
+	 *  event code (as for perf stat -e rNNNN),
+	 *  e.g. "p0=0x01a1,p1=0x02a1" (on Skylake).
+	 *
+	 *  When the counters are not available
+	 *  (other systems, a restrictive setting of
+	 *  perf_event_paranoid, or LSIMD_PERF=0),
+	 *  only the TSC is used.
+	 *
+	 ********************************************/
+
+	enum perf_event_kind
+	{
+		perf_instructions = 0,
+		perf_cycles,
+		perf_l1d_misses,
+		perf_llc_misses,
+		perf_branch_misses,
+		num_perf_std_events
+	};
+
+	const int max_perf_raw_events = 8;
+	const int max_perf_events = num_perf_std_events + max_perf_raw_events;
+
+	/**
+	 * Counter values over a timed loop. A value is negative when 
+	 * the corresponding counter is not available.
+	 */
+	struct perf_counts
+	{
+		double value[max_perf_events];
+
+		int num_raw;
+		const char *raw_names[max_perf_raw_events];
+
+		perf_counts() : num_raw(0)
+		{
+			for (int i = 0; i < max_perf_events; ++i) value[i] = -1.0;
+		}
+
+		bool has(int k) const { return value[k] >= 0.0; }
+	};
+
+
+	class perf_monitor
+	{
+	public:
+		perf_monitor() : m_num_raw(0)
+		{
+			for (int i = 0; i < max_perf_events; ++i) m_fds[i] = -1;
+
+#ifdef LSIMD_BENCH_HAS_PERF
+			const char *en = std::getenv("LSIMD_PERF");
+			if (en && std::strcmp(en, "0") == 0) return;
+
+			m_fds[perf_instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+			m_fds[perf_cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+			m_fds[perf_l1d_misses] = open_event(PERF_TYPE_HW_CACHE,
+					PERF_COUNT_HW_CACHE_L1D |
+					(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+					(PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+			m_fds[perf_llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+			m_fds[perf_branch_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+
+			open_raw_events(std::getenv("LSIMD_PERF_RAW"));
+#endif
+		}
+
+		~perf_monitor()
+		{
+#ifdef LSIMD_BENCH_HAS_PERF
+			for (int i = 0; i < max_perf_events; ++i)
+			{
+				if (m_fds[i] >= 0) close(m_fds[i]);
+			}
+#endif
+		}
+
+		bool available() const
+		{
+			for (int i = 0; i < max_perf_events; ++i)
+			{
+				if (m_fds[i] >= 0) return true;
+			}
+			return false;
+		}
+
+		void start()
+		{
+#ifdef LSIMD_BENCH_HAS_PERF
+			for (int i = 0; i < max_perf_events; ++i)
+			{
+				if (m_fds[i] >= 0)
+				{
+					ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+					ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+
+		void stop(perf_counts& c)
+		{
+			c = perf_counts();
+			c.num_raw = m_num_raw;
+			for (int i = 0; i < m_num_raw; ++i) c.raw_names[i] = m_raw_names[i];
+
+#ifdef LSIMD_BENCH_HAS_PERF
+			for (int i = 0; i < max_perf_events; ++i)
+			{
+				if (m_fds[i] >= 0) ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+
+			for (int i = 0; i < max_perf_events; ++i)
+			{
+				// value, time enabled, time running (the latter two
+				// scale the value when counters are multiplexed)
+
+				uint64_t buf[3];
+				if (m_fds[i] >= 0 && read(m_fds[i], buf, sizeof(buf)) == (ssize_t)sizeof(buf) && buf[2] > 0)
+				{
+					c.value[i] = double(buf[0]) * (double(buf[1]) / double(buf[2]));
+				}
+			}
+#endif
+		}
+
+	private:
+		perf_monitor(const perf_monitor& );
+		perf_monitor& operator = (const perf_monitor& );
+
+#ifdef LSIMD_BENCH_HAS_PERF
+		static int open_event(uint32_t type, uint64_t config)
+		{
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = type;
+			attr.config = config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+
+		void open_raw_events(const char *spec)
+		{
+			if (!spec) return;
+
+			const char *p = spec;
+			while (*p && m_num_raw < max_perf_raw_events)
+			{
+				const char *q = p;
+				while (*q && *q != ',') ++q;
+
+				const char *e = p;
+				while (e < q && *e != '=') ++e;
+
+				if (e < q && e - p < 16)
+				{
+					char *name = m_raw_names[m_num_raw];
+					std::memcpy(name, p, (size_t)(e - p));
+					name[e - p] = '\0';
+
+					uint64_t code = (uint64_t)std::strtoul(e + 1, 0, 16);
+					int fd = open_event(PERF_TYPE_RAW, code);
+					if (fd >= 0)
+					{
+						m_fds[num_perf_std_events + m_num_raw] = fd;
+						++ m_num_raw;
+					}
+				}
+
+				p = *q ? q + 1 : q;
+			}
+		}
+#endif
+
+	private:
+		int m_fds[max_perf_events];
+		int m_num_raw;
+		char m_raw_names[max_perf_raw_events][16];
+	};
+
+	inline perf_monitor& bench_perf_monitor()
+	{
+		static perf_monitor mon;
+		return mon;
+	}
+
+
+	/**
+	 * The result of a timed loop: the statistics of the TSC samples
+	 * and the hardware counters over all of them.
+	 */
+	struct bench_result : public tsc_stats
+	{
+		perf_counts perf;
+	};
+
+	// hooks the perf monitor into _sampled_bench
+	struct _perf_hook
+	{
+		perf_monitor& mon;
+		perf_counts& c;
+
+		_perf_hook(perf_monitor& m, perf_counts& c_) : mon(m), c(c_) { }
+
+		void start() { mon.start(); }
+		void stop() { mon.stop(c); }
+
+	private:
+		_perf_hook& operator = (const _perf_hook& );
+	};
 
-		uint64_t tic = read_tsc();
-		for (unsigned i = 0; i < repeat_times; ++i) op.run();
-		uint64_t toc = read_tsc();
+	template<class Op>
+	bench_result perf_bench(Op op, unsigned warming_times, unsigned repeat_times)
+	{
+		bench_result r;
+		_perf_hook hook(bench_perf_monitor(), r.perf);
+		_sampled_bench(op, warming_times, repeat_times, hook, r);
+		return r;
+	}
+
+	/**
+	 * Prints the counter-derived figures of a timed loop, i.e. 
+	 * the IPC and the misses per element, and ends the line.
+	 *
+	 * @param r         The result of the loop.
+	 * @param elems     The number of elements processed by each run.
+	 * @param unit      The name of an element (e.g. "elem", "vec").
+	 */
+	inline void print_perf(const bench_result& r, double elems, const char *unit)
+	{
+		const perf_counts& c = r.perf;
+
+		if (!c.has(perf_instructions) && !c.has(perf_cycles))
+		{
+			std::printf("   [perf n/a]\n");
+			return;
+		}
+
+		const double ne = double(r.repeat_times) * elems;
+		const double cyc = c.has(perf_cycles) ? c.value[perf_cycles] : double(r.cycles);
+
+		std::printf("   [");
+		if (c.has(perf_instructions))
+			std::printf("IPC %.2f", c.value[perf_instructions] / cyc);
+
+		std::printf(" | miss / %s:", unit);
+		if (c.has(perf_l1d_misses))
+			std::printf(" L1D %.3f", c.value[perf_l1d_misses] / ne);
+		if (c.has(perf_llc_misses))
+			std::printf(" LLC %.3f", c.value[perf_llc_misses] / ne);
+		if (c.has(perf_branch_misses))
+			std::printf(" br %.3f", c.value[perf_branch_misses] / ne);
 
-		return toc - tic;  // total cycles
+		if (c.num_raw > 0)
+		{
+			std::printf(" | per %s:", unit);
+			for (int i = 0; i < c.num_raw; ++i)
+			{
+				if (c.has(num_perf_std_events + i))
+					std::printf(" %s %.2f", c.raw_names[i], c.value[num_perf_std_events + i] / ne);
+			}
+		}
+
+		std::printf("]\n");
 	}
 
 
+	/********************************************
+	 *
+	 *  Structured output
+	 *
+	 *  Besides the text report, each benchmark
+	 *  can write its results as records to a
+	 *  JSON or CSV file, given on the command
+	 *  line as --json=<file> or --csv=<file>
+	 *  (or through the environment variable
+	 *  LSIMD_BENCH_OUT, where the format follows
+	 *  the file extension).
+	 *
+	 *  Each record has the fields
+	 *
+	 *  - bench:        the benchmark program
+	 *  - op:           the operation
+	 *  - config:       the sizes or variant (may be empty)
+	 *  - type:         the scalar type (f32 or f64)
+	 *  - pack_width:   the number of scalars per pack
+	 *  - unit:         what the cycles are counted for
+	 *  - cycles:       the mean cycles per unit
+	 *  - variance:     the variance of cycles per unit over samples
+	 *  - median:       the median cycles per unit
+	 *  - mad:          the median absolute deviation
+	 *  - p05, p95:     the 5th and 95th percentiles
+	 *  - ns:           the mean time per unit in nanoseconds
+	 *  - samples:      the number of samples
+	 *  - repetitions:  the number of timed runs
+	 *
+	 *  The JSON file is an array with one record
+	 *  per line. Two files can be compared with
+	 *  bench_compare.
+	 *
+	 ********************************************/
+
+	template<typename T> struct bench_type_name;
+
+	template<> struct bench_type_name<f32>
+	{
+		static const char *get() { return "f32"; }
+	};
+
+	template<> struct bench_type_name<f64>
+	{
+		static const char *get() { return "f64"; }
+	};
+
+	template<> struct bench_type_name<i32>
+	{
+		static const char *get() { return "i32"; }
+	};
+
+	class bench_output
+	{
+	public:
+		enum format_t
+		{
+			no_output,
+			json_output,
+			csv_output
+		};
+
+		bench_output() : m_fp(0), m_fmt(no_output), m_count(0)
+		{
+			m_bench[0] = '\0';
+		}
+
+		~bench_output()
+		{
+			close();
+		}
+
+		/**
+		 * Opens the output file given by the command line
+		 * (or LSIMD_BENCH_OUT). The benchmark name is the base
+		 * name of the program.
+		 */
+		void open(int argc, char *argv[])
+		{
+			const char *path = std::getenv("LSIMD_BENCH_OUT");
+			format_t fmt = path ? format_of(path) : no_output;
+
+			for (int i = 1; i < argc; ++i)
+			{
+				if (std::strncmp(argv[i], "--json=", 7) == 0)
+				{
+					path = argv[i] + 7;
+					fmt = json_output;
+				}
+				else if (std::strncmp(argv[i], "--csv=", 6) == 0)
+				{
+					path = argv[i] + 6;
+					fmt = csv_output;
+				}
+			}
+
+			set_bench_name(argc > 0 ? argv[0] : "bench");
+
+			if (!path || fmt == no_output) return;
+
+			m_fp = std::fopen(path, "w");
+			if (!m_fp)
+			{
+				std::fprintf(stderr, "Failed to open %s for output.\n", path);
+				return;
+			}
+
+			m_fmt = fmt;
+			if (m_fmt == json_output)
+				std::fprintf(m_fp, "[\n");
+			else
+				std::fprintf(m_fp, "bench,op,config,type,pack_width,unit,"
+						"cycles,variance,median,mad,p05,p95,ns,samples,repetitions\n");
+		}
+
+		void close()
+		{
+			if (!m_fp) return;
+
+			if (m_fmt == json_output)
+				std::fprintf(m_fp, "%s]\n", m_count > 0 ? "\n" : "");
+
+			std::fclose(m_fp);
+			m_fp = 0;
+			m_fmt = no_output;
+		}
+
+		bool is_open() const
+		{
+			return m_fp != 0;
+		}
+
+		/**
+		 * Adds a record, with the statistics of st divided by
+		 * the number of units per run.
+		 */
+		void add(const char *op, const char *config, const char *type, unsigned pack_w,
+				const char *unit, double units, const tsc_stats& st)
+		{
+			if (!m_fp) return;
+
+			if (m_fmt == json_output)
+			{
+				std::fprintf(m_fp, "%s{\"bench\": ", m_count > 0 ? ",\n" : "");
+				put_json_str(m_bench);
+				std::fprintf(m_fp, ", \"op\": ");
+				put_json_str(op);
+				std::fprintf(m_fp, ", \"config\": ");
+				put_json_str(config);
+				std::fprintf(m_fp, ", \"type\": ");
+				put_json_str(type);
+				std::fprintf(m_fp, ", \"pack_width\": %u, \"unit\": ", pack_w);
+				put_json_str(unit);
+				std::fprintf(m_fp, ", \"cycles\": %.6g, \"variance\": %.6g, \"median\": %.6g, \"mad\": %.6g"
+						", \"p05\": %.6g, \"p95\": %.6g, \"ns\": %.6g, \"samples\": %u, \"repetitions\": %u}",
+						st.mean / units, st.var / (units * units), st.median / units, st.mad / units,
+						st.p05 / units, st.p95 / units, st.mean / (units * tsc_per_ns()),
+						st.num_samples, st.repeat_times);
+			}
+			else
+			{
+				put_csv_str(m_bench);
+				std::fputc(',', m_fp);
+				put_csv_str(op);
+				std::fputc(',', m_fp);
+				put_csv_str(config);
+				std::fprintf(m_fp, ",%s,%u,%s,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g,%u,%u\n",
+						type, pack_w, unit,
+						st.mean / units, st.var / (units * units), st.median / units, st.mad / units,
+						st.p05 / units, st.p95 / units, st.mean / (units * tsc_per_ns()),
+						st.num_samples, st.repeat_times);
+			}
+
+			++ m_count;
+			std::fflush(m_fp);
+		}
+
+	private:
+		bench_output(const bench_output& );
+		bench_output& operator = (const bench_output& );
+
+		static format_t format_of(const char *path)
+		{
+			size_t n = std::strlen(path);
+			if (n >= 5 && std::strcmp(path + n - 5, ".json") == 0) return json_output;
+			if (n >= 4 && std::strcmp(path + n - 4, ".csv") == 0) return csv_output;
+			return no_output;
+		}
+
+		void set_bench_name(const char *prog)
+		{
+			const char *b = prog;
+			for (const char *p = prog; *p; ++p)
+			{
+				if (*p == '/' || *p == '\\') b = p + 1;
+			}
+
+			size_t n = std::strlen(b);
+			if (n >= 4 && std::strcmp(b + n - 4, ".exe") == 0) n -= 4;
+			if (n >= sizeof(m_bench)) n = sizeof(m_bench) - 1;
+
+			std::memcpy(m_bench, b, n);
+			m_bench[n] = '\0';
+		}
+
+		void put_json_str(const char *s)
+		{
+			std::fputc('"', m_fp);
+			for (; *s; ++s)
+			{
+				if (*s == '"' || *s == '\\') std::fputc('\\', m_fp);
+				std::fputc(*s, m_fp);
+			}
+			std::fputc('"', m_fp);
+		}
+
+		void put_csv_str(const char *s)
+		{
+			std::fputc('"', m_fp);
+			for (; *s; ++s)
+			{
+				if (*s == '"') std::fputc('"', m_fp);
+				std::fputc(*s, m_fp);
+			}
+			std::fputc('"', m_fp);
+		}
+
+	private:
+		std::FILE *m_fp;
+		format_t m_fmt;
+		unsigned m_count;
+		char m_bench[64];
+	};
+
+	inline bench_output& bench_out()
+	{
+		static bench_output out;
+		return out;
+	}
+
+	/**
+	 * Adds the record of a timed loop to the structured output
+	 * (if any).
+	 *
+	 * @param op        The name of the operation.
+	 * @param config    The sizes or variant, e.g. "3x4" (may be empty).
+	 * @param pack_w    The number of scalars per pack.
+	 * @param unit      The name of the unit the cycles are counted for.
+	 * @param units     The number of units processed by each run.
+	 * @param r         The result of the loop.
+	 */
+	template<typename T>
+	inline void record_bench(const char *op, const char *config, unsigned pack_w,
+			const char *unit, double units, const bench_result& r)
+	{
+		bench_out().add(op, config, bench_type_name<T>::get(), pack_w, unit, units, r);
+	}
+
+	/**
+	 * Applies the settings on the command line (or in the environment)
+	 * and opens the structured output, then prints the setup.
+	 */
+	inline void bench_setup(int argc, char *argv[])
+	{
+		bench_settings& cfg = bench_config();
+
+		const char *es = std::getenv("LSIMD_BENCH_SAMPLES");
+		if (es) cfg.num_samples = (unsigned)std::atoi(es);
+
+		const char *ec = std::getenv("LSIMD_BENCH_CPU");
+		if (ec) cfg.cpu = std::atoi(ec);
+
+		for (int i = 1; i < argc; ++i)
+		{
+			if (std::strncmp(argv[i], "--samples=", 10) == 0)
+				cfg.num_samples = (unsigned)std::atoi(argv[i] + 10);
+			else if (std::strncmp(argv[i], "--cpu=", 6) == 0)
+				cfg.cpu = std::atoi(argv[i] + 6);
+		}
+
+		if (cfg.num_samples < 1) cfg.num_samples = 1;
+		if (cfg.num_samples > max_tsc_samples) cfg.num_samples = max_tsc_samples;
+
+		if (cfg.cpu >= 0 && !pin_to_cpu(cfg.cpu))
+		{
+			std::fprintf(stderr, "Failed to pin to CPU %d.\n", cfg.cpu);
+			cfg.cpu = -1;
+		}
+
+		bench_out().open(argc, argv);
+
+		std::printf("[TSC %.3f GHz, %u samples", tsc_per_ns(), cfg.num_samples);
+		if (cfg.cpu >= 0)
+			std::printf(", pinned to CPU %d]\n\n", cfg.cpu);
+		else
+			std::printf(", not pinned]\n\n");
+	}
+
+
+
 	template<typename T, typename Kind, class Op, unsigned Len>
 	struct wrap_op
 	{
@@ -135,6 +1013,140 @@ namespace lsimd
 		}
 	};
 
+	/**
+	 * Runs Op::scalar on each element of the same data as wrap_op,
+	 * which gives the scalar baseline of a pack operation.
+	 */
+	template<typename T, class Op, unsigned Len>
+	struct wrap_scalar_op
+	{
+		static const unsigned w = simd<T, sse_kind>::pack_width;
+		const T *a;
+
+		wrap_scalar_op(const T *a_)
+		: a(a_)
+		{
+		}
+
+		LSIMD_ENSURE_INLINE
+		void run()
+		{
+			for (unsigned i = 0; i < Len * w; ++i)
+			{
+				T x0 = a[i];
+				make_opaque(x0);
+
+				T r = Op::scalar(x0);
+				force_to_reg(r);
+			}
+		}
+	};
+
+
+	/********************************************
+	 *
+	 *  Latency
+	 *
+	 *  wrap_op runs independent ops, and thus
+	 *  measures the throughput. wrap_lat_op
+	 *  instead feeds the result of each op into
+	 *  the input of the next, as
+	 *
+	 *    x[i+1] = a[i+1] | (op(x[i]) & 0)
+	 *
+	 *  where the zero mask is hidden from the
+	 *  compiler. This yields a dependent chain
+	 *  over the actual inputs a[i], whose cycles
+	 *  per op, less those of the same chain with
+	 *  the identity (chain_overhead), give the
+	 *  latency.
+	 *
+	 *  The ops used with both provide
+	 *  Op::eval(x), which returns the result.
+	 *
+	 ********************************************/
+
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f32, sse_kind> chain_input(const simd_pack<f32, sse_kind>& a,
+			const simd_pack<f32, sse_kind>& y, const simd_pack<f32, sse_kind>& z)
+	{
+		return _mm_or_ps(a.impl.v, _mm_and_ps(y.impl.v, z.impl.v));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f64, sse_kind> chain_input(const simd_pack<f64, sse_kind>& a,
+			const simd_pack<f64, sse_kind>& y, const simd_pack<f64, sse_kind>& z)
+	{
+		return _mm_or_pd(a.impl.v, _mm_and_pd(y.impl.v, z.impl.v));
+	}
+
+	/**
+	 * Adapts an op with eval to wrap_op.
+	 */
+	template<class Op>
+	struct eval_op
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind>& x)
+		{
+			simd_pack<T, Kind> r = Op::eval(x);
+			force_to_reg(r);
+		}
+	};
+
+	struct ident_op
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static simd_pack<T, Kind> eval(const simd_pack<T, Kind>& x)
+		{
+			return x;
+		}
+	};
+
+	template<typename T, typename Kind, class Op, unsigned Len>
+	struct wrap_lat_op
+	{
+		static const unsigned w = simd<T, Kind>::pack_width;
+		const T *a;
+
+		wrap_lat_op(const T *a_)
+		: a(a_)
+		{
+		}
+
+		LSIMD_ENSURE_INLINE
+		void run()
+		{
+			simd_pack<T, Kind> z = simd_pack<T, Kind>::zeros();
+			make_opaque(z);
+
+			simd_pack<T, Kind> x(a, aligned_t());
+
+			for (unsigned i = 1; i < Len; ++i)
+			{
+				simd_pack<T, Kind> y = Op::eval(x);
+				x = chain_input(simd_pack<T, Kind>(a + i * w, aligned_t()), y, z);
+			}
+
+			simd_pack<T, Kind> r = Op::eval(x);
+			force_to_reg(r);
+		}
+	};
+
+	/**
+	 * The cycles per link of the chain of wrap_lat_op with the
+	 * identity, i.e. the part of the chain that is not the op.
+	 */
+	template<typename T, unsigned Len>
+	inline double chain_overhead(const T *a)
+	{
+		wrap_lat_op<T, sse_kind, ident_op, Len> op(a);
+		bench_result r = perf_bench(op, 1000, 100000);
+		return r.median / double(Len);
+	}
+
 
 	/********************************************
 	 *
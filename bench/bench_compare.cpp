@@ -0,0 +1,346 @@
+/**
+ * @file bench_compare.cpp
+ *
+ * Compares two runs of the benchmarks (as written with --json or --csv)
+ * and flags the statistically significant regressions
+ *
+ * Usage: bench_compare [options] <baseline> <current>
+ *
+ *   --alpha=<a>       the significance level of the test (default 0.01)
+ *   --threshold=<r>   the minimum relative change to report (default 0.02)
+ *
+ * Each pair of records with the same bench, op, config, type and unit is
+ * compared with Welch's t-test on the mean cycles, using the variance
+ * and the number of samples of each record. A record is flagged as a
+ * regression when it is slower by more than the threshold, and the
+ * difference is significant at the given level.
+ *
+ * The program returns 1 if any regression is found, and 0 otherwise.
+ *
+ * @author Dahua Lin
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+
+
+struct bench_rec
+{
+	std::string key;
+	double cycles;
+	double variance;
+	double samples;
+};
+
+typedef std::vector<bench_rec> rec_list;
+
+
+/********************************************
+ *
+ *  Parsing
+ *
+ ********************************************/
+
+// JSON: one record per line, as written by bench_output
+
+static bool json_field(const std::string& line, const char *name, std::string& v)
+{
+	std::string pat = std::string("\"") + name + "\":";
+	std::string::size_type p = line.find(pat);
+	if (p == std::string::npos) return false;
+
+	p += pat.size();
+	while (p < line.size() && line[p] == ' ') ++p;
+	if (p >= line.size()) return false;
+
+	v.clear();
+	if (line[p] == '"')
+	{
+		for (++p; p < line.size() && line[p] != '"'; ++p)
+		{
+			if (line[p] == '\\' && p + 1 < line.size()) ++p;
+			v += line[p];
+		}
+	}
+	else
+	{
+		for (; p < line.size() && line[p] != ',' && line[p] != '}'; ++p) v += line[p];
+	}
+	return true;
+}
+
+static void split_csv(const std::string& line, std::vector<std::string>& fs)
+{
+	fs.clear();
+	std::string f;
+	bool quoted = false;
+
+	for (std::string::size_type i = 0; i < line.size(); ++i)
+	{
+		char c = line[i];
+		if (quoted)
+		{
+			if (c == '"')
+			{
+				if (i + 1 < line.size() && line[i + 1] == '"') { f += '"'; ++i; }
+				else quoted = false;
+			}
+			else f += c;
+		}
+		else if (c == '"') quoted = true;
+		else if (c == ',') { fs.push_back(f); f.clear(); }
+		else if (c != '\r') f += c;
+	}
+	fs.push_back(f);
+}
+
+static const char *key_fields[] = { "bench", "op", "config", "type", "unit" };
+static const int num_key_fields = 5;
+
+static bool read_records(const char *path, rec_list& recs)
+{
+	std::FILE *fp = std::fopen(path, "r");
+	if (!fp)
+	{
+		std::fprintf(stderr, "Failed to open %s\n", path);
+		return false;
+	}
+
+	std::vector<std::string> lines;
+	std::string cur;
+	int c;
+	while ((c = std::fgetc(fp)) != EOF)
+	{
+		if (c == '\n') { lines.push_back(cur); cur.clear(); }
+		else cur += (char)c;
+	}
+	if (!cur.empty()) lines.push_back(cur);
+	std::fclose(fp);
+
+	std::vector<std::string> header;
+	bool is_csv = !lines.empty() && lines[0].compare(0, 6, "bench,") == 0;
+	if (is_csv) split_csv(lines[0], header);
+
+	for (size_t i = is_csv ? 1 : 0; i < lines.size(); ++i)
+	{
+		const std::string& line = lines[i];
+		std::map<std::string, std::string> fm;
+
+		if (is_csv)
+		{
+			std::vector<std::string> fs;
+			split_csv(line, fs);
+			if (fs.size() != header.size()) continue;
+			for (size_t j = 0; j < fs.size(); ++j) fm[header[j]] = fs[j];
+		}
+		else
+		{
+			if (line.find('{') == std::string::npos) continue;
+
+			static const char *names[] = { "bench", "op", "config", "type", "unit",
+				"cycles", "variance", "samples" };
+			std::string v;
+			for (int j = 0; j < 8; ++j)
+			{
+				if (json_field(line, names[j], v)) fm[names[j]] = v;
+			}
+		}
+
+		if (fm.find("cycles") == fm.end()) continue;
+
+		bench_rec r;
+		for (int j = 0; j < num_key_fields; ++j)
+		{
+			if (j > 0) r.key += " | ";
+			r.key += fm[key_fields[j]];
+		}
+		r.cycles = std::atof(fm["cycles"].c_str());
+		r.variance = std::atof(fm["variance"].c_str());
+		r.samples = std::atof(fm["samples"].c_str());
+		if (r.samples < 1) r.samples = 1;
+
+		recs.push_back(r);
+	}
+
+	return true;
+}
+
+
+/********************************************
+ *
+ *  Statistics
+ *
+ ********************************************/
+
+// the upper quantile of the standard normal distribution
+// (Abramowitz & Stegun 26.2.23, |error| < 4.5e-4)
+
+static double normal_upper_quantile(double p)
+{
+	double t = std::sqrt(-2.0 * std::log(p));
+	return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) /
+		(1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+// the upper quantile of Student's t distribution with df degrees
+// of freedom (Cornish-Fisher expansion around the normal quantile)
+
+static double t_upper_quantile(double p, double df)
+{
+	double z = normal_upper_quantile(p);
+	double z2 = z * z;
+
+	double g1 = (z2 + 1.0) * z / 4.0;
+	double g2 = ((5.0 * z2 + 16.0) * z2 + 3.0) * z / 96.0;
+	double g3 = (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) * z / 384.0;
+
+	return z + g1 / df + g2 / (df * df) + g3 / (df * df * df);
+}
+
+struct compare_result
+{
+	double rel;     // relative change of cycles
+	double t;       // Welch's t statistic
+	double df;      // degrees of freedom
+	bool signif;
+};
+
+static compare_result welch_test(const bench_rec& a, const bench_rec& b, double alpha)
+{
+	compare_result c;
+	c.rel = a.cycles > 0 ? (b.cycles - a.cycles) / a.cycles : 0.0;
+
+	double va = a.variance / a.samples;
+	double vb = b.variance / b.samples;
+	double se2 = va + vb;
+	double d = b.cycles - a.cycles;
+
+	if (se2 <= 0)
+	{
+		// no spread on either side: any difference counts
+
+		c.t = d == 0 ? 0.0 : (d > 0 ? HUGE_VAL : -HUGE_VAL);
+		c.df = 0;
+		c.signif = d != 0;
+		return c;
+	}
+
+	c.t = d / std::sqrt(se2);
+
+	double dfa = a.samples > 1 ? va * va / (a.samples - 1) : 0.0;
+	double dfb = b.samples > 1 ? vb * vb / (b.samples - 1) : 0.0;
+	c.df = (dfa + dfb) > 0 ? se2 * se2 / (dfa + dfb) : 1.0;
+	if (c.df < 1.0) c.df = 1.0;
+
+	c.signif = std::fabs(c.t) > t_upper_quantile(alpha / 2, c.df);
+	return c;
+}
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+static void usage()
+{
+	std::fprintf(stderr, "Usage: bench_compare [--alpha=<a>] [--threshold=<r>] <baseline> <current>\n");
+}
+
+int main(int argc, char *argv[])
+{
+	double alpha = 0.01;
+	double threshold = 0.02;
+	const char *paths[2] = { 0, 0 };
+	int np = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--alpha=", 8) == 0)
+			alpha = std::atof(argv[i] + 8);
+		else if (std::strncmp(argv[i], "--threshold=", 12) == 0)
+			threshold = std::atof(argv[i] + 12);
+		else if (np < 2)
+			paths[np++] = argv[i];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+
+	if (np < 2 || !(alpha > 0 && alpha < 1) || threshold < 0)
+	{
+		usage();
+		return 2;
+	}
+
+	rec_list base, cur;
+	if (!read_records(paths[0], base) || !read_records(paths[1], cur)) return 2;
+
+	std::map<std::string, size_t> base_idx;
+	for (size_t i = 0; i < base.size(); ++i) base_idx[base[i].key] = i;
+
+	std::printf("%-56s %10s %10s %8s %8s\n", "bench | op | config | type | unit",
+			"baseline", "current", "change", "t");
+	std::printf("------------------------------------------------------------"
+			"--------------------------------------------\n");
+
+	int n_regress = 0, n_improve = 0, n_new = 0;
+	std::map<std::string, bool> seen;
+
+	for (size_t i = 0; i < cur.size(); ++i)
+	{
+		const bench_rec& b = cur[i];
+		seen[b.key] = true;
+
+		std::map<std::string, size_t>::const_iterator it = base_idx.find(b.key);
+		if (it == base_idx.end())
+		{
+			std::printf("%-56s %10s %10.3f %8s %8s   new\n", b.key.c_str(), "-", b.cycles, "", "");
+			++ n_new;
+			continue;
+		}
+
+		const bench_rec& a = base[it->second];
+		compare_result c = welch_test(a, b, alpha);
+
+		const char *flag = "";
+		if (c.signif && c.rel > threshold)
+		{
+			flag = "REGRESSION";
+			++ n_regress;
+		}
+		else if (c.signif && c.rel < -threshold)
+		{
+			flag = "improved";
+			++ n_improve;
+		}
+
+		std::printf("%-56s %10.3f %10.3f %+7.1f%% %8.2f   %s\n", b.key.c_str(),
+				a.cycles, b.cycles, c.rel * 100.0, c.t, flag);
+	}
+
+	int n_missing = 0;
+	for (size_t i = 0; i < base.size(); ++i)
+	{
+		if (seen.find(base[i].key) == seen.end())
+		{
+			std::printf("%-56s %10.3f %10s %8s %8s   missing\n", base[i].key.c_str(),
+					base[i].cycles, "-", "", "");
+			++ n_missing;
+		}
+	}
+
+	std::printf("\n%d regression(s), %d improvement(s), %d new, %d missing "
+			"(alpha = %g, threshold = %.1f%%)\n",
+			n_regress, n_improve, n_new, n_missing, alpha, threshold * 100.0);
+
+	return n_regress > 0 ? 1 : 0;
+}
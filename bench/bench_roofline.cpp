@@ -0,0 +1,484 @@
+/**
+ * @file bench_roofline.cpp
+ *
+ * Roofline benchmark: the achieved bandwidth and throughput of
+ * streaming kernels (load, store, copy, triad) and of the library's
+ * array kernels, over working sets from 4 KB to 1 GB
+ *
+ * The peak throughput is measured with independent multiply-add
+ * chains in registers, and the bandwidth ceiling at each size is
+ * the highest bandwidth of the streaming kernels at the same size.
+ * A kernel processing B bytes with F flops in time t thus achieves
+ *
+ *   max(F / peak_flops, B / peak_bw) / t
+ *
+ * of its roof, which is bound by memory or by compute (cpu)
+ * depending on which term is larger.
+ *
+ * The largest working set can be lowered with --max-size=<MB>
+ * (or LSIMD_ROOFLINE_MAX_MB).
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <new>
+
+using namespace lsimd;
+
+const unsigned warming_times = 1;
+const size_t min_size = size_t(4) << 10;
+const size_t default_max_size = size_t(1) << 30;
+const double bytes_per_measure = 512.0 * (1 << 20);
+
+typedef default_simd_kind kind_t;
+
+
+/********************************************
+ *
+ *  Working set
+ *
+ ********************************************/
+
+template<typename T>
+class roof_buffer
+{
+public:
+	roof_buffer(size_t bytes) : m_raw(0), m_data(0), m_len(bytes / sizeof(T))
+	{
+		m_raw = new (std::nothrow) char[bytes + 64];
+		if (!m_raw) return;
+
+		// align to a cache line
+
+		size_t p = (size_t)m_raw;
+		m_data = (T*)(m_raw + ((64 - p % 64) % 64));
+
+		// touch every page before timing
+
+		for (size_t i = 0; i < m_len; ++i) m_data[i] = T(0.5) + T(i % 7) * T(0.125);
+	}
+
+	~roof_buffer()
+	{
+		delete[] m_raw;
+	}
+
+	bool ok() const { return m_data != 0; }
+
+	T *data() { return m_data; }
+
+	size_t size() const { return m_len; }
+
+private:
+	roof_buffer(const roof_buffer& );
+	roof_buffer& operator = (const roof_buffer& );
+
+	char *m_raw;
+	T *m_data;
+	size_t m_len;
+};
+
+
+/********************************************
+ *
+ *  Kernels
+ *
+ *  Each kernel is a view on the working set
+ *  of len scalars, and tells the bytes it
+ *  moves and the flops it does per run.
+ *
+ ********************************************/
+
+template<typename T>
+struct peak_flops_k
+{
+	typedef simd_pack<T, kind_t> pack_t;
+	static const int W = (int)simd<T, kind_t>::pack_width;
+	static const int len = 256;
+
+	static const char *name() { return "peak"; }
+
+	double bytes() const { return 0; }
+	double flops() const { return 2.0 * 8 * len * W; }
+
+	void run()
+	{
+		pack_t m(T(0.999));
+		pack_t a(T(0.001));
+		make_opaque(m);
+		make_opaque(a);
+
+		pack_t x0 = pack_t::zeros(), x1 = x0, x2 = x0, x3 = x0;
+		pack_t x4 = x0, x5 = x0, x6 = x0, x7 = x0;
+
+		for (int i = 0; i < len; ++i)
+		{
+			x0 = fmadd(x0, m, a);
+			x1 = fmadd(x1, m, a);
+			x2 = fmadd(x2, m, a);
+			x3 = fmadd(x3, m, a);
+			x4 = fmadd(x4, m, a);
+			x5 = fmadd(x5, m, a);
+			x6 = fmadd(x6, m, a);
+			x7 = fmadd(x7, m, a);
+		}
+
+		pack_t s = ((x0 + x1) + (x2 + x3)) + ((x4 + x5) + (x6 + x7));
+		force_to_reg(s);
+	}
+};
+
+
+template<typename T>
+struct load_k
+{
+	typedef simd_pack<T, kind_t> pack_t;
+	static const int W = (int)simd<T, kind_t>::pack_width;
+
+	const T *a;
+	int n;
+
+	static const char *name() { return "load"; }
+
+	load_k(T *buf, size_t len) : a(buf), n((int)len) { }
+
+	double bytes() const { return double(n) * sizeof(T); }
+	double flops() const { return double(n); }
+
+	void run()
+	{
+		pack_t s0 = pack_t::zeros(), s1 = s0, s2 = s0, s3 = s0;
+
+		for (int i = 0; i < n; i += 4 * W)
+		{
+			s0 = s0 + pack_t(a + i, aligned_t());
+			s1 = s1 + pack_t(a + i + W, aligned_t());
+			s2 = s2 + pack_t(a + i + 2 * W, aligned_t());
+			s3 = s3 + pack_t(a + i + 3 * W, aligned_t());
+		}
+
+		pack_t s = (s0 + s1) + (s2 + s3);
+		force_to_reg(s);
+	}
+};
+
+
+template<typename T>
+struct store_k
+{
+	typedef simd_pack<T, kind_t> pack_t;
+	static const int W = (int)simd<T, kind_t>::pack_width;
+
+	T *a;
+	int n;
+
+	static const char *name() { return "store"; }
+
+	store_k(T *buf, size_t len) : a(buf), n((int)len) { }
+
+	double bytes() const { return double(n) * sizeof(T); }
+	double flops() const { return 0; }
+
+	void run()
+	{
+		pack_t v(T(0.25));
+		make_opaque(v);
+
+		for (int i = 0; i < n; i += W)
+		{
+			v.store(a + i, aligned_t());
+		}
+	}
+};
+
+
+template<typename T>
+struct copy_k
+{
+	typedef simd_pack<T, kind_t> pack_t;
+	static const int W = (int)simd<T, kind_t>::pack_width;
+
+	const T *a;
+	T *b;
+	int n;
+
+	static const char *name() { return "copy"; }
+
+	copy_k(T *buf, size_t len) : a(buf), b(buf + len / 2), n((int)(len / 2)) { }
+
+	double bytes() const { return 2.0 * double(n) * sizeof(T); }
+	double flops() const { return 0; }
+
+	void run()
+	{
+		for (int i = 0; i < n; i += W)
+		{
+			pack_t(a + i, aligned_t()).store(b + i, aligned_t());
+		}
+	}
+};
+
+
+template<typename T>
+struct triad_k
+{
+	typedef simd_pack<T, kind_t> pack_t;
+	static const int W = (int)simd<T, kind_t>::pack_width;
+
+	T *a;
+	const T *b;
+	const T *c;
+	int n;
+
+	static const char *name() { return "triad"; }
+
+	triad_k(T *buf, size_t len)
+	: a(buf), b(buf + len / 3 / W * W), c(buf + 2 * (len / 3 / W * W)), n((int)(len / 3 / W * W)) { }
+
+	double bytes() const { return 3.0 * double(n) * sizeof(T); }
+	double flops() const { return 2.0 * double(n); }
+
+	void run()
+	{
+		pack_t s(T(1.5));
+
+		for (int i = 0; i < n; i += W)
+		{
+			fmadd(s, pack_t(c + i, aligned_t()), pack_t(b + i, aligned_t())).store(a + i, aligned_t());
+		}
+	}
+};
+
+
+template<typename T>
+struct batch_transform_k
+{
+	const T *xs;
+	T *ys;
+	int nv;
+	simd_mat<T, 4, 4, kind_t> A;
+
+	static const char *name() { return "batch_transform 4x4"; }
+
+	batch_transform_k(T *buf, size_t len)
+	: xs(buf), ys(buf + len / 2), nv((int)(len / 8))
+	{
+		T a[16];
+		for (int i = 0; i < 16; ++i) a[i] = T(0.0625) * T(i);
+		A.load(a, unaligned_t());
+	}
+
+	double bytes() const { return 8.0 * double(nv) * sizeof(T); }
+	double flops() const { return 32.0 * double(nv); }
+
+	void run()
+	{
+		batch_transform(A, nv, xs, ys);
+	}
+};
+
+
+/**
+ * quat_rotate on planar data: each item has 4 + 3 scalars of input
+ * and 3 of output, and takes about 30 flops.
+ */
+template<typename T>
+struct quat_rotate_k
+{
+	const T *q;
+	const T *v;
+	T *r;
+	int n;
+
+	static const char *name() { return "quat_rotate"; }
+
+	quat_rotate_k(T *buf, size_t len)
+	: q(buf), v(buf + 4 * (len / 10)), r(buf + 7 * (len / 10)), n((int)(len / 10)) { }
+
+	double bytes() const { return 10.0 * double(n) * sizeof(T); }
+	double flops() const { return 30.0 * double(n); }
+
+	void run()
+	{
+		quat_rotate(n, q, n, v, n, r, n);
+	}
+};
+
+
+template<typename T>
+struct gemv_k
+{
+	const T *a;
+	const T *x;
+	T *y;
+	int m;
+
+	static const char *name() { return "gemv"; }
+
+	gemv_k(T *buf, size_t len)
+	: m(int(std::sqrt(double(len))) - 1)
+	{
+		a = buf;
+		x = buf + size_t(m) * size_t(m);
+		y = buf + size_t(m) * size_t(m) + size_t(m);
+	}
+
+	double bytes() const { return (double(m) + 3.0) * double(m) * sizeof(T); }
+	double flops() const { return 2.0 * double(m) * double(m); }
+
+	void run()
+	{
+		gemv(m, m, T(1), a, m, x, T(0), y);
+	}
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+const int max_num_sizes = 16;
+const int num_kernels = 7;
+
+const int num_stream_kernels = 4;
+
+struct roof_point
+{
+	double ns;        // time per run
+	double bytes;     // bytes per run
+	double flops;     // flops per run
+	bool valid;
+
+	roof_point() : ns(0), bytes(0), flops(0), valid(false) { }
+};
+
+roof_point results[num_kernels][max_num_sizes];
+double peak_gbs[max_num_sizes];
+const char *kernel_names[num_kernels];
+
+
+inline void format_size(size_t bytes, char *s)
+{
+	if (bytes >= (size_t(1) << 30))
+		std::sprintf(s, "%u GB", (unsigned)(bytes >> 30));
+	else if (bytes >= (size_t(1) << 20))
+		std::sprintf(s, "%u MB", (unsigned)(bytes >> 20));
+	else
+		std::sprintf(s, "%u KB", (unsigned)(bytes >> 10));
+}
+
+template<typename T, class K>
+inline void measure(int k, int si, size_t size, K op)
+{
+	unsigned reps = (unsigned)(bytes_per_measure / double(size));
+	if (reps < 4) reps = 4;
+
+	bench_result r = perf_bench(op, warming_times, reps);
+
+	roof_point& p = results[k][si];
+	p.ns = r.median / tsc_per_ns();
+	p.bytes = op.bytes();
+	p.flops = op.flops();
+	p.valid = true;
+
+	if (k < num_stream_kernels && p.bytes / p.ns > peak_gbs[si])
+		peak_gbs[si] = p.bytes / p.ns;
+
+	kernel_names[k] = K::name();
+
+	char cfg[32];
+	format_size(size, cfg);
+	record_bench<T>(K::name(), cfg, simd<T, kind_t>::pack_width, "byte",
+			op.bytes() > 0 ? op.bytes() : 1.0, r);
+}
+
+template<typename T>
+void bench_all(size_t max_size)
+{
+	peak_flops_k<T> pk;
+	bench_result rp = perf_bench(pk, 100, 20000);
+	const double peak_gflops = pk.flops() / (rp.median / tsc_per_ns());
+
+	std::printf("Roofline (f%d)\n", (int)(sizeof(T) * 8));
+	std::printf("================================\n");
+	std::printf("\tpeak compute: %.2f GFLOP/s\n", peak_gflops);
+
+	int ns = 0;
+	for (size_t size = min_size; size <= max_size && ns < max_num_sizes; size *= 4, ++ns)
+	{
+		roof_buffer<T> buf(size);
+		if (!buf.ok())
+		{
+			char s[32];
+			format_size(size, s);
+			std::printf("\tfailed to allocate %s, stopping here.\n", s);
+			break;
+		}
+
+		peak_gbs[ns] = 0;
+
+		T *p = buf.data();
+		const size_t len = buf.size();
+
+		measure<T>(0, ns, size, load_k<T>(p, len));
+		measure<T>(1, ns, size, store_k<T>(p, len));
+		measure<T>(2, ns, size, copy_k<T>(p, len));
+		measure<T>(3, ns, size, triad_k<T>(p, len));
+		measure<T>(4, ns, size, batch_transform_k<T>(p, len));
+		measure<T>(5, ns, size, quat_rotate_k<T>(p, len));
+		measure<T>(6, ns, size, gemv_k<T>(p, len));
+	}
+
+	double max_bw = 0;
+	for (int i = 0; i < ns; ++i) if (peak_gbs[i] > max_bw) max_bw = peak_gbs[i];
+
+	std::printf("\tpeak bandwidth: %.2f GB/s (cache), %.2f GB/s (largest set)\n\n",
+			max_bw, ns > 0 ? peak_gbs[ns - 1] : 0.0);
+
+	for (int k = 0; k < num_kernels; ++k)
+	{
+		std::printf("\t%s\n", kernel_names[k]);
+		std::printf("\t\t%8s  %9s  %9s  %9s  %6s  %6s\n", "size", "GB/s", "GFLOP/s", "roof GB/s", "bound", "% roof");
+
+		size_t size = min_size;
+		for (int i = 0; i < ns; ++i, size *= 4)
+		{
+			const roof_point& pt = results[k][i];
+			if (!pt.valid) continue;
+
+			double tm = pt.bytes / peak_gbs[i];
+			double tc = pt.flops / peak_gflops;
+			bool mem_bound = tm >= tc;
+
+			char s[32];
+			format_size(size, s);
+			std::printf("\t\t%8s  %9.2f  %9.2f  %9.2f  %6s  %5.1f%%\n", s,
+					pt.bytes / pt.ns, pt.flops / pt.ns, peak_gbs[i],
+					mem_bound ? "mem" : "cpu", (mem_bound ? tm : tc) / pt.ns * 100.0);
+		}
+		std::printf("\n");
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	size_t max_size = default_max_size;
+
+	const char *em = std::getenv("LSIMD_ROOFLINE_MAX_MB");
+	if (em) max_size = size_t(std::atoi(em)) << 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--max-size=", 11) == 0)
+			max_size = size_t(std::atoi(argv[i] + 11)) << 20;
+	}
+
+	bench_all<f32>(max_size);
+}
@@ -14,15 +14,25 @@ using namespace lsimd;
 const unsigned arr_len = 64;
 const unsigned warming_times = 1000;
 
-inline void report_bench(const char *name, unsigned rtimes, uint64_t cycles,
-		int pack_w, int nops)
+inline void report_bench(const char *name, unsigned rtimes, const bench_result& r,
+		const bench_result& rl, double overhead, int pack_w, int nops)
 {
-	double cpo_f = double(cycles) / (double(rtimes) * double(arr_len));
+	double cpo_f = r.median / (double(rtimes / r.repeat_times) * double(arr_len));
 
 	int cpoi = int(cpo_f);
 	cpoi = (cpoi - nops);  // re-calibrated
 
-	std::printf("\t%-10s:   %4d cycles / %d op\n", name, cpoi, pack_w);
+	double lat = rl.median / (double(rtimes / rl.repeat_times) * double(arr_len)) - overhead;
+
+	std::printf("\t%-10s:   %4d cycles / %d op,  latency = %5.1f cycles", name, cpoi, pack_w, lat);
+	print_perf(r, double(arr_len) * double(pack_w), "elem");
+}
+
+template<typename T>
+inline double lat_overhead(const T *pa)
+{
+	static const double v = chain_overhead<T, arr_len>(pa);
+	return v;
 }
 
 
@@ -34,11 +44,23 @@ inline void bench(unsigned repeat_times, T *pa)
 
 	fill_rand(arr_len, pa, lb, ub);
 
-	wrap_op<T, sse_kind, OpT<T>, arr_len> op1(pa);
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	wrap_op<T, sse_kind, eval_op<OpT<T> >, arr_len> op1(pa);
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
+
+	wrap_lat_op<T, sse_kind, OpT<T>, arr_len> op2(pa);
+	bench_result cs2 = perf_bench(op2, warming_times, repeat_times);
+
+	const double ovh = lat_overhead(pa);
+	const unsigned w = simd_pack<T, sse_kind>::pack_width;
+	const double units = double(arr_len) * double(OpT<T>::folds());
 
 	report_bench(OpT<T>::name(), repeat_times * OpT<T>::folds(),
-			cs1, (int)simd_pack<T, sse_kind>::pack_width, 1);
+			cs1, cs2, ovh, (int)w, 1);
+
+	record_bench<T>(OpT<T>::name(), "", w, "op", units, cs1);
+
+	subtract_cycles(cs2, ovh * double(arr_len));
+	record_bench<T>(OpT<T>::name(), "latency", w, "op", units, cs2);
 }
 
 
@@ -53,10 +75,9 @@ struct sqrt_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = lsimd::sqrt(x);
-		force_to_reg(r);
+		return lsimd::sqrt(x);
 	}
 };
 
@@ -72,10 +93,9 @@ struct rcp_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = rcp(x);
-		force_to_reg(r);
+		return rcp(x);
 	}
 };
 
@@ -90,10 +110,9 @@ struct rsqrt_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = rsqrt(x);
-		force_to_reg(r);
+		return rsqrt(x);
 	}
 };
 
@@ -108,10 +127,9 @@ struct approx_rcp_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = approx_rcp(x.impl);
-		force_to_reg(r);
+		return approx_rcp(x.impl);
 	}
 };
 
@@ -126,10 +144,9 @@ struct approx_rsqrt_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r =  approx_rsqrt(x.impl);
-		force_to_reg(r);
+		return approx_rsqrt(x.impl);
 	}
 };
 
@@ -144,10 +161,9 @@ struct floor_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = floor(x);
-		force_to_reg(r);
+		return floor(x);
 	}
 };
 
@@ -162,10 +178,9 @@ struct ceil_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = ceil(x);
-		force_to_reg(r);
+		return ceil(x);
 	}
 };
 
@@ -180,10 +195,9 @@ struct floor2_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = floor_sse2(x.impl);
-		force_to_reg(r);
+		return floor_sse2(x.impl);
 	}
 };
 
@@ -198,10 +212,9 @@ struct ceil2_op
 	static unsigned folds() { return 1; }
 
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = ceil_sse2(x.impl);
-		force_to_reg(r);
+		return ceil_sse2(x.impl);
 	}
 };
 
@@ -219,6 +232,8 @@ LSIMD_ALIGN(256) f64 bd[arr_len];
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
 	std::printf("Benchmarks on f32\n");
 	std::printf("============================\n");
 
@@ -0,0 +1,197 @@
+/**
+ * @file bench_sse_blas.cpp
+ *
+ * Benchmark of matrix-vector routines (gemv, ger) on large matrices
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct blas_data
+{
+	int m;
+	int n;
+	T *a;
+	T *x;
+	T *y;
+
+	blas_data(int m_, int n_) : m(m_), n(n_)
+	{
+		a = new T[m * n];
+		x = new T[m > n ? m : n];
+		y = new T[m > n ? m : n];
+
+		fill_rand(m * n, a, T(-1), T(1));
+		fill_rand(m > n ? m : n, x, T(-1), T(1));
+		clear_zeros(m > n ? m : n, y);
+	}
+
+	~blas_data()
+	{
+		delete[] a;
+		delete[] x;
+		delete[] y;
+	}
+};
+
+
+template<typename T>
+struct gemv_scalar
+{
+	const blas_data<T>& d;
+	gemv_scalar(const blas_data<T>& d_) : d(d_) { }
+
+	void run()
+	{
+		const int m = d.m;
+		const int n = d.n;
+
+		for (int i = 0; i < m; ++i) d.y[i] = T(0);
+
+		for (int j = 0; j < n; ++j)
+		{
+			const T *aj = d.a + j * m;
+			const T xj = d.x[j];
+			for (int i = 0; i < m; ++i) d.y[i] += aj[i] * xj;
+		}
+	}
+};
+
+template<typename T>
+struct gemv_simd
+{
+	const blas_data<T>& d;
+	gemv_simd(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { gemv(d.m, d.n, T(1), d.a, d.m, d.x, T(0), d.y); }
+};
+
+template<typename T>
+struct gemv_simd_mt
+{
+	const blas_data<T>& d;
+	gemv_simd_mt(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { gemv_mt(d.m, d.n, T(1), d.a, d.m, d.x, T(0), d.y); }
+};
+
+template<typename T>
+struct gemv_t_simd
+{
+	const blas_data<T>& d;
+	gemv_t_simd(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { gemv_t(d.m, d.n, T(1), d.a, d.m, d.x, T(0), d.y); }
+};
+
+template<typename T>
+struct gemv_t_simd_mt
+{
+	const blas_data<T>& d;
+	gemv_t_simd_mt(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { gemv_t_mt(d.m, d.n, T(1), d.a, d.m, d.x, T(0), d.y); }
+};
+
+template<typename T>
+struct ger_simd
+{
+	const blas_data<T>& d;
+	ger_simd(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { ger(d.m, d.n, T(1.0e-6), d.x, d.y, d.a, d.m); }
+};
+
+template<typename T>
+struct ger_simd_mt
+{
+	const blas_data<T>& d;
+	ger_simd_mt(const blas_data<T>& d_) : d(d_) { }
+
+	void run() { ger_mt(d.m, d.n, T(1.0e-6), d.x, d.y, d.a, d.m); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline void bench_op(const char *name, const blas_data<T>& d, unsigned repeat_times)
+{
+	Op<T> op(d);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	double ne = double(d.m) * double(d.n);
+	double cpe = r.median / ne;
+
+	std::printf("\t\t%-10s: %.3f cycles / entry", name, cpe);
+	print_perf(r, ne, "entry");
+
+	char cfg[32];
+	std::sprintf(cfg, "%dx%d", d.m, d.n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "entry", ne, r);
+}
+
+template<typename T>
+void bench_size(int m, unsigned repeat_times)
+{
+	blas_data<T> d(m, m);
+
+	std::printf("\tf%d %d x %d:\n", (int)(sizeof(T) * 8), m, m);
+
+	bench_op<T, gemv_scalar>   ("scalar", d, repeat_times);
+	bench_op<T, gemv_simd>     ("gemv", d, repeat_times);
+	bench_op<T, gemv_simd_mt>  ("gemv_mt", d, repeat_times);
+	bench_op<T, gemv_t_simd>   ("gemv_t", d, repeat_times);
+	bench_op<T, gemv_t_simd_mt>("gemv_t_mt", d, repeat_times);
+	bench_op<T, ger_simd>      ("ger", d, repeat_times);
+	bench_op<T, ger_simd_mt>   ("ger_mt", d, repeat_times);
+}
+
+template<typename T>
+void bench_all()
+{
+	bench_size<T>(64, 20000);
+	bench_size<T>(256, 2000);
+	bench_size<T>(1024, 100);
+	bench_size<T>(4096, 5);
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+#ifdef LSIMD_HAS_OPENMP
+	std::printf("[OpenMP enabled]\n\n");
+#else
+	std::printf("[OpenMP disabled]\n\n");
+#endif
+
+	std::printf("Benchmarks on matrix-vector routines (cycles per matrix entry)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>();
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>();
+	std::printf("\n");
+}
+
@@ -0,0 +1,152 @@
+/**
+ * @file bench_sse_conv.cpp
+ *
+ * Benchmark of FIR filters against scalar loops
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct fir_data
+{
+	int n;
+	int k;
+	T *x;
+	T *h;
+	T *y;
+
+	fir_data(int n_, int k_) : n(n_), k(k_)
+	{
+		x = new T[n + k - 1];
+		h = new T[k];
+		y = new T[n];
+
+		fill_rand(n + k - 1, x, T(-1), T(1));
+		fill_rand(k, h, T(-1), T(1));
+		clear_zeros(n, y);
+	}
+
+	~fir_data()
+	{
+		delete[] x;
+		delete[] h;
+		delete[] y;
+	}
+};
+
+
+template<typename T>
+struct fir_scalar
+{
+	const fir_data<T>& d;
+	fir_scalar(const fir_data<T>& d_) : d(d_) { }
+
+	void run()
+	{
+		const int k = d.k;
+		for (int i = 0; i < d.n; ++i)
+		{
+			T s(0);
+			for (int j = 0; j < k; ++j) s += d.h[j] * d.x[i + k - 1 - j];
+			d.y[i] = s;
+		}
+	}
+};
+
+template<typename T>
+struct fir_simd
+{
+	const fir_data<T>& d;
+	fir_simd(const fir_data<T>& d_) : d(d_) { }
+
+	void run() { fir(d.n, d.x, d.h, d.k, d.y); }
+};
+
+template<typename T>
+struct conv_same_simd
+{
+	const fir_data<T>& d;
+	conv_same_simd(const fir_data<T>& d_) : d(d_) { }
+
+	void run() { conv1d(d.n, d.x, d.h, d.k, d.y, conv_same_t()); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, const fir_data<T>& d, unsigned repeat_times, double base)
+{
+	Op<T> op(d);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = r.median / d.n;
+
+	std::printf("\t\t%-10s: %.3f cycles / output", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(r, d.n, "output");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d,k=%d", d.n, d.k);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "output", d.n, r);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_taps(int n, int k)
+{
+	fir_data<T> d(n, k);
+	const unsigned repeat_times = (unsigned)(1 << 24) / (unsigned)(n * k) + 5;
+
+	std::printf("\tf%d k = %d:\n", (int)(sizeof(T) * 8), k);
+
+	double base = bench_op<T, fir_scalar>("scalar", d, repeat_times, 0);
+	bench_op<T, fir_simd>      ("fir", d, repeat_times, base);
+	bench_op<T, conv_same_simd>("conv_same", d, repeat_times, base);
+}
+
+template<typename T>
+void bench_all()
+{
+	const int n = 8192;
+
+	bench_taps<T>(n, 3);
+	bench_taps<T>(n, 5);
+	bench_taps<T>(n, 7);
+	bench_taps<T>(n, 16);
+	bench_taps<T>(n, 63);
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on FIR filters (cycles per output, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>();
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>();
+	std::printf("\n");
+}
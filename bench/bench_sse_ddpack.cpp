@@ -0,0 +1,230 @@
+/**
+ * @file bench_sse_ddpack.cpp
+ *
+ * Benchmark of double-double sums and dot products
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+// the results are kept, so that the loops are not optimized away
+
+struct ldouble_dot
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	ldouble_dot(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run()
+	{
+		long double s = 0;
+		for (int i = 0; i < n; ++i) s += (long double)x[i] * (long double)y[i];
+		r = f64(s);
+	}
+};
+
+// the double-double dot product entry by entry (with FMA when available,
+// as the compiler may otherwise contract Dekker's product)
+
+struct scalar_dd_dot
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	scalar_dd_dot(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	static void two_sum(f64 a, f64 b, f64& s, f64& e)
+	{
+		s = a + b;
+		const f64 z = s - a;
+		e = (a - (s - z)) + (b - z);
+	}
+
+	static void two_prod(f64 a, f64 b, f64& p, f64& e)
+	{
+		p = a * b;
+#ifdef LSIMD_HAS_FMA
+		e = _mm_cvtsd_f64(_mm_fmsub_sd(_mm_set_sd(a), _mm_set_sd(b), _mm_set_sd(p)));
+#else
+		const f64 ca = 134217729.0 * a, ah = ca - (ca - a), al = a - ah;
+		const f64 cb = 134217729.0 * b, bh = cb - (cb - b), bl = b - bh;
+		e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+	}
+
+	void run()
+	{
+		f64 sh = 0, sl = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			f64 p, e, s, t, u, v;
+			two_prod(x[i], y[i], p, e);
+			two_sum(sh, p, s, t);
+			two_sum(sl, e, u, v);
+			t += u;
+			sh = s + t; t = t - (sh - s);
+			t += v;
+			s = sh + t; sl = t - (s - sh); sh = s;
+		}
+		r = sh;
+	}
+};
+
+struct plain_dot
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	plain_dot(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dot(n, x, y); }
+};
+
+struct comp_dot
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	comp_dot(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dot(n, x, y, compensated_t()); }
+};
+
+struct simd_dd_dot
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	simd_dd_dot(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dd_dot(n, x, y); }
+};
+
+struct comp_sum
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	comp_sum(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = sum(n, x, compensated_t()); }
+};
+
+struct simd_dd_sum
+{
+	int n;
+	const f64 *x, *y;
+	f64 r;
+	simd_dd_sum(int n_, const f64 *x_, const f64 *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dd_sum(n, x); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+// reports the cost, and the relative error against the exact result
+
+template<class Op>
+inline double bench_op(const char *name, int n, const f64 *x, const f64 *y, f64 ref,
+		unsigned repeat_times, double base)
+{
+	Op op(n, x, y);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	op.run();
+	const double err = std::fabs(op.r - ref) / std::fabs(ref);
+
+	std::printf("\t%-16s: %.3f cycles / value, rel.err = %.2e", name, cpe, err);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", n);
+	record_bench<f64>(name, cfg, simd<f64, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+// ill-conditioned inputs: the products of the second half cancel those
+// of the first half exactly, apart from the small integers at every 16-th
+// entry, whose sum is the exact result
+
+void bench_all(int n)
+{
+	f64 *x = new f64[n];
+	f64 *y = new f64[n];
+
+	const int h = n / 2;
+	f64 ref = 0;
+
+	for (int i = 0; i < h; ++i)
+	{
+		if (i % 16 == 0)
+		{
+			x[i] = x[h + i] = f64(std::rand() % 7 + 1);
+			y[i] = y[h + i] = 1.0;
+			ref += 2 * x[i];
+		}
+		else
+		{
+			x[i] = x[h + i] = std::ldexp(f64(std::rand()) / f64(RAND_MAX), 30);
+			y[i] = f64(std::rand()) / f64(RAND_MAX) - 0.5;
+			y[h + i] = -y[i];
+		}
+	}
+
+	const unsigned repeat_times = (unsigned)(20000000.0 / n) + 1;
+
+	std::printf("  n = %d:\n", n);
+	double b0 = bench_op<scalar_dd_dot>("scalar dd", n, x, y, ref, repeat_times, 0);
+	bench_op<ldouble_dot>("long double", n, x, y, ref, repeat_times, b0);
+	bench_op<plain_dot>("dot", n, x, y, ref, repeat_times, b0);
+	bench_op<comp_dot>("dot (comp)", n, x, y, ref, repeat_times, b0);
+	bench_op<simd_dd_dot>("dd_dot", n, x, y, ref, repeat_times, b0);
+
+	// the sums of the products, as inputs
+
+	for (int i = 0; i < n; ++i) x[i] *= y[i];
+	bench_op<comp_sum>("sum (comp)", n, x, y, ref, repeat_times, 0);
+	bench_op<simd_dd_sum>("dd_sum", n, x, y, ref, repeat_times, 0);
+
+	delete[] y;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on double-double reductions (cycles per value, speedup over scalar double-double)\n");
+	std::printf("================================\n");
+
+	bench_all(4096);
+	bench_all(1 << 20);
+	std::printf("\n");
+}
@@ -0,0 +1,214 @@
+/**
+ * @file bench_sse_dist.cpp
+ *
+ * Benchmark of pairwise distances against scalar implementations
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+struct dist_args
+{
+	int m, n, d;
+};
+
+template<typename T>
+struct scalar_sqeuclidean
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	scalar_sqeuclidean(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run()
+	{
+		for (int i = 0; i < s.m; ++i)
+		{
+			const T *xi = x + i * s.d;
+			for (int j = 0; j < s.n; ++j)
+			{
+				const T *yj = y + j * s.d;
+				T v(0);
+				for (int k = 0; k < s.d; ++k) v += (xi[k] - yj[k]) * (xi[k] - yj[k]);
+				r[i * s.n + j] = v;
+			}
+		}
+	}
+};
+
+template<typename T>
+struct simd_sqeuclidean
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	simd_sqeuclidean(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run() { cdist(s.m, s.n, s.d, x, s.d, y, s.d, ny, r, s.n, dist_sqeuclidean_t()); }
+};
+
+template<typename T>
+struct simd_sqeuclidean_norms
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	simd_sqeuclidean_norms(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run() { cdist(s.m, s.n, s.d, x, s.d, y, s.d, r, s.n, dist_sqeuclidean_t()); }
+};
+
+template<typename T>
+struct simd_cosine
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	simd_cosine(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run() { cdist(s.m, s.n, s.d, x, s.d, y, s.d, r, s.n, dist_cosine_t()); }
+};
+
+template<typename T>
+struct simd_dot
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	simd_dot(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run() { cdist(s.m, s.n, s.d, x, s.d, y, s.d, ny, r, s.n, dist_dot_t()); }
+};
+
+template<typename T>
+struct simd_pdist
+{
+	dist_args s;
+	const T *x, *y, *ny;
+	T *r;
+	simd_pdist(dist_args s_, const T *x_, const T *y_, const T *ny_, T *r_)
+	: s(s_), x(x_), y(y_), ny(ny_), r(r_) { }
+
+	void run() { pdist(s.m, s.d, x, s.d, r, s.n, dist_sqeuclidean_t()); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, dist_args s, const T *x, const T *y, const T *ny, T *r,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(s, x, y, ny, r);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const int len = s.m * s.n;
+	const double cpe = br.median / len;
+
+	std::printf("\t%-16s: %.3f cycles / pair", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, len, "pair");
+
+	char cfg[48];
+	std::sprintf(cfg, "%dx%d,d=%d", s.m, s.n, s.d);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "pair", len, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int m, int n, int d)
+{
+	dist_args s;
+	s.m = m;
+	s.n = n;
+	s.d = d;
+
+	T *x = new T[m * d];
+	T *y = new T[n * d];
+	T *ny = new T[n];
+	T *r = new T[m * n];
+
+	for (int i = 0; i < m * d; ++i) x[i] = T(std::rand()) / T(RAND_MAX);
+	for (int i = 0; i < n * d; ++i) y[i] = T(std::rand()) / T(RAND_MAX);
+	dist_norms(n, d, y, d, ny, dist_sqeuclidean_t());
+
+	const unsigned repeat_times = (unsigned)(200000000.0 / (double(m) * n * d)) + 1;
+
+	std::printf("  f%d, %d x %d pairs, d = %d:\n", (int)(sizeof(T) * 8), m, n, d);
+	double b0 = bench_op<T, scalar_sqeuclidean>("scalar sqeuclid", s, x, y, ny, r, repeat_times, 0);
+	bench_op<T, simd_sqeuclidean>("sqeuclidean", s, x, y, ny, r, repeat_times, b0);
+	bench_op<T, simd_sqeuclidean_norms>("sqeuclid+norms", s, x, y, ny, r, repeat_times, b0);
+	bench_op<T, simd_cosine>("cosine", s, x, y, ny, r, repeat_times, b0);
+	bench_op<T, simd_dot>("dot", s, x, y, ny, r, repeat_times, b0);
+
+	delete[] r;
+	delete[] ny;
+	delete[] y;
+	delete[] x;
+}
+
+template<typename T>
+void bench_pdist(int m, int d)
+{
+	dist_args s;
+	s.m = m;
+	s.n = m;
+	s.d = d;
+
+	T *x = new T[m * d];
+	T *r = new T[m * m];
+	for (int i = 0; i < m * d; ++i) x[i] = T(std::rand()) / T(RAND_MAX);
+
+	const unsigned repeat_times = (unsigned)(200000000.0 / (double(m) * m * d)) + 1;
+
+	std::printf("  f%d, pdist of %d, d = %d:\n", (int)(sizeof(T) * 8), m, d);
+	double b0 = bench_op<T, scalar_sqeuclidean>("scalar sqeuclid", s, x, x, x, r, repeat_times, 0);
+	bench_op<T, simd_pdist>("pdist", s, x, x, x, r, repeat_times, b0);
+
+	delete[] r;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on pairwise distances (cycles per pair, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(16, 16384, 128);
+	bench_all<f32>(64, 4096, 384);
+	bench_pdist<f32>(512, 128);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(16, 16384, 128);
+	bench_all<f64>(64, 4096, 384);
+	bench_pdist<f64>(512, 128);
+	std::printf("\n");
+}
@@ -0,0 +1,334 @@
+/**
+ * @file bench_sse_expr.cpp
+ *
+ * Benchmark of fused vector expressions against step-by-step evaluation
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+
+using namespace lsimd;
+
+const unsigned arr_len = 512;
+const unsigned step_size = 16;
+const unsigned num_vecs = arr_len / step_size;
+const unsigned warming_times = 10;
+
+LSIMD_ALIGN(128) f32 af[arr_len];
+LSIMD_ALIGN(128) f64 ad[arr_len];
+
+LSIMD_ALIGN(128) f32 bf[arr_len];
+LSIMD_ALIGN(128) f64 bd[arr_len];
+
+template<typename T> struct data_s;
+
+template<> struct data_s<f32>
+{
+	LSIMD_ENSURE_INLINE
+	static const f32 *src() { return af; }
+
+	LSIMD_ENSURE_INLINE
+	static f32 *dst() { return bf; }
+};
+
+template<> struct data_s<f64>
+{
+	LSIMD_ENSURE_INLINE
+	static const f64 *src() { return ad; }
+
+	LSIMD_ENSURE_INLINE
+	static f64 *dst() { return bd; }
+};
+
+
+/********************************************
+ *
+ *  y = A * x + c
+ *
+ ********************************************/
+
+template<typename T, int M, int N>
+struct mv_add_eager
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a(src, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, N, sse_kind> x(src + i * step_size, aligned_t());
+			simd_vec<T, M, sse_kind> c(dst + i * step_size, aligned_t());
+
+			simd_vec<T, M, sse_kind> t = a * x;
+			(t + c).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+template<typename T, int M, int N>
+struct mv_add_fused
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a(src, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, N, sse_kind> x(src + i * step_size, aligned_t());
+			simd_vec<T, M, sse_kind> c(dst + i * step_size, aligned_t());
+
+			(a * x + c).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+
+/********************************************
+ *
+ *  y = A * x + B * z - c
+ *
+ ********************************************/
+
+template<typename T, int M, int N>
+struct mv2_eager
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a(src, aligned_t());
+		simd_mat<T, M, N, sse_kind> b(src + step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, N, sse_kind> x(src + i * step_size, aligned_t());
+			simd_vec<T, N, sse_kind> z(src + i * step_size + 4, aligned_t());
+			simd_vec<T, M, sse_kind> c(dst + i * step_size, aligned_t());
+
+			simd_vec<T, M, sse_kind> t1 = a * x;
+			simd_vec<T, M, sse_kind> t2 = b * z;
+			simd_vec<T, M, sse_kind> t3 = t1 + t2;
+			(t3 - c).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+template<typename T, int M, int N>
+struct mv2_fused
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a(src, aligned_t());
+		simd_mat<T, M, N, sse_kind> b(src + step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, N, sse_kind> x(src + i * step_size, aligned_t());
+			simd_vec<T, N, sse_kind> z(src + i * step_size + 4, aligned_t());
+			simd_vec<T, M, sse_kind> c(dst + i * step_size, aligned_t());
+
+			(a * x + b * z - c).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+
+/********************************************
+ *
+ *  y = u * s + v * t + w
+ *
+ ********************************************/
+
+template<typename T, int M, int N>
+struct axpby_eager
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_pack<T, sse_kind> s( T(1.5) );
+		simd_pack<T, sse_kind> t( T(-0.5) );
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, M, sse_kind> u(src + i * step_size, aligned_t());
+			simd_vec<T, M, sse_kind> v(src + i * step_size + 4, aligned_t());
+			simd_vec<T, M, sse_kind> w(dst + i * step_size, aligned_t());
+
+			simd_vec<T, M, sse_kind> t1 = u * s;
+			simd_vec<T, M, sse_kind> t2 = v * t;
+			simd_vec<T, M, sse_kind> t3 = t1 + t2;
+			(t3 + w).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+template<typename T, int M, int N>
+struct axpby_fused
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_pack<T, sse_kind> s( T(1.5) );
+		simd_pack<T, sse_kind> t( T(-0.5) );
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_vec<T, M, sse_kind> u(src + i * step_size, aligned_t());
+			simd_vec<T, M, sse_kind> v(src + i * step_size + 4, aligned_t());
+			simd_vec<T, M, sse_kind> w(dst + i * step_size, aligned_t());
+
+			(u * s + v * t + w).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+
+/********************************************
+ *
+ *  y = A * B * C * x
+ *
+ ********************************************/
+
+template<typename T, int M, int N>
+struct chain_eager
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, N, N, sse_kind> b(src + step_size, aligned_t());
+		simd_mat<T, N, N, sse_kind> c(src + 2 * step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_mat<T, M, N, sse_kind> a(src + i * step_size, aligned_t());
+			simd_vec<T, N, sse_kind> x(src + i * step_size + 4, aligned_t());
+
+			simd_mat<T, M, N, sse_kind> ab = a * b;
+			simd_mat<T, M, N, sse_kind> abc = ab * c;
+			(abc * x).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+template<typename T, int M, int N>
+struct chain_fused
+{
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, N, N, sse_kind> b(src + step_size, aligned_t());
+		simd_mat<T, N, N, sse_kind> c(src + 2 * step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_vecs; ++i)
+		{
+			simd_mat<T, M, N, sse_kind> a(src + i * step_size, aligned_t());
+			simd_vec<T, N, sse_kind> x(src + i * step_size + 4, aligned_t());
+
+			(a * b * c * x).store(dst + i * step_size, aligned_t());
+		}
+	}
+};
+
+
+template<typename T, int M, int N,
+	template<typename U, int M_, int N_> class EagerOp,
+	template<typename U, int M_, int N_> class FusedOp>
+inline void bench(const char *name, unsigned repeat_times)
+{
+	EagerOp<T, M, N> op1;
+	FusedOp<T, M, N> op2;
+
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
+	bench_result cs2 = perf_bench(op2, warming_times, repeat_times);
+
+	double cpv1 = cs1.median / double(num_vecs);
+	double cpv2 = cs2.median / double(num_vecs);
+
+	std::printf("\tf%d %d x %d:  eager = %6.2f cycles,  fused = %6.2f cycles ==> gain = %.2fx",
+			(int)(sizeof(T) * 8), M, N, cpv1, cpv2, cpv1 / cpv2);
+	print_perf(cs2, double(num_vecs), "vec");
+
+	const unsigned w = simd<T, sse_kind>::pack_width;
+	char cfg[32];
+	std::sprintf(cfg, "%dx%d eager", M, N);
+	record_bench<T>(name, cfg, w, "vec", double(num_vecs), cs1);
+	std::sprintf(cfg, "%dx%d fused", M, N);
+	record_bench<T>(name, cfg, w, "vec", double(num_vecs), cs2);
+}
+
+
+template<template<typename U, int M, int N> class EagerOp,
+	template<typename U, int M, int N> class FusedOp>
+void do_bench(const char *name)
+{
+	const unsigned int rt_f = 2000000;
+	const unsigned int rt_d = rt_f / 2;
+
+	std::printf("Benchmarks on %s\n", name);
+	std::printf("================================\n");
+
+	bench<f32, 2, 2, EagerOp, FusedOp>(name, rt_f);
+	bench<f32, 3, 3, EagerOp, FusedOp>(name, rt_f);
+	bench<f32, 4, 4, EagerOp, FusedOp>(name, rt_f);
+
+	std::printf("\t-------------------------------------------------------\n");
+
+	bench<f64, 2, 2, EagerOp, FusedOp>(name, rt_d);
+	bench<f64, 3, 3, EagerOp, FusedOp>(name, rt_d);
+	bench<f64, 4, 4, EagerOp, FusedOp>(name, rt_d);
+
+	std::printf("\n");
+}
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4100)
+#endif
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	fill_rand(arr_len, af, 0.f, 1.f);
+	fill_rand(arr_len, ad, 0.0, 1.0);
+
+#ifdef LSIMD_HAS_FMA
+	std::printf("[FMA enabled]\n\n");
+#else
+	std::printf("[FMA disabled]\n\n");
+#endif
+
+	do_bench<mv_add_eager, mv_add_fused>("A * x + c");
+	do_bench<mv2_eager, mv2_fused>("A * x + B * z - c");
+	do_bench<axpby_eager, axpby_fused>("u * s + v * t + w");
+	do_bench<chain_eager, chain_fused>("A * B * C * x");
+}
+
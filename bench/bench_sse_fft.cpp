@@ -0,0 +1,322 @@
+/**
+ * @file bench_sse_fft.cpp
+ *
+ * Benchmark of FFTs against a naive radix-2 implementation
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cmath>
+#include <vector>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Naive radix-2 FFT
+ *
+ ********************************************/
+
+// iterative radix-2 (bit reversal + butterflies) with a
+// precomputed twiddle table, on interleaved (re, im) pairs
+
+template<typename T>
+struct naive_fft
+{
+	int n;
+	std::vector<T> tw;
+
+	explicit naive_fft(int n_) : n(n_), tw((size_t)n_)
+	{
+		const double pi = 3.14159265358979323846;
+		for (int k = 0; k < n / 2; ++k)
+		{
+			tw[2 * k] = T(std::cos(-2.0 * pi * k / n));
+			tw[2 * k + 1] = T(std::sin(-2.0 * pi * k / n));
+		}
+	}
+
+	void run(T *x) const
+	{
+		for (int i = 1, j = 0; i < n; ++i)
+		{
+			int b = n >> 1;
+			for (; j & b; b >>= 1) j ^= b;
+			j ^= b;
+
+			if (i < j)
+			{
+				T tr = x[2 * i], ti = x[2 * i + 1];
+				x[2 * i] = x[2 * j];
+				x[2 * i + 1] = x[2 * j + 1];
+				x[2 * j] = tr;
+				x[2 * j + 1] = ti;
+			}
+		}
+
+		for (int len = 2; len <= n; len <<= 1)
+		{
+			const int h = len / 2;
+			const int ts = n / len;
+
+			for (int i = 0; i < n; i += len)
+			{
+				for (int k = 0; k < h; ++k)
+				{
+					T *a = x + 2 * (i + k);
+					T *b = a + 2 * h;
+					const T wr = tw[2 * k * ts];
+					const T wi = tw[2 * k * ts + 1];
+
+					const T br = b[0] * wr - b[1] * wi;
+					const T bi = b[0] * wi + b[1] * wr;
+
+					b[0] = a[0] - br;
+					b[1] = a[1] - bi;
+					a[0] += br;
+					a[1] += bi;
+				}
+			}
+		}
+	}
+};
+
+
+// the real-input transform of the same algorithm as rfft_plan: the
+// naive radix-2 FFT of size n / 2 on the (even, odd) pairs, followed
+// by the pass that separates the two spectra
+
+template<typename T>
+struct naive_rfft
+{
+	int n;
+	naive_fft<T> f;
+	std::vector<T> tw;
+
+	explicit naive_rfft(int n_) : n(n_), f(n_ / 2), tw((size_t)n_ / 2 + 2)
+	{
+		const double pi = 3.14159265358979323846;
+		for (int k = 0; k <= n / 4; ++k)
+		{
+			tw[2 * k] = T(std::cos(-2.0 * pi * k / n));
+			tw[2 * k + 1] = T(std::sin(-2.0 * pi * k / n));
+		}
+	}
+
+	void run(const T *x, T *z) const
+	{
+		const int m = n / 2;
+		for (int i = 0; i < n; ++i) z[i] = x[i];
+		f.run(z);
+
+		const T z0r = z[0];
+		const T z0i = z[1];
+		z[0] = z0r + z0i;
+		z[1] = T(0);
+		z[2 * m] = z0r - z0i;
+		z[2 * m + 1] = T(0);
+
+		const T half(0.5);
+		for (int k = 1; k <= m / 2; ++k)
+		{
+			T *a = z + 2 * k;
+			T *b = z + 2 * (m - k);
+			const T wr = tw[2 * k];
+			const T wi = tw[2 * k + 1];
+
+			const T er = half * (a[0] + b[0]);
+			const T ei = half * (a[1] - b[1]);
+			const T orr = half * (a[1] + b[1]);
+			const T oi = half * (b[0] - a[0]);
+
+			const T tr = wr * orr - wi * oi;
+			const T ti = wr * oi + wi * orr;
+
+			a[0] = er + tr;
+			a[1] = ei + ti;
+			b[0] = er - tr;
+			b[1] = ti - ei;
+		}
+	}
+};
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct fft_data
+{
+	int n;
+	std::complex<T> *x;
+	std::complex<T> *y;
+	T *r;
+
+	explicit fft_data(int n_) : n(n_)
+	{
+		x = new std::complex<T>[n];
+		y = new std::complex<T>[n];
+		r = new T[n];
+
+		T *xs = reinterpret_cast<T*>(x);
+		fill_rand(2 * n, xs, T(-1), T(1));
+		fill_rand(n, r, T(-1), T(1));
+	}
+
+	~fft_data()
+	{
+		delete[] x;
+		delete[] y;
+		delete[] r;
+	}
+};
+
+
+template<typename T>
+struct fft_naive_op
+{
+	fft_data<T>& d;
+	naive_fft<T> f;
+	fft_naive_op(fft_data<T>& d_) : d(d_), f(d_.n) { }
+
+	void run()
+	{
+		for (int i = 0; i < d.n; ++i) d.y[i] = d.x[i];
+		f.run(reinterpret_cast<T*>(d.y));
+	}
+};
+
+template<typename T>
+struct rfft_naive_op
+{
+	fft_data<T>& d;
+	naive_rfft<T> f;
+	rfft_naive_op(fft_data<T>& d_) : d(d_), f(d_.n) { }
+
+	void run() { f.run(d.r, reinterpret_cast<T*>(d.y)); }
+};
+
+template<typename T>
+struct fft_op
+{
+	fft_data<T>& d;
+	const fft_plan<T>& p;
+	fft_op(fft_data<T>& d_) : d(d_), p(fft_plan<T>::cached(d_.n)) { }
+
+	void run() { p.forward(d.x, d.y); }
+};
+
+template<typename T>
+struct fft_inplace_op
+{
+	fft_data<T>& d;
+	const fft_plan<T>& p;
+	fft_inplace_op(fft_data<T>& d_) : d(d_), p(fft_plan<T>::cached(d_.n)) { }
+
+	void run()
+	{
+		for (int i = 0; i < d.n; ++i) d.y[i] = d.x[i];
+		p.forward(d.y, d.y);
+	}
+};
+
+template<typename T>
+struct ifft_op
+{
+	fft_data<T>& d;
+	const fft_plan<T>& p;
+	ifft_op(fft_data<T>& d_) : d(d_), p(fft_plan<T>::cached(d_.n)) { }
+
+	void run() { p.backward(d.x, d.y); }
+};
+
+template<typename T>
+struct rfft_op
+{
+	fft_data<T>& d;
+	const rfft_plan<T>& p;
+	rfft_op(fft_data<T>& d_) : d(d_), p(rfft_plan<T>::cached(d_.n)) { }
+
+	void run() { p.forward(d.r, d.y); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, fft_data<T>& d, unsigned repeat_times, double base)
+{
+	Op<T> op(d);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	std::printf("\t\t%-10s: %12.0f cycles", name, r.median);
+	if (base > 0) std::printf("  (%5.2fx)", base / r.median);
+	print_perf(r, 1.0, "transform");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", d.n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "transform", 1.0, r);
+
+	return r.median;
+}
+
+template<typename T>
+void bench_size(int n)
+{
+	fft_data<T> d(n);
+
+	int e = 0;
+	while ((1 << e) < n) ++e;
+
+	// about 2^26 butterfly entries per measurement
+	unsigned repeat_times = (unsigned)((1 << 26) / (n * e));
+	if (repeat_times < 5) repeat_times = 5;
+
+	std::printf("\tf%d n = %d:\n", (int)(sizeof(T) * 8), n);
+
+	double base = bench_op<T, fft_naive_op>("naive", d, repeat_times, 0);
+	bench_op<T, fft_op>        ("fft", d, repeat_times, base);
+	bench_op<T, fft_inplace_op>("fft_ip", d, repeat_times, base);
+	bench_op<T, ifft_op>       ("ifft", d, repeat_times, base);
+
+	// the real transforms, against the naive one of the same size
+
+	double rbase = bench_op<T, rfft_naive_op>("naive_real", d, repeat_times, 0);
+	bench_op<T, rfft_op>       ("rfft", d, repeat_times, rbase);
+}
+
+template<typename T>
+void bench_all()
+{
+	for (int n = 16; n <= (1 << 16); n *= 4)
+	{
+		bench_size<T>(n);
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on FFTs (cycles per transform, speedup over naive radix-2)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>();
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>();
+	std::printf("\n");
+}
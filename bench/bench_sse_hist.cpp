@@ -0,0 +1,146 @@
+/**
+ * @file bench_sse_hist.cpp
+ *
+ * Benchmark of histograms against a scalar loop
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct scalar_hist
+{
+	int n, nbins;
+	const T *x;
+	int *c;
+	scalar_hist(int n_, int nbins_, const T *x_, int *c_)
+	: n(n_), nbins(nbins_), x(x_), c(c_) { }
+
+	void run()
+	{
+		const T lo(0), hi(1);
+		const T s = T(nbins) / (hi - lo);
+		const T tm = T(nbins - 1);
+
+		for (int i = 0; i < n; ++i)
+		{
+			const T v = x[i];
+			if (v >= lo && v <= hi)
+			{
+				const T t = (v - lo) * s;
+				++ c[(int)(t < tm ? t : tm)];
+			}
+		}
+	}
+};
+
+template<typename T>
+struct simd_hist
+{
+	int n, nbins;
+	const T *x;
+	int *c;
+	simd_hist(int n_, int nbins_, const T *x_, int *c_)
+	: n(n_), nbins(nbins_), x(x_), c(c_) { }
+
+	void run() { histogram(n, x, T(0), T(1), nbins, c); }
+};
+
+template<typename T>
+struct simd_hist_mt
+{
+	int n, nbins;
+	const T *x;
+	int *c;
+	simd_hist_mt(int n_, int nbins_, const T *x_, int *c_)
+	: n(n_), nbins(nbins_), x(x_), c(c_) { }
+
+	void run() { histogram_mt(n, x, T(0), T(1), nbins, c); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, const char *dist, int n, int nbins, const T *x, int *c,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(n, nbins, x, c);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[48];
+	std::sprintf(cfg, "n=%d,nbins=%d,%s", n, nbins, dist);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+// uniform values over [0, 1], or values concentrated in a few bins
+
+template<typename T>
+void bench_all(int n, int nbins, bool skewed)
+{
+	T *x = new T[n];
+	int *c = new int[nbins];
+
+	for (int i = 0; i < n; ++i)
+	{
+		const T u = T(std::rand()) / T(RAND_MAX);
+		x[i] = skewed ? T(0.5) + u * T(0.01) : u;
+	}
+	for (int j = 0; j < nbins; ++j) c[j] = 0;
+
+	const unsigned repeat_times = (unsigned)(100000000.0 / n) + 1;
+	const char *dist = skewed ? "skewed" : "uniform";
+
+	std::printf("  f%d, n = %d, nbins = %d, %s:\n", (int)(sizeof(T) * 8), n, nbins, dist);
+	double b0 = bench_op<T, scalar_hist>("scalar", dist, n, nbins, x, c, repeat_times, 0);
+	bench_op<T, simd_hist>("histogram", dist, n, nbins, x, c, repeat_times, b0);
+	bench_op<T, simd_hist_mt>("histogram_mt", dist, n, nbins, x, c, repeat_times, b0);
+
+	delete[] c;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on histograms (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(1 << 20, 64, false);
+	bench_all<f32>(1 << 20, 64, true);
+	bench_all<f32>(1 << 20, 100000, false);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(1 << 20, 64, false);
+	bench_all<f64>(1 << 20, 64, true);
+	bench_all<f64>(1 << 20, 100000, false);
+	std::printf("\n");
+}
@@ -0,0 +1,161 @@
+/**
+ * @file bench_sse_kmeans.cpp
+ *
+ * Benchmark of the k-means steps against scalar implementations
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+struct kmeans_args
+{
+	int n, d, k;
+};
+
+template<typename T>
+struct scalar_assign
+{
+	kmeans_args s;
+	const T *x;
+	T *c;
+	int *labels;
+	T *dists;
+	scalar_assign(kmeans_args s_, const T *x_, T *c_, int *labels_, T *dists_)
+	: s(s_), x(x_), c(c_), labels(labels_), dists(dists_) { }
+
+	void run()
+	{
+		for (int i = 0; i < s.n; ++i)
+		{
+			const T *xi = x + i * s.d;
+			int l = 0;
+			T mv(0);
+			for (int j = 0; j < s.k; ++j)
+			{
+				const T *cj = c + j * s.d;
+				T v(0);
+				for (int t = 0; t < s.d; ++t) v += (xi[t] - cj[t]) * (xi[t] - cj[t]);
+				if (j == 0 || v < mv) { mv = v; l = j; }
+			}
+			labels[i] = l;
+			dists[i] = mv;
+		}
+	}
+};
+
+template<typename T>
+struct simd_assign
+{
+	kmeans_args s;
+	const T *x;
+	T *c;
+	int *labels;
+	T *dists;
+	simd_assign(kmeans_args s_, const T *x_, T *c_, int *labels_, T *dists_)
+	: s(s_), x(x_), c(c_), labels(labels_), dists(dists_) { }
+
+	void run() { kmeans_assign(s.n, s.d, x, s.d, s.k, c, s.d, labels, dists); }
+};
+
+template<typename T>
+struct simd_update
+{
+	kmeans_args s;
+	const T *x;
+	T *c;
+	int *labels;
+	T *dists;
+	simd_update(kmeans_args s_, const T *x_, T *c_, int *labels_, T *dists_)
+	: s(s_), x(x_), c(c_), labels(labels_), dists(dists_) { }
+
+	// the counts are written to the (unused) distances
+
+	void run() { kmeans_update(s.n, s.d, x, s.d, labels, s.k, c, s.d, (int*)dists); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, kmeans_args s, const T *x, T *c, int *labels, T *dists,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(s, x, c, labels, dists);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / s.n;
+
+	std::printf("\t%-16s: %.3f cycles / point", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, s.n, "point");
+
+	char cfg[48];
+	std::sprintf(cfg, "n=%d,d=%d,k=%d", s.n, s.d, s.k);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "point", s.n, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int n, int d, int k)
+{
+	kmeans_args s;
+	s.n = n;
+	s.d = d;
+	s.k = k;
+
+	T *x = new T[n * d];
+	T *c = new T[k * d];
+	int *labels = new int[n];
+	T *dists = new T[n > k ? n : k];
+
+	for (int i = 0; i < n * d; ++i) x[i] = T(std::rand()) / T(RAND_MAX);
+	for (int i = 0; i < k * d; ++i) c[i] = T(std::rand()) / T(RAND_MAX);
+
+	const unsigned repeat_times = (unsigned)(200000000.0 / (double(n) * k * d)) + 1;
+
+	std::printf("  f%d, n = %d, d = %d, k = %d:\n", (int)(sizeof(T) * 8), n, d, k);
+	double b0 = bench_op<T, scalar_assign>("scalar assign", s, x, c, labels, dists, repeat_times, 0);
+	bench_op<T, simd_assign>("kmeans_assign", s, x, c, labels, dists, repeat_times, b0);
+	bench_op<T, simd_update>("kmeans_update", s, x, c, labels, dists, repeat_times, 0);
+
+	delete[] dists;
+	delete[] labels;
+	delete[] c;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on k-means steps (cycles per point, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(65536, 64, 16);
+	bench_all<f32>(16384, 64, 256);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(65536, 64, 16);
+	bench_all<f64>(16384, 64, 256);
+	std::printf("\n");
+}
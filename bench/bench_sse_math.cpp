@@ -3,26 +3,123 @@
  *
  * Benchmarking of SSE math functions
  *
+ * The functions are provided by the active backend (Intel SVML,
+ * AMD LibM, or the native fallback), and each of them is compared
+ * with the scalar function of the C library on the same inputs.
+ *
  * @author Dahua Lin
  */
 
 
 #include "bench_aux.h"
+#include <math.h>
 
 using namespace lsimd;
 
 const unsigned arr_len = 64;
 const unsigned warming_times = 10;
 
-inline void report_bench(const char *name, unsigned rtimes, uint64_t cycles,
-		unsigned pack_w, int nops)
+
+/********************************************
+ *
+ *  Scalar C library functions
+ *
+ ********************************************/
+
+namespace libm
+{
+
+#define LSIMD_BENCH_LIBM1(name) \
+	inline f32 name(f32 x) { return ::name##f(x); } \
+	inline f64 name(f64 x) { return ::name(x); }
+
+#define LSIMD_BENCH_LIBM2(name) \
+	inline f32 name(f32 x, f32 y) { return ::name##f(x, y); } \
+	inline f64 name(f64 x, f64 y) { return ::name(x, y); }
+
+	LSIMD_BENCH_LIBM2(pow)
+	LSIMD_BENCH_LIBM1(cbrt)
+	LSIMD_BENCH_LIBM2(hypot)
+
+	LSIMD_BENCH_LIBM1(exp)
+	LSIMD_BENCH_LIBM1(exp2)
+	LSIMD_BENCH_LIBM1(log)
+	LSIMD_BENCH_LIBM1(log2)
+	LSIMD_BENCH_LIBM1(log10)
+	LSIMD_BENCH_LIBM1(expm1)
+	LSIMD_BENCH_LIBM1(log1p)
+
+	LSIMD_BENCH_LIBM1(sin)
+	LSIMD_BENCH_LIBM1(cos)
+	LSIMD_BENCH_LIBM1(tan)
+	LSIMD_BENCH_LIBM1(asin)
+	LSIMD_BENCH_LIBM1(acos)
+	LSIMD_BENCH_LIBM1(atan)
+	LSIMD_BENCH_LIBM2(atan2)
+
+	LSIMD_BENCH_LIBM1(sinh)
+	LSIMD_BENCH_LIBM1(cosh)
+	LSIMD_BENCH_LIBM1(tanh)
+	LSIMD_BENCH_LIBM1(asinh)
+	LSIMD_BENCH_LIBM1(acosh)
+	LSIMD_BENCH_LIBM1(atanh)
+
+	LSIMD_BENCH_LIBM1(erf)
+	LSIMD_BENCH_LIBM1(erfc)
+
+#undef LSIMD_BENCH_LIBM1
+#undef LSIMD_BENCH_LIBM2
+
+	// exp10 is not part of C99
+
+	inline f32 exp10(f32 x) { return ::powf(10.f, x); }
+	inline f64 exp10(f64 x) { return ::pow(10.0, x); }
+}
+
+inline const char *math_backend_name()
+{
+#if defined(LSIMD_USE_INTEL_SVML)
+	return "Intel SVML";
+#elif defined(LSIMD_USE_AMD_LIBM)
+	return "AMD LibM";
+#else
+	return "native (C library per element)";
+#endif
+}
+
+
+/********************************************
+ *
+ *  Bench routines
+ *
+ ********************************************/
+
+inline double cycles_per_op(unsigned rtimes, const bench_result& r)
+{
+	return r.median / (double(rtimes / r.repeat_times) * double(arr_len));
+}
+
+inline void report_bench(const char *name, unsigned rtimes, const bench_result& r,
+		const bench_result& rl, const bench_result& rs, double overhead, unsigned pack_w, int nops)
 {
-	double cpo_f = double(cycles) / (double(rtimes) * double(arr_len));
+	double cpo_f = cycles_per_op(rtimes, r);
 
 	int cpoi = int(cpo_f);
 	cpoi = (cpoi - nops);  // re-calibrated
 
-	std::printf("\t%-5s :   %4d cycles / %u op\n", name, cpoi, pack_w);
+	double lat = cycles_per_op(rtimes, rl) - overhead;
+	double cpo_s = cycles_per_op(rtimes, rs);
+
+	std::printf("\t%-5s :   %4d cycles / %u op,  latency = %5.1f cycles,  libm = %5d cycles,  speedup = %5.2fx",
+			name, cpoi, pack_w, lat, int(cpo_s), cpo_s / cpo_f);
+	print_perf(r, double(arr_len) * double(pack_w), "elem");
+}
+
+template<typename T>
+inline double lat_overhead(const T *pa)
+{
+	static const double v = chain_overhead<T, arr_len>(pa);
+	return v;
 }
 
 
@@ -32,12 +129,28 @@ inline void bench(unsigned repeat_times, T *pa)
 	const T lb = OpT<T>::lbound();
 	const T ub = OpT<T>::ubound();
 
-	fill_rand(arr_len, pa, lb, ub);
+	const unsigned w = simd<T, sse_kind>::pack_width;
+
+	fill_rand(arr_len * w, pa, lb, ub);
+
+	wrap_op<T, sse_kind, eval_op<OpT<T> >, arr_len> op1(pa);
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
+
+	wrap_lat_op<T, sse_kind, OpT<T>, arr_len> op2(pa);
+	bench_result cs2 = perf_bench(op2, warming_times, repeat_times);
+
+	wrap_scalar_op<T, OpT<T>, arr_len> op3(pa);
+	bench_result cs3 = perf_bench(op3, warming_times, repeat_times);
+
+	const double ovh = lat_overhead(pa);
 
-	wrap_op<T, sse_kind, OpT<T>, arr_len> op1(pa);
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	report_bench(OpT<T>::name(), repeat_times, cs1, cs2, cs3, ovh, w, 1);
 
-	report_bench(OpT<T>::name(), repeat_times, cs1, simd<T, sse_kind>::pack_width, 1);
+	record_bench<T>(OpT<T>::name(), "", w, "op", double(arr_len), cs1);
+	record_bench<T>(OpT<T>::name(), "libm", w, "op", double(arr_len), cs3);
+
+	subtract_cycles(cs2, ovh * double(arr_len));
+	record_bench<T>(OpT<T>::name(), "latency", w, "op", double(arr_len), cs2);
 }
 
 
@@ -51,11 +164,12 @@ struct pow_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::pow(x, T(2.5)); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = pow(x, simd_pack<T, sse_kind>(2.5));
-		force_to_reg(r);
+		return pow(x, simd_pack<T, sse_kind>(2.5));
 	}
 };
 
@@ -67,11 +181,12 @@ struct cbrt_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::cbrt(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = cbrt(x);
-		force_to_reg(r);
+		return cbrt(x);
 	}
 };
 
@@ -83,11 +198,12 @@ struct hypot_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::hypot(x, T(2)); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = hypot(x, simd_pack<T, sse_kind>(2.0));
-		force_to_reg(r);
+		return hypot(x, simd_pack<T, sse_kind>(2.0));
 	}
 };
 
@@ -100,11 +216,12 @@ struct exp_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::exp(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = exp(x);
-		force_to_reg(r);
+		return exp(x);
 	}
 };
 
@@ -116,11 +233,12 @@ struct exp2_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::exp2(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = exp2(x);
-		force_to_reg(r);
+		return exp2(x);
 	}
 };
 
@@ -132,11 +250,12 @@ struct exp10_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(3); }
 
+	static T scalar(T x) { return libm::exp10(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = exp10(x);
-		force_to_reg(r);
+		return exp10(x);
 	}
 };
 
@@ -148,11 +267,12 @@ struct log_op
 	static T lbound() { return T(1); }
 	static T ubound() { return T(100); }
 
+	static T scalar(T x) { return libm::log(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = log(x);
-		force_to_reg(r);
+		return log(x);
 	}
 };
 
@@ -164,11 +284,12 @@ struct log2_op
 	static T lbound() { return T(1); }
 	static T ubound() { return T(100); }
 
+	static T scalar(T x) { return libm::log2(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = log2(x);
-		force_to_reg(r);
+		return log2(x);
 	}
 };
 
@@ -180,11 +301,12 @@ struct log10_op
 	static T lbound() { return T(1); }
 	static T ubound() { return T(100); }
 
+	static T scalar(T x) { return libm::log10(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = log10(x);
-		force_to_reg(r);
+		return log10(x);
 	}
 };
 
@@ -196,11 +318,12 @@ struct expm1_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(0.1); }
 
+	static T scalar(T x) { return libm::expm1(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = expm1(x);
-		force_to_reg(r);
+		return expm1(x);
 	}
 };
 
@@ -212,11 +335,12 @@ struct log1p_op
 	static T lbound() { return T(0); }
 	static T ubound() { return T(0.1); }
 
+	static T scalar(T x) { return libm::log1p(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = log1p(x);
-		force_to_reg(r);
+		return log1p(x);
 	}
 };
 
@@ -229,11 +353,12 @@ struct sin_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::sin(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = sin(x);
-		force_to_reg(r);
+		return sin(x);
 	}
 };
 
@@ -245,11 +370,12 @@ struct cos_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::cos(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = cos(x);
-		force_to_reg(r);
+		return cos(x);
 	}
 };
 
@@ -261,11 +387,12 @@ struct tan_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::tan(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = tan(x);
-		force_to_reg(r);
+		return tan(x);
 	}
 };
 
@@ -277,11 +404,12 @@ struct asin_op
 	static T lbound() { return T(-1); }
 	static T ubound() { return T(1); }
 
+	static T scalar(T x) { return libm::asin(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = asin(x);
-		force_to_reg(r);
+		return asin(x);
 	}
 };
 
@@ -293,11 +421,12 @@ struct acos_op
 	static T lbound() { return T(-1); }
 	static T ubound() { return T(1); }
 
+	static T scalar(T x) { return libm::acos(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = acos(x);
-		force_to_reg(r);
+		return acos(x);
 	}
 };
 
@@ -309,11 +438,12 @@ struct atan_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::atan(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = atan(x);
-		force_to_reg(r);
+		return atan(x);
 	}
 };
 
@@ -325,11 +455,12 @@ struct atan2_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::atan2(x, T(1)); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = atan2(x, simd_pack<T, sse_kind>::ones());
-		force_to_reg(r);
+		return atan2(x, simd_pack<T, sse_kind>::ones());
 	}
 };
 
@@ -342,11 +473,12 @@ struct sinh_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::sinh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = sinh(x);
-		force_to_reg(r);
+		return sinh(x);
 	}
 };
 
@@ -358,11 +490,12 @@ struct cosh_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::cosh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = cosh(x);
-		force_to_reg(r);
+		return cosh(x);
 	}
 };
 
@@ -374,11 +507,12 @@ struct tanh_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::tanh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = tanh(x);
-		force_to_reg(r);
+		return tanh(x);
 	}
 };
 
@@ -390,11 +524,12 @@ struct asinh_op
 	static T lbound() { return T(-1); }
 	static T ubound() { return T(1); }
 
+	static T scalar(T x) { return libm::asinh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = asinh(x);
-		force_to_reg(r);
+		return asinh(x);
 	}
 };
 
@@ -406,11 +541,12 @@ struct acosh_op
 	static T lbound() { return T(-1); }
 	static T ubound() { return T(1); }
 
+	static T scalar(T x) { return libm::acosh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = acosh(x);
-		force_to_reg(r);
+		return acosh(x);
 	}
 };
 
@@ -422,11 +558,12 @@ struct atanh_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::atanh(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = atanh(x);
-		force_to_reg(r);
+		return atanh(x);
 	}
 };
 
@@ -440,11 +577,12 @@ struct erf_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::erf(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = erf(x);
-		force_to_reg(r);
+		return erf(x);
 	}
 };
 
@@ -456,21 +594,22 @@ struct erfc_op
 	static T lbound() { return T(-10); }
 	static T ubound() { return T(10); }
 
+	static T scalar(T x) { return libm::erfc(x); }
+
 	LSIMD_ENSURE_INLINE
-	static void run(const simd_pack<T, sse_kind>& x)
+	static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x)
 	{
-		simd_pack<T, sse_kind> r = erfc(x);
-		force_to_reg(r);
+		return erfc(x);
 	}
 };
 
 #endif /* LSIMD_HAS_SSE_ERF */
 
 
-LSIMD_ALIGN(256) f32 af[arr_len];
-LSIMD_ALIGN(256) f32 bf[arr_len];
-LSIMD_ALIGN(256) f64 ad[arr_len];
-LSIMD_ALIGN(256) f64 bd[arr_len];
+LSIMD_ALIGN(256) f32 af[arr_len * 4];
+LSIMD_ALIGN(256) f32 bf[arr_len * 4];
+LSIMD_ALIGN(256) f64 ad[arr_len * 2];
+LSIMD_ALIGN(256) f64 bd[arr_len * 2];
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4100)
@@ -478,6 +617,10 @@ LSIMD_ALIGN(256) f64 bd[arr_len];
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
+	std::printf("[math backend: %s]\n\n", math_backend_name());
+
 	std::printf("Benchmarks on f32\n");
 	std::printf("==========================================\n");
 
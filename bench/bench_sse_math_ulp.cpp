@@ -0,0 +1,391 @@
+/**
+ * @file bench_sse_math_ulp.cpp
+ *
+ * Accuracy sweep of SSE math functions
+ *
+ * Usage: bench_sse_math_ulp [--points=<n>] [--max-ulp=<u>]
+ *
+ *   --points=<n>    the number of inputs per function (default 65536)
+ *   --max-ulp=<u>   returns 1 if the max error of any function exceeds u
+ *
+ * Each function of the active backend is evaluated over its input
+ * domain, and compared with the long double function of the C library.
+ * The error is measured in units in the last place (ULP) of the
+ * correctly rounded result. The special inputs (NaN, +/-Inf, +/-0)
+ * are evaluated separately: non-finite results that differ from those
+ * of the C library (any NaN matches NaN) are reported as mismatches,
+ * while finite ones are measured in ULP as the other points.
+ *
+ * @author Dahua Lin
+ */
+
+#include <light_simd/simd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <limits>
+#include <math.h>
+
+using namespace lsimd;
+
+
+/********************************************
+ *
+ *  Functions and domains
+ *
+ *  lbound > 0 means the inputs are sampled
+ *  geometrically, otherwise linearly.
+ *  Binary functions are swept over a grid,
+ *  with y in [ylbound, yubound].
+ *
+ ********************************************/
+
+#define LSIMD_ULP_FUNC1(fname, lb, ub, reffun) \
+	struct fname##_f { \
+		static const char *name() { return #fname; } \
+		static const int arity = 1; \
+		static double lbound() { return lb; } \
+		static double ubound() { return ub; } \
+		static double ylbound() { return 0; } \
+		static double yubound() { return 0; } \
+		template<typename T> \
+		static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x, const simd_pack<T, sse_kind>&) \
+		{ return fname(x); } \
+		static long double ref(long double x, long double) { return reffun; } };
+
+#define LSIMD_ULP_FUNC2(fname, lb, ub, ylb, yub, reffun) \
+	struct fname##_f { \
+		static const char *name() { return #fname; } \
+		static const int arity = 2; \
+		static double lbound() { return lb; } \
+		static double ubound() { return ub; } \
+		static double ylbound() { return ylb; } \
+		static double yubound() { return yub; } \
+		template<typename T> \
+		static simd_pack<T, sse_kind> eval(const simd_pack<T, sse_kind>& x, const simd_pack<T, sse_kind>& y) \
+		{ return fname(x, y); } \
+		static long double ref(long double x, long double y) { return reffun; } };
+
+LSIMD_ULP_FUNC2(pow,   1.0e-2, 1.0e2,   -4.0, 4.0, ::powl(x, y))
+LSIMD_ULP_FUNC1(cbrt,  -1.0e3, 1.0e3,   ::cbrtl(x))
+LSIMD_ULP_FUNC2(hypot, -1.0e3, 1.0e3,   -1.0e3, 1.0e3, ::hypotl(x, y))
+
+LSIMD_ULP_FUNC1(exp,   -80.0, 80.0,     ::expl(x))
+LSIMD_ULP_FUNC1(exp2,  -120.0, 120.0,   ::exp2l(x))
+LSIMD_ULP_FUNC1(exp10, -35.0, 35.0,     ::powl(10.0L, x))
+LSIMD_ULP_FUNC1(log,   1.0e-30, 1.0e30, ::logl(x))
+LSIMD_ULP_FUNC1(log2,  1.0e-30, 1.0e30, ::log2l(x))
+LSIMD_ULP_FUNC1(log10, 1.0e-30, 1.0e30, ::log10l(x))
+LSIMD_ULP_FUNC1(expm1, -10.0, 10.0,     ::expm1l(x))
+LSIMD_ULP_FUNC1(log1p, -0.9, 10.0,      ::log1pl(x))
+
+LSIMD_ULP_FUNC1(sin,   -100.0, 100.0,   ::sinl(x))
+LSIMD_ULP_FUNC1(cos,   -100.0, 100.0,   ::cosl(x))
+LSIMD_ULP_FUNC1(tan,   -100.0, 100.0,   ::tanl(x))
+LSIMD_ULP_FUNC1(asin,  -1.0, 1.0,       ::asinl(x))
+LSIMD_ULP_FUNC1(acos,  -1.0, 1.0,       ::acosl(x))
+LSIMD_ULP_FUNC1(atan,  -1.0e4, 1.0e4,   ::atanl(x))
+LSIMD_ULP_FUNC2(atan2, -10.0, 10.0,     -10.0, 10.0, ::atan2l(x, y))
+
+LSIMD_ULP_FUNC1(sinh,  -80.0, 80.0,     ::sinhl(x))
+LSIMD_ULP_FUNC1(cosh,  -80.0, 80.0,     ::coshl(x))
+LSIMD_ULP_FUNC1(tanh,  -20.0, 20.0,     ::tanhl(x))
+LSIMD_ULP_FUNC1(asinh, -1.0e4, 1.0e4,   ::asinhl(x))
+LSIMD_ULP_FUNC1(acosh, 1.0, 1.0e4,      ::acoshl(x))
+LSIMD_ULP_FUNC1(atanh, -0.999, 0.999,   ::atanhl(x))
+
+#ifdef LSIMD_HAS_SSE_ERF
+LSIMD_ULP_FUNC1(erf,   -6.0, 6.0,       ::erfl(x))
+LSIMD_ULP_FUNC1(erfc,  -6.0, 27.0,      ::erfcl(x))
+#endif
+
+#undef LSIMD_ULP_FUNC1
+#undef LSIMD_ULP_FUNC2
+
+
+/********************************************
+ *
+ *  Error measurement
+ *
+ ********************************************/
+
+template<typename T>
+inline bool is_nan(T x)
+{
+	return x != x;
+}
+
+template<typename T>
+inline bool is_inf(T x)
+{
+	return x == std::numeric_limits<T>::infinity() ||
+			x == -std::numeric_limits<T>::infinity();
+}
+
+/**
+ * The size of one ULP of T at the value v, i.e. the spacing
+ * of the values of T around v (down to the smallest subnormal).
+ */
+template<typename T>
+inline long double ulp_of(long double v)
+{
+	const int d = std::numeric_limits<T>::digits;
+	const int emin = std::numeric_limits<T>::min_exponent;
+
+	int e;
+	::frexpl(v, &e);
+	if (e < emin) e = emin;
+
+	return ::ldexpl(1.0L, e - d);
+}
+
+template<typename T>
+inline T sample_point(double lb, double ub, int i, int n)
+{
+	double t = n > 1 ? double(i) / double(n - 1) : 0.0;
+	double v = lb > 0 ? lb * ::pow(ub / lb, t) : lb + (ub - lb) * t;
+	return T(v);
+}
+
+struct ulp_stats
+{
+	double max_ulp;
+	double max_at_x;
+	double max_at_y;
+	double sum_ulp;
+	long num_points;
+	long num_special_mismatches;
+
+	ulp_stats()
+	: max_ulp(0), max_at_x(0), max_at_y(0), sum_ulp(0)
+	, num_points(0), num_special_mismatches(0)
+	{
+	}
+
+	double mean_ulp() const
+	{
+		return num_points > 0 ? sum_ulp / double(num_points) : 0.0;
+	}
+};
+
+template<typename T>
+inline void add_point(ulp_stats& s, T x, T y, T r, long double ref)
+{
+	T rt = T(ref);   // the correctly rounded result (up to double rounding)
+
+	if (is_nan(rt) || is_inf(rt) || is_nan(r) || is_inf(r))
+	{
+		bool match = is_nan(rt) ? is_nan(r) : (r == rt);
+		if (!match) ++ s.num_special_mismatches;
+		return;
+	}
+
+	long double err = ::fabsl((long double)r - ref) / ulp_of<T>(ref);
+	double e = double(err);
+
+	if (e > s.max_ulp)
+	{
+		s.max_ulp = e;
+		s.max_at_x = double(x);
+		s.max_at_y = double(y);
+	}
+	s.sum_ulp += e;
+	++ s.num_points;
+}
+
+
+template<typename T, class F>
+ulp_stats sweep(int npoints)
+{
+	const unsigned w = simd<T, sse_kind>::pack_width;
+
+	int nx = npoints;
+	int ny = 1;
+	if (F::arity == 2)
+	{
+		ny = int(::sqrt(double(npoints)));
+		if (ny < 1) ny = 1;
+		nx = npoints / ny;
+	}
+	nx = (nx + int(w) - 1) / int(w) * int(w);
+
+	std::vector<T> xs(nx);
+	for (int i = 0; i < nx; ++i)
+		xs[i] = sample_point<T>(F::lbound(), F::ubound(), i, nx);
+
+	LSIMD_ALIGN_SSE T xb[4];
+	LSIMD_ALIGN_SSE T rb[4];
+
+	ulp_stats s;
+
+	for (int j = 0; j < ny; ++j)
+	{
+		T yv = ny > 1 ? sample_point<T>(F::ylbound(), F::yubound(), j, ny) : T(0);
+		simd_pack<T, sse_kind> y(yv);
+
+		for (int i = 0; i < nx; i += int(w))
+		{
+			for (unsigned k = 0; k < w; ++k) xb[k] = xs[i + int(k)];
+
+			simd_pack<T, sse_kind> x(xb, aligned_t());
+			F::template eval<T>(x, y).store(rb, aligned_t());
+
+			for (unsigned k = 0; k < w; ++k)
+			{
+				add_point(s, xb[k], yv, rb[k],
+						F::ref((long double)xb[k], (long double)yv));
+			}
+		}
+	}
+
+	return s;
+}
+
+/**
+ * Evaluates the special inputs, i.e. NaN, +/-Inf and +/-0, as x (with
+ * y = 1 for binary functions), and also as y (with x = 1).
+ */
+template<typename T, class F>
+void sweep_special(ulp_stats& s)
+{
+	const T inf = std::numeric_limits<T>::infinity();
+	const T sv[5] = { std::numeric_limits<T>::quiet_NaN(), inf, -inf, T(0), -T(0) };
+
+	const unsigned w = simd<T, sse_kind>::pack_width;
+	LSIMD_ALIGN_SSE T xb[4];
+	LSIMD_ALIGN_SSE T yb[4];
+	LSIMD_ALIGN_SSE T rb[4];
+
+	const int nr = F::arity == 2 ? 2 : 1;
+	for (int r = 0; r < nr; ++r)
+	{
+		for (int i = 0; i < 5; ++i)
+		{
+			const T xv = r == 0 ? sv[i] : T(1);
+			const T yv = F::arity == 2 ? (r == 0 ? T(1) : sv[i]) : T(0);
+			for (unsigned k = 0; k < w; ++k) { xb[k] = xv; yb[k] = yv; }
+
+			simd_pack<T, sse_kind> x(xb, aligned_t());
+			simd_pack<T, sse_kind> y(yb, aligned_t());
+			F::template eval<T>(x, y).store(rb, aligned_t());
+
+			add_point(s, xv, yv, rb[0], F::ref((long double)xv, (long double)yv));
+		}
+	}
+}
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+static int g_points = 65536;
+static double g_max_ulp = -1.0;
+static bool g_failed = false;
+
+template<typename T, class F>
+void run()
+{
+	ulp_stats s = sweep<T, F>(g_points);
+	sweep_special<T, F>(s);
+
+	char dom[64];
+	if (F::arity == 2)
+		std::sprintf(dom, "[%g, %g] x [%g, %g]", F::lbound(), F::ubound(), F::ylbound(), F::yubound());
+	else
+		std::sprintf(dom, "[%g, %g]", F::lbound(), F::ubound());
+
+	char at[64];
+	if (F::arity == 2)
+		std::sprintf(at, "(%.6g, %.6g)", s.max_at_x, s.max_at_y);
+	else
+		std::sprintf(at, "%.6g", s.max_at_x);
+
+	bool bad = g_max_ulp >= 0 && (s.max_ulp > g_max_ulp || s.num_special_mismatches > 0);
+	if (bad) g_failed = true;
+
+	std::printf("\t%-5s  %-30s  max = %8.3f ulp at %-22s  mean = %6.3f ulp",
+			F::name(), dom, s.max_ulp, at, s.mean_ulp());
+	if (s.num_special_mismatches > 0)
+		std::printf(",  %ld special mismatch(es)", s.num_special_mismatches);
+	std::printf("%s\n", bad ? "  ...  FAILED" : "");
+}
+
+template<typename T>
+void run_all()
+{
+	run<T, pow_f>();
+	run<T, cbrt_f>();
+	run<T, hypot_f>();
+
+	run<T, exp_f>();
+	run<T, exp2_f>();
+	run<T, exp10_f>();
+	run<T, log_f>();
+	run<T, log2_f>();
+	run<T, log10_f>();
+	run<T, expm1_f>();
+	run<T, log1p_f>();
+
+	run<T, sin_f>();
+	run<T, cos_f>();
+	run<T, tan_f>();
+	run<T, asin_f>();
+	run<T, acos_f>();
+	run<T, atan_f>();
+	run<T, atan2_f>();
+
+	run<T, sinh_f>();
+	run<T, cosh_f>();
+	run<T, tanh_f>();
+	run<T, asinh_f>();
+	run<T, acosh_f>();
+	run<T, atanh_f>();
+
+#ifdef LSIMD_HAS_SSE_ERF
+	run<T, erf_f>();
+	run<T, erfc_f>();
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strncmp(argv[i], "--points=", 9) == 0)
+			g_points = std::atoi(argv[i] + 9);
+		else if (std::strncmp(argv[i], "--max-ulp=", 10) == 0)
+			g_max_ulp = std::atof(argv[i] + 10);
+		else
+		{
+			std::fprintf(stderr, "Usage: bench_sse_math_ulp [--points=<n>] [--max-ulp=<u>]\n");
+			return 2;
+		}
+	}
+	if (g_points < 1) g_points = 1;
+
+#if defined(LSIMD_USE_INTEL_SVML)
+	std::printf("[math backend: Intel SVML, %d points]\n\n", g_points);
+#elif defined(LSIMD_USE_AMD_LIBM)
+	std::printf("[math backend: AMD LibM, %d points]\n\n", g_points);
+#else
+	std::printf("[math backend: native (C library per element), %d points]\n\n", g_points);
+#endif
+
+	std::printf("Accuracy on f32\n");
+	std::printf("==========================================\n");
+	run_all<f32>();
+	std::printf("\n");
+
+	std::printf("Accuracy on f64\n");
+	std::printf("==========================================\n");
+	run_all<f64>();
+	std::printf("\n");
+
+	return g_failed ? 1 : 0;
+}
+
@@ -43,28 +43,81 @@ template<> struct data_s<f64>
 };
 
 
-template<typename T, int M, int N, template<typename U, int M_, int N_> class OpT>
-inline void bench(unsigned repeat_times)
+/********************************************
+ *
+ *  Each op runs over num_mats independent
+ *  matrices (throughput). The ops that have
+ *  has_chain also provide run_chain, which
+ *  feeds the result of each op into the next
+ *  (latency).
+ *
+ ********************************************/
+
+template<class Op, bool HasChain> struct chain_bench;
+
+template<class Op>
+struct chain_bench<Op, true>
 {
-	OpT<T, M, N> op1;
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	Op op;
+
+	LSIMD_ENSURE_INLINE
+	void run() { op.run_chain(); }
+
+	static bool measure(unsigned repeat_times, bench_result& r)
+	{
+		r = perf_bench(chain_bench(), warming_times, repeat_times);
+		return true;
+	}
+};
 
-	double cpv = double(cs1) / (double(repeat_times) * double(num_mats));
+template<class Op>
+struct chain_bench<Op, false>
+{
+	static bool measure(unsigned, bench_result&) { return false; }
+};
+
+
+template<typename T, class Op>
+inline void bench_op(int m, int n, unsigned repeat_times)
+{
+	Op op1;
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
+
+	bench_result cs2;
+	bool has_lat = chain_bench<Op, Op::has_chain>::measure(repeat_times, cs2);
+
+	double cpv = cs1.median / double(num_mats);
+
+	std::printf("\tf%d %d x %d:  %6.1f cycles / mat", (int)(sizeof(T) * 8), m, n, cpv);
+	if (has_lat)
+		std::printf(",  latency = %6.1f cycles", cs2.median / double(num_mats));
+	else
+		std::printf(",  latency =    n/a       ");
+	std::printf(" ==> %.1f scalar-op / cycle", op1.scalar_ops() / cpv);
+	print_perf(cs1, double(num_mats), "mat");
+
+	const unsigned w = simd<T, sse_kind>::pack_width;
+	char cfg[32];
+	std::sprintf(cfg, "%dx%d", m, n);
+	record_bench<T>(op1.name(), cfg, w, "mat", double(num_mats), cs1);
+
+	if (has_lat)
+	{
+		std::sprintf(cfg, "%dx%d latency", m, n);
+		record_bench<T>(op1.name(), cfg, w, "mat", double(num_mats), cs2);
+	}
+}
 
-	std::printf("\tf%d %d x %d:  %6.1f cycles / mat ==> %.1f scalar-op / cycle\n",
-			(int)(sizeof(T) * 8), M, N, cpv, op1.scalar_ops() / cpv);
+template<typename T, int M, int N, template<typename U, int M_, int N_> class OpT>
+inline void bench(unsigned repeat_times)
+{
+	bench_op<T, OpT<T, M, N> >(M, N, repeat_times);
 }
 
 template<typename T, int N, template<typename U, int N_> class OpT>
 inline void bench1(unsigned repeat_times)
 {
-	OpT<T, N> op1;
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
-
-	double cpv = double(cs1) / (double(repeat_times) * double(num_mats));
-
-	std::printf("\tf%d %d x %d:  %6.1f cycles / mat ==> %.1f scalar-op / cycle\n",
-			(int)(sizeof(T) * 8), N, N, cpv, op1.scalar_ops() / cpv);
+	bench_op<T, OpT<T, N> >(N, N, repeat_times);
 }
 
 
@@ -76,6 +129,8 @@ struct addcp_op
 
 	int scalar_ops() const { return M * N; }
 
+	static const bool has_chain = true;
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -90,6 +145,23 @@ struct addcp_op
 			(a + b).store(dst + i * step_size, aligned_t());
 		}
 	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> b(src, aligned_t());
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			simd_mat<T, M, N, sse_kind> a(src + i * step_size, aligned_t());
+			b = a + b;
+		}
+
+		b.store(dst, aligned_t());
+	}
 };
 
 
@@ -100,6 +172,8 @@ struct addip_op
 
 	int scalar_ops() const { return M * N; }
 
+	static const bool has_chain = true;
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -116,6 +190,23 @@ struct addip_op
 			a.store(dst + i * step_size, aligned_t());
 		}
 	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> b(src, aligned_t());
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			simd_mat<T, M, N, sse_kind> a(src + i * step_size, aligned_t());
+			b += a;
+		}
+
+		b.store(dst, aligned_t());
+	}
 };
 
 
@@ -127,6 +218,8 @@ struct transcp_op
 
 	int scalar_ops() const { return M * N; }
 
+	static const bool has_chain = false;
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -150,6 +243,8 @@ struct mtimes_op
 
 	int scalar_ops() const { return 2 * M * N; }
 
+	static const bool has_chain = (M == N);
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -167,9 +262,74 @@ struct mtimes_op
 			(a * v).store(dst + i * step_size, aligned_t());
 		}
 	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a;
+		a.load(src, aligned_t());
+
+		simd_vec<T, N, sse_kind> v;
+		v.load(src + step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			v = a * v;
+		}
+
+		v.store(dst, aligned_t());
+	}
 };
 
 
+template<typename T, int M, int N>
+struct mtimes_batch_op
+{
+	const char *name() const { return "mtimes-batch (strided)"; }
+
+	int scalar_ops() const { return 2 * M * N; }
+
+	static const bool has_chain = false;
+
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a;
+		a.load(src, aligned_t());
+
+		batch_transform(a, (int)num_mats, src, (int)step_size, dst, (int)step_size);
+	}
+};
+
+
+template<typename T, int M, int N>
+struct mtimes_batch_packed_op
+{
+	const char *name() const { return "mtimes-batch (packed)"; }
+
+	int scalar_ops() const { return 2 * M * N; }
+
+	static const bool has_chain = false;
+
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, M, N, sse_kind> a;
+		a.load(src, aligned_t());
+
+		batch_transform(a, (int)num_mats, src, dst);
+	}
+};
+
 template<typename T, int N>
 struct inv_op
 {
@@ -180,6 +340,8 @@ struct inv_op
 		return 4 * N * N * N;
 	}
 
+	static const bool has_chain = true;
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -195,6 +357,78 @@ struct inv_op
 			b.store(dst + i * step_size, aligned_t());
 		}
 	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, N, N, sse_kind> a, b;
+		a.load(src, aligned_t());
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			inv_and_det(a, b);
+			a = b;
+		}
+
+		a.store(dst, aligned_t());
+	}
+};
+
+
+/**
+ * The chain of det goes through scaling the next matrix
+ * by d * 0 + 1 (with an opaque zero), so its latency also
+ * includes that of a multiply-add, a broadcast and a scaling.
+ */
+template<typename T, int N>
+struct det_op
+{
+	const char *name() const { return "det"; }
+
+	int scalar_ops() const { return N * N * N; }
+
+	static const bool has_chain = true;
+
+	LSIMD_ENSURE_INLINE
+	void run()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, N, N, sse_kind> a;
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			a.load(src + i * step_size, aligned_t());
+			dst[i * step_size] = det(a);
+		}
+	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		T z(0);
+		make_opaque(z);
+
+		simd_mat<T, N, N, sse_kind> a;
+		a.load(src, aligned_t());
+
+		T d(0);
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			d = det(a);
+			a.load(src + ((i + 1) % num_mats) * step_size, aligned_t());
+			a *= simd_pack<T, sse_kind>(d * z + T(1));
+		}
+
+		dst[0] = d;
+	}
 };
 
 
@@ -205,6 +439,8 @@ struct solve_op
 
 	int scalar_ops() const { return 4 * N * N * N; }
 
+	static const bool has_chain = true;
+
 	LSIMD_ENSURE_INLINE
 	void run()
 	{
@@ -222,6 +458,26 @@ struct solve_op
 			solve(a, v).store(dst + i * step_size, aligned_t());
 		}
 	}
+
+	LSIMD_ENSURE_INLINE
+	void run_chain()
+	{
+		const T *src = data_s<T>::src();
+		T *dst = data_s<T>::dst();
+
+		simd_mat<T, N, N, sse_kind> a;
+		a.load(src, aligned_t());
+
+		simd_vec<T, N, sse_kind> v;
+		v.load(src + step_size, aligned_t());
+
+		for (unsigned i = 0; i < num_mats; ++i)
+		{
+			v = solve(a, v);
+		}
+
+		v.store(dst, aligned_t());
+	}
 };
 
 
@@ -294,6 +550,8 @@ void do_bench1()
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
 	fill_rand(arr_len, af, 0.f, 1.f);
 	fill_rand(arr_len, ad, 0.0, 1.0);
 
@@ -301,8 +559,11 @@ int main(int argc, char *argv[])
 	do_bench<addip_op>();
 	do_bench<transcp_op>();
 	do_bench<mtimes_op>();
+	do_bench<mtimes_batch_op>();
+	do_bench<mtimes_batch_packed_op>();
 
 	do_bench1<inv_op>();
+	do_bench1<det_op>();
 	do_bench1<solve_op>();
 }
 
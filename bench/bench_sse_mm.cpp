@@ -84,12 +84,17 @@ template<typename T, int M, int K, int N>
 inline void bench(unsigned repeat_times)
 {
 	mtimes_cp<T, M, K, N> op1;
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
 
-	double cpv = double(cs1) / (double(repeat_times) * double(num_mats));
+	double cpv = cs1.median / double(num_mats);
 
-	std::printf("(%d x %d) * (%d x %d):  %6.1f cycles / mat ==> %.1f scalar-op / cycle\n",
+	std::printf("(%d x %d) * (%d x %d):  %6.1f cycles / mat ==> %.1f scalar-op / cycle",
 			M, K, K, N, cpv, double(2 * M * K * N) / cpv);
+	print_perf(cs1, double(num_mats), "mat");
+
+	char cfg[32];
+	std::sprintf(cfg, "%dx%dx%d", M, K, N);
+	record_bench<T>("mtimes", cfg, simd<T, sse_kind>::pack_width, "mat", double(num_mats), cs1);
 }
 
 
@@ -144,6 +149,8 @@ void do_bench(const unsigned int rt)
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
 	fill_rand(arr_len, af, 0.f, 1.f);
 	fill_rand(arr_len, ad, 0.0, 1.0);
 	fill_rand(arr_len, bf, 0.f, 1.f);
@@ -0,0 +1,207 @@
+/**
+ * @file bench_sse_normalize.cpp
+ *
+ * Benchmark of standardization and layer normalization against
+ * scalar implementations
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+// the scalar versions take two passes for the statistics
+
+template<typename T>
+inline void scalar_mean_var(int n, const T *x, T& mean, T& var)
+{
+	T s(0);
+	for (int i = 0; i < n; ++i) s += x[i];
+	mean = s / T(n);
+
+	T s2(0);
+	for (int i = 0; i < n; ++i) s2 += (x[i] - mean) * (x[i] - mean);
+	var = s2 / T(n);
+}
+
+template<typename T>
+struct scalar_layernorm_rows
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	scalar_layernorm_rows(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run()
+	{
+		for (int i = 0; i < m; ++i)
+		{
+			const T *xi = x + i * n;
+			T *yi = y + i * n;
+
+			T mean, var;
+			scalar_mean_var(n, xi, mean, var);
+			const T inv = T(1) / std::sqrt(var + T(1.0e-5));
+
+			for (int j = 0; j < n; ++j) yi[j] = (xi[j] - mean) * inv * g[j] + b[j];
+		}
+	}
+};
+
+template<typename T>
+struct simd_mean_var
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	simd_mean_var(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run()
+	{
+		for (int i = 0; i < m; ++i) mean_var(n, x + i * n, y[2 * i], y[2 * i + 1]);
+	}
+};
+
+template<typename T>
+struct scalar_mean_var_rows
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	scalar_mean_var_rows(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run()
+	{
+		for (int i = 0; i < m; ++i) scalar_mean_var(n, x + i * n, y[2 * i], y[2 * i + 1]);
+	}
+};
+
+template<typename T>
+struct simd_standardize_rows
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	simd_standardize_rows(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run() { standardize_rows(m, n, x, n, y, n, T(1.0e-5)); }
+};
+
+template<typename T>
+struct simd_layernorm_rows
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	simd_layernorm_rows(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run() { layernorm_rows(m, n, x, n, g, b, y, n); }
+};
+
+template<typename T>
+struct simd_layernorm_rows_mt
+{
+	int m, n;
+	const T *x, *g, *b;
+	T *y;
+	simd_layernorm_rows_mt(int m_, int n_, const T *x_, const T *g_, const T *b_, T *y_)
+	: m(m_), n(n_), x(x_), g(g_), b(b_), y(y_) { }
+
+	void run() { layernorm_rows_mt(m, n, x, n, g, b, y, n); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int m, int n, const T *x, const T *g, const T *b, T *y,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(m, n, x, g, b, y);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	const int len = m * n;
+	const double cpe = r.median / len;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(r, len, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "%dx%d", m, n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", len, r);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int m, int n)
+{
+	const int len = m * n;
+	T *x = new T[len];
+	T *y = new T[len];
+	T *g = new T[n];
+	T *b = new T[n];
+
+	for (int i = 0; i < len; ++i) x[i] = T(std::rand()) / T(RAND_MAX);
+	for (int j = 0; j < n; ++j)
+	{
+		g[j] = T(1) + T(std::rand()) / T(RAND_MAX);
+		b[j] = T(std::rand()) / T(RAND_MAX);
+	}
+
+	const unsigned repeat_times = (unsigned)(20000000 / len);
+
+	std::printf("  f%d, %d rows of %d:\n", (int)(sizeof(T) * 8), m, n);
+	double b0 = bench_op<T, scalar_mean_var_rows>("scalar mean_var", m, n, x, g, b, y, repeat_times, 0);
+	bench_op<T, simd_mean_var>("mean_var", m, n, x, g, b, y, repeat_times, b0);
+
+	double b1 = bench_op<T, scalar_layernorm_rows>("scalar layernorm", m, n, x, g, b, y, repeat_times, 0);
+	bench_op<T, simd_standardize_rows>("standardize", m, n, x, g, b, y, repeat_times, b1);
+	bench_op<T, simd_layernorm_rows>("layernorm", m, n, x, g, b, y, repeat_times, b1);
+	bench_op<T, simd_layernorm_rows_mt>("layernorm_mt", m, n, x, g, b, y, repeat_times, b1);
+
+	delete[] b;
+	delete[] g;
+	delete[] y;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on normalization (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(64, 768);
+	bench_all<f32>(16, 4096);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(64, 768);
+	bench_all<f64>(16, 4096);
+	std::printf("\n");
+}
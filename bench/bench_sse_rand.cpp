@@ -0,0 +1,273 @@
+/**
+ * @file bench_sse_rand.cpp
+ *
+ * Benchmark of the random number generators against scalar generation
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+const int len = 4096;
+
+
+/********************************************
+ *
+ *  Scalar generators
+ *
+ ********************************************/
+
+// the scalar xoshiro128+, seeded as lane 0 of xoshiro128p
+
+struct scalar_xoshiro
+{
+	u32 s[4];
+
+	explicit scalar_xoshiro(u64 seed)
+	{
+		u64 a = xoshiro128p::_splitmix64(seed);
+		u64 b = xoshiro128p::_splitmix64(seed);
+		s[0] = (u32)a;
+		s[1] = (u32)(a >> 32);
+		s[2] = (u32)b;
+		s[3] = (u32)(b >> 32);
+	}
+
+	u32 next()
+	{
+		const u32 r = s[0] + s[3];
+		const u32 t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = (s[3] << 11) | (s[3] >> 21);
+		return r;
+	}
+};
+
+
+// the scalar Philox-4x32-10, producing the same stream as philox4x32
+
+struct scalar_philox
+{
+	u32 key[2];
+	u32 ctr[4];
+	u32 buf[4];
+	int pos;
+
+	explicit scalar_philox(u64 seed) : pos(4)
+	{
+		key[0] = (u32)seed;
+		key[1] = (u32)(seed >> 32);
+		ctr[0] = ctr[1] = ctr[2] = ctr[3] = 0;
+	}
+
+	u32 next()
+	{
+		if (pos == 4)
+		{
+			u32 c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+			u32 k0 = key[0];
+			u32 k1 = key[1];
+
+			for (int r = 0; r < 10; ++r)
+			{
+				u64 p0 = (u64)0xD2511F53u * c[0];
+				u64 p1 = (u64)0xCD9E8D57u * c[2];
+				u32 t0 = (u32)(p1 >> 32) ^ c[1] ^ k0;
+				u32 t2 = (u32)(p0 >> 32) ^ c[3] ^ k1;
+				c[0] = t0;
+				c[1] = (u32)p1;
+				c[2] = t2;
+				c[3] = (u32)p0;
+				k0 += 0x9E3779B9u;
+				k1 += 0xBB67AE85u;
+			}
+
+			for (int i = 0; i < 4; ++i) buf[i] = c[i];
+			if (++ctr[0] == 0) ++ctr[1];
+			pos = 0;
+		}
+		return buf[pos++];
+	}
+};
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct std_rand_uniform
+{
+	T *a;
+	std_rand_uniform(T *a_) : a(a_) { }
+
+	void run()
+	{
+		for (int i = 0; i < len; ++i) a[i] = T(std::rand()) / T(RAND_MAX);
+	}
+};
+
+// the same mappings from words to values as those of simd_rand.h
+
+template<class G>
+inline f32 scalar_uniform_value(G& g, f32)
+{
+	return f32(g.next() >> 8) * 5.9604644775390625e-8f;
+}
+
+template<class G>
+inline f64 scalar_uniform_value(G& g, f64)
+{
+	u32 lo = g.next();
+	u32 hi = g.next();
+	return (f64(hi >> 12) * 4294967296.0 + f64(lo)) * 2.220446049250313080847e-16;
+}
+
+template<typename T, class G>
+struct scalar_uniform
+{
+	T *a;
+	G g;
+	scalar_uniform(T *a_) : a(a_), g(1) { }
+
+	void run()
+	{
+		for (int i = 0; i < len; ++i) a[i] = scalar_uniform_value(g, T());
+	}
+};
+
+template<typename T>
+struct scalar_xoshiro_uniform : public scalar_uniform<T, scalar_xoshiro>
+{
+	scalar_xoshiro_uniform(T *a_) : scalar_uniform<T, scalar_xoshiro>(a_) { }
+};
+
+template<typename T>
+struct scalar_philox_uniform : public scalar_uniform<T, scalar_philox>
+{
+	scalar_philox_uniform(T *a_) : scalar_uniform<T, scalar_philox>(a_) { }
+};
+
+template<typename T>
+struct scalar_normal
+{
+	T *a;
+	scalar_xoshiro g;
+	scalar_normal(T *a_) : a(a_), g(1) { }
+
+	void run()
+	{
+		for (int i = 0; i < len; i += 2)
+		{
+			T u1 = scalar_uniform_value(g, T());
+			T u2 = scalar_uniform_value(g, T());
+			T rho = std::sqrt(T(-2) * std::log(T(1) - u1));
+			T theta = T(6.283185307179586) * u2;
+			a[i] = rho * std::cos(theta);
+			a[i+1] = rho * std::sin(theta);
+		}
+	}
+};
+
+template<typename T>
+struct philox_uniform
+{
+	T *a;
+	philox4x32 g;
+	philox_uniform(T *a_) : a(a_), g(1) { }
+
+	void run() { fill_uniform(g, len, a, T(0), T(1)); }
+};
+
+template<typename T>
+struct xoshiro_uniform
+{
+	T *a;
+	xoshiro128p g;
+	xoshiro_uniform(T *a_) : a(a_), g(1) { }
+
+	void run() { fill_uniform(g, len, a, T(0), T(1)); }
+};
+
+template<typename T>
+struct xoshiro_normal
+{
+	T *a;
+	xoshiro128p g;
+	xoshiro_normal(T *a_) : a(a_), g(1) { }
+
+	void run() { fill_normal(g, len, a, T(0), T(1)); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, T *a, unsigned repeat_times, double base)
+{
+	Op<T> op(a);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = r.median / len;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(r, len, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", len);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", len, r);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all()
+{
+	T *a = new T[len];
+	const unsigned repeat_times = 2000;
+
+	std::printf("  f%d uniform:\n", (int)(sizeof(T) * 8));
+	bench_op<T, std_rand_uniform>("std::rand", a, repeat_times, 0);
+	double b0 = bench_op<T, scalar_philox_uniform>("scalar philox", a, repeat_times, 0);
+	bench_op<T, philox_uniform> ("philox4x32", a, repeat_times, b0);
+	double b1 = bench_op<T, scalar_xoshiro_uniform>("scalar xoshiro", a, repeat_times, 0);
+	bench_op<T, xoshiro_uniform>("xoshiro128p", a, repeat_times, b1);
+
+	std::printf("  f%d normal:\n", (int)(sizeof(T) * 8));
+	double b2 = bench_op<T, scalar_normal>("scalar xoshiro", a, repeat_times / 4, 0);
+	bench_op<T, xoshiro_normal>("xoshiro128p", a, repeat_times / 4, b2);
+
+	delete[] a;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on random number generation (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>();
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>();
+	std::printf("\n");
+}
@@ -17,15 +17,16 @@ const unsigned warming_times = 10;
 LSIMD_ALIGN(128) f32 af[arr_len];
 LSIMD_ALIGN(128) f64 ad[arr_len];
 
-inline void report_bench(const char *name, unsigned rtimes, uint64_t cycles,
+inline void report_bench(const char *name, unsigned rtimes, const bench_result& r,
 		int pack_w, int nops)
 {
-	double cpo_f = double(cycles) / (double(rtimes) * double(arr_len));
+	double cpo_f = r.median / (double(rtimes / r.repeat_times) * double(arr_len));
 
 	int cpoi = int(cpo_f);
 	cpoi = (cpoi - nops);  // re-calibrated
 
-	std::printf("\t%-8s:   %4d cycles / %d op\n", name, cpoi, pack_w);
+	std::printf("\t%-8s:   %4d cycles / %d op", name, cpoi, pack_w);
+	print_perf(r, double(arr_len) * double(pack_w), "elem");
 }
 
 
@@ -38,10 +39,13 @@ inline void bench(unsigned repeat_times, T *pa)
 	fill_rand(arr_len, pa, lb, ub);
 
 	wrap_op<T, sse_kind, OpT<T>, arr_len> op1(pa);
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
 
 	report_bench(OpT<T>::name(), repeat_times * OpT<T>::folds(),
 			cs1, (int)simd_pack<T, sse_kind>::pack_width, 1);
+
+	record_bench<T>(OpT<T>::name(), "", simd_pack<T, sse_kind>::pack_width,
+			"op", double(arr_len) * double(OpT<T>::folds()), cs1);
 }
 
 template<typename T>
@@ -219,6 +223,8 @@ struct pmin3_op
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
 	std::printf("Benchmarks on f32\n");
 	std::printf("============================\n");
 
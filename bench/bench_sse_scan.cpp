@@ -0,0 +1,137 @@
+/**
+ * @file bench_sse_scan.cpp
+ *
+ * Benchmark of prefix sums against a scalar loop
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct scalar_scan
+{
+	int n;
+	const T *x;
+	T *y;
+	scalar_scan(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run()
+	{
+		T s(0);
+		for (int i = 0; i < n; ++i) y[i] = (s += x[i]);
+	}
+};
+
+template<typename T>
+struct simd_incl_scan
+{
+	int n;
+	const T *x;
+	T *y;
+	simd_incl_scan(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run() { inclusive_scan(n, x, y); }
+};
+
+template<typename T>
+struct simd_excl_scan
+{
+	int n;
+	const T *x;
+	T *y;
+	simd_excl_scan(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run() { exclusive_scan(n, x, y); }
+};
+
+template<typename T>
+struct simd_incl_scan_mt
+{
+	int n;
+	const T *x;
+	T *y;
+	simd_incl_scan_mt(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run() { inclusive_scan_mt(n, x, y); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int n, const T *x, T *y,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(n, x, y);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(const char *tname, int n)
+{
+	T *x = new T[n];
+	T *y = new T[n];
+
+	for (int i = 0; i < n; ++i) x[i] = T(std::rand() % 100);
+
+	const unsigned repeat_times = (unsigned)(100000000.0 / n) + 1;
+
+	std::printf("  %s, n = %d:\n", tname, n);
+	double b0 = bench_op<T, scalar_scan>("scalar", n, x, y, repeat_times, 0);
+	bench_op<T, simd_incl_scan>("inclusive_scan", n, x, y, repeat_times, b0);
+	bench_op<T, simd_excl_scan>("exclusive_scan", n, x, y, repeat_times, b0);
+	bench_op<T, simd_incl_scan_mt>("inclusive_mt", n, x, y, repeat_times, b0);
+
+	delete[] y;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on prefix sums (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>("f32", 4096);
+	bench_all<f32>("f32", 1 << 22);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>("f64", 4096);
+	bench_all<f64>("f64", 1 << 22);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<i32>("i32", 4096);
+	bench_all<i32>("i32", 1 << 22);
+	std::printf("\n");
+}
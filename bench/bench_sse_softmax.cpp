@@ -0,0 +1,184 @@
+/**
+ * @file bench_sse_softmax.cpp
+ *
+ * Benchmark of softmax and log-sum-exp against scalar implementations
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+inline T scalar_max(int n, const T *x)
+{
+	T m = x[0];
+	for (int i = 1; i < n; ++i) if (x[i] > m) m = x[i];
+	return m;
+}
+
+template<typename T>
+struct scalar_logsumexp
+{
+	int n;
+	const T *x;
+	T *y;
+	T r;
+	scalar_logsumexp(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run()
+	{
+		const T m = scalar_max(n, x);
+		T s(0);
+		for (int i = 0; i < n; ++i) s += std::exp(x[i] - m);
+		r = m + std::log(s);
+	}
+};
+
+template<typename T>
+struct scalar_softmax
+{
+	int n;
+	const T *x;
+	T *y;
+	scalar_softmax(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run()
+	{
+		const T m = scalar_max(n, x);
+		T s(0);
+		for (int i = 0; i < n; ++i) s += (y[i] = std::exp(x[i] - m));
+		const T c = T(1) / s;
+		for (int i = 0; i < n; ++i) y[i] *= c;
+	}
+};
+
+template<typename T>
+struct simd_logsumexp
+{
+	int n;
+	const T *x;
+	T *y;
+	T r;
+	simd_logsumexp(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = logsumexp(n, x); }
+};
+
+template<typename T>
+struct simd_logsumexp_online
+{
+	int n;
+	const T *x;
+	T *y;
+	T r;
+	simd_logsumexp_online(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = logsumexp_online(n, x); }
+};
+
+template<typename T>
+struct simd_softmax
+{
+	int n;
+	const T *x;
+	T *y;
+	simd_softmax(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run() { softmax(n, x, y); }
+};
+
+template<typename T>
+struct simd_softmax_online
+{
+	int n;
+	const T *x;
+	T *y;
+	simd_softmax_online(int n_, const T *x_, T *y_) : n(n_), x(x_), y(y_) { }
+
+	void run() { softmax_online(n, x, y); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int n, const T *x, T *y, unsigned repeat_times, double base)
+{
+	Op<T> op(n, x, y);
+	bench_result r = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = r.median / n;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(r, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, r);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int n)
+{
+	T *x = new T[n];
+	T *y = new T[n];
+	for (int i = 0; i < n; ++i) x[i] = T(20) * (T(std::rand()) / T(RAND_MAX)) - T(10);
+
+	const unsigned repeat_times = (unsigned)(4000000 / n);
+
+	std::printf("  f%d, n = %d:\n", (int)(sizeof(T) * 8), n);
+	double b0 = bench_op<T, scalar_logsumexp>("scalar lse", n, x, y, repeat_times, 0);
+	bench_op<T, simd_logsumexp>("logsumexp", n, x, y, repeat_times, b0);
+	bench_op<T, simd_logsumexp_online>("logsumexp_online", n, x, y, repeat_times, b0);
+
+	double b1 = bench_op<T, scalar_softmax>("scalar softmax", n, x, y, repeat_times, 0);
+	bench_op<T, simd_softmax>("softmax", n, x, y, repeat_times, b1);
+	bench_op<T, simd_softmax_online>("softmax_online", n, x, y, repeat_times, b1);
+
+	delete[] y;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on softmax and log-sum-exp (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	const int lens[3] = {1024, 4096, 32768};
+
+	for (int k = 0; k < 3; ++k)
+	{
+		bench_all<f32>(lens[k]);
+	}
+	std::printf("\t-------------------------------------------------------\n");
+	for (int k = 0; k < 3; ++k)
+	{
+		bench_all<f64>(lens[k]);
+	}
+	std::printf("\n");
+}
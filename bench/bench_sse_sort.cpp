@@ -0,0 +1,179 @@
+/**
+ * @file bench_sse_sort.cpp
+ *
+ * Benchmark of array sorting against std::sort
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+// the values moved along with keys of type T (of the same size)
+
+template<typename T> struct kv_val;
+template<> struct kv_val<f32> { typedef i32 type; };
+template<> struct kv_val<f64> { typedef i64 type; };
+
+// each run sorts a fresh copy of the input
+
+template<typename T>
+struct std_sort
+{
+	int n;
+	const T *x;
+	T *r;
+	typename kv_val<T>::type *v;
+	std::pair<T, typename kv_val<T>::type> *p;
+	std_sort(int n_, const T *x_, T *r_, typename kv_val<T>::type *v_, std::pair<T, typename kv_val<T>::type> *p_)
+	: n(n_), x(x_), r(r_), v(v_), p(p_) { }
+
+	void run()
+	{
+		std::memcpy(r, x, sizeof(T) * (size_t)n);
+		std::sort(r, r + n);
+	}
+};
+
+template<typename T>
+struct simd_sort
+{
+	int n;
+	const T *x;
+	T *r;
+	typename kv_val<T>::type *v;
+	std::pair<T, typename kv_val<T>::type> *p;
+	simd_sort(int n_, const T *x_, T *r_, typename kv_val<T>::type *v_, std::pair<T, typename kv_val<T>::type> *p_)
+	: n(n_), x(x_), r(r_), v(v_), p(p_) { }
+
+	void run()
+	{
+		std::memcpy(r, x, sizeof(T) * (size_t)n);
+		lsimd::sort(n, r);
+	}
+};
+
+template<typename T>
+struct std_sort_pairs
+{
+	int n;
+	const T *x;
+	T *r;
+	typename kv_val<T>::type *v;
+	std::pair<T, typename kv_val<T>::type> *p;
+	std_sort_pairs(int n_, const T *x_, T *r_, typename kv_val<T>::type *v_, std::pair<T, typename kv_val<T>::type> *p_)
+	: n(n_), x(x_), r(r_), v(v_), p(p_) { }
+
+	void run()
+	{
+		for (int i = 0; i < n; ++i) p[i] = std::make_pair(x[i], typename kv_val<T>::type(i));
+		std::sort(p, p + n);
+	}
+};
+
+template<typename T>
+struct simd_sort_kv
+{
+	int n;
+	const T *x;
+	T *r;
+	typename kv_val<T>::type *v;
+	std::pair<T, typename kv_val<T>::type> *p;
+	simd_sort_kv(int n_, const T *x_, T *r_, typename kv_val<T>::type *v_, std::pair<T, typename kv_val<T>::type> *p_)
+	: n(n_), x(x_), r(r_), v(v_), p(p_) { }
+
+	void run()
+	{
+		std::memcpy(r, x, sizeof(T) * (size_t)n);
+		for (int i = 0; i < n; ++i) v[i] = typename kv_val<T>::type(i);
+		sort_kv(n, r, v);
+	}
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int n, const T *x, T *r,
+		typename kv_val<T>::type *v, std::pair<T, typename kv_val<T>::type> *p,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(n, x, r, v, p);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int n)
+{
+	typedef typename kv_val<T>::type V;
+
+	T *x = new T[n];
+	T *r = new T[n];
+	V *v = new V[n];
+	std::pair<T, V> *p = new std::pair<T, V>[n];
+
+	for (int i = 0; i < n; ++i) x[i] = T(std::rand()) / T(RAND_MAX) * T(1 << 20);
+
+	const unsigned repeat_times = (unsigned)(20000000.0 / n) + 1;
+
+	std::printf("  %s, n = %d:\n", sizeof(T) == 8 ? "f64" : "f32", n);
+	double b0 = bench_op<T, std_sort>("std::sort", n, x, r, v, p, repeat_times, 0);
+	bench_op<T, simd_sort>("sort", n, x, r, v, p, repeat_times, b0);
+	double b1 = bench_op<T, std_sort_pairs>("std::sort pairs", n, x, r, v, p, repeat_times, 0);
+	bench_op<T, simd_sort_kv>("sort_kv", n, x, r, v, p, repeat_times, b1);
+
+	delete[] p;
+	delete[] v;
+	delete[] r;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on sorting (cycles per value, speedup over std::sort)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(1024);
+	bench_all<f32>(65536);
+	bench_all<f32>(1 << 20);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(1024);
+	bench_all<f64>(65536);
+	bench_all<f64>(1 << 20);
+	std::printf("\n");
+}
@@ -0,0 +1,207 @@
+/**
+ * @file bench_sse_sum.cpp
+ *
+ * Benchmark of the summation modes
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+// the results are kept, so that the sums are not optimized away
+
+template<typename T>
+struct scalar_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	scalar_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run()
+	{
+		T s(0);
+		for (int i = 0; i < n; ++i) s += x[i];
+		r = s;
+	}
+};
+
+template<typename T>
+struct widened_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	widened_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run()
+	{
+		double s = 0;
+		for (int i = 0; i < n; ++i) s += double(x[i]);
+		r = T(s);
+	}
+};
+
+template<typename T>
+struct plain_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	plain_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = sum(n, x); }
+};
+
+template<typename T>
+struct pairwise_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	pairwise_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = sum(n, x, pairwise_t()); }
+};
+
+template<typename T>
+struct kahan_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	kahan_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = sum(n, x, kahan_t()); }
+};
+
+template<typename T>
+struct comp_sum
+{
+	int n;
+	const T *x, *y;
+	T r;
+	comp_sum(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = sum(n, x, compensated_t()); }
+};
+
+template<typename T>
+struct plain_dot
+{
+	int n;
+	const T *x, *y;
+	T r;
+	plain_dot(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dot(n, x, y); }
+};
+
+template<typename T>
+struct comp_dot
+{
+	int n;
+	const T *x, *y;
+	T r;
+	comp_dot(int n_, const T *x_, const T *y_) : n(n_), x(x_), y(y_), r(0) { }
+
+	void run() { r = dot(n, x, y, compensated_t()); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+// reports the cost, and the relative error against a reference
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int n, const T *x, const T *y, long double ref,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(n, x, y);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	op.run();
+	const double err = (double)(std::fabs((long double)op.r - ref) / std::fabs(ref));
+
+	std::printf("\t%-16s: %.3f cycles / value, rel.err = %.2e", name, cpe, err);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d", n);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int n)
+{
+	T *x = new T[n];
+	T *y = new T[n];
+
+	for (int i = 0; i < n; ++i)
+	{
+		x[i] = T(1) + T(std::rand()) / T(RAND_MAX);
+		y[i] = T(std::rand()) / T(RAND_MAX) - T(0.5);
+	}
+
+	long double rs = 0, rd = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		rs += (long double)x[i];
+		rd += (long double)x[i] * (long double)y[i];
+	}
+
+	const unsigned repeat_times = (unsigned)(100000000.0 / n) + 1;
+
+	std::printf("  f%d, n = %d:\n", (int)(sizeof(T) * 8), n);
+	double b0 = bench_op<T, scalar_sum>("scalar", n, x, y, rs, repeat_times, 0);
+	if (sizeof(T) == 4) bench_op<T, widened_sum>("scalar (f64)", n, x, y, rs, repeat_times, b0);
+	bench_op<T, plain_sum>("sum", n, x, y, rs, repeat_times, b0);
+	bench_op<T, pairwise_sum>("sum (pairwise)", n, x, y, rs, repeat_times, b0);
+	bench_op<T, kahan_sum>("sum (kahan)", n, x, y, rs, repeat_times, b0);
+	bench_op<T, comp_sum>("sum (comp)", n, x, y, rs, repeat_times, b0);
+	double b1 = bench_op<T, plain_dot>("dot", n, x, y, rd, repeat_times, 0);
+	bench_op<T, comp_dot>("dot (comp)", n, x, y, rd, repeat_times, b1);
+
+	delete[] y;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on summation (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(4096);
+	bench_all<f32>(1 << 22);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(4096);
+	bench_all<f64>(1 << 22);
+	std::printf("\n");
+}
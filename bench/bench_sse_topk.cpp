@@ -0,0 +1,145 @@
+/**
+ * @file bench_sse_topk.cpp
+ *
+ * Benchmark of top-k selection against a scalar heap
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "bench_aux.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace lsimd;
+
+const unsigned warming_times = 2;
+
+
+/********************************************
+ *
+ *  Operations
+ *
+ ********************************************/
+
+template<typename T>
+struct scalar_topk
+{
+	int n, k;
+	const T *x;
+	int *idx;
+	T *val;
+	scalar_topk(int n_, int k_, const T *x_, int *idx_, T *val_)
+	: n(n_), k(k_), x(x_), idx(idx_), val(val_) { }
+
+	// a max-heap of the k smallest, tested entry by entry
+
+	void sift_down(int i)
+	{
+		for (int c = 2 * i + 1; c < k; c = 2 * i + 1)
+		{
+			if (c + 1 < k && val[c + 1] > val[c]) ++c;
+			if (!(val[c] > val[i])) break;
+
+			const T tv = val[i]; val[i] = val[c]; val[c] = tv;
+			const int ti = idx[i]; idx[i] = idx[c]; idx[c] = ti;
+			i = c;
+		}
+	}
+
+	void run()
+	{
+		for (int i = 0; i < k; ++i) { val[i] = x[i]; idx[i] = i; }
+		for (int i = k / 2 - 1; i >= 0; --i) sift_down(i);
+
+		for (int i = k; i < n; ++i)
+		{
+			if (x[i] < val[0])
+			{
+				val[0] = x[i];
+				idx[0] = i;
+				sift_down(0);
+			}
+		}
+	}
+};
+
+template<typename T>
+struct simd_topk
+{
+	int n, k;
+	const T *x;
+	int *idx;
+	T *val;
+	simd_topk(int n_, int k_, const T *x_, int *idx_, T *val_)
+	: n(n_), k(k_), x(x_), idx(idx_), val(val_) { }
+
+	void run() { topk(n, x, k, idx, val); }
+};
+
+
+/********************************************
+ *
+ *  Main
+ *
+ ********************************************/
+
+template<typename T, template<typename U> class Op>
+inline double bench_op(const char *name, int n, int k, const T *x, int *idx, T *val,
+		unsigned repeat_times, double base)
+{
+	Op<T> op(n, k, x, idx, val);
+	bench_result br = perf_bench(op, warming_times, repeat_times);
+
+	const double cpe = br.median / n;
+
+	std::printf("\t%-16s: %.3f cycles / value", name, cpe);
+	if (base > 0) std::printf("  (%5.2fx)", base / cpe);
+	print_perf(br, n, "value");
+
+	char cfg[32];
+	std::sprintf(cfg, "n=%d,k=%d", n, k);
+	record_bench<T>(name, cfg, simd<T, sse_kind>::pack_width, "value", n, br);
+
+	return cpe;
+}
+
+template<typename T>
+void bench_all(int n, int k)
+{
+	T *x = new T[n];
+	int *idx = new int[k];
+	T *val = new T[k];
+
+	for (int i = 0; i < n; ++i) x[i] = T(std::rand()) / T(RAND_MAX);
+
+	const unsigned repeat_times = (unsigned)(100000000.0 / n) + 1;
+
+	std::printf("  f%d, n = %d, k = %d:\n", (int)(sizeof(T) * 8), n, k);
+	double b0 = bench_op<T, scalar_topk>("scalar heap", n, k, x, idx, val, repeat_times, 0);
+	bench_op<T, simd_topk>("topk", n, k, x, idx, val, repeat_times, b0);
+
+	delete[] val;
+	delete[] idx;
+	delete[] x;
+}
+
+
+int main(int argc, char *argv[])
+{
+	bench_setup(argc, argv);
+
+	std::printf("Benchmarks on top-k selection (cycles per value, speedup over scalar)\n");
+	std::printf("================================\n");
+
+	bench_all<f32>(16384, 10);
+	bench_all<f32>(16384, 100);
+	bench_all<f32>(1 << 20, 10);
+	bench_all<f32>(1 << 20, 100);
+	std::printf("\t-------------------------------------------------------\n");
+	bench_all<f64>(16384, 10);
+	bench_all<f64>(16384, 100);
+	bench_all<f64>(1 << 20, 10);
+	bench_all<f64>(1 << 20, 100);
+	std::printf("\n");
+}
@@ -46,11 +46,16 @@ template<typename T, int N, template<typename U, int M> class OpT>
 inline void bench(unsigned repeat_times)
 {
 	OpT<T, N> op1;
-	uint64_t cs1 = tsc_bench(op1, warming_times, repeat_times);
+	bench_result cs1 = perf_bench(op1, warming_times, repeat_times);
 
-	double cpv = double(cs1) / (double(repeat_times) * double(num_vecs));
+	double cpv = cs1.median / double(num_vecs);
 
-	std::printf("\tf%d x %d:  %.1f cycles / vec\n", (int)(sizeof(T) * 8), N, cpv);
+	std::printf("\tf%d x %d:  %.1f cycles / vec", (int)(sizeof(T) * 8), N, cpv);
+	print_perf(cs1, double(num_vecs), "vec");
+
+	char cfg[32];
+	std::sprintf(cfg, "%d", N);
+	record_bench<T>(op1.name(), cfg, simd<T, sse_kind>::pack_width, "vec", double(num_vecs), cs1);
 }
 
 
@@ -152,6 +157,8 @@ void do_bench()
 
 int main(int argc, char *argv[])
 {
+	bench_setup(argc, argv);
+
 	fill_rand(arr_len, af, 0.f, 1.f);
 	fill_rand(arr_len, ad, 0.0, 1.0);
 
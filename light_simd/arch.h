@@ -60,6 +60,10 @@
 #define LSIMD_HAS_SSE2
 #endif
 
+#if defined(__AVX2__)
+#define LSIMD_HAS_FMA
+#endif
+
 #else
 
 #if defined(__SSE2__)
@@ -82,6 +86,16 @@
 #define LSIMD_HAS_SSE4_2
 #endif
 
+#if defined(__FMA__)
+#define LSIMD_HAS_FMA
+#endif
+
+#endif
+
+// Multi-threading support
+
+#if defined(_OPENMP)
+#define LSIMD_HAS_OPENMP
 #endif
 
 #ifndef LSIMD_HAS_SSE2
@@ -133,6 +133,16 @@ namespace lsimd
 	 */
 	typedef uint32_t u32;
 
+	/**
+	 * @brief 64-bit signed integer.
+	 */
+	typedef  int64_t i64;
+
+	/**
+	 * @brief 64-bit unsigned integer.
+	 */
+	typedef uint64_t u64;
+
 	/**
 	 * @brief Single-precision (32-bit) floating-point real number.
 	 */
@@ -223,6 +233,10 @@ namespace lsimd
 
 	template<typename T, int M, int N, typename Kind=default_simd_kind> struct simd_mat;
 
+	template<typename T, typename Kind=default_simd_kind> struct simd_quat;
+
+	template<typename T, typename Kind=default_simd_kind> struct simd_cpack;
+
 }
 
 /**
@@ -413,6 +413,27 @@ namespace lsimd
 		return rsqrt(a.impl);
 	}
 
+	/**
+	 * Calculates the approximate reciprocals of the squared roots
+	 * in an entry-wise way.
+	 *
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The input pack.
+	 *
+	 * @return    The resultant pack, approximately 1 / sqrt(a).
+	 *
+	 * @remark    The relative error is below 1.5 * 2^(-12). One Newton
+	 *            step, as y * (1.5 - 0.5 * a * y * y), brings it close
+	 *            to full single precision.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f32, Kind> approx_rsqrt(const simd_pack<f32, Kind>& a)
+	{
+		return approx_rsqrt(a.impl);
+	}
+
 	/**
 	 * Calculates the squares in an entry-wise way.
 	 *
@@ -448,6 +469,51 @@ namespace lsimd
 	}
 
 
+	/**
+	 * Calculates a * b + c in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of addends.
+	 *
+	 * @return    The resultant pack, as a * b + c.
+	 *
+	 * @remark    A fused instruction is used when the architecture
+	 *            supports it (see LSIMD_HAS_FMA).
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> fmadd(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b, const simd_pack<T, Kind>& c)
+	{
+		return fmadd(a.impl, b.impl, c.impl);
+	}
+
+	/**
+	 * Calculates c - a * b in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of minuends.
+	 *
+	 * @return    The resultant pack, as c - a * b.
+	 *
+	 * @remark    A fused instruction is used when the architecture
+	 *            supports it (see LSIMD_HAS_FMA).
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> fnmadd(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b, const simd_pack<T, Kind>& c)
+	{
+		return fnmadd(a.impl, b.impl, c.impl);
+	}
+
+
 	/**
 	 * Calculates the floor values in an entry-wise way.
 	 *
@@ -476,8 +542,286 @@ namespace lsimd
 		return ceil(a.impl);
 	}
 
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] < b[i].
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline int mask_lt(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return mask_lt(a.impl, b.impl);
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] <= b[i].
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline int mask_le(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return mask_le(a.impl, b.impl);
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] > b[i].
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline int mask_gt(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return mask_gt(a.impl, b.impl);
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @tparam   The scalar type of the packs.
+	 * @tparam   The SIMD kind of the packs.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] >= b[i].
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline int mask_ge(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return mask_ge(a.impl, b.impl);
+	}
+
+	/**
+	 * Calculates the inclusive prefix sums of the entries.
+	 *
+	 * @tparam   The scalar type of the pack.
+	 * @tparam   The SIMD kind of the pack.
+	 *
+	 * @param a   The input pack.
+	 *
+	 * @return    The resultant pack, whose i-th entry equals
+	 *            a[0] + ... + a[i].
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> prefix_sum(const simd_pack<T, Kind>& a)
+	{
+		return prefix_sum(a.impl);
+	}
+
 	/** @} */  // arith_generic
 
+
+	/**
+	 * @defgroup bitwise_generic Generic Integer Operations
+	 * @ingroup arith
+	 *
+	 * @brief Generic bitwise operators and conversions for
+	 *        packs of 32-bit integers.
+	 */
+	/** @{ */
+
+	/**
+	 * Bitwise and of two integer packs.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> operator & (const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return a.impl & b.impl;
+	}
+
+	/**
+	 * Bitwise or of two integer packs.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> operator | (const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return a.impl | b.impl;
+	}
+
+	/**
+	 * Bitwise exclusive or of two integer packs.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> operator ^ (const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b)
+	{
+		return a.impl ^ b.impl;
+	}
+
+	/**
+	 * Shifts all entries of an integer pack to the left by n bits.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> operator << (const simd_pack<T, Kind>& a, const int n)
+	{
+		return a.impl << n;
+	}
+
+	/**
+	 * Shifts all entries of an integer pack to the right by n bits.
+	 *
+	 * @remark  The shift is arithmetic for signed types, and logical
+	 *          for unsigned types.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T, Kind> operator >> (const simd_pack<T, Kind>& a, const int n)
+	{
+		return a.impl >> n;
+	}
+
+	/**
+	 * Multiplies two unsigned packs in an entry-wise way, keeping
+	 * the higher 32 bits of the 64-bit products.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<u32, Kind> mulhi(const simd_pack<u32, Kind>& a, const simd_pack<u32, Kind>& b)
+	{
+		return mulhi(a.impl, b.impl);
+	}
+
+	/**
+	 * Multiplies two unsigned packs in an entry-wise way, and splits
+	 * each 64-bit product into its higher and lower 32 bits.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void mulhilo(const simd_pack<u32, Kind>& a, const simd_pack<u32, Kind>& b,
+			simd_pack<u32, Kind>& hi, simd_pack<u32, Kind>& lo)
+	{
+		mulhilo(a.impl, b.impl, hi.impl, lo.impl);
+	}
+
+	/**
+	 * Converts integers to single-precision values.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f32, Kind> cvt_f32(const simd_pack<i32, Kind>& a)
+	{
+		return cvt_f32(a.impl);
+	}
+
+	/**
+	 * Converts the lower-end integers to double-precision values.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f64, Kind> cvt_f64(const simd_pack<i32, Kind>& a)
+	{
+		return cvt_f64(a.impl);
+	}
+
+	/**
+	 * Converts real values to integers by rounding to the nearest.
+	 *
+	 * @remark  For f64, the results occupy the lower-end of the pack,
+	 *          while the remaining entries are set to zeros.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<i32, Kind> cvt_i32(const simd_pack<T, Kind>& a)
+	{
+		return cvt_i32(a.impl);
+	}
+
+	/**
+	 * Converts real values to integers by truncation.
+	 *
+	 * @remark  For f64, the results occupy the lower-end of the pack,
+	 *          while the remaining entries are set to zeros.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<i32, Kind> cvtt_i32(const simd_pack<T, Kind>& a)
+	{
+		return cvtt_i32(a.impl);
+	}
+
+	/**
+	 * Reinterprets the bits of a pack as signed integers.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<i32, Kind> as_i32(const simd_pack<T, Kind>& a)
+	{
+		return as_i32(a.impl);
+	}
+
+	/**
+	 * Reinterprets the bits of a pack as unsigned integers.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<u32, Kind> as_u32(const simd_pack<T, Kind>& a)
+	{
+		return as_u32(a.impl);
+	}
+
+	/**
+	 * Reinterprets the bits of an unsigned pack as single-precision values.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f32, Kind> as_f32(const simd_pack<u32, Kind>& a)
+	{
+		return as_f32(a.impl);
+	}
+
+	/**
+	 * Reinterprets the bits of an unsigned pack as double-precision values.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f64, Kind> as_f64(const simd_pack<u32, Kind>& a)
+	{
+		return as_f64(a.impl);
+	}
+
+	/**
+	 * Transposes four unsigned packs in place, regarding them as
+	 * the rows of a square matrix.
+	 *
+	 * @remark  This requires the pack width to be 4.
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void transpose4(simd_pack<u32, Kind>& a, simd_pack<u32, Kind>& b,
+			simd_pack<u32, Kind>& c, simd_pack<u32, Kind>& d)
+	{
+		transpose4(a.impl, b.impl, c.impl, d.impl);
+	}
+
+	/** @} */  // bitwise_generic
+
 }
 
 
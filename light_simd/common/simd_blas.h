@@ -0,0 +1,405 @@
+/**
+ * @file simd_blas.h
+ *
+ * @brief BLAS-like matrix-vector routines for matrices of arbitrary size
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, merge, 
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES 
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_BLAS_H_
+#define LSIMD_SIMD_BLAS_H_
+
+#include "simd_pack.h"
+#include "simd_arith.h"
+
+namespace lsimd
+{
+
+	/**
+	 * \defgroup blas_generic Generic Matrix-Vector Routines
+	 * @ingroup  linalg_module
+	 *
+	 * @brief BLAS-like routines on matrices whose size is only known
+	 *        at run time.
+	 *
+	 * A matrix of size m x n is stored in column-major order (the same 
+	 * as sse_mat), with an offset lda (>= m) between the beginnings of 
+	 * consecutive columns. Neither the matrices nor the vectors need 
+	 * to be aligned.
+	 *
+	 * The routines work on blocks of rows whose portion of the vectors 
+	 * stays in L1 cache (see blas_blocking). The variants suffixed 
+	 * with _mt split the work across threads with OpenMP when 
+	 * LSIMD_HAS_OPENMP is defined (i.e. when compiled with -fopenmp 
+	 * or /openmp), and are the same as the serial ones otherwise.
+	 */
+	/** @{ */
+
+	/**
+	 * Blocking parameters of the matrix-vector routines.
+	 */
+	template<typename T>
+	struct blas_blocking
+	{
+		/**
+		 * The number of rows in a block (8 KB of each vector).
+		 */
+		static const int rows = 8192 / (int)sizeof(T);
+
+		/**
+		 * The number of rows assigned to a thread at a time in gemv_mt.
+		 */
+		static const int mt_rows = 256;
+
+		/**
+		 * The number of columns assigned to a thread at a time 
+		 * in gemv_t_mt and ger_mt.
+		 */
+		static const int mt_cols = 64;
+
+		/**
+		 * The minimum number of matrix entries for which the _mt 
+		 * variants go parallel.
+		 */
+		static const int mt_threshold = 1 << 16;
+	};
+
+
+	template<typename T>
+	inline void _blas_scale(int n, T beta, T *y)
+	{
+		if (beta == T(0))
+		{
+			for (int i = 0; i < n; ++i) y[i] = T(0);
+		}
+		else if (beta != T(1))
+		{
+			for (int i = 0; i < n; ++i) y[i] *= beta;
+		}
+	}
+
+	template<typename T, typename Kind>
+	inline void _gemv_n_rows(int i0, int i1, int n, T alpha, const T *a, int lda, const T *x, T *y)
+	{
+		typedef simd_pack<T, Kind> pack_t;
+		const int W = (int)simd<T, Kind>::pack_width;
+		const int n4 = n - n % 4;
+
+		for (int ib = i0; ib < i1; ib += blas_blocking<T>::rows)
+		{
+			const int ie = ib + blas_blocking<T>::rows < i1 ? ib + blas_blocking<T>::rows : i1;
+			const int iv = ib + (ie - ib) / W * W;
+
+			int j = 0;
+			for (; j < n4; j += 4)
+			{
+				const T *a0 = a + j * lda;
+				const T *a1 = a0 + lda;
+				const T *a2 = a1 + lda;
+				const T *a3 = a2 + lda;
+
+				const T s0 = alpha * x[j];
+				const T s1 = alpha * x[j + 1];
+				const T s2 = alpha * x[j + 2];
+				const T s3 = alpha * x[j + 3];
+
+				pack_t x0(s0), x1(s1), x2(s2), x3(s3);
+
+				for (int i = ib; i < iv; i += W)
+				{
+					pack_t yp(y + i, unaligned_t());
+					yp = fmadd(pack_t(a0 + i, unaligned_t()), x0, yp);
+					yp = fmadd(pack_t(a1 + i, unaligned_t()), x1, yp);
+					yp = fmadd(pack_t(a2 + i, unaligned_t()), x2, yp);
+					yp = fmadd(pack_t(a3 + i, unaligned_t()), x3, yp);
+					yp.store(y + i, unaligned_t());
+				}
+
+				for (int i = iv; i < ie; ++i)
+				{
+					y[i] += a0[i] * s0 + a1[i] * s1 + a2[i] * s2 + a3[i] * s3;
+				}
+			}
+
+			for (; j < n; ++j)
+			{
+				const T *a0 = a + j * lda;
+				const T s0 = alpha * x[j];
+				pack_t x0(s0);
+
+				for (int i = ib; i < iv; i += W)
+				{
+					fmadd(pack_t(a0 + i, unaligned_t()), x0, pack_t(y + i, unaligned_t())).store(y + i, unaligned_t());
+				}
+
+				for (int i = iv; i < ie; ++i)
+				{
+					y[i] += a0[i] * s0;
+				}
+			}
+		}
+	}
+
+	template<typename T, typename Kind>
+	inline void _gemv_t_cols(int m, int j0, int j1, T alpha, const T *a, int lda, const T *x, T *y)
+	{
+		typedef simd_pack<T, Kind> pack_t;
+		const int W = (int)simd<T, Kind>::pack_width;
+		const int j4 = j0 + (j1 - j0) / 4 * 4;
+
+		for (int ib = 0; ib < m; ib += blas_blocking<T>::rows)
+		{
+			const int ie = ib + blas_blocking<T>::rows < m ? ib + blas_blocking<T>::rows : m;
+			const int iv = ib + (ie - ib) / W * W;
+
+			int j = j0;
+			for (; j < j4; j += 4)
+			{
+				const T *a0 = a + j * lda;
+				const T *a1 = a0 + lda;
+				const T *a2 = a1 + lda;
+				const T *a3 = a2 + lda;
+
+				pack_t u0 = pack_t::zeros();
+				pack_t u1 = pack_t::zeros();
+				pack_t u2 = pack_t::zeros();
+				pack_t u3 = pack_t::zeros();
+
+				for (int i = ib; i < iv; i += W)
+				{
+					pack_t xp(x + i, unaligned_t());
+					u0 = fmadd(pack_t(a0 + i, unaligned_t()), xp, u0);
+					u1 = fmadd(pack_t(a1 + i, unaligned_t()), xp, u1);
+					u2 = fmadd(pack_t(a2 + i, unaligned_t()), xp, u2);
+					u3 = fmadd(pack_t(a3 + i, unaligned_t()), xp, u3);
+				}
+
+				T s0 = u0.sum();
+				T s1 = u1.sum();
+				T s2 = u2.sum();
+				T s3 = u3.sum();
+
+				for (int i = iv; i < ie; ++i)
+				{
+					s0 += a0[i] * x[i];
+					s1 += a1[i] * x[i];
+					s2 += a2[i] * x[i];
+					s3 += a3[i] * x[i];
+				}
+
+				y[j] += alpha * s0;
+				y[j + 1] += alpha * s1;
+				y[j + 2] += alpha * s2;
+				y[j + 3] += alpha * s3;
+			}
+
+			for (; j < j1; ++j)
+			{
+				const T *a0 = a + j * lda;
+				pack_t u0 = pack_t::zeros();
+
+				for (int i = ib; i < iv; i += W)
+				{
+					u0 = fmadd(pack_t(a0 + i, unaligned_t()), pack_t(x + i, unaligned_t()), u0);
+				}
+
+				T s0 = u0.sum();
+				for (int i = iv; i < ie; ++i) s0 += a0[i] * x[i];
+
+				y[j] += alpha * s0;
+			}
+		}
+	}
+
+	template<typename T, typename Kind>
+	inline void _ger_cols(int m, int j0, int j1, T alpha, const T *x, const T *y, T *a, int lda)
+	{
+		typedef simd_pack<T, Kind> pack_t;
+		const int W = (int)simd<T, Kind>::pack_width;
+
+		for (int ib = 0; ib < m; ib += blas_blocking<T>::rows)
+		{
+			const int ie = ib + blas_blocking<T>::rows < m ? ib + blas_blocking<T>::rows : m;
+			const int iv = ib + (ie - ib) / W * W;
+
+			for (int j = j0; j < j1; ++j)
+			{
+				T *aj = a + j * lda;
+				const T s = alpha * y[j];
+				pack_t sp(s);
+
+				for (int i = ib; i < iv; i += W)
+				{
+					fmadd(pack_t(x + i, unaligned_t()), sp, pack_t(aj + i, unaligned_t())).store(aj + i, unaligned_t());
+				}
+
+				for (int i = iv; i < ie; ++i)
+				{
+					aj[i] += x[i] * s;
+				}
+			}
+		}
+	}
+
+
+	/**
+	 * Evaluates a matrix-vector product, as y = alpha * A * x + beta * y.
+	 *
+	 * @param m      The number of rows of A (the length of y).
+	 * @param n      The number of columns of A (the length of x).
+	 * @param alpha  The coefficient of A * x.
+	 * @param a      The base address of A.
+	 * @param lda    The offset between consecutive columns of A.
+	 * @param x      The input vector.
+	 * @param beta   The coefficient of y. When beta is zero, y need
+	 *               not be initialized.
+	 * @param y      The output vector.
+	 */
+	template<typename T>
+	inline void gemv(int m, int n, T alpha, const T *a, int lda, const T *x, T beta, T *y)
+	{
+		_blas_scale(m, beta, y);
+		_gemv_n_rows<T, default_simd_kind>(0, m, n, alpha, a, lda, x, y);
+	}
+
+	/**
+	 * Evaluates a transposed matrix-vector product, 
+	 * as y = alpha * A^T * x + beta * y.
+	 *
+	 * @param m      The number of rows of A (the length of x).
+	 * @param n      The number of columns of A (the length of y).
+	 * @param alpha  The coefficient of A^T * x.
+	 * @param a      The base address of A.
+	 * @param lda    The offset between consecutive columns of A.
+	 * @param x      The input vector.
+	 * @param beta   The coefficient of y. When beta is zero, y need
+	 *               not be initialized.
+	 * @param y      The output vector.
+	 */
+	template<typename T>
+	inline void gemv_t(int m, int n, T alpha, const T *a, int lda, const T *x, T beta, T *y)
+	{
+		_blas_scale(n, beta, y);
+		_gemv_t_cols<T, default_simd_kind>(m, 0, n, alpha, a, lda, x, y);
+	}
+
+	/**
+	 * Performs a rank-1 update, as A += alpha * x * y^T.
+	 *
+	 * @param m      The number of rows of A (the length of x).
+	 * @param n      The number of columns of A (the length of y).
+	 * @param alpha  The coefficient of x * y^T.
+	 * @param x      The left vector.
+	 * @param y      The right vector.
+	 * @param a      The base address of A.
+	 * @param lda    The offset between consecutive columns of A.
+	 */
+	template<typename T>
+	inline void ger(int m, int n, T alpha, const T *x, const T *y, T *a, int lda)
+	{
+		_ger_cols<T, default_simd_kind>(m, 0, n, alpha, x, y, a, lda);
+	}
+
+	/**
+	 * Multi-threaded version of gemv, where each thread takes
+	 * a block of rows.
+	 */
+	template<typename T>
+	inline void gemv_mt(int m, int n, T alpha, const T *a, int lda, const T *x, T beta, T *y)
+	{
+		const int bs = blas_blocking<T>::mt_rows;
+		const int nb = (m + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(blas_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i0 = b * bs;
+			const int i1 = i0 + bs < m ? i0 + bs : m;
+
+			_blas_scale(i1 - i0, beta, y + i0);
+			_gemv_n_rows<T, default_simd_kind>(i0, i1, n, alpha, a, lda, x, y);
+		}
+	}
+
+	/**
+	 * Multi-threaded version of gemv_t, where each thread takes
+	 * a block of columns.
+	 */
+	template<typename T>
+	inline void gemv_t_mt(int m, int n, T alpha, const T *a, int lda, const T *x, T beta, T *y)
+	{
+		const int bs = blas_blocking<T>::mt_cols;
+		const int nb = (n + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(blas_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int j0 = b * bs;
+			const int j1 = j0 + bs < n ? j0 + bs : n;
+
+			_blas_scale(j1 - j0, beta, y + j0);
+			_gemv_t_cols<T, default_simd_kind>(m, j0, j1, alpha, a, lda, x, y);
+		}
+	}
+
+	/**
+	 * Multi-threaded version of ger, where each thread takes
+	 * a block of columns.
+	 */
+	template<typename T>
+	inline void ger_mt(int m, int n, T alpha, const T *x, const T *y, T *a, int lda)
+	{
+		const int bs = blas_blocking<T>::mt_cols;
+		const int nb = (n + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(blas_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int j0 = b * bs;
+			const int j1 = j0 + bs < n ? j0 + bs : n;
+
+			_ger_cols<T, default_simd_kind>(m, j0, j1, alpha, x, y, a, lda);
+		}
+	}
+
+	/** @} */ // blas_generic
+
+}
+
+#endif /* SIMD_BLAS_H_ */
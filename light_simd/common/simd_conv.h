@@ -0,0 +1,385 @@
+/**
+ * @file simd_conv.h
+ *
+ * @brief FIR filters and 1-D convolution
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_CONV_H_
+#define LSIMD_SIMD_CONV_H_
+
+#include "simd_pack.h"
+#include "simd_arith.h"
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup conv_generic FIR Filters and Convolution
+	 * @ingroup  signal_module
+	 *
+	 * @brief FIR filtering and 1-D convolution of arrays.
+	 *
+	 * A filter of k taps h[0], ..., h[k-1] produces
+	 * y[i] = h[0] * x[i] + h[1] * x[i-1] + ... + h[k-1] * x[i-k+1].
+	 *
+	 * Each pass computes four packs of consecutive outputs at once, so
+	 * that every tap, broadcast to a pack (with bsx from a pack of taps),
+	 * is used by four multiply-adds. For 3, 5 and 7 taps, the taps are
+	 * broadcast once and kept in registers throughout (see fir<K>).
+	 *
+	 * Neither the signals nor the taps need to be aligned.
+	 */
+	/** @{ */
+
+	/**
+	 * The tag of a convolution that only keeps the outputs for which
+	 * all the taps meet the signal, i.e. n - k + 1 of them.
+	 */
+	struct conv_valid_t { };
+
+	/**
+	 * The tag of a convolution that keeps n outputs (as many as
+	 * the samples), centered on the full one.
+	 *
+	 * @remark  This agrees with the "same" mode of numpy.convolve
+	 *          only when n >= k, since numpy keeps max(n, k) outputs.
+	 */
+	struct conv_same_t { };
+
+	/**
+	 * The tag of a convolution that keeps all the n + k - 1 outputs,
+	 * with zeros beyond the ends of the signal.
+	 */
+	struct conv_full_t { };
+
+
+	// a0 .. a3 += (reversed taps in t) * x[j + I], for I < W
+
+	template<int I, int W>
+	struct _fir_lanes
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind>& t, const T *x,
+				simd_pack<T, Kind>& a0, simd_pack<T, Kind>& a1,
+				simd_pack<T, Kind>& a2, simd_pack<T, Kind>& a3)
+		{
+			typedef simd_pack<T, Kind> pack_t;
+			const pack_t g = t.template bsx<W - 1 - I>();
+
+			a0 = fmadd(g, pack_t(x + I, unaligned_t()), a0);
+			a1 = fmadd(g, pack_t(x + I + W, unaligned_t()), a1);
+			a2 = fmadd(g, pack_t(x + I + 2 * W, unaligned_t()), a2);
+			a3 = fmadd(g, pack_t(x + I + 3 * W, unaligned_t()), a3);
+
+			_fir_lanes<I + 1, W>::run(t, x, a0, a1, a2, a3);
+		}
+	};
+
+	template<int W>
+	struct _fir_lanes<W, W>
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind>&, const T *,
+				simd_pack<T, Kind>&, simd_pack<T, Kind>&,
+				simd_pack<T, Kind>&, simd_pack<T, Kind>&)
+		{ }
+	};
+
+	// a0 .. a3 += g[J] * x[J], for J < K
+
+	template<int J, int K>
+	struct _fir_fixed_taps
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind> *g, const T *x,
+				simd_pack<T, Kind>& a0, simd_pack<T, Kind>& a1,
+				simd_pack<T, Kind>& a2, simd_pack<T, Kind>& a3)
+		{
+			typedef simd_pack<T, Kind> pack_t;
+			const int W = (int)simd<T, Kind>::pack_width;
+
+			a0 = fmadd(g[J], pack_t(x + J, unaligned_t()), a0);
+			a1 = fmadd(g[J], pack_t(x + J + W, unaligned_t()), a1);
+			a2 = fmadd(g[J], pack_t(x + J + 2 * W, unaligned_t()), a2);
+			a3 = fmadd(g[J], pack_t(x + J + 3 * W, unaligned_t()), a3);
+
+			_fir_fixed_taps<J + 1, K>::run(g, x, a0, a1, a2, a3);
+		}
+
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind> *g, const T *x, simd_pack<T, Kind>& a)
+		{
+			a = fmadd(g[J], simd_pack<T, Kind>(x + J, unaligned_t()), a);
+			_fir_fixed_taps<J + 1, K>::run(g, x, a);
+		}
+	};
+
+	template<int K>
+	struct _fir_fixed_taps<K, K>
+	{
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind> *, const T *,
+				simd_pack<T, Kind>&, simd_pack<T, Kind>&,
+				simd_pack<T, Kind>&, simd_pack<T, Kind>&)
+		{ }
+
+		template<typename T, typename Kind>
+		LSIMD_ENSURE_INLINE
+		static void run(const simd_pack<T, Kind> *, const T *, simd_pack<T, Kind>&)
+		{ }
+	};
+
+
+	/**
+	 * Applies a FIR filter with a number of taps fixed at compile time.
+	 *
+	 * @tparam K    The number of taps.
+	 * @param n     The number of outputs.
+	 * @param x     The input signal, of n + K - 1 samples. The output y[i]
+	 *              is aligned with x[i + K - 1], i.e. the first K - 1 samples
+	 *              are the history before the first output.
+	 * @param h     The taps.
+	 * @param y     The output array.
+	 */
+	template<int K, typename T>
+	inline void fir(int n, const T *x, const T *h, T *y)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<T, kind_t> pack_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+
+		pack_t g[K];
+		for (int j = 0; j < K; ++j) g[j] = pack_t(h[K - 1 - j]);
+
+		int i = 0;
+		for (; i + 4 * W <= n; i += 4 * W)
+		{
+			pack_t a0 = zero_t();
+			pack_t a1 = zero_t();
+			pack_t a2 = zero_t();
+			pack_t a3 = zero_t();
+
+			_fir_fixed_taps<0, K>::run(g, x + i, a0, a1, a2, a3);
+
+			a0.store(y + i, unaligned_t());
+			a1.store(y + i + W, unaligned_t());
+			a2.store(y + i + 2 * W, unaligned_t());
+			a3.store(y + i + 3 * W, unaligned_t());
+		}
+
+		for (; i + W <= n; i += W)
+		{
+			pack_t a = zero_t();
+			_fir_fixed_taps<0, K>::run(g, x + i, a);
+			a.store(y + i, unaligned_t());
+		}
+
+		for (; i < n; ++i)
+		{
+			T s(0);
+			for (int j = 0; j < K; ++j) s += h[K - 1 - j] * x[i + j];
+			y[i] = s;
+		}
+	}
+
+
+	/**
+	 * Applies a FIR filter.
+	 *
+	 * @param n     The number of outputs.
+	 * @param x     The input signal, of n + k - 1 samples. The output y[i]
+	 *              is aligned with x[i + k - 1], i.e. the first k - 1 samples
+	 *              are the history before the first output.
+	 * @param h     The taps.
+	 * @param k     The number of taps (k >= 1).
+	 * @param y     The output array.
+	 *
+	 * @remark      Filters of 3, 5 and 7 taps are dispatched to fir<K>.
+	 */
+	template<typename T>
+	inline void fir(int n, const T *x, const T *h, int k, T *y)
+	{
+		switch (k)
+		{
+		case 3: fir<3>(n, x, h, y); return;
+		case 5: fir<5>(n, x, h, y); return;
+		case 7: fir<7>(n, x, h, y); return;
+		}
+
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<T, kind_t> pack_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+
+		const int kv = k - k % W;
+
+		int i = 0;
+		for (; i + 4 * W <= n; i += 4 * W)
+		{
+			const T *xi = x + i;
+
+			pack_t a0 = zero_t();
+			pack_t a1 = zero_t();
+			pack_t a2 = zero_t();
+			pack_t a3 = zero_t();
+
+			// taps h[k-j-W] .. h[k-j-1] apply to x[i+j+W-1] .. x[i+j]
+
+			int j = 0;
+			for (; j < kv; j += W)
+			{
+				_fir_lanes<0, W>::run(pack_t(h + (k - j - W), unaligned_t()), xi + j, a0, a1, a2, a3);
+			}
+
+			for (; j < k; ++j)
+			{
+				const pack_t g(h[k - 1 - j]);
+				a0 = fmadd(g, pack_t(xi + j, unaligned_t()), a0);
+				a1 = fmadd(g, pack_t(xi + j + W, unaligned_t()), a1);
+				a2 = fmadd(g, pack_t(xi + j + 2 * W, unaligned_t()), a2);
+				a3 = fmadd(g, pack_t(xi + j + 3 * W, unaligned_t()), a3);
+			}
+
+			a0.store(y + i, unaligned_t());
+			a1.store(y + i + W, unaligned_t());
+			a2.store(y + i + 2 * W, unaligned_t());
+			a3.store(y + i + 3 * W, unaligned_t());
+		}
+
+		for (; i + W <= n; i += W)
+		{
+			pack_t a = zero_t();
+			for (int j = 0; j < k; ++j)
+			{
+				a = fmadd(pack_t(h[k - 1 - j]), pack_t(x + i + j, unaligned_t()), a);
+			}
+			a.store(y + i, unaligned_t());
+		}
+
+		for (; i < n; ++i)
+		{
+			T s(0);
+			for (int j = 0; j < k; ++j) s += h[k - 1 - j] * x[i + j];
+			y[i] = s;
+		}
+	}
+
+
+	// the outputs lo <= i < hi of the full convolution, to y[i - lo]
+
+	template<typename T>
+	inline void _conv1d_range(int n, const T *x, const T *h, int k, T *y, int lo, int hi)
+	{
+		// the outputs k - 1 <= i < n are covered by all the taps
+
+		const int vb = lo > k - 1 ? lo : k - 1;
+		const int ve = hi < n ? hi : n;
+
+		for (int i = lo; i < hi; ++i)
+		{
+			if (i == vb && vb < ve)
+			{
+				fir(ve - vb, x + (vb - (k - 1)), h, k, y + (vb - lo));
+				i = ve - 1;
+				continue;
+			}
+
+			const int j0 = i - n + 1 > 0 ? i - n + 1 : 0;
+			const int j1 = i + 1 < k ? i + 1 : k;
+
+			T s(0);
+			for (int j = j0; j < j1; ++j) s += h[j] * x[i - j];
+			y[i - lo] = s;
+		}
+	}
+
+	/**
+	 * Computes the convolution of a signal and a filter, keeping the
+	 * n - k + 1 outputs covered by the whole filter (none if n < k).
+	 *
+	 * @param n     The number of samples.
+	 * @param x     The input signal.
+	 * @param h     The taps.
+	 * @param k     The number of taps (k >= 1).
+	 * @param y     The output array.
+	 */
+	template<typename T>
+	inline void conv1d(int n, const T *x, const T *h, int k, T *y, conv_valid_t)
+	{
+		_conv1d_range(n, x, h, k, y, k - 1, n);
+	}
+
+	/**
+	 * Computes the convolution of a signal and a filter, keeping the
+	 * n outputs centered on the full convolution, i.e. the outputs
+	 * (k - 1) / 2, ..., (k - 1) / 2 + n - 1 of it.
+	 *
+	 * There are always n outputs, also when n < k (in which case
+	 * they do not cover the middle of the full convolution).
+	 *
+	 * @param n     The number of samples.
+	 * @param x     The input signal.
+	 * @param h     The taps.
+	 * @param k     The number of taps (k >= 1).
+	 * @param y     The output array.
+	 */
+	template<typename T>
+	inline void conv1d(int n, const T *x, const T *h, int k, T *y, conv_same_t)
+	{
+		const int c = (k - 1) / 2;
+		_conv1d_range(n, x, h, k, y, c, c + n);
+	}
+
+	/**
+	 * Computes the full convolution of a signal and a filter, of
+	 * n + k - 1 outputs.
+	 *
+	 * @param n     The number of samples.
+	 * @param x     The input signal.
+	 * @param h     The taps.
+	 * @param k     The number of taps (k >= 1).
+	 * @param y     The output array.
+	 */
+	template<typename T>
+	inline void conv1d(int n, const T *x, const T *h, int k, T *y, conv_full_t)
+	{
+		_conv1d_range(n, x, h, k, y, 0, n + k - 1);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_CONV_H_ */
@@ -0,0 +1,702 @@
+/**
+ * @file simd_cpack.h
+ *
+ * @brief SIMD-based complex pack classes
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_CPACK_H_
+#define LSIMD_SIMD_CPACK_H_
+
+#include "simd_arith.h"
+#include <light_simd/sse/sse_cpack.h>
+#include <complex>
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup complex_generic Generic Complex Packs
+	 * @ingroup packs
+	 *
+	 * @brief Packs of complex numbers.
+	 *
+	 * lsimd::simd_cpack holds complex numbers interleaved as (re, im)
+	 * pairs, which is the layout of std::complex arrays, while
+	 * lsimd::simd_cpack_soa holds the real and imaginary parts in
+	 * separate packs.
+	 */
+	/** @{ */
+
+	template<typename T, typename Kind>
+	struct simd_cpack_traits;
+
+	template<typename T>
+	struct simd_cpack_traits<T, sse_kind>
+	{
+		typedef sse_cpack<T> impl_type;
+	};
+
+
+	/**
+	 * @brief Generic pack of interleaved complex numbers.
+	 *
+	 * @tparam T    The type of real and imaginary parts.
+	 */
+	template<typename T, typename Kind>
+	struct simd_cpack
+	{
+		/**
+		 * The type of real and imaginary parts.
+		 */
+		typedef T value_type;
+
+		/**
+		 * The complex number type.
+		 */
+		typedef std::complex<T> complex_type;
+
+		/**
+		 * The architecture-specific type that provides the internal
+		 * implementation.
+		 */
+		typedef typename simd_cpack_traits<T, Kind>::impl_type impl_type;
+
+		/**
+		 * The corresponding SIMD pack type.
+		 */
+		typedef simd_pack<T, Kind> pack_type;
+
+		/**
+		 * The number of complex numbers in a pack.
+		 */
+		static const unsigned int count = impl_type::count;
+
+		/**
+		 * The variable that actually implements the functionalities.
+		 */
+		impl_type impl;
+
+
+		/**
+		 * Default constructor.
+		 *
+		 * All entries are left uninitialized.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack() { }
+
+		/**
+		 * Constructs a pack with all entries initialized to zeros.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack( zero_t ) : impl( zero_t() ) { }
+
+		/**
+		 * Constructs a pack using the internal implementation.
+		 *
+		 * @param imp    The internal implementation.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack( const impl_type& imp ) : impl(imp) { }
+
+		/**
+		 * Constructs a pack with all complex numbers set to re + im * i.
+		 *
+		 * @param re   The real part.
+		 * @param im   The imaginary part.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack(const T re, const T im) : impl(re, im) { }
+
+		/**
+		 * Constructs a pack with all complex numbers set to c.
+		 *
+		 * @param c    The complex value.
+		 */
+		LSIMD_ENSURE_INLINE
+		explicit simd_cpack(const complex_type& c) : impl(c.real(), c.imag()) { }
+
+		/**
+		 * Constructs a pack by loading interleaved (re, im) pairs.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		simd_cpack(const T *a, AlignT) : impl(a, AlignT()) { }
+
+		/**
+		 * Constructs a pack by loading from an array of complex numbers.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		simd_cpack(const complex_type *a, AlignT)
+		: impl(reinterpret_cast<const T*>(a), AlignT()) { }
+
+		/**
+		 * Loads interleaved (re, im) pairs.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void load(const T *a, AlignT)
+		{
+			impl.load(a, AlignT());
+		}
+
+		/**
+		 * Loads from an array of complex numbers.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void load(const complex_type *a, AlignT)
+		{
+			impl.load(reinterpret_cast<const T*>(a), AlignT());
+		}
+
+		/**
+		 * Stores as interleaved (re, im) pairs.
+		 *
+		 * @param a    The memory address to which the values are stored.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void store(T *a, AlignT) const
+		{
+			impl.store(a, AlignT());
+		}
+
+		/**
+		 * Stores to an array of complex numbers.
+		 *
+		 * @param a    The memory address to which the values are stored.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void store(complex_type *a, AlignT) const
+		{
+			impl.store(reinterpret_cast<T*>(a), AlignT());
+		}
+
+		/**
+		 * Stores the I-th complex number in the pack.
+		 *
+		 * @tparam I   The index of the complex number (less than count).
+		 * @param a    The address to which (re, im) is stored.
+		 */
+		template<int I>
+		LSIMD_ENSURE_INLINE
+		void store_entry(T *a) const
+		{
+			impl.template store_entry<I>(a);
+		}
+
+		/**
+		 * Gets the I-th complex numbers of this pack and another,
+		 * as a pack of two (available when count is 2).
+		 *
+		 * @tparam I   The index of the complex numbers (0 or 1).
+		 * @param r    The pack that gives the second complex number.
+		 */
+		template<int I>
+		LSIMD_ENSURE_INLINE
+		simd_cpack pair(const simd_cpack& r) const
+		{
+			return impl.template pair<I>(r.impl);
+		}
+
+
+		/**
+		 * Adds two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack operator + (const simd_cpack& r) const
+		{
+			return impl + r.impl;
+		}
+
+		/**
+		 * Subtracts two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack operator - (const simd_cpack& r) const
+		{
+			return impl - r.impl;
+		}
+
+		/**
+		 * Negates all entries.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack operator - () const
+		{
+			return -impl;
+		}
+
+		/**
+		 * Multiplies the real and imaginary parts with real scales.
+		 *
+		 * @param s    A pack of scales, e.g. filled with the same value,
+		 *             or as returned by abs2().
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack operator * (const pack_type& s) const
+		{
+			return impl * s.impl;
+		}
+
+		/**
+		 * Multiplies two packs of complex numbers pair-wisely.
+		 *
+		 * @remark     This uses the ADDSUB instructions when SSE3
+		 *             is available, and FMADDSUB with FMA.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack operator * (const simd_cpack& r) const
+		{
+			return impl * r.impl;
+		}
+
+		/**
+		 * Multiplies with complex numbers given by their real and
+		 * imaginary parts, each replicated in the (re, im) slots of
+		 * the corresponding entry (e.g. re = (r0, r0, r1, r1)).
+		 *
+		 * @remark     This takes fewer shuffles than the product of two
+		 *             packs, and is meant for multipliers that are used
+		 *             repeatedly, such as the twiddle factors of FFTs.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack mul_dup(const pack_type& re, const pack_type& im) const
+		{
+			return impl.mul_dup(re.impl, im.impl);
+		}
+
+		/**
+		 * Gets the conjugates.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack conj() const
+		{
+			return impl.conj();
+		}
+
+		/**
+		 * Gets the complex numbers in reverse order.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack reverse() const
+		{
+			return impl.reverse();
+		}
+
+		/**
+		 * Multiplies with the conjugates of another pack, as this * conj(r).
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack mul_conj(const simd_cpack& r) const
+		{
+			return impl.mul_conj(r.impl);
+		}
+
+		/**
+		 * Multiplies with the imaginary unit, i.e. (re, im) -> (-im, re).
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack mul_i() const
+		{
+			return impl.mul_i();
+		}
+
+		/**
+		 * Gets the squared magnitudes.
+		 *
+		 * @return     A pack in which the squared magnitude of each
+		 *             complex number is at both of its (re, im) entries.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type abs2() const
+		{
+			return impl.abs2();
+		}
+
+		/**
+		 * Gets the magnitudes.
+		 *
+		 * @return     A pack in which the magnitude of each complex
+		 *             number is at both of its (re, im) entries.
+		 *
+		 * @remark     This is computed as sqrt(abs2()), which (unlike
+		 *             std::abs) may overflow for very large entries.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type abs() const
+		{
+			return impl.abs();
+		}
+
+		/**
+		 * Gets the sum of all complex numbers in the pack.
+		 */
+		LSIMD_ENSURE_INLINE
+		complex_type sum() const
+		{
+			return impl.sum();
+		}
+	};
+
+
+	/**
+	 * @brief A pack of complex numbers with split real and imaginary parts.
+	 *
+	 * Each member holds one part of pack_width complex numbers, such
+	 * that the complex arithmetic becomes plain entry-wise pack
+	 * arithmetic, without any shuffling.
+	 *
+	 * @tparam T    The type of real and imaginary parts.
+	 */
+	template<typename T, typename Kind=default_simd_kind>
+	struct simd_cpack_soa
+	{
+		/**
+		 * The pack type of each part.
+		 */
+		typedef simd_pack<T, Kind> pack_type;
+
+		pack_type re;	///< The real parts.
+		pack_type im;	///< The imaginary parts.
+
+		/**
+		 * Default constructor.
+		 *
+		 * All entries are left uninitialized.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa() { }
+
+		/**
+		 * Constructs from the real and imaginary packs.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa(const pack_type& re_, const pack_type& im_)
+		: re(re_), im(im_) { }
+
+		/**
+		 * Constructs by loading the real and imaginary parts.
+		 *
+		 * @param pr    The address of the real parts.
+		 * @param pi    The address of the imaginary parts.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa(const T *pr, const T *pi, AlignT)
+		: re(pr, AlignT()), im(pi, AlignT()) { }
+
+		/**
+		 * Loads the real and imaginary parts.
+		 *
+		 * @param pr    The address of the real parts.
+		 * @param pi    The address of the imaginary parts.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void load(const T *pr, const T *pi, AlignT)
+		{
+			re.load(pr, AlignT());
+			im.load(pi, AlignT());
+		}
+
+		/**
+		 * Stores the real and imaginary parts.
+		 *
+		 * @param pr    The address of the real parts.
+		 * @param pi    The address of the imaginary parts.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void store(T *pr, T *pi, AlignT) const
+		{
+			re.store(pr, AlignT());
+			im.store(pi, AlignT());
+		}
+
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa operator + (const simd_cpack_soa& r) const
+		{
+			return simd_cpack_soa(re + r.re, im + r.im);
+		}
+
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa operator - (const simd_cpack_soa& r) const
+		{
+			return simd_cpack_soa(re - r.re, im - r.im);
+		}
+
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa operator - () const
+		{
+			return simd_cpack_soa(-re, -im);
+		}
+
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa operator * (const pack_type& s) const
+		{
+			return simd_cpack_soa(re * s, im * s);
+		}
+
+		/**
+		 * Multiplies the complex numbers pair-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa operator * (const simd_cpack_soa& r) const
+		{
+			return simd_cpack_soa(
+					fnmadd(im, r.im, re * r.re),
+					fmadd(re, r.im, im * r.re));
+		}
+
+		/**
+		 * Gets the conjugates.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa conj() const
+		{
+			return simd_cpack_soa(re, -im);
+		}
+
+		/**
+		 * Multiplies with the imaginary unit.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa mul_i() const
+		{
+			return simd_cpack_soa(-im, re);
+		}
+
+		/**
+		 * Multiplies with the conjugates of another pack, as this * conj(r).
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_cpack_soa mul_conj(const simd_cpack_soa& r) const
+		{
+			return simd_cpack_soa(
+					fmadd(re, r.re, im * r.im),
+					fnmadd(re, r.im, im * r.re));
+		}
+
+		/**
+		 * Gets the squared magnitudes.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type abs2() const
+		{
+			return fmadd(re, re, im * im);
+		}
+
+		/**
+		 * Gets the magnitudes, as sqrt(abs2()).
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type abs() const
+		{
+			return sqrt(abs2());
+		}
+	};
+
+	/** @} */ // complex_generic
+
+
+	/**
+	 * \defgroup complex_array Complex Array Functions
+	 * @ingroup  packs
+	 *
+	 * @brief Functions that act on large arrays of complex numbers.
+	 *
+	 * Each function comes in two forms: one for interleaved arrays of
+	 * std::complex, and one for split arrays, where the real and the
+	 * imaginary parts are in separate arrays of T. The arrays need not
+	 * be aligned.
+	 */
+	/** @{ */
+
+	template<typename T>
+	LSIMD_ENSURE_INLINE
+	inline std::complex<T> _cmul(const std::complex<T>& a, const std::complex<T>& b)
+	{
+		// the textbook formula, as in the SIMD path (std::complex
+		// multiplication may check for infinities and NaNs)
+
+		return std::complex<T>(
+				a.real() * b.real() - a.imag() * b.imag(),
+				a.real() * b.imag() + a.imag() * b.real());
+	}
+
+	/**
+	 * Multiplies two arrays of complex numbers, as r[i] = a[i] * b[i].
+	 *
+	 * @param n     The number of complex numbers.
+	 * @param a     The left hand side array.
+	 * @param b     The right hand side array.
+	 * @param r     The results (can be a or b).
+	 */
+	template<typename T>
+	inline void cmul(int n, const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *r)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_cpack<T, kind_t> cpack_t;
+		const int C = (int)cpack_t::count;
+		const int m = n - n % C;
+
+		for (int i = 0; i < m; i += C)
+		{
+			cpack_t ca(a + i, unaligned_t());
+			cpack_t cb(b + i, unaligned_t());
+			(ca * cb).store(r + i, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			r[i] = _cmul(a[i], b[i]);
+		}
+	}
+
+	/**
+	 * Multiplies and accumulates two arrays of complex numbers,
+	 * as r[i] += a[i] * b[i].
+	 *
+	 * @param n     The number of complex numbers.
+	 * @param a     The left hand side array.
+	 * @param b     The right hand side array.
+	 * @param r     The accumulators.
+	 */
+	template<typename T>
+	inline void cmac(int n, const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *r)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_cpack<T, kind_t> cpack_t;
+		const int C = (int)cpack_t::count;
+		const int m = n - n % C;
+
+		for (int i = 0; i < m; i += C)
+		{
+			cpack_t ca(a + i, unaligned_t());
+			cpack_t cb(b + i, unaligned_t());
+			cpack_t cr(r + i, unaligned_t());
+			(cr + ca * cb).store(r + i, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			r[i] += _cmul(a[i], b[i]);
+		}
+	}
+
+	/**
+	 * Multiplies two split arrays of complex numbers, as r[i] = a[i] * b[i].
+	 *
+	 * @param n          The number of complex numbers.
+	 * @param are, aim   The real and imaginary parts of the left hand side.
+	 * @param bre, bim   The real and imaginary parts of the right hand side.
+	 * @param rre, rim   The real and imaginary parts of the results.
+	 */
+	template<typename T>
+	inline void cmul(int n, const T *are, const T *aim, const T *bre, const T *bim, T *rre, T *rim)
+	{
+		typedef default_simd_kind kind_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_cpack_soa<T, kind_t> ca(are + i, aim + i, unaligned_t());
+			simd_cpack_soa<T, kind_t> cb(bre + i, bim + i, unaligned_t());
+			(ca * cb).store(rre + i, rim + i, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			const T ar = are[i], ai = aim[i];
+			const T br = bre[i], bi = bim[i];
+			rre[i] = ar * br - ai * bi;
+			rim[i] = ar * bi + ai * br;
+		}
+	}
+
+	/**
+	 * Multiplies and accumulates two split arrays of complex numbers,
+	 * as r[i] += a[i] * b[i].
+	 *
+	 * @param n          The number of complex numbers.
+	 * @param are, aim   The real and imaginary parts of the left hand side.
+	 * @param bre, bim   The real and imaginary parts of the right hand side.
+	 * @param rre, rim   The real and imaginary parts of the accumulators.
+	 */
+	template<typename T>
+	inline void cmac(int n, const T *are, const T *aim, const T *bre, const T *bim, T *rre, T *rim)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<T, kind_t> pack_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			pack_t ar(are + i, unaligned_t());
+			pack_t ai(aim + i, unaligned_t());
+			pack_t br(bre + i, unaligned_t());
+			pack_t bi(bim + i, unaligned_t());
+
+			pack_t cr(rre + i, unaligned_t());
+			pack_t ci(rim + i, unaligned_t());
+
+			fnmadd(ai, bi, fmadd(ar, br, cr)).store(rre + i, unaligned_t());
+			fmadd(ai, br, fmadd(ar, bi, ci)).store(rim + i, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			const T ar = are[i], ai = aim[i];
+			const T br = bre[i], bi = bim[i];
+			rre[i] += ar * br - ai * bi;
+			rim[i] += ar * bi + ai * br;
+		}
+	}
+
+	/** @} */ // complex_array
+}
+
+#endif /* LSIMD_SIMD_CPACK_H_ */
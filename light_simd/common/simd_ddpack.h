@@ -0,0 +1,431 @@
+/**
+ * @file simd_ddpack.h
+ *
+ * @brief SIMD-based double-double pack classes
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_DDPACK_H_
+#define LSIMD_SIMD_DDPACK_H_
+
+#include "simd_arith.h"
+#include "simd_sum.h"
+#include <light_simd/sse/sse_ddpack.h>
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup dd_generic Generic Double-Double Packs
+	 * @ingroup packs
+	 *
+	 * @brief Packs of double-double numbers, for extended precision.
+	 *
+	 * lsimd::dd_pack represents each entry as the unevaluated sum of
+	 * a high and a low f64 part, which gives about 32 significant
+	 * decimal digits at a small multiple of the cost of f64
+	 * arithmetic (see \ref dd_sse).
+	 */
+	/** @{ */
+
+	template<typename Kind>
+	struct dd_pack_traits;
+
+	template<>
+	struct dd_pack_traits<sse_kind>
+	{
+		typedef sse_ddpack impl_type;
+	};
+
+
+	/**
+	 * @brief Generic pack of double-double numbers.
+	 */
+	template<typename Kind=default_simd_kind>
+	struct dd_pack
+	{
+		/**
+		 * The architecture-specific type that provides the internal
+		 * implementation.
+		 */
+		typedef typename dd_pack_traits<Kind>::impl_type impl_type;
+
+		/**
+		 * The pack type of the high and the low parts.
+		 */
+		typedef simd_pack<f64, Kind> pack_type;
+
+		/**
+		 * The number of double-double numbers in a pack.
+		 */
+		static const unsigned int count = impl_type::count;
+
+		/**
+		 * The variable that actually implements the functionalities.
+		 */
+		impl_type impl;
+
+
+		/**
+		 * Default constructor.
+		 *
+		 * All entries are left uninitialized.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack() { }
+
+		/**
+		 * Constructs a pack with all entries initialized to zeros.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack( zero_t ) : impl( zero_t() ) { }
+
+		/**
+		 * Constructs a pack using the internal implementation.
+		 *
+		 * @param imp    The internal implementation.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack( const impl_type& imp ) : impl(imp) { }
+
+		/**
+		 * Constructs a pack with all entries set to x.
+		 */
+		LSIMD_ENSURE_INLINE
+		explicit dd_pack(const f64 x) : impl(x) { }
+
+		/**
+		 * Constructs a pack with all entries set to h + l.
+		 *
+		 * @remark  h + l must be normalized, i.e. h == fl(h + l).
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack(const f64 h, const f64 l) : impl(h, l) { }
+
+		/**
+		 * Constructs a pack from a pack of f64 values.
+		 */
+		LSIMD_ENSURE_INLINE
+		explicit dd_pack(const pack_type& h) : impl(h.impl) { }
+
+		/**
+		 * Constructs a pack from the high and the low parts.
+		 *
+		 * @remark  The parts must be normalized, as with
+		 *          dd_pack(f64, f64).
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack(const pack_type& h, const pack_type& l) : impl(h.impl, l.impl) { }
+
+		/**
+		 * Constructs a pack by loading f64 values (with zero low parts).
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		dd_pack(const f64 *a, AlignT) : impl(a, AlignT()) { }
+
+		/**
+		 * Loads f64 values (with zero low parts).
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void load(const f64 *a, AlignT)
+		{
+			impl.load(a, AlignT());
+		}
+
+		/**
+		 * Stores the entries rounded to f64 (i.e. the high parts).
+		 *
+		 * @param a    The memory address to which the values are stored.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void store(f64 *a, AlignT) const
+		{
+			impl.store(a, AlignT());
+		}
+
+		/**
+		 * Gets the high parts.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type hi() const
+		{
+			return impl.hi;
+		}
+
+		/**
+		 * Gets the low parts.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type lo() const
+		{
+			return impl.lo;
+		}
+
+
+		/**
+		 * Adds two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator + (const dd_pack& r) const
+		{
+			return impl + r.impl;
+		}
+
+		/**
+		 * Adds a pack of f64 values entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator + (const pack_type& r) const
+		{
+			return impl + r.impl;
+		}
+
+		/**
+		 * Subtracts two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator - (const dd_pack& r) const
+		{
+			return impl - r.impl;
+		}
+
+		/**
+		 * Subtracts a pack of f64 values entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator - (const pack_type& r) const
+		{
+			return impl - r.impl;
+		}
+
+		/**
+		 * Negates all entries.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator - () const
+		{
+			return -impl;
+		}
+
+		/**
+		 * Multiplies two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator * (const dd_pack& r) const
+		{
+			return impl * r.impl;
+		}
+
+		/**
+		 * Multiplies with a pack of f64 values entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator * (const pack_type& r) const
+		{
+			return impl * r.impl;
+		}
+
+		/**
+		 * Divides two packs entry-wisely.
+		 */
+		LSIMD_ENSURE_INLINE
+		dd_pack operator / (const dd_pack& r) const
+		{
+			return impl / r.impl;
+		}
+
+		/**
+		 * Gets the sum of all entries, rounded to f64.
+		 */
+		LSIMD_ENSURE_INLINE
+		f64 sum() const
+		{
+			return impl.sum();
+		}
+
+		/**
+		 * Gets the sum of all entries, as h + l.
+		 */
+		LSIMD_ENSURE_INLINE
+		void sum(f64& h, f64& l) const
+		{
+			impl.sum(h, l);
+		}
+	};
+
+
+	/**
+	 * Calculates the square roots of double-double numbers.
+	 *
+	 * @param a  The input pack (of non-negative entries).
+	 *
+	 * @return   The resultant pack, as sqrt(a).
+	 */
+	template<typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline dd_pack<Kind> sqrt(const dd_pack<Kind>& a)
+	{
+		return sqrt(a.impl);
+	}
+
+	/** @} */
+
+
+	/**
+	 * @defgroup dd_array Double-Double Reductions
+	 * @ingroup stats_module
+	 *
+	 * @brief Sums and dot products of f64 arrays, accumulated in
+	 *        double-double precision.
+	 *
+	 * The results are as accurate as if computed with about 106 bits
+	 * of significand and rounded at the end (barring underflow), so
+	 * they remain accurate for ill-conditioned inputs, for which the
+	 * compensated variants (see \ref sum_generic) lose accuracy once
+	 * the condition number approaches 10^32. The low part of the
+	 * result can also be retrieved, to continue in extended precision.
+	 */
+	/** @{ */
+
+	// reduces four accumulators to a scalar h + l
+
+	template<typename Kind>
+	inline f64 _dd_final(const dd_pack<Kind> *s, f64 *lo)
+	{
+		f64 h, l;
+		((s[0] + s[1]) + (s[2] + s[3])).sum(h, l);
+		if (lo) *lo = l;
+		return h;
+	}
+
+	/**
+	 * Computes the sum of an array in double-double precision.
+	 *
+	 * @param n    The number of entries.
+	 * @param x    The input array (need not be aligned).
+	 * @param lo   Where to store the low part of the sum (if not null).
+	 *
+	 * @return     The sum rounded to f64 (i.e. its high part).
+	 */
+	inline f64 dd_sum(int n, const f64 *x, f64 *lo = 0)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<f64, kind_t> pack_t;
+		typedef dd_pack<kind_t> ddpack_t;
+		const int w = (int)pack_t::pack_width;
+
+		ddpack_t s[4];
+		for (int k = 0; k < 4; ++k) s[k] = ddpack_t(zero_t());
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			s[0] = s[0] + pack_t(x + i, unaligned_t());
+			s[1] = s[1] + pack_t(x + i + w, unaligned_t());
+			s[2] = s[2] + pack_t(x + i + 2 * w, unaligned_t());
+			s[3] = s[3] + pack_t(x + i + 3 * w, unaligned_t());
+		}
+
+		if (i < n)
+		{
+			LSIMD_ALIGN_SSE f64 b[4 * 2];
+			_sum_pad(n - i, x + i, b, 4 * w);
+
+			for (int k = 0; k < 4; ++k)
+			{
+				s[k] = s[k] + pack_t(b + k * w, aligned_t());
+			}
+		}
+
+		return _dd_final(s, lo);
+	}
+
+	/**
+	 * Computes the dot product of two arrays in double-double precision.
+	 *
+	 * Each product is split exactly into a double-double number
+	 * (with FMA when LSIMD_HAS_FMA is defined), which is then added
+	 * to the accumulators.
+	 *
+	 * @param n    The number of entries.
+	 * @param x    The first array (need not be aligned).
+	 * @param y    The second array (need not be aligned).
+	 * @param lo   Where to store the low part of the result (if not null).
+	 *
+	 * @return     The dot product rounded to f64 (i.e. its high part).
+	 */
+	inline f64 dd_dot(int n, const f64 *x, const f64 *y, f64 *lo = 0)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<f64, kind_t> pack_t;
+		typedef dd_pack<kind_t> ddpack_t;
+		const int w = (int)pack_t::pack_width;
+
+		ddpack_t s[4];
+		for (int k = 0; k < 4; ++k) s[k] = ddpack_t(zero_t());
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			for (int k = 0; k < 4; ++k)
+			{
+				s[k] = s[k] + ddpack_t(pack_t(x + i + k * w, unaligned_t())) * pack_t(y + i + k * w, unaligned_t());
+			}
+		}
+
+		if (i < n)
+		{
+			LSIMD_ALIGN_SSE f64 a[4 * 2];
+			LSIMD_ALIGN_SSE f64 b[4 * 2];
+			_sum_pad(n - i, x + i, a, 4 * w);
+			_sum_pad(n - i, y + i, b, 4 * w);
+
+			for (int k = 0; k < 4; ++k)
+			{
+				s[k] = s[k] + ddpack_t(pack_t(a + k * w, aligned_t())) * pack_t(b + k * w, aligned_t());
+			}
+		}
+
+		return _dd_final(s, lo);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_DDPACK_H_ */
@@ -0,0 +1,607 @@
+/**
+ * @file simd_dist.h
+ *
+ * @brief Pairwise distances between sets of vectors.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_DIST_H_
+#define LSIMD_SIMD_DIST_H_
+
+#include "simd_pack.h"
+#include "simd_arith.h"
+#include <cmath>
+#include <vector>
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup dist_generic Pairwise Distances
+	 * @ingroup  linalg_module
+	 *
+	 * @brief Distance matrices between sets of d-dimensional vectors.
+	 *
+	 * A set of m vectors is stored as the rows of a row-major matrix,
+	 * with an offset ld (>= d) between the beginnings of consecutive
+	 * vectors, and so is the m x n matrix of distances, whose entry
+	 * (i, j) is at r[i * ldr + j].
+	 *
+	 * All the metrics are derived from the dot products x . y, which
+	 * are computed by a micro-kernel on 4 x 2 pairs of vectors at a
+	 * time (with 8 accumulators), on tiles of y that fit in L2 cache
+	 * (see dist_blocking), while the 4 vectors of x stay in L1. Each
+	 * tile of the output is then turned into distances, using the
+	 * per-vector quantities of the metric (see dist_norms), e.g. as
+	 * ||x||^2 + ||y||^2 - 2 x . y for the squared Euclidean distance.
+	 * These can be precomputed for a fixed set y and passed to cdist.
+	 *
+	 * Neither the vectors nor the matrices need to be aligned.
+	 */
+	/** @{ */
+
+	/**
+	 * The tag of the squared Euclidean distance ||x - y||^2.
+	 */
+	struct dist_sqeuclidean_t { };
+
+	/**
+	 * The tag of the Euclidean distance ||x - y||.
+	 */
+	struct dist_euclidean_t { };
+
+	/**
+	 * The tag of the cosine distance 1 - x . y / (||x|| ||y||), which
+	 * is 1 when either vector is zero.
+	 */
+	struct dist_cosine_t { };
+
+	/**
+	 * The tag of the dot product x . y (a similarity).
+	 */
+	struct dist_dot_t { };
+
+	/**
+	 * Blocking parameters of the distance routines.
+	 */
+	template<typename T>
+	struct dist_blocking
+	{
+		/**
+		 * The number of vectors of x per micro-kernel.
+		 */
+		static const int rows = 4;
+
+		/**
+		 * The number of vectors of y per micro-kernel.
+		 */
+		static const int cols = 2;
+
+		/**
+		 * The size (in bytes) of a tile of y (half of a 256 KB L2).
+		 */
+		static const int tile_bytes = 1 << 17;
+
+		/**
+		 * The minimum number of dot products for which cdist_mt
+		 * goes parallel.
+		 */
+		static const int mt_threshold = 1 << 14;
+
+		/**
+		 * The number of vectors in a tile of y of dimension d.
+		 */
+		static int tile_cols(int d)
+		{
+			int c = tile_bytes / ((d > 0 ? d : 1) * (int)sizeof(T));
+			c -= c % cols;
+			return c > cols ? c : cols;
+		}
+	};
+
+
+	template<typename T>
+	inline T _sqnorm(int d, const T *x)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t s0 = zero_t();
+		pack_t s1 = zero_t();
+
+		int k = 0;
+		for (; k + 2 * w <= d; k += 2 * w)
+		{
+			pack_t v0(x + k, unaligned_t());
+			pack_t v1(x + k + w, unaligned_t());
+			s0 = fmadd(v0, v0, s0);
+			s1 = fmadd(v1, v1, s1);
+		}
+
+		T s = (s0 + s1).sum();
+		for (; k < d; ++k) s += x[k] * x[k];
+		return s;
+	}
+
+	// the micro-kernels, as r(a, b) = x_a . y_b, with the accumulators
+	// written out, so that they all stay in registers
+
+	template<typename T>
+	inline T _dot_tail(int k, int d, const T *x, const T *y, T s)
+	{
+		for (; k < d; ++k) s += x[k] * y[k];
+		return s;
+	}
+
+	template<typename T>
+	inline void _dot_4x2(int d, const T *x, int ldx, const T *y, int ldy, T *r, int ldr)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int dv = d - d % w;
+
+		const T *x0 = x;
+		const T *x1 = x0 + ldx;
+		const T *x2 = x1 + ldx;
+		const T *x3 = x2 + ldx;
+		const T *y0 = y;
+		const T *y1 = y + ldy;
+
+		pack_t a00 = zero_t(), a01 = zero_t();
+		pack_t a10 = zero_t(), a11 = zero_t();
+		pack_t a20 = zero_t(), a21 = zero_t();
+		pack_t a30 = zero_t(), a31 = zero_t();
+
+		for (int k = 0; k < dv; k += w)
+		{
+			const pack_t v0(y0 + k, unaligned_t());
+			const pack_t v1(y1 + k, unaligned_t());
+			pack_t u;
+
+			u = pack_t(x0 + k, unaligned_t());
+			a00 = fmadd(u, v0, a00);
+			a01 = fmadd(u, v1, a01);
+
+			u = pack_t(x1 + k, unaligned_t());
+			a10 = fmadd(u, v0, a10);
+			a11 = fmadd(u, v1, a11);
+
+			u = pack_t(x2 + k, unaligned_t());
+			a20 = fmadd(u, v0, a20);
+			a21 = fmadd(u, v1, a21);
+
+			u = pack_t(x3 + k, unaligned_t());
+			a30 = fmadd(u, v0, a30);
+			a31 = fmadd(u, v1, a31);
+		}
+
+		r[0] = _dot_tail(dv, d, x0, y0, a00.sum());
+		r[1] = _dot_tail(dv, d, x0, y1, a01.sum());
+		r += ldr;
+		r[0] = _dot_tail(dv, d, x1, y0, a10.sum());
+		r[1] = _dot_tail(dv, d, x1, y1, a11.sum());
+		r += ldr;
+		r[0] = _dot_tail(dv, d, x2, y0, a20.sum());
+		r[1] = _dot_tail(dv, d, x2, y1, a21.sum());
+		r += ldr;
+		r[0] = _dot_tail(dv, d, x3, y0, a30.sum());
+		r[1] = _dot_tail(dv, d, x3, y1, a31.sum());
+	}
+
+	template<typename T>
+	inline void _dot_4x1(int d, const T *x, int ldx, const T *y, T *r, int ldr)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int dv = d - d % w;
+
+		const T *x0 = x;
+		const T *x1 = x0 + ldx;
+		const T *x2 = x1 + ldx;
+		const T *x3 = x2 + ldx;
+
+		pack_t a0 = zero_t(), a1 = zero_t(), a2 = zero_t(), a3 = zero_t();
+
+		for (int k = 0; k < dv; k += w)
+		{
+			const pack_t v(y + k, unaligned_t());
+			a0 = fmadd(pack_t(x0 + k, unaligned_t()), v, a0);
+			a1 = fmadd(pack_t(x1 + k, unaligned_t()), v, a1);
+			a2 = fmadd(pack_t(x2 + k, unaligned_t()), v, a2);
+			a3 = fmadd(pack_t(x3 + k, unaligned_t()), v, a3);
+		}
+
+		r[0] = _dot_tail(dv, d, x0, y, a0.sum());
+		r[ldr] = _dot_tail(dv, d, x1, y, a1.sum());
+		r[2 * ldr] = _dot_tail(dv, d, x2, y, a2.sum());
+		r[3 * ldr] = _dot_tail(dv, d, x3, y, a3.sum());
+	}
+
+	template<typename T>
+	inline void _dot_1x2(int d, const T *x, const T *y, int ldy, T *r)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int dv = d - d % w;
+
+		const T *y0 = y;
+		const T *y1 = y + ldy;
+
+		pack_t a0 = zero_t(), a1 = zero_t();
+
+		for (int k = 0; k < dv; k += w)
+		{
+			const pack_t u(x + k, unaligned_t());
+			a0 = fmadd(u, pack_t(y0 + k, unaligned_t()), a0);
+			a1 = fmadd(u, pack_t(y1 + k, unaligned_t()), a1);
+		}
+
+		r[0] = _dot_tail(dv, d, x, y0, a0.sum());
+		r[1] = _dot_tail(dv, d, x, y1, a1.sum());
+	}
+
+	template<typename T>
+	inline void _dot_1x1(int d, const T *x, const T *y, T *r)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int dv = d - d % w;
+
+		pack_t a0 = zero_t();
+		for (int k = 0; k < dv; k += w)
+		{
+			a0 = fmadd(pack_t(x + k, unaligned_t()), pack_t(y + k, unaligned_t()), a0);
+		}
+
+		r[0] = _dot_tail(dv, d, x, y, a0.sum());
+	}
+
+	// the dot products of 4 (or 1) vectors of x with the vectors
+	// [j0, j1) of y
+
+	template<typename T>
+	inline void _dot_rows4(int j0, int j1, int d, const T *x, int ldx, const T *y, int ldy, T *r, int ldr)
+	{
+		int j = j0;
+		for (; j + 2 <= j1; j += 2) _dot_4x2(d, x, ldx, y + j * ldy, ldy, r + j, ldr);
+		if (j < j1) _dot_4x1(d, x, ldx, y + j * ldy, r + j, ldr);
+	}
+
+	template<typename T>
+	inline void _dot_rows1(int j0, int j1, int d, const T *x, const T *y, int ldy, T *r)
+	{
+		int j = j0;
+		for (; j + 2 <= j1; j += 2) _dot_1x2(d, x, y + j * ldy, ldy, r + j);
+		if (j < j1) _dot_1x1(d, x, y + j * ldy, r + j);
+	}
+
+	// the per-vector quantities of the metrics
+
+	template<typename T>
+	inline T _dist_norm(int d, const T *x, dist_sqeuclidean_t)
+	{
+		return _sqnorm(d, x);
+	}
+
+	template<typename T>
+	inline T _dist_norm(int d, const T *x, dist_euclidean_t)
+	{
+		return _sqnorm(d, x);
+	}
+
+	template<typename T>
+	inline T _dist_norm(int d, const T *x, dist_cosine_t)
+	{
+		const T s = _sqnorm(d, x);
+		return s > T(0) ? T(1) / std::sqrt(s) : T(0);
+	}
+
+	template<typename T>
+	inline T _dist_norm(int d, const T *x, dist_dot_t)
+	{
+		return T(0);
+	}
+
+	// turns r[j] = x_i . y_j into distances, where a and b[j] are the
+	// per-vector quantities of x_i and y_j
+
+	template<typename T>
+	inline void _dist_finish(int n, T a, const T *b, T *r, dist_sqeuclidean_t)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t ap(a);
+		const pack_t z = zero_t();
+
+		int j = 0;
+		for (; j + w <= n; j += w)
+		{
+			const pack_t rv(r + j, unaligned_t());
+			vmax(ap + pack_t(b + j, unaligned_t()) - (rv + rv), z).store(r + j, unaligned_t());
+		}
+
+		for (; j < n; ++j)
+		{
+			const T v = a + b[j] - (r[j] + r[j]);
+			r[j] = v > T(0) ? v : T(0);
+		}
+	}
+
+	template<typename T>
+	inline void _dist_finish(int n, T a, const T *b, T *r, dist_euclidean_t)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t ap(a);
+		const pack_t z = zero_t();
+
+		int j = 0;
+		for (; j + w <= n; j += w)
+		{
+			const pack_t rv(r + j, unaligned_t());
+			sqrt(vmax(ap + pack_t(b + j, unaligned_t()) - (rv + rv), z)).store(r + j, unaligned_t());
+		}
+
+		for (; j < n; ++j)
+		{
+			const T v = a + b[j] - (r[j] + r[j]);
+			r[j] = v > T(0) ? std::sqrt(v) : T(0);
+		}
+	}
+
+	template<typename T>
+	inline void _dist_finish(int n, T a, const T *b, T *r, dist_cosine_t)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t ap(a);
+		const pack_t one(T(1));
+
+		int j = 0;
+		for (; j + w <= n; j += w)
+		{
+			const pack_t rv(r + j, unaligned_t());
+			fnmadd(rv * ap, pack_t(b + j, unaligned_t()), one).store(r + j, unaligned_t());
+		}
+
+		for (; j < n; ++j) r[j] = T(1) - r[j] * a * b[j];
+	}
+
+	template<typename T>
+	inline void _dist_finish(int n, T a, const T *b, T *r, dist_dot_t)
+	{
+	}
+
+	// the distance of a vector to itself
+
+	template<typename T>
+	inline T _dist_self(T a, T r, dist_sqeuclidean_t) { return T(0); }
+
+	template<typename T>
+	inline T _dist_self(T a, T r, dist_euclidean_t) { return T(0); }
+
+	template<typename T>
+	inline T _dist_self(T a, T r, dist_cosine_t) { return a > T(0) ? T(0) : T(1); }
+
+	template<typename T>
+	inline T _dist_self(T a, T r, dist_dot_t) { return r; }
+
+	// the distances between all vectors of x and the vectors [j0, j1) of y
+
+	template<typename T, typename Metric>
+	inline void _cdist_cols(int j0, int j1, int m, int d,
+			const T *x, int ldx, const T *nx, const T *y, int ldy, const T *ny,
+			T *r, int ldr, Metric)
+	{
+		const int mr = dist_blocking<T>::rows;
+		const int tc = dist_blocking<T>::tile_cols(d);
+
+		for (int jb = j0; jb < j1; jb += tc)
+		{
+			const int je = jb + tc < j1 ? jb + tc : j1;
+
+			int i = 0;
+			for (; i + mr <= m; i += mr)
+			{
+				_dot_rows4(jb, je, d, x + i * ldx, ldx, y, ldy, r + i * ldr, ldr);
+				for (int a = 0; a < mr; ++a)
+				{
+					_dist_finish(je - jb, nx[i + a], ny + jb, r + (i + a) * ldr + jb, Metric());
+				}
+			}
+
+			for (; i < m; ++i)
+			{
+				_dot_rows1(jb, je, d, x + i * ldx, y, ldy, r + i * ldr);
+				_dist_finish(je - jb, nx[i], ny + jb, r + i * ldr + jb, Metric());
+			}
+		}
+	}
+
+
+	/**
+	 * Computes the per-vector quantities that a metric needs, i.e.
+	 * the squared norms for the Euclidean metrics, the inverse norms
+	 * (or 0 for zero vectors) for the cosine distance, and zeros for
+	 * the dot product.
+	 *
+	 * @param n    The number of vectors.
+	 * @param d    The dimension.
+	 * @param x    The base address of the vectors.
+	 * @param ldx  The offset between consecutive vectors.
+	 * @param out  The output array (of length n).
+	 */
+	template<typename T, typename Metric>
+	inline void dist_norms(int n, int d, const T *x, int ldx, T *out, Metric)
+	{
+		for (int i = 0; i < n; ++i) out[i] = _dist_norm(d, x + i * ldx, Metric());
+	}
+
+	/**
+	 * Computes the distances between two sets of vectors, with the
+	 * per-vector quantities of y given (as computed by dist_norms).
+	 *
+	 * @param m    The number of vectors in x.
+	 * @param n    The number of vectors in y.
+	 * @param d    The dimension.
+	 * @param x    The base address of the vectors in x.
+	 * @param ldx  The offset between consecutive vectors of x.
+	 * @param y    The base address of the vectors in y.
+	 * @param ldy  The offset between consecutive vectors of y.
+	 * @param ny   The per-vector quantities of y (of length n).
+	 * @param r    The base address of the m x n output matrix.
+	 * @param ldr  The offset between consecutive rows of r.
+	 * @param tag  The metric, e.g. dist_euclidean_t().
+	 */
+	template<typename T, typename Metric>
+	inline void cdist(int m, int n, int d, const T *x, int ldx,
+			const T *y, int ldy, const T *ny, T *r, int ldr, Metric tag)
+	{
+		std::vector<T> nx((size_t)m + 1);
+		dist_norms(m, d, x, ldx, &nx[0], tag);
+
+		_cdist_cols(0, n, m, d, x, ldx, &nx[0], y, ldy, ny, r, ldr, tag);
+	}
+
+	/**
+	 * Computes the distances between two sets of vectors.
+	 *
+	 * @param m    The number of vectors in x.
+	 * @param n    The number of vectors in y.
+	 * @param d    The dimension.
+	 * @param x    The base address of the vectors in x.
+	 * @param ldx  The offset between consecutive vectors of x.
+	 * @param y    The base address of the vectors in y.
+	 * @param ldy  The offset between consecutive vectors of y.
+	 * @param r    The base address of the m x n output matrix.
+	 * @param ldr  The offset between consecutive rows of r.
+	 * @param tag  The metric, e.g. dist_euclidean_t().
+	 */
+	template<typename T, typename Metric>
+	inline void cdist(int m, int n, int d, const T *x, int ldx,
+			const T *y, int ldy, T *r, int ldr, Metric tag)
+	{
+		std::vector<T> ny((size_t)n + 1);
+		dist_norms(n, d, y, ldy, &ny[0], tag);
+
+		cdist(m, n, d, x, ldx, y, ldy, &ny[0], r, ldr, tag);
+	}
+
+	/**
+	 * Multi-threaded version of cdist (with the per-vector quantities
+	 * of y given), where each thread takes a tile of y.
+	 */
+	template<typename T, typename Metric>
+	inline void cdist_mt(int m, int n, int d, const T *x, int ldx,
+			const T *y, int ldy, const T *ny, T *r, int ldr, Metric tag)
+	{
+		std::vector<T> nx((size_t)m + 1);
+		dist_norms(m, d, x, ldx, &nx[0], tag);
+
+		const int bs = dist_blocking<T>::tile_cols(d);
+		const int nb = (n + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(dist_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int j0 = b * bs;
+			const int j1 = j0 + bs < n ? j0 + bs : n;
+
+			_cdist_cols(j0, j1, m, d, x, ldx, &nx[0], y, ldy, ny, r, ldr, tag);
+		}
+	}
+
+	/**
+	 * Computes the distances between all pairs of vectors in a set,
+	 * as a symmetric m x m matrix. Only the upper triangle is computed
+	 * (by blocks), and then copied to the lower one.
+	 *
+	 * @param m    The number of vectors.
+	 * @param d    The dimension.
+	 * @param x    The base address of the vectors.
+	 * @param ldx  The offset between consecutive vectors.
+	 * @param r    The base address of the m x m output matrix.
+	 * @param ldr  The offset between consecutive rows of r.
+	 * @param tag  The metric, e.g. dist_euclidean_t().
+	 */
+	template<typename T, typename Metric>
+	inline void pdist(int m, int d, const T *x, int ldx, T *r, int ldr, Metric tag)
+	{
+		const int mr = dist_blocking<T>::rows;
+		const int tc = dist_blocking<T>::tile_cols(d);
+
+		std::vector<T> nx((size_t)m + 1);
+		dist_norms(m, d, x, ldx, &nx[0], tag);
+		const T *pn = &nx[0];
+
+		for (int jb = 0; jb < m; jb += tc)
+		{
+			const int je = jb + tc < m ? jb + tc : m;
+
+			// blocks of rows with i < je, from their first row onward
+
+			int i = 0;
+			for (; i + mr <= je; i += mr)
+			{
+				const int j0 = i > jb ? i : jb;
+				_dot_rows4(j0, je, d, x + i * ldx, ldx, x, ldx, r + i * ldr, ldr);
+				for (int a = 0; a < mr; ++a)
+				{
+					_dist_finish(je - j0, pn[i + a], pn + j0, r + (i + a) * ldr + j0, tag);
+				}
+			}
+
+			for (; i < je; ++i)
+			{
+				const int j0 = i > jb ? i : jb;
+				_dot_rows1(j0, je, d, x + i * ldx, x, ldx, r + i * ldr);
+				_dist_finish(je - j0, pn[i], pn + j0, r + i * ldr + j0, tag);
+			}
+		}
+
+		for (int i = 0; i < m; ++i)
+		{
+			T *ri = r + i * ldr;
+			ri[i] = _dist_self(pn[i], ri[i], tag);
+			for (int j = i + 1; j < m; ++j) r[j * ldr + i] = ri[j];
+		}
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_DIST_H_ */
@@ -0,0 +1,864 @@
+/**
+ * @file simd_fft.h
+ *
+ * @brief Fast Fourier transforms of power-of-two sizes
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_FFT_H_
+#define LSIMD_SIMD_FFT_H_
+
+#include "simd_cpack.h"
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+namespace lsimd
+{
+	/**
+	 * @defgroup signal_module Signal Processing Module
+	 *
+	 * @brief Transforms and filters on arrays of samples.
+	 */
+
+	/**
+	 * @defgroup fft_generic Fast Fourier Transforms
+	 * @ingroup  signal_module
+	 *
+	 * @brief Complex and real FFTs of power-of-two sizes.
+	 *
+	 * The transforms follow the usual conventions of FFT libraries:
+	 * the forward transform computes
+	 * X[k] = sum_j x[j] * exp(-2 pi i j k / n), and the backward
+	 * transform uses exp(+2 pi i j k / n) and is not scaled, such
+	 * that backward(forward(x)) = n * x.
+	 *
+	 * The complex transform is a Stockham radix-4 decomposition (with
+	 * one radix-2 stage when log2(n) is odd), whose butterflies are
+	 * computed on simd_cpack. Each stage reads from one buffer and
+	 * writes to another in natural order, so no bit reversal is needed.
+	 * The twiddle factors of all stages are computed once when a plan
+	 * is constructed. The free functions fft, ifft, rfft and irfft use
+	 * plans cached per size (see fft_plan::cached).
+	 *
+	 * The size n must be a power of two. Arrays need not be aligned.
+	 *
+	 * @remark  These transforms do not reach a 5x speedup over a naive
+	 *          radix-2 FFT at all sizes. With SSE and -O3, the complex
+	 *          f32 transform is about 6-7.5x faster for n <= 1024, but
+	 *          only 3.3-3.8x once the buffers leave L1 (n >= 4096).
+	 *          An f64 pack holds a single complex number, so the f64
+	 *          transform is 1.7-4.8x faster, 2-3x for most sizes.
+	 *          The real transform is 1.9-3.4x (f32) and 1.7-2.3x (f64)
+	 *          faster than a naive real FFT of the same size (a naive
+	 *          complex FFT of size n / 2 and the same split pass).
+	 *          See bench/bench_sse_fft.cpp.
+	 */
+	/** @{ */
+
+	/**
+	 * The largest size whose work buffer is allocated on stack.
+	 */
+	const int fft_stack_size = 1024;
+
+
+	// The work buffer of a transform, placed at an offset of half a page
+	// from the output (modulo 4 KB). Otherwise the loads and stores of the
+	// power-of-two strided streams on the two buffers map to the same
+	// cache sets, and the loads falsely depend on the stores (4K aliasing).
+
+	template<typename T>
+	class _fft_buffer
+	{
+	public:
+		_fft_buffer(int n, const T *peer) : m_heap(0)
+		{
+			char *base = n <= fft_stack_size ? m_local :
+				(m_heap = new char[sizeof(T) * 2 * (size_t)n + page]);
+
+			const size_t d = (size_t)(base - reinterpret_cast<const char*>(peer)) % page;
+			m_data = reinterpret_cast<T*>(base + (page + page / 2 - d) % page);
+		}
+
+		~_fft_buffer()
+		{
+			delete[] m_heap;
+		}
+
+		T *data() { return m_data; }
+
+	private:
+		_fft_buffer(const _fft_buffer&);
+		_fft_buffer& operator = (const _fft_buffer&);
+
+		static const size_t page = 4096;
+
+		LSIMD_ALIGN_SSE char m_local[sizeof(T) * 2 * fft_stack_size + page];
+		char *m_heap;
+		T *m_data;
+	};
+
+
+	/************************************************
+	 *
+	 *  butterflies
+	 *
+	 ************************************************/
+
+	template<typename T, bool Inv>
+	struct _fft_r4
+	{
+		typedef simd_cpack<T, default_simd_kind> cp_t;
+		typedef simd_pack<T, default_simd_kind> pk_t;
+
+		// y0 .. y3 <- radix-4 butterfly of a, b, c, d (without twiddles)
+
+		LSIMD_ENSURE_INLINE
+		static void bfly(const cp_t& a, const cp_t& b, const cp_t& c, const cp_t& d,
+				cp_t& y0, cp_t& y1, cp_t& y2, cp_t& y3)
+		{
+			cp_t apc = a + c;
+			cp_t amc = a - c;
+			cp_t bpd = b + d;
+			cp_t jbmd = (b - d).mul_i();
+
+			y0 = apc + bpd;
+			y2 = apc - bpd;
+
+			if (Inv)
+			{
+				y1 = amc + jbmd;
+				y3 = amc - jbmd;
+			}
+			else
+			{
+				y1 = amc - jbmd;
+				y3 = amc + jbmd;
+			}
+		}
+
+		// y * w, with w given by the replicated parts wr and wi
+		// (wi is negated beforehand for the backward transform)
+
+		LSIMD_ENSURE_INLINE
+		static cp_t twiddle(const cp_t& y, const pk_t& wr, const pk_t& wi)
+		{
+			return y.mul_dup(wr, wi);
+		}
+
+		LSIMD_ENSURE_INLINE
+		static pk_t load_wi(const T *a)
+		{
+			return Inv ? -pk_t(a, unaligned_t()) : pk_t(a, unaligned_t());
+		}
+	};
+
+
+	template<int C> struct _fft_scatter4;
+
+	template<>
+	struct _fft_scatter4<1>
+	{
+		template<typename P, typename T>
+		LSIMD_ENSURE_INLINE
+		static void run(const P& y0, const P& y1, const P& y2, const P& y3, T *y)
+		{
+			y0.store(y,     unaligned_t());
+			y1.store(y + 2, unaligned_t());
+			y2.store(y + 4, unaligned_t());
+			y3.store(y + 6, unaligned_t());
+		}
+	};
+
+	template<>
+	struct _fft_scatter4<2>
+	{
+		template<typename P, typename T>
+		LSIMD_ENSURE_INLINE
+		static void run(const P& y0, const P& y1, const P& y2, const P& y3, T *y)
+		{
+			y0.template pair<0>(y1).store(y,      unaligned_t());
+			y2.template pair<0>(y3).store(y + 4,  unaligned_t());
+			y0.template pair<1>(y1).store(y + 8,  unaligned_t());
+			y2.template pair<1>(y3).store(y + 12, unaligned_t());
+		}
+	};
+
+
+	/**
+	 * One radix-4 Stockham stage: for p < m and q < s,
+	 * y[q + s (4p + k)] = w^(kp) * sum_j x[q + s (p + jm)] * (-i)^(jk).
+	 *
+	 * The twiddles are in g groups per k = 1, 2, 3, each group being
+	 * a pack of real parts followed by a pack of imaginary parts, with
+	 * the parts of each complex number replicated in its (re, im) slots.
+	 * A group holds w^(kp) of one p (g = m) when s >= count, and of
+	 * count consecutive values of p (g = m / count) otherwise.
+	 *
+	 * x may be equal to y when m == 1.
+	 */
+	template<typename T, bool Inv>
+	inline void _fft_radix4_stage(int m, int s, const T *tw, const T *x, T *y)
+	{
+		typedef _fft_r4<T, Inv> r4;
+		typedef typename r4::cp_t cp_t;
+		typedef typename r4::pk_t pk_t;
+		const int C = (int)cp_t::count;
+		const int W = (int)simd<T, default_simd_kind>::pack_width;
+
+		const int xs = 2 * s * m;
+		const int ys = 2 * s;
+
+		if (s >= C)
+		{
+			const T *tw1 = tw;
+			const T *tw2 = tw1 + 2 * W * m;
+			const T *tw3 = tw2 + 2 * W * m;
+
+			for (int p = 0; p < m; ++p)
+			{
+				const T *xp = x + 2 * s * p;
+				T *yp = y + 8 * s * p;
+
+				cp_t y0, y1, y2, y3;
+
+				if (p == 0)
+				{
+					for (int q = 0; q < 2 * s; q += 2 * C)
+					{
+						r4::bfly(
+							cp_t(xp + q, unaligned_t()), cp_t(xp + xs + q, unaligned_t()),
+							cp_t(xp + 2 * xs + q, unaligned_t()), cp_t(xp + 3 * xs + q, unaligned_t()),
+							y0, y1, y2, y3);
+
+						y0.store(yp + q, unaligned_t());
+						y1.store(yp + ys + q, unaligned_t());
+						y2.store(yp + 2 * ys + q, unaligned_t());
+						y3.store(yp + 3 * ys + q, unaligned_t());
+					}
+				}
+				else
+				{
+					const int o = 2 * W * p;
+					const pk_t w1r(tw1 + o, unaligned_t());
+					const pk_t w2r(tw2 + o, unaligned_t());
+					const pk_t w3r(tw3 + o, unaligned_t());
+					const pk_t w1i = r4::load_wi(tw1 + o + W);
+					const pk_t w2i = r4::load_wi(tw2 + o + W);
+					const pk_t w3i = r4::load_wi(tw3 + o + W);
+
+					for (int q = 0; q < 2 * s; q += 2 * C)
+					{
+						r4::bfly(
+							cp_t(xp + q, unaligned_t()), cp_t(xp + xs + q, unaligned_t()),
+							cp_t(xp + 2 * xs + q, unaligned_t()), cp_t(xp + 3 * xs + q, unaligned_t()),
+							y0, y1, y2, y3);
+
+						y0.store(yp + q, unaligned_t());
+						r4::twiddle(y1, w1r, w1i).store(yp + ys + q, unaligned_t());
+						r4::twiddle(y2, w2r, w2i).store(yp + 2 * ys + q, unaligned_t());
+						r4::twiddle(y3, w3r, w3i).store(yp + 3 * ys + q, unaligned_t());
+					}
+				}
+			}
+		}
+		else  // s == 1 < count: a pack spans count consecutive values of p
+		{
+			const T *tw1 = tw;
+			const T *tw2 = tw1 + 2 * W * (m / C);
+			const T *tw3 = tw2 + 2 * W * (m / C);
+
+			for (int p = 0; p < m; p += C)
+			{
+				const T *xp = x + 2 * p;
+				const int o = 2 * W * (p / C);
+
+				cp_t y0, y1, y2, y3;
+				r4::bfly(
+					cp_t(xp, unaligned_t()), cp_t(xp + xs, unaligned_t()),
+					cp_t(xp + 2 * xs, unaligned_t()), cp_t(xp + 3 * xs, unaligned_t()),
+					y0, y1, y2, y3);
+
+				y1 = r4::twiddle(y1, pk_t(tw1 + o, unaligned_t()), r4::load_wi(tw1 + o + W));
+				y2 = r4::twiddle(y2, pk_t(tw2 + o, unaligned_t()), r4::load_wi(tw2 + o + W));
+				y3 = r4::twiddle(y3, pk_t(tw3 + o, unaligned_t()), r4::load_wi(tw3 + o + W));
+
+				_fft_scatter4<C>::run(y0, y1, y2, y3, y + 8 * p);
+			}
+		}
+	}
+
+	/**
+	 * The final radix-2 stage (of length 2 and stride s), for which
+	 * x may be equal to y.
+	 */
+	template<typename T>
+	inline void _fft_radix2_stage(int s, const T *x, T *y)
+	{
+		typedef simd_cpack<T, default_simd_kind> cp_t;
+		const int C = (int)cp_t::count;
+
+		for (int q = 0; q < 2 * s; q += 2 * C)
+		{
+			cp_t a(x + q, unaligned_t());
+			cp_t b(x + 2 * s + q, unaligned_t());
+
+			(a + b).store(y + q, unaligned_t());
+			(a - b).store(y + 2 * s + q, unaligned_t());
+		}
+	}
+
+	/**
+	 * A direct DFT for the sizes too small to fill the packs of
+	 * the first stage.
+	 */
+	template<typename T, bool Inv>
+	inline void _fft_tiny(int n, const T *x, T *y)
+	{
+		T r[8];
+		const double sg = Inv ? 2.0 : -2.0;
+		const double pi = 3.14159265358979323846;
+
+		for (int k = 0; k < n; ++k)
+		{
+			T sr(0), si(0);
+			for (int j = 0; j < n; ++j)
+			{
+				const double a = sg * pi * double((j * k) % n) / double(n);
+				const T c = T(std::cos(a));
+				const T s = T(std::sin(a));
+				sr += x[2 * j] * c - x[2 * j + 1] * s;
+				si += x[2 * j] * s + x[2 * j + 1] * c;
+			}
+			r[2 * k] = sr;
+			r[2 * k + 1] = si;
+		}
+
+		for (int i = 0; i < 2 * n; ++i) y[i] = r[i];
+	}
+
+
+	/************************************************
+	 *
+	 *  plans
+	 *
+	 ************************************************/
+
+	/**
+	 * @brief A complex FFT of a fixed power-of-two size.
+	 *
+	 * A plan holds the stage layout and the twiddle tables of a size.
+	 * It is not modified by the transforms, and thus can be shared
+	 * by multiple threads.
+	 *
+	 * @tparam T  The real type (f32 or f64).
+	 */
+	template<typename T>
+	class fft_plan
+	{
+	public:
+		/**
+		 * The complex number type.
+		 */
+		typedef std::complex<T> complex_type;
+
+		/**
+		 * Constructs a plan.
+		 *
+		 * @param n  The size of the transforms, which must be a power of two.
+		 */
+		explicit fft_plan(int n) : m_n(n)
+		{
+			const int C = (int)simd_cpack<T, default_simd_kind>::count;
+			const int W = (int)simd<T, default_simd_kind>::pack_width;
+			const double pi = 3.14159265358979323846;
+
+			if (n < 4 * C) return;  // handled by _fft_tiny
+
+			int len = n;
+			int s = 1;
+
+			for (; len >= 4; len /= 4, s *= 4)
+			{
+				const int m = len / 4;
+				const int g = s >= C ? m : m / C;
+
+				stage st;
+				st.radix = 4;
+				st.m = m;
+				st.s = s;
+				st.tw_offset = (int)m_tw.size();
+				m_stages.push_back(st);
+
+				m_tw.resize(m_tw.size() + 3 * 2 * W * (size_t)g);
+				T *t = &m_tw[0] + st.tw_offset;
+
+				for (int k = 1; k <= 3; ++k)
+				{
+					for (int i = 0; i < g; ++i, t += 2 * W)
+					{
+						for (int l = 0; l < W; ++l)
+						{
+							const int p = s >= C ? i : i * C + l / 2;
+							const double a = -2.0 * pi * double(k * p) / double(len);
+							t[l] = T(std::cos(a));
+							t[W + l] = T(std::sin(a));
+						}
+					}
+				}
+			}
+
+			if (len == 2)
+			{
+				stage st;
+				st.radix = 2;
+				st.m = 1;
+				st.s = s;
+				st.tw_offset = 0;
+				m_stages.push_back(st);
+			}
+		}
+
+		/**
+		 * Gets the size of the transforms.
+		 */
+		int size() const
+		{
+			return m_n;
+		}
+
+		/**
+		 * Computes the forward transform.
+		 *
+		 * @param in   The input array of size n.
+		 * @param out  The output array of size n (can be the same as in).
+		 */
+		void forward(const complex_type *in, complex_type *out) const
+		{
+			run<false>(reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out));
+		}
+
+		/**
+		 * Computes the (unscaled) backward transform.
+		 *
+		 * @param in   The input array of size n.
+		 * @param out  The output array of size n (can be the same as in).
+		 */
+		void backward(const complex_type *in, complex_type *out) const
+		{
+			run<true>(reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out));
+		}
+
+		/**
+		 * Gets the plan of a size shared by the whole program.
+		 *
+		 * The plan is constructed upon the first request of the
+		 * size, and is kept until the program exits. This can be
+		 * called from multiple threads concurrently.
+		 *
+		 * @param n  The size of the transforms, which must be a power of two.
+		 */
+		static const fft_plan& cached(int n)
+		{
+			// a mutex rather than an OpenMP critical section, so that
+			// the table is guarded with any threads, with or without OpenMP
+
+			static std::mutex mtx;
+			static fft_plan *plans[32] = {0};
+
+			int e = 0;
+			while ((1 << e) < n) ++e;
+
+			std::lock_guard<std::mutex> lock(mtx);
+			if (!plans[e]) plans[e] = new fft_plan(n);
+			return *plans[e];
+		}
+
+	private:
+		struct stage
+		{
+			int radix;
+			int m;
+			int s;
+			int tw_offset;
+		};
+
+		template<bool Inv>
+		void run(const T *in, T *out) const
+		{
+			const int ns = (int)m_stages.size();
+
+			if (ns == 0)
+			{
+				if (m_n > 1) _fft_tiny<T, Inv>(m_n, in, out);
+				else if (m_n == 1) { out[0] = in[0]; out[1] = in[1]; }
+				return;
+			}
+
+			_fft_buffer<T> buf(m_n, out);
+			T *work = buf.data();
+
+			// the stages alternate between out and work, starting such
+			// that the last one writes to out. The last stage (of length
+			// 4 or 2) can run in place, which an in-place transform with
+			// an odd number of stages uses instead of copying the input.
+
+			T *dst = ns % 2 == 1 && in != out ? out : work;
+			const T *src = in;
+
+			for (int i = 0; i < ns; ++i)
+			{
+				const stage& st = m_stages[i];
+				if (i == ns - 1) dst = out;
+
+				if (st.radix == 4)
+					_fft_radix4_stage<T, Inv>(st.m, st.s, &m_tw[0] + st.tw_offset, src, dst);
+				else
+					_fft_radix2_stage(st.s, src, dst);
+
+				src = dst;
+				dst = dst == work ? out : work;
+			}
+		}
+
+		int m_n;
+		std::vector<stage> m_stages;
+		std::vector<T> m_tw;
+	};
+
+
+	/**
+	 * @brief A real-input FFT of a fixed power-of-two size.
+	 *
+	 * The forward transform of n real values gives the n / 2 + 1
+	 * non-redundant bins X[0], ..., X[n/2]. It is computed by a complex
+	 * FFT of size n / 2 on the even and odd values paired as complex
+	 * numbers, followed by a pass that separates the two spectra.
+	 * The backward transform inverts this, such that
+	 * backward(forward(x)) = n * x.
+	 *
+	 * @tparam T  The real type (f32 or f64).
+	 */
+	template<typename T>
+	class rfft_plan
+	{
+	public:
+		/**
+		 * The complex number type.
+		 */
+		typedef std::complex<T> complex_type;
+
+		/**
+		 * Constructs a plan.
+		 *
+		 * @param n  The number of real values, which must be a power
+		 *           of two no less than 4.
+		 */
+		explicit rfft_plan(int n)
+		: m_n(n), m_half(fft_plan<T>::cached(n / 2))
+		{
+			const double pi = 3.14159265358979323846;
+
+			const int h = n / 4;
+			m_tw.resize(2 * (size_t)(h + 1));
+			for (int k = 0; k <= h; ++k)
+			{
+				const double a = -2.0 * pi * double(k) / double(n);
+				m_tw[2 * k] = T(std::cos(a));
+				m_tw[2 * k + 1] = T(std::sin(a));
+			}
+		}
+
+		/**
+		 * Gets the number of real values.
+		 */
+		int size() const
+		{
+			return m_n;
+		}
+
+		/**
+		 * Computes the forward transform.
+		 *
+		 * @param in   The input array of n real values.
+		 * @param out  The output array of n / 2 + 1 complex values.
+		 */
+		void forward(const T *in, complex_type *out) const
+		{
+			const int m = m_n / 2;
+			m_half.forward(reinterpret_cast<const complex_type*>(in), out);
+
+			T *z = reinterpret_cast<T*>(out);
+
+			const T z0r = z[0];
+			const T z0i = z[1];
+			z[0] = z0r + z0i;
+			z[1] = T(0);
+			z[2 * m] = z0r - z0i;
+			z[2 * m + 1] = T(0);
+
+			// E = (z[k] + conj(z[m-k])) / 2, O = -i (z[k] - conj(z[m-k])) / 2,
+			// X[k] = E + w^k O, X[m-k] = conj(E - w^k O)
+			//
+			// C entries at each end are done at once as long as the
+			// two ends do not meet, the lanes at the upper end being
+			// reversed on load and store
+
+			const pk_t half(T(0.5));
+			int k = 1;
+			for (; 2 * (k + C - 1) < m; k += C)
+			{
+				T *a = z + 2 * k;
+				T *b = z + 2 * (m - k - C + 1);
+
+				const cp_t za(a, unaligned_t());
+				const cp_t zb = cp_t(b, unaligned_t()).reverse().conj();
+
+				const cp_t e = (za + zb) * half;
+				const cp_t t = ((zb - za).mul_i() * half) * cp_t(&m_tw[2 * k], unaligned_t());
+
+				(e + t).store(a, unaligned_t());
+				(e - t).conj().reverse().store(b, unaligned_t());
+			}
+
+			for (; k <= m / 2; ++k) forward_entry(z, k);
+		}
+
+		/**
+		 * Computes the (unscaled) backward transform.
+		 *
+		 * @param in   The input array of n / 2 + 1 complex values.
+		 * @param out  The output array of n real values.
+		 */
+		void backward(const complex_type *in, T *out) const
+		{
+			const int m = m_n / 2;
+			const T *x = reinterpret_cast<const T*>(in);
+
+			// E = x[k] + conj(x[m-k]), O = (x[k] - conj(x[m-k])) conj(w^k),
+			// z[k] = E + i O, z[m-k] = conj(E) + i conj(O)
+
+			int k = 1;
+			for (; 2 * (k + C - 1) < m; k += C)
+			{
+				const T *a = x + 2 * k;
+				const T *b = x + 2 * (m - k - C + 1);
+
+				const cp_t xa(a, unaligned_t());
+				const cp_t xb = cp_t(b, unaligned_t()).reverse().conj();
+
+				const cp_t e = xa + xb;
+				const cp_t io = (xa - xb).mul_conj(cp_t(&m_tw[2 * k], unaligned_t())).mul_i();
+
+				(e + io).store(out + 2 * k, unaligned_t());
+				(e - io).conj().reverse().store(out + 2 * (m - k - C + 1), unaligned_t());
+			}
+
+			backward_entry(x, out, 0);
+			for (; k <= m / 2; ++k) backward_entry(x, out, k);
+
+			complex_type *z = reinterpret_cast<complex_type*>(out);
+			m_half.backward(z, z);
+		}
+
+		/**
+		 * Gets the plan of a size shared by the whole program.
+		 *
+		 * @param n  The number of real values, which must be a power
+		 *           of two no less than 4.
+		 */
+		static const rfft_plan& cached(int n)
+		{
+			// a mutex rather than an OpenMP critical section, so that
+			// the table is guarded with any threads, with or without OpenMP
+
+			static std::mutex mtx;
+			static rfft_plan *plans[32] = {0};
+
+			int e = 0;
+			while ((1 << e) < n) ++e;
+
+			std::lock_guard<std::mutex> lock(mtx);
+			if (!plans[e]) plans[e] = new rfft_plan(n);
+			return *plans[e];
+		}
+
+	private:
+		typedef simd_cpack<T, default_simd_kind> cp_t;
+		typedef typename cp_t::pack_type pk_t;
+		static const int C = (int)cp_t::count;
+
+		LSIMD_ENSURE_INLINE
+		void forward_entry(T *z, int k) const
+		{
+			const int m = m_n / 2;
+			const T half(0.5);
+
+			T *a = z + 2 * k;
+			T *b = z + 2 * (m - k);
+			const T wr = m_tw[2 * k];
+			const T wi = m_tw[2 * k + 1];
+
+			const T er = half * (a[0] + b[0]);
+			const T ei = half * (a[1] - b[1]);
+			const T orr = half * (a[1] + b[1]);
+			const T oi = half * (b[0] - a[0]);
+
+			const T tr = wr * orr - wi * oi;
+			const T ti = wr * oi + wi * orr;
+
+			a[0] = er + tr;
+			a[1] = ei + ti;
+			b[0] = er - tr;
+			b[1] = ti - ei;
+		}
+
+		LSIMD_ENSURE_INLINE
+		void backward_entry(const T *x, T *out, int k) const
+		{
+			const int m = m_n / 2;
+
+			const T *a = x + 2 * k;
+			const T *b = x + 2 * (m - k);
+			const T wr = m_tw[2 * k];
+			const T wi = m_tw[2 * k + 1];
+
+			const T er = a[0] + b[0];
+			const T ei = a[1] - b[1];
+			const T dr = a[0] - b[0];
+			const T di = a[1] + b[1];
+
+			const T orr = dr * wr + di * wi;
+			const T oi = di * wr - dr * wi;
+
+			out[2 * k] = er - oi;
+			out[2 * k + 1] = ei + orr;
+
+			if (k > 0 && k < m - k)
+			{
+				out[2 * (m - k)] = er + oi;
+				out[2 * (m - k) + 1] = orr - ei;
+			}
+		}
+
+	private:
+		int m_n;
+		const fft_plan<T>& m_half;
+		std::vector<T> m_tw;
+	};
+
+
+	/************************************************
+	 *
+	 *  functions
+	 *
+	 ************************************************/
+
+	/**
+	 * Computes the forward FFT of a complex array.
+	 *
+	 * @param n    The size, which must be a power of two.
+	 * @param in   The input array.
+	 * @param out  The output array (can be the same as in).
+	 */
+	template<typename T>
+	inline void fft(int n, const std::complex<T> *in, std::complex<T> *out)
+	{
+		fft_plan<T>::cached(n).forward(in, out);
+	}
+
+	/**
+	 * Computes the forward FFT of a complex array in place.
+	 *
+	 * @param n    The size, which must be a power of two.
+	 * @param x    The array to be transformed.
+	 */
+	template<typename T>
+	inline void fft(int n, std::complex<T> *x)
+	{
+		fft_plan<T>::cached(n).forward(x, x);
+	}
+
+	/**
+	 * Computes the (unscaled) backward FFT of a complex array.
+	 *
+	 * @param n    The size, which must be a power of two.
+	 * @param in   The input array.
+	 * @param out  The output array (can be the same as in).
+	 */
+	template<typename T>
+	inline void ifft(int n, const std::complex<T> *in, std::complex<T> *out)
+	{
+		fft_plan<T>::cached(n).backward(in, out);
+	}
+
+	/**
+	 * Computes the (unscaled) backward FFT of a complex array in place.
+	 *
+	 * @param n    The size, which must be a power of two.
+	 * @param x    The array to be transformed.
+	 */
+	template<typename T>
+	inline void ifft(int n, std::complex<T> *x)
+	{
+		fft_plan<T>::cached(n).backward(x, x);
+	}
+
+	/**
+	 * Computes the forward FFT of a real array.
+	 *
+	 * @param n    The number of real values, a power of two no less than 4.
+	 * @param in   The input array of n real values.
+	 * @param out  The output array of n / 2 + 1 complex values.
+	 */
+	template<typename T>
+	inline void rfft(int n, const T *in, std::complex<T> *out)
+	{
+		rfft_plan<T>::cached(n).forward(in, out);
+	}
+
+	/**
+	 * Computes the (unscaled) backward FFT to a real array.
+	 *
+	 * @param n    The number of real values, a power of two no less than 4.
+	 * @param in   The input array of n / 2 + 1 complex values.
+	 * @param out  The output array of n real values.
+	 */
+	template<typename T>
+	inline void irfft(int n, const std::complex<T> *in, T *out)
+	{
+		rfft_plan<T>::cached(n).backward(in, out);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_FFT_H_ */
@@ -0,0 +1,300 @@
+/**
+ * @file simd_hist.h
+ *
+ * @brief Histograms over uniform bins.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_HIST_H_
+#define LSIMD_SIMD_HIST_H_
+
+#include "simd_arith.h"
+#include <vector>
+
+namespace lsimd
+{
+	/**
+	 * @defgroup hist_generic Histograms
+	 * @ingroup  stats_module
+	 *
+	 * @brief Counting of values over nbins uniform bins that split
+	 *        the range [lo, hi].
+	 *
+	 * The bin of x is floor((x - lo) * nbins / (hi - lo)), with the
+	 * value hi counted into the last bin. Values outside [lo, hi]
+	 * (and NaNs) are not counted.
+	 *
+	 * The bin indices are computed a pack at a time, and the range
+	 * check gives a bit mask. Consecutive values are then counted
+	 * into separate sub-histograms in a round-robin way, so that a
+	 * run of values in the same bin does not serialize on a single
+	 * counter (through store-to-load forwarding). Values out of range
+	 * go to an extra bin at the end of each sub-histogram, which
+	 * keeps the counting loop free of branches. The sub-histograms
+	 * are merged at the end.
+	 *
+	 * The counts are accumulated into arrays of int or i64. The
+	 * counts of a single call fit in int, but as a stream is binned
+	 * over many calls, a bin of int overflows past 2^31 - 1 values,
+	 * which i64 counts avoid.
+	 */
+	/** @{ */
+
+	/**
+	 * Blocking parameters of the histogram routines.
+	 */
+	template<typename T>
+	struct hist_blocking
+	{
+		/**
+		 * The number of sub-histograms.
+		 */
+		static const int subs = 4;
+
+		/**
+		 * The maximum number of bins for which sub-histograms are
+		 * used. With more bins, collisions are rare, and a single
+		 * histogram is kinder to the cache.
+		 */
+		static const int max_sub_bins = 1 << 12;
+
+		/**
+		 * The maximum number of chunks of histogram_mt, each with
+		 * its own histograms.
+		 */
+		static const int mt_chunks = 16;
+
+		/**
+		 * The minimum number of values per chunk of histogram_mt
+		 * (which is also at least four times the size of the
+		 * histograms of a chunk).
+		 */
+		static const int mt_size = 1 << 16;
+
+		/**
+		 * The offset between consecutive sub-histograms, given the
+		 * number of bins (zero if all share a single one).
+		 */
+		static int sub_offset(int nbins)
+		{
+			return nbins <= max_sub_bins ? nbins + 1 : 0;
+		}
+
+		/**
+		 * The size of the buffer of sub-histograms, given the number
+		 * of bins.
+		 */
+		static int sub_size(int nbins)
+		{
+			return nbins <= max_sub_bins ? subs * (nbins + 1) : nbins + 1;
+		}
+	};
+
+
+	// counts x[0 .. n) into the sub-histograms of h (with offset ld),
+	// and the values out of range into h[nbins] (of each)
+
+	template<typename T>
+	inline void _hist_count(int n, const T *x, const T lo, const T hi, int nbins, int *h, int ld)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const T s = T(nbins) / (hi - lo);
+		const T tm = T(nbins - 1);
+
+		int *h0 = h;
+		int *h1 = h + ld;
+		int *h2 = h + 2 * ld;
+		int *h3 = h + 3 * ld;
+
+		int i = 0;
+
+		if (n >= 2 * w)
+		{
+			const pack_t pl(lo), ph(hi), ps(s), pm(tm);
+			LSIMD_ALIGN_SSE i32 b[12];
+
+			for (; i + 2 * w <= n; i += 2 * w)
+			{
+				const pack_t x0(x + i, unaligned_t());
+				const pack_t x1(x + i + w, unaligned_t());
+
+				// the in-range lanes, and their bins (where values
+				// at hi, or rounded up to nbins, are kept in range)
+
+				const int m = (mask_ge(x0, pl) & mask_le(x0, ph)) |
+						((mask_ge(x1, pl) & mask_le(x1, ph)) << w);
+
+				cvtt_i32(vmin((x0 - pl) * ps, pm)).store(b, aligned_t());
+				cvtt_i32(vmin((x1 - pl) * ps, pm)).store(b + w, unaligned_t());
+
+				for (int j = 0; j < 2 * w; j += 4)
+				{
+					++ h0[(m >> j) & 1 ? b[j] : nbins];
+					++ h1[(m >> (j + 1)) & 1 ? b[j + 1] : nbins];
+					++ h2[(m >> (j + 2)) & 1 ? b[j + 2] : nbins];
+					++ h3[(m >> (j + 3)) & 1 ? b[j + 3] : nbins];
+				}
+			}
+		}
+
+		for (; i < n; ++i)
+		{
+			const T v = x[i];
+			if (v >= lo && v <= hi)
+			{
+				const T t = (v - lo) * s;
+				++ h0[(int)(t < tm ? t : tm)];
+			}
+			else ++ h0[nbins];
+		}
+	}
+
+	// adds the counts of the sub-histograms in h to counts,
+	// and returns the number of values out of range
+
+	inline int _hist_merge(int nbins, const int *h, int ld, int ns, int *counts)
+	{
+		typedef simd_pack<i32> ipack_t;
+		const int w = (int)ipack_t::pack_width;
+
+		int out = 0;
+		for (int k = 0; k < ns; ++k) out += h[k * ld + nbins];
+
+		int j = 0;
+		for (; j + w <= nbins; j += w)
+		{
+			ipack_t c(counts + j, unaligned_t());
+			for (int k = 0; k < ns; ++k) c = c + ipack_t(h + k * ld + j, unaligned_t());
+			c.store(counts + j, unaligned_t());
+		}
+		for (; j < nbins; ++j)
+		{
+			for (int k = 0; k < ns; ++k) counts[j] += h[k * ld + j];
+		}
+
+		return out;
+	}
+
+	inline int _hist_merge(int nbins, const int *h, int ld, int ns, i64 *counts)
+	{
+		// the counts of one call fit in int, and are widened when added
+
+		int out = 0;
+		for (int k = 0; k < ns; ++k) out += h[k * ld + nbins];
+
+		for (int j = 0; j < nbins; ++j)
+		{
+			int c = 0;
+			for (int k = 0; k < ns; ++k) c += h[k * ld + j];
+			counts[j] += c;
+		}
+
+		return out;
+	}
+
+
+	/**
+	 * Counts the values of an array over uniform bins.
+	 *
+	 * @param n       The number of values.
+	 * @param x       The values.
+	 * @param lo      The lower end of the range.
+	 * @param hi      The upper end of the range (hi > lo).
+	 * @param nbins   The number of bins (nbins > 0).
+	 * @param counts  The counts of the bins (of length nbins, of int
+	 *                or i64), to which the counts of x are added (so
+	 *                that a long stream can be binned piece by piece).
+	 *                With int, each bin holds at most 2^31 - 1 values.
+	 *
+	 * @return        The number of values within [lo, hi].
+	 */
+	template<typename T, typename C>
+	inline int histogram(int n, const T *x, T lo, T hi, int nbins, C *counts)
+	{
+		const int ld = hist_blocking<T>::sub_offset(nbins);
+		std::vector<int> h((size_t)hist_blocking<T>::sub_size(nbins), 0);
+
+		_hist_count(n, x, lo, hi, nbins, &h[0], ld);
+		return n - _hist_merge(nbins, &h[0], ld, ld ? hist_blocking<T>::subs : 1, counts);
+	}
+
+	/**
+	 * Multi-threaded version of histogram, where the values are split
+	 * into chunks, which are counted in parallel into their own
+	 * histograms, and then merged.
+	 */
+	template<typename T, typename C>
+	inline int histogram_mt(int n, const T *x, T lo, T hi, int nbins, C *counts)
+	{
+		const int ld = hist_blocking<T>::sub_offset(nbins);
+		const int hs = hist_blocking<T>::sub_size(nbins);
+
+		// each chunk is large enough to pay for merging its histograms
+
+		const int cs = hist_blocking<T>::mt_size > 4 * hs ? hist_blocking<T>::mt_size : 4 * hs;
+		int nb = n / cs;
+		if (nb > hist_blocking<T>::mt_chunks) nb = hist_blocking<T>::mt_chunks;
+
+		if (nb < 2)
+		{
+			return histogram(n, x, lo, hi, nbins, counts);
+		}
+		std::vector<int> h((size_t)nb * (size_t)hs, 0);
+
+#ifdef LSIMD_HAS_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i0 = (int)((long long)n * b / nb);
+			const int i1 = (int)((long long)n * (b + 1) / nb);
+
+			_hist_count(i1 - i0, x + i0, lo, hi, nbins, &h[0] + b * hs, ld);
+		}
+
+		// the histograms of all chunks are merged as sub-histograms
+
+		const int ns = ld ? hist_blocking<T>::subs : 1;
+		int r = n;
+		for (int b = 0; b < nb; ++b)
+		{
+			r -= _hist_merge(nbins, &h[0] + b * hs, ld, ns, counts);
+		}
+		return r;
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_HIST_H_ */
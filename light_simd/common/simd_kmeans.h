@@ -0,0 +1,376 @@
+/**
+ * @file simd_kmeans.h
+ *
+ * @brief The assignment and update steps of k-means clustering.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_KMEANS_H_
+#define LSIMD_SIMD_KMEANS_H_
+
+#include "simd_dist.h"
+#include <vector>
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup kmeans_generic K-means Clustering
+	 * @ingroup  linalg_module
+	 *
+	 * @brief The two steps of Lloyd's k-means iteration, on n points
+	 *        and k centroids of dimension d.
+	 *
+	 * The points and the centroids are stored as the rows of row-major
+	 * matrices (with offsets ldx and ldc), as in dist_generic.
+	 *
+	 * The assignment step computes the squared Euclidean distances
+	 * from a block of points to all centroids with the micro-kernel of
+	 * cdist, into a buffer that stays in L1 cache (see kmeans_blocking),
+	 * and then takes the argmin of each row of the buffer. Ties are
+	 * resolved in favor of lower centroid indices.
+	 *
+	 * The update step accumulates the points into the sums of their
+	 * clusters, and moves each centroid to the mean of its cluster.
+	 * The centroids of empty clusters are left unchanged.
+	 */
+	/** @{ */
+
+	/**
+	 * Blocking parameters of the k-means routines.
+	 */
+	template<typename T>
+	struct kmeans_blocking
+	{
+		/**
+		 * The size (in bytes) of the buffer of distances for a block
+		 * of points.
+		 */
+		static const int buf_bytes = 1 << 15;
+
+		/**
+		 * The minimum number of point-centroid pairs for which
+		 * kmeans_assign_mt goes parallel.
+		 */
+		static const int mt_threshold = 1 << 14;
+
+		/**
+		 * The number of partial sums of kmeans_update_mt, merged in
+		 * a fixed order (so the results do not depend on the number
+		 * of threads).
+		 */
+		static const int mt_chunks = 16;
+
+		/**
+		 * The minimum number of points per partial sum of
+		 * kmeans_update_mt.
+		 */
+		static const int mt_rows = 4096;
+
+		/**
+		 * The number of points in a block, given k centroids.
+		 */
+		static int rows(int k)
+		{
+			int r = buf_bytes / ((k > 0 ? k : 1) * (int)sizeof(T));
+			r -= r % dist_blocking<T>::rows;
+			return r > dist_blocking<T>::rows ? r : dist_blocking<T>::rows;
+		}
+	};
+
+
+	// the index of the (first) minimum of r[0 .. n) (with n > 0)
+
+	template<typename T>
+	inline int _argmin(int n, const T *r)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		T mv = r[0];
+		int j = 0;
+
+		if (n >= 2 * w)
+		{
+			pack_t m0(r, unaligned_t());
+			pack_t m1(r + w, unaligned_t());
+
+			for (j = 2 * w; j + 2 * w <= n; j += 2 * w)
+			{
+				m0 = vmin(m0, pack_t(r + j, unaligned_t()));
+				m1 = vmin(m1, pack_t(r + j + w, unaligned_t()));
+			}
+			mv = (vmin(m0, m1).min)();
+		}
+
+		for (; j < n; ++j) if (r[j] < mv) mv = r[j];
+
+		// the first lane reaching the minimum
+
+		const pack_t mp(mv);
+
+		j = 0;
+		for (; j + w <= n; j += w)
+		{
+			int m = mask_le(pack_t(r + j, unaligned_t()), mp);
+			if (m)
+			{
+				for (; !(m & 1); m >>= 1) ++j;
+				return j;
+			}
+		}
+
+		for (; j < n; ++j) if (r[j] <= mv) break;
+		return j;
+	}
+
+	// assigns a block of m points, with buf of length m * (k + 1),
+	// and returns the sum of their distances
+
+	template<typename T>
+	inline T _kmeans_assign_block(int m, int d, const T *x, int ldx, int k,
+			const T *c, int ldc, const T *nc, int *labels, T *dists, T *buf)
+	{
+		T *nx = buf + m * k;
+		dist_norms(m, d, x, ldx, nx, dist_sqeuclidean_t());
+
+		_cdist_cols(0, k, m, d, x, ldx, nx, c, ldc, nc, buf, k, dist_sqeuclidean_t());
+
+		T s(0);
+		for (int i = 0; i < m; ++i)
+		{
+			const T *r = buf + i * k;
+			const int l = _argmin(k, r);
+
+			labels[i] = l;
+			dists[i] = r[l];
+			s += r[l];
+		}
+		return s;
+	}
+
+	// adds the points [i0, i1) to the sums s (of k x d) of their clusters
+
+	template<typename T>
+	inline void _kmeans_sums(int i0, int i1, int d, const T *x, int ldx,
+			const int *labels, T *s, int *counts)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		for (int i = i0; i < i1; ++i)
+		{
+			const int l = labels[i];
+			const T *xi = x + i * ldx;
+			T *sl = s + l * d;
+
+			int j = 0;
+			for (; j + w <= d; j += w)
+			{
+				(pack_t(sl + j, unaligned_t()) + pack_t(xi + j, unaligned_t())).store(sl + j, unaligned_t());
+			}
+			for (; j < d; ++j) sl[j] += xi[j];
+
+			++ counts[l];
+		}
+	}
+
+	// moves the centroids of the non-empty clusters to the means
+
+	template<typename T>
+	inline void _kmeans_means(int d, int k, const T *s, const int *counts, T *c, int ldc)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		for (int l = 0; l < k; ++l)
+		{
+			if (counts[l] == 0) continue;
+
+			const T a = T(1) / T(counts[l]);
+			const pack_t ap(a);
+			const T *sl = s + l * d;
+			T *cl = c + l * ldc;
+
+			int j = 0;
+			for (; j + w <= d; j += w)
+			{
+				(pack_t(sl + j, unaligned_t()) * ap).store(cl + j, unaligned_t());
+			}
+			for (; j < d; ++j) cl[j] = sl[j] * a;
+		}
+	}
+
+
+	/**
+	 * Assigns each point to its nearest centroid.
+	 *
+	 * @param n       The number of points.
+	 * @param d       The dimension.
+	 * @param x       The base address of the points.
+	 * @param ldx     The offset between consecutive points.
+	 * @param k       The number of centroids (k > 0).
+	 * @param c       The base address of the centroids.
+	 * @param ldc     The offset between consecutive centroids.
+	 * @param labels  The indices of the nearest centroids (of length n).
+	 * @param dists   The squared distances to the nearest centroids
+	 *                (of length n).
+	 *
+	 * @return        The sum of the squared distances (the inertia).
+	 */
+	template<typename T>
+	inline T kmeans_assign(int n, int d, const T *x, int ldx, int k,
+			const T *c, int ldc, int *labels, T *dists)
+	{
+		std::vector<T> nc((size_t)k + 1);
+		dist_norms(k, d, c, ldc, &nc[0], dist_sqeuclidean_t());
+
+		const int br = kmeans_blocking<T>::rows(k);
+		std::vector<T> buf((size_t)br * (size_t)(k + 1));
+
+		T s(0);
+		for (int i = 0; i < n; i += br)
+		{
+			const int m = br < n - i ? br : n - i;
+			s += _kmeans_assign_block(m, d, x + i * ldx, ldx, k, c, ldc, &nc[0],
+					labels + i, dists + i, &buf[0]);
+		}
+		return s;
+	}
+
+	/**
+	 * Multi-threaded version of kmeans_assign, where each thread takes
+	 * a share of the blocks of points. The labels and the distances are
+	 * the same as those of kmeans_assign.
+	 */
+	template<typename T>
+	inline T kmeans_assign_mt(int n, int d, const T *x, int ldx, int k,
+			const T *c, int ldc, int *labels, T *dists)
+	{
+		std::vector<T> nc((size_t)k + 1);
+		dist_norms(k, d, c, ldc, &nc[0], dist_sqeuclidean_t());
+
+		const int br = kmeans_blocking<T>::rows(k);
+		const int nb = (n + br - 1) / br;
+
+		T s(0);
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(n) * double(k) >= double(kmeans_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) reduction(+:s) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i = b * br;
+			const int m = br < n - i ? br : n - i;
+
+			std::vector<T> buf((size_t)m * (size_t)(k + 1));
+			s += _kmeans_assign_block(m, d, x + i * ldx, ldx, k, c, ldc, &nc[0],
+					labels + i, dists + i, &buf[0]);
+		}
+		return s;
+	}
+
+	/**
+	 * Moves each centroid to the mean of the points assigned to it.
+	 *
+	 * @param n       The number of points.
+	 * @param d       The dimension.
+	 * @param x       The base address of the points.
+	 * @param ldx     The offset between consecutive points.
+	 * @param labels  The cluster of each point (in [0, k)).
+	 * @param k       The number of centroids.
+	 * @param c       The base address of the centroids, which are
+	 *                updated in place (except those of empty clusters).
+	 * @param ldc     The offset between consecutive centroids.
+	 * @param counts  The sizes of the clusters (of length k).
+	 */
+	template<typename T>
+	inline void kmeans_update(int n, int d, const T *x, int ldx, const int *labels,
+			int k, T *c, int ldc, int *counts)
+	{
+		std::vector<T> s((size_t)k * (size_t)d + 1, T(0));
+		for (int l = 0; l < k; ++l) counts[l] = 0;
+
+		_kmeans_sums(0, n, d, x, ldx, labels, &s[0], counts);
+		_kmeans_means(d, k, &s[0], counts, c, ldc);
+	}
+
+	/**
+	 * Multi-threaded version of kmeans_update, where the points are
+	 * split into chunks, whose partial sums are computed in parallel
+	 * and then merged.
+	 */
+	template<typename T>
+	inline void kmeans_update_mt(int n, int d, const T *x, int ldx, const int *labels,
+			int k, T *c, int ldc, int *counts)
+	{
+		int nb = n / kmeans_blocking<T>::mt_rows;
+		if (nb > kmeans_blocking<T>::mt_chunks) nb = kmeans_blocking<T>::mt_chunks;
+
+		if (nb < 2)
+		{
+			kmeans_update(n, d, x, ldx, labels, k, c, ldc, counts);
+			return;
+		}
+
+		const int kd = k * d;
+		std::vector<T> s((size_t)nb * (size_t)kd + 1, T(0));
+		std::vector<int> cnt((size_t)nb * (size_t)k + 1, 0);
+
+#ifdef LSIMD_HAS_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i0 = (int)((long long)n * b / nb);
+			const int i1 = (int)((long long)n * (b + 1) / nb);
+
+			_kmeans_sums(i0, i1, d, x, ldx, labels, &s[0] + b * kd, &cnt[0] + b * k);
+		}
+
+		// merge the partial sums into the first
+
+		for (int b = 1; b < nb; ++b)
+		{
+			const T *sb = &s[0] + b * kd;
+			for (int j = 0; j < kd; ++j) s[j] += sb[j];
+			for (int l = 0; l < k; ++l) cnt[l] += cnt[b * k + l];
+		}
+
+		for (int l = 0; l < k; ++l) counts[l] = cnt[l];
+		_kmeans_means(d, k, &s[0], counts, c, ldc);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_KMEANS_H_ */
@@ -56,6 +56,319 @@ namespace lsimd
 		typedef sse_mat<T, M, N> impl_type;
 	};
 
+	/**
+	 * Expression node: a matrix-vector product, as a * x.
+	 */
+	template<typename T, int M, int N, typename Kind>
+	struct vexpr_mtimes
+	{
+		typedef typename simd_vec_traits<T, M, Kind>::impl_type impl_type;
+		typedef typename simd_mat_traits<T, M, N, Kind>::impl_type mat_impl_type;
+		typedef typename simd_vec_traits<T, N, Kind>::impl_type arg_impl_type;
+		static const bool is_leaf = false;
+
+		mat_impl_type a;
+		arg_impl_type x;
+
+		LSIMD_ENSURE_INLINE
+		vexpr_mtimes(const mat_impl_type& a_, const arg_impl_type& x_) : a(a_), x(x_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const { return a * x; }
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const { y = a.transform_add(x, y); }
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const { y = a.transform_sub(x, y); }
+	};
+
+
+	/********************************************
+	 *
+	 *  Matrix chains
+	 *
+	 ********************************************/
+
+	/**
+	 * Matrix chain operand: a matrix of size M x N.
+	 */
+	template<typename T, int M, int N, typename Kind>
+	struct mexpr_leaf
+	{
+		typedef T value_type;
+		typedef Kind kind_type;
+		typedef typename simd_mat_traits<T, M, N, Kind>::impl_type impl_type;
+
+		static const int length = 1;
+		static const int rows = M;
+		static const int cols = N;
+		static const bool ends_with_vec = false;
+
+		impl_type a;
+
+		LSIMD_ENSURE_INLINE
+		explicit mexpr_leaf(const impl_type& a_) : a(a_) { }
+	};
+
+	/**
+	 * Matrix chain operand: a vector of length N, which is treated
+	 * as an N x 1 matrix, and can only appear at the end of a chain.
+	 */
+	template<typename T, int N, typename Kind>
+	struct mexpr_vec
+	{
+		typedef T value_type;
+		typedef Kind kind_type;
+		typedef typename simd_vec_traits<T, N, Kind>::impl_type impl_type;
+
+		static const int length = 1;
+		static const int rows = N;
+		static const int cols = 1;
+		static const bool ends_with_vec = true;
+
+		impl_type a;
+
+		LSIMD_ENSURE_INLINE
+		explicit mexpr_vec(const impl_type& a_) : a(a_) { }
+	};
+
+	/**
+	 * The architecture-specific type of a (partial) chain product
+	 * of size M x N, which is a vector when IsVec is true.
+	 */
+	template<typename T, int M, int N, typename Kind, bool IsVec>
+	struct mexpr_result
+	{
+		typedef typename simd_mat_traits<T, M, N, Kind>::impl_type type;
+	};
+
+	template<typename T, int M, int N, typename Kind>
+	struct mexpr_result<T, M, N, Kind, true>
+	{
+		typedef typename simd_vec_traits<T, M, Kind>::impl_type type;
+	};
+
+	template<class Op, int I, int J>
+	struct mexpr_eval;
+
+	/**
+	 * Matrix chain: the product of two (sub-)chains, as lhs * rhs.
+	 *
+	 * The operands of both sides are flattened into a single sequence,
+	 * which is multiplied in the order chosen by mexpr_plan, regardless
+	 * of how the chain was written.
+	 */
+	template<class L, class R>
+	struct mexpr_chain
+	{
+		typedef typename L::value_type value_type;
+		typedef typename L::kind_type kind_type;
+
+		static const int length = L::length + R::length;
+		static const int rows = L::rows;
+		static const int cols = R::cols;
+		static const bool ends_with_vec = R::ends_with_vec;
+
+		typedef typename mexpr_result<value_type, rows, cols, kind_type, ends_with_vec>::type impl_type;
+
+		L lhs;
+		R rhs;
+
+		LSIMD_ENSURE_INLINE
+		mexpr_chain(const L& lhs_, const R& rhs_) : lhs(lhs_), rhs(rhs_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const
+		{
+			return mexpr_eval<mexpr_chain, 0, length - 1>::run(*this);
+		}
+	};
+
+
+	/**
+	 * Gets the I-th operand of a chain.
+	 */
+	template<class Op, int I>
+	struct mexpr_at;
+
+	template<typename T, int M, int N, typename Kind>
+	struct mexpr_at<mexpr_leaf<T, M, N, Kind>, 0>
+	{
+		typedef mexpr_leaf<T, M, N, Kind> type;
+
+		LSIMD_ENSURE_INLINE
+		static const type& get(const type& x) { return x; }
+	};
+
+	template<typename T, int N, typename Kind>
+	struct mexpr_at<mexpr_vec<T, N, Kind>, 0>
+	{
+		typedef mexpr_vec<T, N, Kind> type;
+
+		LSIMD_ENSURE_INLINE
+		static const type& get(const type& x) { return x; }
+	};
+
+	template<class L, class R, int I, bool InLeft>
+	struct mexpr_chain_at
+	{
+		typedef typename mexpr_at<L, I>::type type;
+
+		LSIMD_ENSURE_INLINE
+		static const type& get(const mexpr_chain<L, R>& c) { return mexpr_at<L, I>::get(c.lhs); }
+	};
+
+	template<class L, class R, int I>
+	struct mexpr_chain_at<L, R, I, false>
+	{
+		typedef typename mexpr_at<R, I - L::length>::type type;
+
+		LSIMD_ENSURE_INLINE
+		static const type& get(const mexpr_chain<L, R>& c) { return mexpr_at<R, I - L::length>::get(c.rhs); }
+	};
+
+	template<class L, class R, int I>
+	struct mexpr_at<mexpr_chain<L, R>, I> : public mexpr_chain_at<L, R, I, (I < L::length)> { };
+
+
+	/**
+	 * The I-th dimension of a chain, that is, the number of rows of 
+	 * the I-th operand, or the number of columns of the chain when
+	 * I equals its length.
+	 */
+	template<class Op, int I, bool Inner = (I < Op::length)>
+	struct mexpr_dim
+	{
+		static const int value = mexpr_at<Op, I>::type::rows;
+	};
+
+	template<class Op, int I>
+	struct mexpr_dim<Op, I, false>
+	{
+		static const int value = Op::cols;
+	};
+
+
+	/**
+	 * The optimal order of multiplying the operands I, ..., J of a chain.
+	 *
+	 * This is the classic dynamic programming on matrix chains, done at 
+	 * compile time: cost is the minimum number of multiply-adds, and 
+	 * the product is formed as (I ... split) * (split + 1 ... J). 
+	 * Ties are resolved to the smallest split, so that a chain ending 
+	 * with a vector is by default evaluated from right to left as 
+	 * successive matrix-vector products.
+	 */
+	template<class Op, int I, int J>
+	struct mexpr_plan;
+
+	template<class Op, int I, int J, int K, bool Last = (K + 1 == J)>
+	struct mexpr_plan_search
+	{
+		typedef mexpr_plan_search<Op, I, J, K + 1> rest_t;
+
+		static const int here = 
+				mexpr_plan<Op, I, K>::cost + mexpr_plan<Op, K + 1, J>::cost + 
+				mexpr_dim<Op, I>::value * mexpr_dim<Op, K + 1>::value * mexpr_dim<Op, J + 1>::value;
+
+		static const int cost = here <= rest_t::cost ? here : rest_t::cost;
+		static const int split = here <= rest_t::cost ? K : rest_t::split;
+	};
+
+	template<class Op, int I, int J, int K>
+	struct mexpr_plan_search<Op, I, J, K, true>
+	{
+		static const int cost = 
+				mexpr_plan<Op, I, K>::cost + mexpr_plan<Op, K + 1, J>::cost + 
+				mexpr_dim<Op, I>::value * mexpr_dim<Op, K + 1>::value * mexpr_dim<Op, J + 1>::value;
+
+		static const int split = K;
+	};
+
+	template<class Op, int I, int J>
+	struct mexpr_plan
+	{
+		static const int cost = mexpr_plan_search<Op, I, J, I>::cost;
+		static const int split = mexpr_plan_search<Op, I, J, I>::split;
+	};
+
+	template<class Op, int I>
+	struct mexpr_plan<Op, I, I>
+	{
+		static const int cost = 0;
+		static const int split = I;
+	};
+
+
+	/**
+	 * Evaluates the product of the operands I, ..., J of a chain, 
+	 * following mexpr_plan.
+	 */
+	template<class Op, int I, int J>
+	struct mexpr_eval
+	{
+		static const int K = mexpr_plan<Op, I, J>::split;
+
+		typedef typename mexpr_result<typename Op::value_type,
+				mexpr_dim<Op, I>::value, mexpr_dim<Op, J + 1>::value, typename Op::kind_type,
+				Op::ends_with_vec && J + 1 == Op::length>::type result_type;
+
+		LSIMD_ENSURE_INLINE
+		static result_type run(const Op& op)
+		{
+			return mexpr_eval<Op, I, K>::run(op) * mexpr_eval<Op, K + 1, J>::run(op);
+		}
+	};
+
+	template<class Op, int I>
+	struct mexpr_eval<Op, I, I>
+	{
+		typedef typename mexpr_at<Op, I>::type::impl_type result_type;
+
+		LSIMD_ENSURE_INLINE
+		static const result_type& run(const Op& op)
+		{
+			return mexpr_at<Op, I>::get(op).a;
+		}
+	};
+
+
+	/**
+	 * Expression node: a matrix chain that ends with a vector, as 
+	 * a1 * ... * ak * x.
+	 *
+	 * When accumulated into a vector, the last matrix-vector product
+	 * of the plan is fused with the accumulation.
+	 */
+	template<typename T, int M, typename Kind, class Op>
+	struct vexpr_mchain
+	{
+		typedef typename simd_vec_traits<T, M, Kind>::impl_type impl_type;
+		static const bool is_leaf = false;
+
+		static const int last = Op::length - 1;
+		static const int split = mexpr_plan<Op, 0, last>::split;
+
+		Op op;
+
+		LSIMD_ENSURE_INLINE
+		explicit vexpr_mchain(const Op& op_) : op(op_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const { return op.eval(); }
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const 
+		{ 
+			y = mexpr_eval<Op, 0, split>::run(op).transform_add(mexpr_eval<Op, split + 1, last>::run(op), y); 
+		}
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const 
+		{ 
+			y = mexpr_eval<Op, 0, split>::run(op).transform_sub(mexpr_eval<Op, split + 1, last>::run(op), y); 
+		}
+	};
+
+
+	template<typename T, int M, int N, typename Kind, class Op>
+	struct simd_mat_expr;
+
+
 	/**
 	 * @brief Generic fixed size matrix.
 	 *  
@@ -453,12 +766,14 @@ namespace lsimd
 		 *
 		 * @param v   The vector to be multiplied with.
 		 *
-		 * @return    The matrix-vector product, as this matrix * v.
+		 * @return    The matrix-vector product, as this matrix * v,
+		 *            which is evaluated lazily (see simd_vec_expr).
 		 */
 		LSIMD_ENSURE_INLINE
-		simd_vec<T, M> operator * (const simd_vec<T, N>& v) const
+		simd_vec_expr<T, M, Kind, vexpr_mtimes<T, M, N, Kind> > operator * (const simd_vec<T, N, Kind>& v) const
 		{
-			return impl * v.impl;
+			return simd_vec_expr<T, M, Kind, vexpr_mtimes<T, M, N, Kind> >(
+					vexpr_mtimes<T, M, N, Kind>(impl, v.impl));
 		}
 
 		/**
@@ -477,22 +792,176 @@ namespace lsimd
 
 	};
 
+	/**
+	 * @brief A lazily evaluated chain of matrix products.
+	 *
+	 * Multiplying matrices yields a chain instead of a matrix, and
+	 * multiplying the chain further with matrices, chains or a vector 
+	 * extends it. When the chain is evaluated, the products are formed 
+	 * in the order that takes the least number of multiply-adds, which 
+	 * is determined at compile time (see mexpr_plan). For instance, 
+	 * A * B * C * x is evaluated as A * (B * (C * x)), which involves 
+	 * three matrix-vector products instead of two matrix-matrix ones.
+	 *
+	 * A chain ending with a vector is a vector expression (see 
+	 * simd_vec_expr). Other chains are also matrices that hold their 
+	 * own values, so that a product such as A * B can be used wherever
+	 * a matrix is expected, as in det(A * B). The value of a chain that
+	 * is only a part of a longer one is never used, and is thus 
+	 * discarded by the compiler once the operators are inlined.
+	 *
+	 * @tparam T    The scalar type.
+	 * @tparam M    The number of rows of the result.
+	 * @tparam N    The number of columns of the result.
+	 * @tparam Kind The kind of architecture.
+	 * @tparam Op   The chain type (see mexpr_chain).
+	 */
+	template<typename T, int M, int N, typename Kind, class Op>
+	struct simd_mat_expr : public simd_mat<T, M, N, Kind>
+	{
+		/**
+		 * The chain of operands.
+		 */
+		Op op;
+
+		LSIMD_ENSURE_INLINE
+		explicit simd_mat_expr(const Op& op_) : simd_mat<T, M, N, Kind>(op_.eval()), op(op_) { }
+
+		/**
+		 * Gets the value of the chain.
+		 *
+		 * @return  The resultant matrix.
+		 */
+		LSIMD_ENSURE_INLINE simd_mat<T, M, N, Kind> eval() const
+		{
+			return *this;
+		}
+	};
+
+
 	/**
 	 * Evaluates matrix-matrix product.
 	 *
 	 * @param A    A matrix of size M x K.
 	 * @param B    A matrix of size K x N.
 	 *
-	 * @return     The product of A and B, whose size is M x N.
+	 * @return     The product of A and B, whose size is M x N, which
+	 *             is evaluated lazily (see simd_mat_expr).
 	 */ 
 	template<typename Kind, typename T, int M, int K, int N>
-	inline simd_mat<T, M, N, Kind> operator * (
+	LSIMD_ENSURE_INLINE 
+	inline simd_mat_expr<T, M, N, Kind, 
+		mexpr_chain<mexpr_leaf<T, M, K, Kind>, mexpr_leaf<T, K, N, Kind> > > 
+	operator * (
 			const simd_mat<T, M, K, Kind>& A,
 			const simd_mat<T, K, N, Kind>& B)
 	{
-		simd_mat<T, M, N, Kind> C;
-		C.impl = A.impl * B.impl;
-		return C;
+		typedef mexpr_chain<mexpr_leaf<T, M, K, Kind>, mexpr_leaf<T, K, N, Kind> > op_t;
+		return simd_mat_expr<T, M, N, Kind, op_t>(
+				op_t(mexpr_leaf<T, M, K, Kind>(A.impl), mexpr_leaf<T, K, N, Kind>(B.impl)));
+	}
+
+	template<typename Kind, typename T, int M, int K, int N, class OpA>
+	LSIMD_ENSURE_INLINE 
+	inline simd_mat_expr<T, M, N, Kind, mexpr_chain<OpA, mexpr_leaf<T, K, N, Kind> > > 
+	operator * (
+			const simd_mat_expr<T, M, K, Kind, OpA>& A,
+			const simd_mat<T, K, N, Kind>& B)
+	{
+		typedef mexpr_chain<OpA, mexpr_leaf<T, K, N, Kind> > op_t;
+		return simd_mat_expr<T, M, N, Kind, op_t>(
+				op_t(A.op, mexpr_leaf<T, K, N, Kind>(B.impl)));
+	}
+
+	template<typename Kind, typename T, int M, int K, int N, class OpB>
+	LSIMD_ENSURE_INLINE 
+	inline simd_mat_expr<T, M, N, Kind, mexpr_chain<mexpr_leaf<T, M, K, Kind>, OpB> > 
+	operator * (
+			const simd_mat<T, M, K, Kind>& A,
+			const simd_mat_expr<T, K, N, Kind, OpB>& B)
+	{
+		typedef mexpr_chain<mexpr_leaf<T, M, K, Kind>, OpB> op_t;
+		return simd_mat_expr<T, M, N, Kind, op_t>(
+				op_t(mexpr_leaf<T, M, K, Kind>(A.impl), B.op));
+	}
+
+	template<typename Kind, typename T, int M, int K, int N, class OpA, class OpB>
+	LSIMD_ENSURE_INLINE 
+	inline simd_mat_expr<T, M, N, Kind, mexpr_chain<OpA, OpB> > 
+	operator * (
+			const simd_mat_expr<T, M, K, Kind, OpA>& A,
+			const simd_mat_expr<T, K, N, Kind, OpB>& B)
+	{
+		typedef mexpr_chain<OpA, OpB> op_t;
+		return simd_mat_expr<T, M, N, Kind, op_t>(op_t(A.op, B.op));
+	}
+
+	/**
+	 * Evaluates the product of a matrix chain and a vector.
+	 *
+	 * @param A    A chain whose product is of size M x N.
+	 * @param v    A vector of length N.
+	 *
+	 * @return     The product A * v, which is evaluated lazily 
+	 *             (see simd_vec_expr).
+	 */ 
+	template<typename Kind, typename T, int M, int N, class OpA>
+	LSIMD_ENSURE_INLINE 
+	inline simd_vec_expr<T, M, Kind, vexpr_mchain<T, M, Kind, mexpr_chain<OpA, mexpr_vec<T, N, Kind> > > > 
+	operator * (
+			const simd_mat_expr<T, M, N, Kind, OpA>& A,
+			const simd_vec<T, N, Kind>& v)
+	{
+		typedef mexpr_chain<OpA, mexpr_vec<T, N, Kind> > op_t;
+		return simd_vec_expr<T, M, Kind, vexpr_mchain<T, M, Kind, op_t> >(
+				vexpr_mchain<T, M, Kind, op_t>(op_t(A.op, mexpr_vec<T, N, Kind>(v.impl))));
+	}
+
+	template<typename Kind, typename T, int M, int N, class OpA, class OpV>
+	LSIMD_ENSURE_INLINE 
+	inline simd_vec_expr<T, M, Kind, vexpr_mchain<T, M, Kind, mexpr_chain<OpA, mexpr_vec<T, N, Kind> > > > 
+	operator * (
+			const simd_mat_expr<T, M, N, Kind, OpA>& A,
+			const simd_vec_expr<T, N, Kind, OpV>& v)
+	{
+		typedef mexpr_chain<OpA, mexpr_vec<T, N, Kind> > op_t;
+		return simd_vec_expr<T, M, Kind, vexpr_mchain<T, M, Kind, op_t> >(
+				vexpr_mchain<T, M, Kind, op_t>(op_t(A.op, mexpr_vec<T, N, Kind>(v.impl))));
+	}
+
+	/**
+	 * Transforms a batch of vectors with a matrix, as ys[i] = A * xs[i].
+	 *
+	 * @param A    A matrix of size M x N.
+	 * @param n    The number of vectors.
+	 * @param xs   The base address of the input vectors.
+	 * @param ldx  The offset between consecutive input vectors (>= N).
+	 * @param ys   The base address of the output vectors.
+	 * @param ldy  The offset between consecutive output vectors (>= M).
+	 *
+	 * @remark     This is considerably faster than multiplying A with
+	 *             each vector in turn. The addresses need not be aligned.
+	 *             ys can be xs when M == N and ldx == ldy.
+	 */
+	template<typename Kind, typename T, int M, int N>
+	inline void batch_transform(const simd_mat<T, M, N, Kind>& A, int n, const T *xs, int ldx, T *ys, int ldy)
+	{
+		batch_transform(A.impl, n, xs, ldx, ys, ldy);
+	}
+
+	/**
+	 * Transforms a batch of packed vectors with a matrix, as 
+	 * ys[i] = A * xs[i].
+	 *
+	 * @param A    A matrix of size M x N.
+	 * @param n    The number of vectors.
+	 * @param xs   The input vectors, stored contiguously (n x N values).
+	 * @param ys   The output vectors, stored contiguously (n x M values).
+	 */
+	template<typename Kind, typename T, int M, int N>
+	inline void batch_transform(const simd_mat<T, M, N, Kind>& A, int n, const T *xs, T *ys)
+	{
+		batch_transform(A.impl, n, xs, ys);
 	}
 
 	/** @} */ // mat_vec_generic
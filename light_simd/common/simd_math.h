@@ -42,14 +42,14 @@
 
 #define LSIMD_DEFINE_SIMD_MATH_FUNC1(fun) \
 	template<typename T, typename Kind> \
-	LSIMD_ENSURE_INLINE \
+	LSIMD_ENSURE_INLINE inline \
 	simd_pack<T, Kind> fun(const simd_pack<T, Kind>& x) \
 	{ return fun(x.impl); }
 
 
 #define LSIMD_DEFINE_SIMD_MATH_FUNC2(fun) \
 	template<typename T, typename Kind> \
-	LSIMD_ENSURE_INLINE \
+	LSIMD_ENSURE_INLINE inline \
 	simd_pack<T, Kind> fun(const simd_pack<T, Kind>& x, const simd_pack<T, Kind>& y) \
 	{ return fun(x.impl, y.impl); }
 
@@ -78,7 +78,11 @@ namespace lsimd
 	 * [Intel SVML (Short Vector Math Library)]
 	 * (http://software.intel.com/sites/products/documentation/hpc/composerxe/en-us/cpp/lin/intref_cls/common/intref_svml_overview.htm) 
 	 * or [AMD LibM]
-	 * (http://developer.amd.com/libraries/LibM).
+	 * (http://developer.amd.com/libraries/LibM),
+	 * selected by defining *LSIMD_USE_INTEL_SVML* or *LSIMD_USE_AMD_LIBM*.
+	 * When neither is selected, the functions are evaluated entry by entry
+	 * with the C library (*LSIMD_USE_NATIVE_MATH*), which is portable
+	 * but not vectorized.
 	 * 
 	 * @remark  Some basic functions like *sqrt*, *floor* and *ceil* are in the 
 	 *          \ref arith module, as we don't rely on SVML or LibM to provide 
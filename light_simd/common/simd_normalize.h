@@ -0,0 +1,553 @@
+/**
+ * @file simd_normalize.h
+ *
+ * @brief Standardization, layer normalization and batch normalization.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_NORMALIZE_H_
+#define LSIMD_SIMD_NORMALIZE_H_
+
+#include "simd_arith.h"
+
+namespace lsimd
+{
+	/**
+	 * @defgroup normalize_generic Normalization
+	 * @ingroup  stats_module
+	 *
+	 * @brief Standardization and layer/batch normalization of arrays
+	 *        and of the rows of matrices.
+	 *
+	 * The mean and the (population) variance are computed in a single
+	 * pass, in the manner of Welford's algorithm: each lane accumulates
+	 * the deviations from its running mean over a block of packs, and
+	 * merges them into its mean and sum of squared deviations at the
+	 * end of the block. This is as robust against large offsets as the
+	 * per-entry update, but needs only one division per block.
+	 *
+	 * The inverse standard deviation 1 / sqrt(var + eps) is obtained
+	 * with approx_rsqrt and a Newton step for f32, and with rsqrt for
+	 * f64.
+	 *
+	 * A matrix of size m x n is stored in row-major order, with an
+	 * offset ld (>= n) between the beginnings of consecutive rows,
+	 * and each row is normalized on its own, except for batchnorm,
+	 * which normalizes each column. The variants suffixed with _mt
+	 * split the rows across threads with OpenMP when LSIMD_HAS_OPENMP
+	 * is defined, and are the same as the serial ones otherwise.
+	 * Neither the matrices nor the vectors need to be aligned.
+	 */
+	/** @{ */
+
+	/**
+	 * Blocking parameters of the normalization routines.
+	 */
+	template<typename T>
+	struct norm_blocking
+	{
+		/**
+		 * The number of packs per lane between the merges of the
+		 * running statistics.
+		 */
+		static const int block_packs = 16;
+
+		/**
+		 * The number of rows assigned to a thread at a time in
+		 * the _mt variants.
+		 */
+		static const int mt_rows = 16;
+
+		/**
+		 * The minimum number of matrix entries for which the _mt
+		 * variants go parallel.
+		 */
+		static const int mt_threshold = 1 << 16;
+	};
+
+
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f32> _rsqrt_nr(const simd_pack<f32>& a)
+	{
+		simd_pack<f32> y = approx_rsqrt(a);
+		return y * (simd_pack<f32>(1.5f) - simd_pack<f32>(0.5f) * a * y * y);
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<f64> _rsqrt_nr(const simd_pack<f64>& a)
+	{
+		return rsqrt(a);
+	}
+
+	template<typename T>
+	inline T _inv_std(T var, T eps)
+	{
+		return _rsqrt_nr(simd_pack<T>(var + eps)).to_scalar();
+	}
+
+	template<typename T>
+	inline void _mean_var(int n, const T *x, T& mean, T& var)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int bp = norm_blocking<T>::block_packs;
+		const int np = n / w;
+
+		T mu = T(0);
+		T m2 = T(0);
+		int c = 0;
+
+		if (np > 0)
+		{
+			// the lanes start from the first pack, with no entries seen
+
+			pack_t mp(x, unaligned_t());
+			pack_t m2p = zero_t();
+
+			for (int k = 0; k < np; )
+			{
+				const int ke = k + bp < np ? k + bp : np;
+
+				pack_t s1a = zero_t();
+				pack_t s2a = zero_t();
+				pack_t s1b = zero_t();
+				pack_t s2b = zero_t();
+
+				int j = k;
+				for (; j + 2 <= ke; j += 2)
+				{
+					pack_t d0 = pack_t(x + j * w, unaligned_t()) - mp;
+					pack_t d1 = pack_t(x + (j + 1) * w, unaligned_t()) - mp;
+					s1a = s1a + d0;
+					s2a = fmadd(d0, d0, s2a);
+					s1b = s1b + d1;
+					s2b = fmadd(d1, d1, s2b);
+				}
+
+				if (j < ke)
+				{
+					pack_t d0 = pack_t(x + j * w, unaligned_t()) - mp;
+					s1a = s1a + d0;
+					s2a = fmadd(d0, d0, s2a);
+				}
+
+				// merge, with t = (mean of the block - running mean) * nb / c
+
+				const pack_t s1 = s1a + s1b;
+				const pack_t s2 = s2a + s2b;
+
+				c += ke - k;
+				const pack_t t = s1 * pack_t(T(1) / T(c));
+				mp = mp + t;
+				m2p = m2p + fnmadd(s1, t, s2);
+
+				k = ke;
+			}
+
+			// merge the lanes, which have the same counts
+
+			mu = mp.sum() / T(w);
+			const pack_t dm = mp - pack_t(mu);
+			m2 = m2p.sum() + T(c) * (dm * dm).sum();
+			c *= w;
+		}
+
+		for (int i = np * w; i < n; ++i)
+		{
+			++c;
+			const T d = x[i] - mu;
+			mu += d / T(c);
+			m2 += d * (x[i] - mu);
+		}
+
+		mean = mu;
+		var = n > 0 && m2 > T(0) ? m2 / T(n) : T(0);
+	}
+
+	template<typename T>
+	inline void _standardize(int n, const T *x, T mean, T inv, T *y)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t mp(mean);
+		const pack_t ip(inv);
+
+		int i = 0;
+		for (; i + 2 * w <= n; i += 2 * w)
+		{
+			pack_t y0 = (pack_t(x + i, unaligned_t()) - mp) * ip;
+			pack_t y1 = (pack_t(x + i + w, unaligned_t()) - mp) * ip;
+			y0.store(y + i, unaligned_t());
+			y1.store(y + i + w, unaligned_t());
+		}
+
+		for (; i < n; ++i) y[i] = (x[i] - mean) * inv;
+	}
+
+	template<typename T>
+	inline void _layernorm(int n, const T *x, T mean, T inv, const T *gamma, const T *beta, T *y)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t mp(mean);
+		const pack_t ip(inv);
+
+		int i = 0;
+		for (; i + 2 * w <= n; i += 2 * w)
+		{
+			pack_t z0 = (pack_t(x + i, unaligned_t()) - mp) * ip;
+			pack_t z1 = (pack_t(x + i + w, unaligned_t()) - mp) * ip;
+			z0 = fmadd(z0, pack_t(gamma + i, unaligned_t()), pack_t(beta + i, unaligned_t()));
+			z1 = fmadd(z1, pack_t(gamma + i + w, unaligned_t()), pack_t(beta + i + w, unaligned_t()));
+			z0.store(y + i, unaligned_t());
+			z1.store(y + i + w, unaligned_t());
+		}
+
+		for (; i < n; ++i) y[i] = (x[i] - mean) * inv * gamma[i] + beta[i];
+	}
+
+	// the statistics of rows [i0, i1), with the inverse standard
+	// deviations of a pack of rows computed at once
+
+	template<typename T>
+	inline void _row_stats(int i0, int i1, int n, const T *x, int ldx, T eps, T *mean, T *inv)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		LSIMD_ALIGN_SSE T v[pack_t::pack_width];
+
+		int i = i0;
+		for (; i + w <= i1; i += w)
+		{
+			for (int k = 0; k < w; ++k)
+			{
+				_mean_var(n, x + (i + k) * ldx, mean[i - i0 + k], v[k]);
+			}
+			_rsqrt_nr(pack_t(v, aligned_t()) + pack_t(eps)).store(inv + (i - i0), unaligned_t());
+		}
+
+		for (; i < i1; ++i)
+		{
+			T vi;
+			_mean_var(n, x + i * ldx, mean[i - i0], vi);
+			inv[i - i0] = _inv_std(vi, eps);
+		}
+	}
+
+	template<typename T>
+	inline void _standardize_rows(int i0, int i1, int n, const T *x, int ldx, T *y, int ldy, T eps)
+	{
+		const int bs = norm_blocking<T>::mt_rows;
+		T mean[bs];
+		T inv[bs];
+
+		for (int ib = i0; ib < i1; ib += bs)
+		{
+			const int ie = ib + bs < i1 ? ib + bs : i1;
+
+			_row_stats(ib, ie, n, x, ldx, eps, mean, inv);
+			for (int i = ib; i < ie; ++i)
+			{
+				_standardize(n, x + i * ldx, mean[i - ib], inv[i - ib], y + i * ldy);
+			}
+		}
+	}
+
+	template<typename T>
+	inline void _layernorm_rows(int i0, int i1, int n, const T *x, int ldx,
+			const T *gamma, const T *beta, T *y, int ldy, T eps)
+	{
+		const int bs = norm_blocking<T>::mt_rows;
+		T mean[bs];
+		T inv[bs];
+
+		for (int ib = i0; ib < i1; ib += bs)
+		{
+			const int ie = ib + bs < i1 ? ib + bs : i1;
+
+			_row_stats(ib, ie, n, x, ldx, eps, mean, inv);
+			for (int i = ib; i < ie; ++i)
+			{
+				_layernorm(n, x + i * ldx, mean[i - ib], inv[i - ib], gamma, beta, y + i * ldy);
+			}
+		}
+	}
+
+
+	/**
+	 * Computes the mean and the population variance of an array.
+	 *
+	 * @param n     The number of entries.
+	 * @param x     The input array.
+	 * @param mean  The output mean (0 when n == 0).
+	 * @param var   The output variance, as sum_i (x[i] - mean)^2 / n.
+	 */
+	template<typename T>
+	inline void mean_var(int n, const T *x, T& mean, T& var)
+	{
+		_mean_var(n, x, mean, var);
+	}
+
+	/**
+	 * Standardizes an array, as y = (x - mean) / sqrt(var + eps).
+	 *
+	 * @param n    The number of entries.
+	 * @param x    The input array.
+	 * @param y    The output array (which can be x itself).
+	 * @param eps  The regularizer added to the variance.
+	 */
+	template<typename T>
+	inline void standardize(int n, const T *x, T *y, T eps)
+	{
+		T mean, var;
+		_mean_var(n, x, mean, var);
+		_standardize(n, x, mean, _inv_std(var, eps), y);
+	}
+
+	/**
+	 * Applies layer normalization to an array, as
+	 * y = (x - mean) / sqrt(var + eps) * gamma + beta.
+	 *
+	 * @param n      The number of entries.
+	 * @param x      The input array.
+	 * @param gamma  The array of scales.
+	 * @param beta   The array of shifts.
+	 * @param y      The output array (which can be x itself).
+	 * @param eps    The regularizer added to the variance.
+	 */
+	template<typename T>
+	inline void layernorm(int n, const T *x, const T *gamma, const T *beta, T *y, T eps = T(1.0e-5))
+	{
+		T mean, var;
+		_mean_var(n, x, mean, var);
+		_layernorm(n, x, mean, _inv_std(var, eps), gamma, beta, y);
+	}
+
+	/**
+	 * Standardizes each row of a matrix.
+	 *
+	 * @param m    The number of rows.
+	 * @param n    The number of columns.
+	 * @param x    The base address of the input matrix.
+	 * @param ldx  The offset between consecutive rows of x.
+	 * @param y    The base address of the output matrix.
+	 * @param ldy  The offset between consecutive rows of y.
+	 * @param eps  The regularizer added to the variances.
+	 */
+	template<typename T>
+	inline void standardize_rows(int m, int n, const T *x, int ldx, T *y, int ldy, T eps)
+	{
+		_standardize_rows(0, m, n, x, ldx, y, ldy, eps);
+	}
+
+	/**
+	 * Applies layer normalization to each row of a matrix.
+	 *
+	 * @param m      The number of rows.
+	 * @param n      The number of columns.
+	 * @param x      The base address of the input matrix.
+	 * @param ldx    The offset between consecutive rows of x.
+	 * @param gamma  The array of scales (of length n).
+	 * @param beta   The array of shifts (of length n).
+	 * @param y      The base address of the output matrix.
+	 * @param ldy    The offset between consecutive rows of y.
+	 * @param eps    The regularizer added to the variances.
+	 */
+	template<typename T>
+	inline void layernorm_rows(int m, int n, const T *x, int ldx,
+			const T *gamma, const T *beta, T *y, int ldy, T eps = T(1.0e-5))
+	{
+		_layernorm_rows(0, m, n, x, ldx, gamma, beta, y, ldy, eps);
+	}
+
+	/**
+	 * Multi-threaded version of standardize_rows, where each thread
+	 * takes a block of rows.
+	 */
+	template<typename T>
+	inline void standardize_rows_mt(int m, int n, const T *x, int ldx, T *y, int ldy, T eps)
+	{
+		const int bs = norm_blocking<T>::mt_rows;
+		const int nb = (m + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(norm_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i0 = b * bs;
+			const int i1 = i0 + bs < m ? i0 + bs : m;
+
+			_standardize_rows(i0, i1, n, x, ldx, y, ldy, eps);
+		}
+	}
+
+	/**
+	 * Multi-threaded version of layernorm_rows, where each thread
+	 * takes a block of rows.
+	 */
+	template<typename T>
+	inline void layernorm_rows_mt(int m, int n, const T *x, int ldx,
+			const T *gamma, const T *beta, T *y, int ldy, T eps = T(1.0e-5))
+	{
+		const int bs = norm_blocking<T>::mt_rows;
+		const int nb = (m + bs - 1) / bs;
+
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(norm_blocking<T>::mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int b = 0; b < nb; ++b)
+		{
+			const int i0 = b * bs;
+			const int i1 = i0 + bs < m ? i0 + bs : m;
+
+			_layernorm_rows(i0, i1, n, x, ldx, gamma, beta, y, ldy, eps);
+		}
+	}
+
+	/**
+	 * Computes the mean and the population variance of each column
+	 * of a matrix (i.e. the statistics of batch normalization), with
+	 * Welford's update applied to a row at a time. The running means
+	 * and sums of squared deviations are kept in the output arrays.
+	 *
+	 * @param m     The number of rows (i.e. the batch size).
+	 * @param n     The number of columns.
+	 * @param x     The base address of the input matrix.
+	 * @param ldx   The offset between consecutive rows of x.
+	 * @param mean  The output array of means (of length n).
+	 * @param var   The output array of variances (of length n).
+	 */
+	template<typename T>
+	inline void mean_var_cols(int m, int n, const T *x, int ldx, T *mean, T *var)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const int nv = n / w * w;
+
+		for (int j = 0; j < n; ++j)
+		{
+			mean[j] = T(0);
+			var[j] = T(0);
+		}
+
+		for (int i = 0; i < m; ++i)
+		{
+			const T *xi = x + i * ldx;
+			const T r = T(1) / T(i + 1);
+			const pack_t rp(r);
+
+			for (int j = 0; j < nv; j += w)
+			{
+				const pack_t v(xi + j, unaligned_t());
+				pack_t mp(mean + j, unaligned_t());
+				const pack_t d = v - mp;
+				mp = fmadd(d, rp, mp);
+				fmadd(d, v - mp, pack_t(var + j, unaligned_t())).store(var + j, unaligned_t());
+				mp.store(mean + j, unaligned_t());
+			}
+
+			for (int j = nv; j < n; ++j)
+			{
+				const T d = xi[j] - mean[j];
+				mean[j] += d * r;
+				var[j] += d * (xi[j] - mean[j]);
+			}
+		}
+
+		if (m > 0)
+		{
+			const T c = T(1) / T(m);
+			for (int j = 0; j < n; ++j) var[j] *= c;
+		}
+	}
+
+	/**
+	 * Applies batch normalization with given statistics, as
+	 * y(i, j) = (x(i, j) - mean[j]) / sqrt(var[j] + eps) * gamma[j] + beta[j].
+	 *
+	 * @param m      The number of rows.
+	 * @param n      The number of columns.
+	 * @param x      The base address of the input matrix.
+	 * @param ldx    The offset between consecutive rows of x.
+	 * @param mean   The array of means (of length n).
+	 * @param var    The array of variances (of length n).
+	 * @param gamma  The array of scales (of length n).
+	 * @param beta   The array of shifts (of length n).
+	 * @param y      The base address of the output matrix.
+	 * @param ldy    The offset between consecutive rows of y.
+	 * @param eps    The regularizer added to the variances.
+	 */
+	template<typename T>
+	inline void batchnorm(int m, int n, const T *x, int ldx,
+			const T *mean, const T *var, const T *gamma, const T *beta,
+			T *y, int ldy, T eps = T(1.0e-5))
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+		const pack_t ep(eps);
+
+		// fold the statistics into a scale and a shift per column,
+		// as y = (x - mean) * a + beta, where a = gamma / sqrt(var + eps)
+
+		int j = 0;
+		for (; j + w <= n; j += w)
+		{
+			const pack_t mp(mean + j, unaligned_t());
+			const pack_t bp(beta + j, unaligned_t());
+			const pack_t ap = _rsqrt_nr(pack_t(var + j, unaligned_t()) + ep) * pack_t(gamma + j, unaligned_t());
+
+			for (int i = 0; i < m; ++i)
+			{
+				const pack_t v(x + i * ldx + j, unaligned_t());
+				fmadd(v - mp, ap, bp).store(y + i * ldy + j, unaligned_t());
+			}
+		}
+
+		for (; j < n; ++j)
+		{
+			const T a = _inv_std(var[j], eps) * gamma[j];
+			for (int i = 0; i < m; ++i)
+			{
+				y[i * ldy + j] = (x[i * ldx + j] - mean[j]) * a + beta[j];
+			}
+		}
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_NORMALIZE_H_ */
@@ -38,6 +38,7 @@
 
 #include <light_simd/common/common_base.h>
 #include <light_simd/sse/sse_pack.h>
+#include <light_simd/sse/sse_ipack.h>
 
 namespace lsimd
 {
@@ -104,7 +105,7 @@ namespace lsimd
 		 * The number of scalars in each pack.
 		 *
 		 * @remark
-		 *  pack_width = 4 (when T is f32)
+		 *  pack_width = 4 (when T is f32, i32 or u32)
 		 *  pack_width = 2 (when T is f64)
 		 */
 		static const unsigned int pack_width = impl_type::pack_width;
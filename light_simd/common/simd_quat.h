@@ -0,0 +1,868 @@
+/**
+ * @file simd_quat.h
+ *
+ * @brief SIMD-based quaternion classes
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, merge, 
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES 
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_QUAT_H_
+#define LSIMD_SIMD_QUAT_H_
+
+#include "simd_mat.h"
+#include "simd_arith.h"
+#include <light_simd/sse/sse_quat.h>
+
+namespace lsimd
+{
+
+	/**
+	 * \addtogroup mat_vec_generic
+	 */
+	/** @{ */
+
+	template<typename T, typename Kind>
+	struct simd_quat_traits;
+
+	template<typename T>
+	struct simd_quat_traits<T, sse_kind>
+	{
+		typedef sse_quat<T> impl_type;
+	};
+
+
+	/**
+	 * @brief Generic quaternion.
+	 *
+	 * @tparam T    The entry value type.
+	 *
+	 * @remarks     The entries are in the order of (x, y, z, w), where
+	 *              (x, y, z) is the vector part and w is the scalar part.
+	 */
+	template<typename T, typename Kind>
+	struct simd_quat
+	{
+		/**
+		 * The entry value type.
+		 */
+		typedef T value_type;
+
+		/**
+		 * The architecture-specific type that provides the internal
+		 * implementation.
+		 */
+		typedef typename simd_quat_traits<T, Kind>::impl_type impl_type;
+
+		/**
+		 * The corresponding SIMD pack type.
+		 */
+		typedef simd_pack<T, Kind> pack_type;
+
+		/**
+		 * The variable that actually implements the functionalities.
+		 */
+		impl_type impl;
+
+
+		/**
+		 * Default constructor.
+		 *
+		 * All entries are left uninitialized.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat() { }
+
+		/**
+		 * Constructs a quaternion with all entries initialized to zeros.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat( zero_t ) : impl( zero_t() ) { }
+
+		/**
+		 * Constructs a quaternion using the internal implementation.
+		 *
+		 * @param imp    The internal implementation.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat( const impl_type& imp ) : impl(imp) { }
+
+		/**
+		 * Constructs a quaternion with given entries.
+		 *
+		 * @param x  The first entry of the vector part.
+		 * @param y  The second entry of the vector part.
+		 * @param z  The third entry of the vector part.
+		 * @param w  The scalar part.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat(const T x, const T y, const T z, const T w)
+		: impl(x, y, z, w) { }
+
+		/**
+		 * Constructs a quaternion by loading (x, y, z, w) from an
+		 * aligned memory address.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat(const T *a, aligned_t)
+		: impl(a, aligned_t()) { }
+
+		/**
+		 * Constructs a quaternion by loading (x, y, z, w) from a memory
+		 * address that is not necessarily aligned.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat(const T *a, unaligned_t)
+		: impl(a, unaligned_t()) { }
+
+		/**
+		 * Constructs a unit quaternion from a rotation matrix.
+		 *
+		 * @param R    The rotation matrix (which should be orthonormal
+		 *             with determinant 1).
+		 */
+		LSIMD_ENSURE_INLINE
+		explicit simd_quat(const simd_mat<T, 3, 3, Kind>& R)
+		: impl(R.impl) { }
+
+		/**
+		 * Gets the identity quaternion, i.e. (0, 0, 0, 1).
+		 */
+		LSIMD_ENSURE_INLINE
+		static simd_quat identity()
+		{
+			return impl_type::identity();
+		}
+
+		/**
+		 * Loads (x, y, z, w) from an aligned memory address.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		LSIMD_ENSURE_INLINE
+		void load(const T *a, aligned_t)
+		{
+			impl.load(a, aligned_t());
+		}
+
+		/**
+		 * Loads (x, y, z, w) from a memory address that is not
+		 * necessarily aligned.
+		 *
+		 * @param a    The memory address from which the values are loaded.
+		 */
+		LSIMD_ENSURE_INLINE
+		void load(const T *a, unaligned_t)
+		{
+			impl.load(a, unaligned_t());
+		}
+
+		/**
+		 * Stores (x, y, z, w) to an aligned memory address.
+		 *
+		 * @param a    The memory address to which the values are stored.
+		 */
+		LSIMD_ENSURE_INLINE
+		void store(T *a, aligned_t) const
+		{
+			impl.store(a, aligned_t());
+		}
+
+		/**
+		 * Stores (x, y, z, w) to a memory address that is not
+		 * necessarily aligned.
+		 *
+		 * @param a    The memory address to which the values are stored.
+		 */
+		LSIMD_ENSURE_INLINE
+		void store(T *a, unaligned_t) const
+		{
+			impl.store(a, unaligned_t());
+		}
+
+		/**
+		 * Gets the first entry of the vector part.
+		 */
+		LSIMD_ENSURE_INLINE T x() const { return impl.x(); }
+
+		/**
+		 * Gets the second entry of the vector part.
+		 */
+		LSIMD_ENSURE_INLINE T y() const { return impl.y(); }
+
+		/**
+		 * Gets the third entry of the vector part.
+		 */
+		LSIMD_ENSURE_INLINE T z() const { return impl.z(); }
+
+		/**
+		 * Gets the scalar part.
+		 */
+		LSIMD_ENSURE_INLINE T w() const { return impl.w(); }
+
+
+		/**
+		 * Adds two quaternions entry-wisely.
+		 *
+		 * @param r    The quaternion of addends.
+		 *
+		 * @return     The resultant quaternion, as this + r.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat operator + (const simd_quat& r) const
+		{
+			return impl + r.impl;
+		}
+
+		/**
+		 * Subtracts two quaternions entry-wisely.
+		 *
+		 * @param r    The quaternion of subtrahends.
+		 *
+		 * @return     The resultant quaternion, as this - r.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat operator - (const simd_quat& r) const
+		{
+			return impl - r.impl;
+		}
+
+		/**
+		 * Negates all entries.
+		 *
+		 * @return     The resultant quaternion, as -this.
+		 *
+		 * @remark     For a unit quaternion, the result represents
+		 *             the same rotation.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat operator - () const
+		{
+			return -impl;
+		}
+
+		/**
+		 * Multiplies with a scale.
+		 *
+		 * @param s    A pack filled with the same scale.
+		 *
+		 * @return     The resultant quaternion, as this * s.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat operator * (const pack_type& s) const
+		{
+			return impl * s.impl;
+		}
+
+		/**
+		 * Composes two quaternions (i.e. the Hamilton product).
+		 *
+		 * @param r    The right hand side quaternion.
+		 *
+		 * @return     The product this * r. For unit quaternions, the
+		 *             result represents applying r first and then this.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat operator * (const simd_quat& r) const
+		{
+			return impl * r.impl;
+		}
+
+		/**
+		 * Gets the conjugate quaternion.
+		 *
+		 * @return     The quaternion (-x, -y, -z, w). For a unit
+		 *             quaternion, this is also its inverse.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat conj() const
+		{
+			return impl.conj();
+		}
+
+		/**
+		 * Computes the inner product of two quaternions, as
+		 * four-dimensional vectors.
+		 *
+		 * @param r    The other quaternion.
+		 *
+		 * @return     The inner product.
+		 */
+		LSIMD_ENSURE_INLINE
+		T dot(const simd_quat& r) const
+		{
+			return impl.dot(r.impl);
+		}
+
+		/**
+		 * Gets the normalized quaternion.
+		 *
+		 * @return     The quaternion scaled to unit norm, via rsqrt
+		 *             of the squared norm.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat normalized() const
+		{
+			return impl.normalized();
+		}
+
+		/**
+		 * Rotates a 3D vector.
+		 *
+		 * @param v    The vector to be rotated.
+		 *
+		 * @return     The rotated vector, as q * v * conj(q).
+		 *
+		 * @remark     This quaternion is assumed to have unit norm.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_vec<T, 3, Kind> rotate(const simd_vec<T, 3, Kind>& v) const
+		{
+			return impl.rotate(v.impl);
+		}
+
+		/**
+		 * Converts to a rotation matrix.
+		 *
+		 * @return     The 3 x 3 rotation matrix R, such that R * v
+		 *             equals rotate(v).
+		 *
+		 * @remark     This quaternion is assumed to have unit norm.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_mat<T, 3, 3, Kind> to_mat() const
+		{
+			return impl.to_mat();
+		}
+	};
+
+
+	/**
+	 * Normalized linear interpolation between two unit quaternions.
+	 *
+	 * @param a   The quaternion at t = 0.
+	 * @param b   The quaternion at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The normalized value of (1 - t) * a + t * b, along
+	 *            the shorter arc.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_quat<T, Kind> nlerp(const simd_quat<T, Kind>& a, const simd_quat<T, Kind>& b, const T t)
+	{
+		return nlerp(a.impl, b.impl, t);
+	}
+
+	/**
+	 * Spherical linear interpolation between two unit quaternions.
+	 *
+	 * @param a   The quaternion at t = 0.
+	 * @param b   The quaternion at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The interpolated rotation along the shorter arc.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_quat<T, Kind> slerp(const simd_quat<T, Kind>& a, const simd_quat<T, Kind>& b, const T t)
+	{
+		return slerp(a.impl, b.impl, t);
+	}
+
+
+	/**
+	 * @brief A pack of quaternions in the structure-of-arrays layout.
+	 *
+	 * Each member holds one component of pack_width quaternions, such
+	 * that all quaternion operations become plain entry-wise pack
+	 * arithmetic, without any shuffling.
+	 *
+	 * In memory, a set of quaternions in this layout is stored as four
+	 * planes: the x components start at q, the y components at q + ldq,
+	 * the z components at q + 2 * ldq, and the w components at q + 3 * ldq.
+	 *
+	 * @tparam T    The entry value type.
+	 */
+	template<typename T, typename Kind=default_simd_kind>
+	struct simd_quat_pack
+	{
+		/**
+		 * The pack type of each component.
+		 */
+		typedef simd_pack<T, Kind> pack_type;
+
+		pack_type x;	///< The first entries of the vector parts.
+		pack_type y;	///< The second entries of the vector parts.
+		pack_type z;	///< The third entries of the vector parts.
+		pack_type w;	///< The scalar parts.
+
+		/**
+		 * Default constructor.
+		 *
+		 * All entries are left uninitialized.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack() { }
+
+		/**
+		 * Constructs from the component packs.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack(const pack_type& x_, const pack_type& y_, const pack_type& z_, const pack_type& w_)
+		: x(x_), y(y_), z(z_), w(w_) { }
+
+		/**
+		 * Constructs by loading from four planes.
+		 *
+		 * @param q      The base address of the x plane.
+		 * @param ldq    The offset between consecutive planes.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack(const T *q, int ldq, AlignT)
+		{
+			load(q, ldq, AlignT());
+		}
+
+		/**
+		 * Loads from four planes.
+		 *
+		 * @param q      The base address of the x plane.
+		 * @param ldq    The offset between consecutive planes.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void load(const T *q, int ldq, AlignT)
+		{
+			x.load(q, AlignT());
+			y.load(q + ldq, AlignT());
+			z.load(q + 2 * ldq, AlignT());
+			w.load(q + 3 * ldq, AlignT());
+		}
+
+		/**
+		 * Stores to four planes.
+		 *
+		 * @param q      The base address of the x plane.
+		 * @param ldq    The offset between consecutive planes.
+		 */
+		template<typename AlignT>
+		LSIMD_ENSURE_INLINE
+		void store(T *q, int ldq, AlignT) const
+		{
+			x.store(q, AlignT());
+			y.store(q + ldq, AlignT());
+			z.store(q + 2 * ldq, AlignT());
+			w.store(q + 3 * ldq, AlignT());
+		}
+
+		/**
+		 * Composes the quaternions pair-wisely (Hamilton product).
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack operator * (const simd_quat_pack& r) const
+		{
+			return simd_quat_pack(
+					w * r.x + x * r.w + y * r.z - z * r.y,
+					w * r.y - x * r.z + y * r.w + z * r.x,
+					w * r.z + x * r.y - y * r.x + z * r.w,
+					w * r.w - x * r.x - y * r.y - z * r.z);
+		}
+
+		/**
+		 * Gets the conjugates.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack conj() const
+		{
+			return simd_quat_pack(-x, -y, -z, w);
+		}
+
+		/**
+		 * Computes the pair-wise inner products.
+		 */
+		LSIMD_ENSURE_INLINE
+		pack_type dot(const simd_quat_pack& r) const
+		{
+			return x * r.x + y * r.y + z * r.z + w * r.w;
+		}
+
+		/**
+		 * Gets the normalized quaternions.
+		 */
+		LSIMD_ENSURE_INLINE
+		simd_quat_pack normalized() const
+		{
+			pack_type s = rsqrt(dot(*this));
+			return simd_quat_pack(x * s, y * s, z * s, w * s);
+		}
+
+		/**
+		 * Rotates a pack of 3D vectors, each by the corresponding quaternion.
+		 *
+		 * @param vx, vy, vz   The components of the input vectors.
+		 * @param rx, ry, rz   The components of the rotated vectors.
+		 *
+		 * @remark  The quaternions are assumed to have unit norms.
+		 */
+		LSIMD_ENSURE_INLINE
+		void rotate(const pack_type& vx, const pack_type& vy, const pack_type& vz,
+				pack_type& rx, pack_type& ry, pack_type& rz) const
+		{
+			// v' = v + w * t + u x t, with t = 2 (u x v)
+
+			pack_type tx = y * vz - z * vy;
+			pack_type ty = z * vx - x * vz;
+			pack_type tz = x * vy - y * vx;
+
+			tx = tx + tx;
+			ty = ty + ty;
+			tz = tz + tz;
+
+			rx = vx + w * tx + (y * tz - z * ty);
+			ry = vy + w * ty + (z * tx - x * tz);
+			rz = vz + w * tz + (x * ty - y * tx);
+		}
+	};
+
+
+	/**
+	 * Normalized linear interpolation between packs of unit quaternions.
+	 *
+	 * @param a   The quaternions at t = 0.
+	 * @param b   The quaternions at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The interpolated quaternions, each along the shorter arc.
+	 */
+	template<typename T, typename Kind>
+	inline simd_quat_pack<T, Kind> nlerp(const simd_quat_pack<T, Kind>& a, const simd_quat_pack<T, Kind>& b, const T t)
+	{
+		typedef simd_pack<T, Kind> pack_t;
+		const unsigned int W = simd<T, Kind>::pack_width;
+
+		T c[W];
+		T tb[W];
+		a.dot(b).store(c, unaligned_t());
+		for (unsigned int i = 0; i < W; ++i) tb[i] = c[i] < T(0) ? -t : t;
+
+		pack_t wa(T(1) - t);
+		pack_t wb(tb, unaligned_t());
+
+		return simd_quat_pack<T, Kind>(
+				a.x * wa + b.x * wb,
+				a.y * wa + b.y * wb,
+				a.z * wa + b.z * wb,
+				a.w * wa + b.w * wb).normalized();
+	}
+
+	/**
+	 * Spherical linear interpolation between packs of unit quaternions.
+	 *
+	 * @param a   The quaternions at t = 0.
+	 * @param b   The quaternions at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The interpolated quaternions, each along the shorter arc.
+	 *
+	 * @remark    The inner products and the interpolation are computed
+	 *            with packs, while the per-lane weights (which involve
+	 *            acos and sin) are computed in scalars.
+	 */
+	template<typename T, typename Kind>
+	inline simd_quat_pack<T, Kind> slerp(const simd_quat_pack<T, Kind>& a, const simd_quat_pack<T, Kind>& b, const T t)
+	{
+		typedef simd_pack<T, Kind> pack_t;
+		const unsigned int W = simd<T, Kind>::pack_width;
+
+		T c[W];
+		T wa_[W];
+		T wb_[W];
+		a.dot(b).store(c, unaligned_t());
+
+		bool all_slerp = true;
+
+		for (unsigned int i = 0; i < W; ++i)
+		{
+			T ci = c[i];
+			T sgn = T(1);
+			if (ci < T(0))
+			{
+				ci = -ci;
+				sgn = T(-1);
+			}
+
+			if (ci > T(0.9995))
+			{
+				wa_[i] = T(1) - t;
+				wb_[i] = t * sgn;
+				all_slerp = false;
+			}
+			else
+			{
+				T th = std::acos(ci);
+				T rs = T(1) / std::sin(th);
+				wa_[i] = std::sin((T(1) - t) * th) * rs;
+				wb_[i] = std::sin(t * th) * rs * sgn;
+			}
+		}
+
+		pack_t wa(wa_, unaligned_t());
+		pack_t wb(wb_, unaligned_t());
+
+		simd_quat_pack<T, Kind> r(
+				a.x * wa + b.x * wb,
+				a.y * wa + b.y * wb,
+				a.z * wa + b.z * wb,
+				a.w * wa + b.w * wb);
+
+		// lanes that fell back to linear interpolation need normalization,
+		// while normalizing the others is harmless
+
+		return all_slerp ? r : r.normalized();
+	}
+
+	/** @} */ // mat_vec_generic
+
+
+	/**
+	 * \defgroup quat_array Quaternion Array Functions
+	 * @ingroup  linalg_module
+	 *
+	 * @brief Functions that act on large sets of quaternions.
+	 *
+	 * The quaternions are stored in the structure-of-arrays layout
+	 * as described in lsimd::simd_quat_pack, i.e. as four planes with
+	 * an offset ldq between consecutive planes. 3D vectors are stored
+	 * likewise as three planes. The planes need not be aligned.
+	 */
+	/** @{ */
+
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline simd_quat<T, Kind> _quat_plane_get(const T *q, int ldq, int i)
+	{
+		return simd_quat<T, Kind>(q[i], q[ldq + i], q[2 * ldq + i], q[3 * ldq + i]);
+	}
+
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void _quat_plane_put(const simd_quat<T, Kind>& s, T *q, int ldq, int i)
+	{
+		q[i] = s.x();
+		q[ldq + i] = s.y();
+		q[2 * ldq + i] = s.z();
+		q[3 * ldq + i] = s.w();
+	}
+
+	/**
+	 * Composes two sets of quaternions pair-wisely, as r[i] = a[i] * b[i].
+	 *
+	 * @param n     The number of quaternions.
+	 * @param a     The base address of the left hand side quaternions.
+	 * @param lda   The plane offset of a.
+	 * @param b     The base address of the right hand side quaternions.
+	 * @param ldb   The plane offset of b.
+	 * @param r     The base address of the results.
+	 * @param ldr   The plane offset of r.
+	 */
+	template<typename T>
+	inline void quat_mul(int n, const T *a, int lda, const T *b, int ldb, T *r, int ldr)
+	{
+		typedef default_simd_kind kind_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_quat_pack<T, kind_t> qa(a + i, lda, unaligned_t());
+			simd_quat_pack<T, kind_t> qb(b + i, ldb, unaligned_t());
+			(qa * qb).store(r + i, ldr, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			_quat_plane_put(
+					_quat_plane_get<T, kind_t>(a, lda, i) *
+					_quat_plane_get<T, kind_t>(b, ldb, i), r, ldr, i);
+		}
+	}
+
+	/**
+	 * Normalizes a set of quaternions.
+	 *
+	 * @param n     The number of quaternions.
+	 * @param q     The base address of the input quaternions.
+	 * @param ldq   The plane offset of q.
+	 * @param r     The base address of the results (can be q).
+	 * @param ldr   The plane offset of r.
+	 */
+	template<typename T>
+	inline void quat_normalize(int n, const T *q, int ldq, T *r, int ldr)
+	{
+		typedef default_simd_kind kind_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_quat_pack<T, kind_t> p(q + i, ldq, unaligned_t());
+			p.normalized().store(r + i, ldr, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			_quat_plane_put(_quat_plane_get<T, kind_t>(q, ldq, i).normalized(), r, ldr, i);
+		}
+	}
+
+	/**
+	 * Rotates a set of 3D vectors, each by the corresponding unit quaternion.
+	 *
+	 * @param n     The number of quaternions (and vectors).
+	 * @param q     The base address of the quaternions.
+	 * @param ldq   The plane offset of q.
+	 * @param v     The base address of the input vectors.
+	 * @param ldv   The plane offset of v.
+	 * @param r     The base address of the rotated vectors.
+	 * @param ldr   The plane offset of r.
+	 */
+	template<typename T>
+	inline void quat_rotate(int n, const T *q, int ldq, const T *v, int ldv, T *r, int ldr)
+	{
+		typedef default_simd_kind kind_t;
+		typedef simd_pack<T, kind_t> pack_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_quat_pack<T, kind_t> p(q + i, ldq, unaligned_t());
+
+			pack_t vx(v + i, unaligned_t());
+			pack_t vy(v + ldv + i, unaligned_t());
+			pack_t vz(v + 2 * ldv + i, unaligned_t());
+
+			pack_t rx, ry, rz;
+			p.rotate(vx, vy, vz, rx, ry, rz);
+
+			rx.store(r + i, unaligned_t());
+			ry.store(r + ldr + i, unaligned_t());
+			rz.store(r + 2 * ldr + i, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			T rv[3] = {v[i], v[ldv + i], v[2 * ldv + i]};
+			simd_vec<T, 3, kind_t> vi(rv, unaligned_t());
+
+			_quat_plane_get<T, kind_t>(q, ldq, i).rotate(vi).store(rv, unaligned_t());
+			r[i] = rv[0];
+			r[ldr + i] = rv[1];
+			r[2 * ldr + i] = rv[2];
+		}
+	}
+
+	/**
+	 * Normalized linear interpolation between two sets of unit quaternions.
+	 *
+	 * @param n     The number of quaternions.
+	 * @param a     The base address of the quaternions at t = 0.
+	 * @param lda   The plane offset of a.
+	 * @param b     The base address of the quaternions at t = 1.
+	 * @param ldb   The plane offset of b.
+	 * @param t     The interpolation coefficient, in [0, 1].
+	 * @param r     The base address of the results.
+	 * @param ldr   The plane offset of r.
+	 */
+	template<typename T>
+	inline void quat_nlerp(int n, const T *a, int lda, const T *b, int ldb, const T t, T *r, int ldr)
+	{
+		typedef default_simd_kind kind_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_quat_pack<T, kind_t> qa(a + i, lda, unaligned_t());
+			simd_quat_pack<T, kind_t> qb(b + i, ldb, unaligned_t());
+			nlerp(qa, qb, t).store(r + i, ldr, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			_quat_plane_put(nlerp(
+					_quat_plane_get<T, kind_t>(a, lda, i),
+					_quat_plane_get<T, kind_t>(b, ldb, i), t), r, ldr, i);
+		}
+	}
+
+	/**
+	 * Spherical linear interpolation between two sets of unit quaternions.
+	 *
+	 * @param n     The number of quaternions.
+	 * @param a     The base address of the quaternions at t = 0.
+	 * @param lda   The plane offset of a.
+	 * @param b     The base address of the quaternions at t = 1.
+	 * @param ldb   The plane offset of b.
+	 * @param t     The interpolation coefficient, in [0, 1].
+	 * @param r     The base address of the results.
+	 * @param ldr   The plane offset of r.
+	 */
+	template<typename T>
+	inline void quat_slerp(int n, const T *a, int lda, const T *b, int ldb, const T t, T *r, int ldr)
+	{
+		typedef default_simd_kind kind_t;
+		const int W = (int)simd<T, kind_t>::pack_width;
+		const int m = n - n % W;
+
+		for (int i = 0; i < m; i += W)
+		{
+			simd_quat_pack<T, kind_t> qa(a + i, lda, unaligned_t());
+			simd_quat_pack<T, kind_t> qb(b + i, ldb, unaligned_t());
+			slerp(qa, qb, t).store(r + i, ldr, unaligned_t());
+		}
+
+		for (int i = m; i < n; ++i)
+		{
+			_quat_plane_put(slerp(
+					_quat_plane_get<T, kind_t>(a, lda, i),
+					_quat_plane_get<T, kind_t>(b, ldb, i), t), r, ldr, i);
+		}
+	}
+
+	/** @} */ // quat_array
+}
+
+#endif /* SIMD_QUAT_H_ */
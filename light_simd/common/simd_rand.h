@@ -0,0 +1,632 @@
+/**
+ * @file simd_rand.h
+ *
+ * @brief Pseudo-random number generators producing SIMD packs.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_RAND_H_
+#define LSIMD_SIMD_RAND_H_
+
+#include "simd_arith.h"
+#include "simd_math.h"
+
+namespace lsimd
+{
+	/**
+	 * @defgroup rand_generic Random Number Generation
+	 * @ingroup  signal_module
+	 *
+	 * @brief Vectorized pseudo-random number generators.
+	 *
+	 * Two generators are provided:
+	 * - philox4x32: the counter-based Philox-4x32-10 generator, whose
+	 *   output is identical to the reference implementation
+	 *   (Salmon et al., 2011). Each (seed, stream) pair selects an
+	 *   independent sequence, and any position can be reached in
+	 *   constant time.
+	 * - xoshiro128p: eight interleaved xoshiro128+ generators, seeded
+	 *   by splitmix64. This is the faster of the two, but its lowest
+	 *   bits are weak, which does not matter for the real-valued
+	 *   outputs below (they only use the higher bits).
+	 *
+	 * Both produce a stream of 32-bit words in blocks of
+	 * \ref rand_block_size words. The stream, and everything derived
+	 * from it, depends only on the seed, not on the pack width:
+	 * - A uniform f32 value takes one word, as (w >> 8) * 2^-24.
+	 * - A uniform f64 value takes two consecutive words, whose 52
+	 *   higher bits (the second word being the higher half) make
+	 *   up the mantissa of a value in [1, 2), minus one.
+	 * - The fill functions consume whole blocks, and discard the
+	 *   unused part of the last one.
+	 *
+	 * Normal variates are generated by the Box-Muller transform, where
+	 * the first half of the uniform values from a block are paired with
+	 * the second half. They depend on the rounding of the log, sqrt,
+	 * sin and cos functions of the math backend (see \ref math).
+	 */
+	/** @{ */
+
+	/**
+	 * The number of 32-bit words generated at a time.
+	 */
+	const int rand_block_size = 16;
+
+
+	/************************************************
+	 *
+	 *  The block stream
+	 *
+	 ************************************************/
+
+	/**
+	 * @brief The buffered stream of words shared by the generators.
+	 *
+	 * @tparam Derived  The generator class, which implements
+	 *                  _generate(u32 *dst, int nb) to write the
+	 *                  next nb blocks of words to dst.
+	 */
+	template<class Derived>
+	class rand_stream
+	{
+	public:
+		typedef simd_pack<u32> pack_type;
+
+		rand_stream() : m_pos(rand_block_size) { }
+
+		/**
+		 * Gets the next pack of words.
+		 */
+		LSIMD_ENSURE_INLINE pack_type next()
+		{
+			if (m_pos == rand_block_size)
+			{
+				derived()._generate(m_buf, 1);
+				m_pos = 0;
+			}
+
+			pack_type r(m_buf + m_pos, unaligned_t());
+			m_pos += (int)pack_type::pack_width;
+			return r;
+		}
+
+		/**
+		 * Writes the next nb * \ref rand_block_size words to dst.
+		 */
+		void next_blocks(u32 *dst, int nb)
+		{
+			if (nb <= 0) return;
+
+			if (m_pos == rand_block_size)
+			{
+				derived()._generate(dst, nb);
+			}
+			else
+			{
+				// the buffered words come first, and the buffer is
+				// refilled at the same position
+
+				const int r = rand_block_size - m_pos;
+				for (int i = 0; i < r; ++i) dst[i] = m_buf[m_pos + i];
+
+				derived()._generate(dst + r, nb - 1);
+				derived()._generate(m_buf, 1);
+
+				u32 *tail = dst + nb * rand_block_size - m_pos;
+				for (int i = 0; i < m_pos; ++i) tail[i] = m_buf[i];
+			}
+		}
+
+		/**
+		 * Writes the next \ref rand_block_size words to dst.
+		 */
+		void next_block(u32 *dst)
+		{
+			next_blocks(dst, 1);
+		}
+
+	protected:
+		// drops the buffered words, after the state is changed
+		void reset_buffer()
+		{
+			m_pos = rand_block_size;
+		}
+
+	private:
+		Derived& derived()
+		{
+			return *static_cast<Derived*>(this);
+		}
+
+		u32 m_buf[rand_block_size];
+		int m_pos;
+	};
+
+
+	/************************************************
+	 *
+	 *  Philox-4x32-10
+	 *
+	 ************************************************/
+
+	/**
+	 * @brief The counter-based Philox-4x32-10 generator.
+	 *
+	 * The k-th Philox block (four words) of the stream encrypts the
+	 * counter (lo(k), hi(k), lo(stream), hi(stream)) with the key
+	 * (lo(seed), hi(seed)). Four blocks are computed at a time, one
+	 * in each lane.
+	 *
+	 * @remark  This requires the width of simd_pack<u32> to be 4.
+	 */
+	class philox4x32 : public rand_stream<philox4x32>
+	{
+	public:
+		typedef simd_pack<u32> pack_type;
+
+		/**
+		 * Constructs a generator at the beginning of a stream.
+		 *
+		 * @param seed    The key.
+		 * @param stream  The index of the stream.
+		 */
+		explicit philox4x32(u64 seed = 0, u64 stream = 0)
+		{
+			this->seed(seed, stream);
+		}
+
+		/**
+		 * Restarts the generator at the beginning of a stream.
+		 */
+		void seed(u64 seed, u64 stream = 0)
+		{
+			m_key[0] = (u32)seed;
+			m_key[1] = (u32)(seed >> 32);
+			m_stream[0] = (u32)stream;
+			m_stream[1] = (u32)(stream >> 32);
+			set_counter(0);
+		}
+
+		/**
+		 * Moves to the beginning of the k-th Philox block (i.e. the
+		 * word 4 k) of the current stream.
+		 */
+		void set_counter(u64 k)
+		{
+			m_ctr = k;
+			reset_buffer();
+		}
+
+		// writes the next 4 nb Philox blocks to dst
+
+		void _generate(u32 *dst, int nb)
+		{
+			for (int b = 0; b < nb; ++b, dst += rand_block_size)
+			{
+				_generate4(dst);
+			}
+		}
+
+	private:
+		LSIMD_ENSURE_INLINE void _generate4(u32 *dst)
+		{
+			LSIMD_ALIGN_SSE u32 c0s[4];
+			LSIMD_ALIGN_SSE u32 c1s[4];
+			for (int i = 0; i < 4; ++i)
+			{
+				const u64 c = m_ctr + (u64)i;
+				c0s[i] = (u32)c;
+				c1s[i] = (u32)(c >> 32);
+			}
+			m_ctr += 4;
+
+			pack_type c0(c0s, aligned_t());
+			pack_type c1(c1s, aligned_t());
+			pack_type c2(m_stream[0]);
+			pack_type c3(m_stream[1]);
+
+			const pack_type m0(0xD2511F53u);
+			const pack_type m1(0xCD9E8D57u);
+
+			const pack_type w0(0x9E3779B9u);
+			const pack_type w1(0xBB67AE85u);
+
+			pack_type k0(m_key[0]);
+			pack_type k1(m_key[1]);
+
+			for (int r = 0; r < 10; ++r)
+			{
+				pack_type hi0, lo0, hi1, lo1;
+				mulhilo(m0, c0, hi0, lo0);
+				mulhilo(m1, c2, hi1, lo1);
+
+				c0 = hi1 ^ c1 ^ k0;
+				c1 = lo1;
+				c2 = hi0 ^ c3 ^ k1;
+				c3 = lo0;
+
+				k0 = k0 + w0;
+				k1 = k1 + w1;
+			}
+
+			transpose4(c0, c1, c2, c3);
+
+			c0.store(dst, unaligned_t());
+			c1.store(dst + 4, unaligned_t());
+			c2.store(dst + 8, unaligned_t());
+			c3.store(dst + 12, unaligned_t());
+		}
+
+		u32 m_key[2];
+		u32 m_stream[2];
+		u64 m_ctr;
+	};
+
+
+	/************************************************
+	 *
+	 *  xoshiro128+
+	 *
+	 ************************************************/
+
+	/**
+	 * @brief Eight interleaved xoshiro128+ generators.
+	 *
+	 * The i-th word of each group of eight comes from the i-th
+	 * generator. The generators are seeded with consecutive
+	 * outputs of splitmix64. Two groups of four generators are
+	 * stepped side by side, which hides the latency of the
+	 * dependent operations within each step.
+	 *
+	 * @remark  This requires the width of simd_pack<u32> to be 4.
+	 */
+	class xoshiro128p : public rand_stream<xoshiro128p>
+	{
+	public:
+		typedef simd_pack<u32> pack_type;
+
+		/**
+		 * The number of interleaved generators.
+		 */
+		static const int lanes = 8;
+
+		/**
+		 * Constructs a generator with a given seed.
+		 */
+		explicit xoshiro128p(u64 seed = 0)
+		{
+			this->seed(seed);
+		}
+
+		/**
+		 * Restarts the generator with a given seed.
+		 */
+		void seed(u64 seed)
+		{
+			LSIMD_ALIGN_SSE u32 s[4][lanes];
+
+			for (int i = 0; i < lanes; ++i)
+			{
+				const u64 a = _splitmix64(seed);
+				const u64 b = _splitmix64(seed);
+
+				s[0][i] = (u32)a;
+				s[1][i] = (u32)(a >> 32);
+				s[2][i] = (u32)b;
+				s[3][i] = (u32)(b >> 32);
+			}
+
+			for (int k = 0; k < 4; ++k)
+			{
+				m_a[k].load(s[k], aligned_t());
+				m_b[k].load(s[k] + 4, aligned_t());
+			}
+
+			reset_buffer();
+		}
+
+		// writes the next 2 nb steps of the generators to dst
+
+		void _generate(u32 *dst, int nb)
+		{
+			pack_type a0 = m_a[0], a1 = m_a[1], a2 = m_a[2], a3 = m_a[3];
+			pack_type b0 = m_b[0], b1 = m_b[1], b2 = m_b[2], b3 = m_b[3];
+
+			for (int i = 0; i < 2 * nb; ++i, dst += 8)
+			{
+				(a0 + a3).store(dst, unaligned_t());
+				(b0 + b3).store(dst + 4, unaligned_t());
+
+				_step(a0, a1, a2, a3);
+				_step(b0, b1, b2, b3);
+			}
+
+			m_a[0] = a0; m_a[1] = a1; m_a[2] = a2; m_a[3] = a3;
+			m_b[0] = b0; m_b[1] = b1; m_b[2] = b2; m_b[3] = b3;
+		}
+
+		// the splitmix64 generator, used for seeding
+
+		static u64 _splitmix64(u64& x)
+		{
+			x += 0x9E3779B97F4A7C15ull;
+			u64 z = x;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+	private:
+		LSIMD_ENSURE_INLINE
+		static void _step(pack_type& s0, pack_type& s1, pack_type& s2, pack_type& s3)
+		{
+			const pack_type t = s1 << 9;
+			s2 = s2 ^ s0;
+			s3 = s3 ^ s1;
+			s1 = s1 ^ s2;
+			s0 = s0 ^ s3;
+			s2 = s2 ^ t;
+			s3 = (s3 << 11) | (s3 >> 21);
+		}
+
+		pack_type m_a[4];
+		pack_type m_b[4];
+	};
+
+
+	/************************************************
+	 *
+	 *  Real-valued variates
+	 *
+	 ************************************************/
+
+	template<typename T> struct _rand_real;
+
+	template<>
+	struct _rand_real<f32>
+	{
+		typedef simd_pack<f32> pack_t;
+
+		static const int words = 1;
+
+		// uniform in [0, 1), from w >> 8
+
+		LSIMD_ENSURE_INLINE
+		static pack_t uniform(const simd_pack<u32>& w)
+		{
+			return cvt_f32(as_i32(w >> 8)) * pack_t(5.9604644775390625e-8f);
+		}
+	};
+
+	template<>
+	struct _rand_real<f64>
+	{
+		typedef simd_pack<f64> pack_t;
+
+		static const int words = 2;
+
+		// uniform in [0, 1), from 1.m - 1, with m taken from the
+		// (lower word, higher word >> 12) of each pair of words
+
+		LSIMD_ENSURE_INLINE
+		static pack_t uniform(const simd_pack<u32>& w)
+		{
+			static const LSIMD_ALIGN_SSE u32 hmask[4] = {0u, 0xFFFFFFFFu, 0u, 0xFFFFFFFFu};
+			static const LSIMD_ALIGN_SSE u32 hexpo[4] = {0u, 0x3FF00000u, 0u, 0x3FF00000u};
+
+			const simd_pack<u32> m(hmask, aligned_t());
+			const simd_pack<u32> e(hexpo, aligned_t());
+			const simd_pack<u32> h = (w >> 12) & m;
+
+			return as_f64((w & (m ^ simd_pack<u32>(0xFFFFFFFFu))) | h | e) - pack_t(1.0);
+		}
+	};
+
+
+	/**
+	 * Gets the next pack of uniformly distributed values in [0, 1).
+	 *
+	 * @tparam T    The value type (f32 or f64).
+	 * @param rng   The generator.
+	 *
+	 * @remark  This takes one pack of words, which makes one pack
+	 *          of f32 values, or one pack of f64 values.
+	 */
+	template<typename T, class RNG>
+	LSIMD_ENSURE_INLINE
+	inline simd_pack<T> uniform(RNG& rng)
+	{
+		return _rand_real<T>::uniform(rng.next());
+	}
+
+
+	/************************************************
+	 *
+	 *  Array filling
+	 *
+	 ************************************************/
+
+	/**
+	 * The number of blocks generated at a time by the fill functions.
+	 */
+	const int rand_fill_blocks = 16;
+
+	/**
+	 * Fills an array with random 32-bit words.
+	 *
+	 * @param rng  The generator.
+	 * @param n    The number of words.
+	 * @param a    The output array.
+	 */
+	template<class RNG>
+	inline void fill(RNG& rng, int n, u32 *a)
+	{
+		const int nb = n / rand_block_size;
+		rng.next_blocks(a, nb);
+
+		n -= nb * rand_block_size;
+		if (n > 0)
+		{
+			u32 w[rand_block_size];
+			rng.next_block(w);
+			for (int i = 0; i < n; ++i) a[nb * rand_block_size + i] = w[i];
+		}
+	}
+
+
+	// converts each block of words into values with op(blk, dst)
+
+	template<typename T, class RNG, class Op>
+	void _rand_fill(RNG& rng, int n, T *a, const Op& op)
+	{
+		const int m = rand_block_size / _rand_real<T>::words;
+		LSIMD_ALIGN_SSE u32 blk[rand_block_size * rand_fill_blocks];
+
+		while (n > 0)
+		{
+			int nb = (n + m - 1) / m;
+			if (nb > rand_fill_blocks) nb = rand_fill_blocks;
+			rng.next_blocks(blk, nb);
+
+			for (int j = 0; j < nb; ++j, n -= m, a += m)
+			{
+				if (n >= m)
+				{
+					op(blk + j * rand_block_size, a);
+				}
+				else
+				{
+					LSIMD_ALIGN_SSE T r[rand_block_size];
+					op(blk + j * rand_block_size, r);
+					for (int i = 0; i < n; ++i) a[i] = r[i];
+					return;
+				}
+			}
+		}
+	}
+
+	template<typename T>
+	struct _rand_uniform_op
+	{
+		typedef simd_pack<T> pack_t;
+		static const int m = rand_block_size / _rand_real<T>::words;
+
+		pack_t lb;
+		pack_t d;
+
+		_rand_uniform_op(const T lb_, const T ub_) : lb(lb_), d(ub_ - lb_) { }
+
+		LSIMD_ENSURE_INLINE void operator() (const u32 *blk, T *dst) const
+		{
+			const int w = (int)pack_t::pack_width;
+
+			for (int j = 0; j < m; j += w)
+			{
+				pack_t u = _rand_real<T>::uniform(
+						simd_pack<u32>(blk + j * _rand_real<T>::words, aligned_t()));
+				fmadd(u, d, lb).store(dst + j, unaligned_t());
+			}
+		}
+	};
+
+	template<typename T>
+	struct _rand_normal_op
+	{
+		typedef simd_pack<T> pack_t;
+		static const int m = rand_block_size / _rand_real<T>::words;
+		static const int h = m / 2;
+
+		pack_t mu;
+		pack_t sigma;
+
+		_rand_normal_op(const T mu_, const T sigma_) : mu(mu_), sigma(sigma_) { }
+
+		LSIMD_ENSURE_INLINE void operator() (const u32 *blk, T *dst) const
+		{
+			const int w = (int)pack_t::pack_width;
+			const pack_t one(T(1));
+			const pack_t m2(T(-2));
+			const pack_t two_pi(T(6.283185307179586476925286766559));
+
+			for (int j = 0; j < h; j += w)
+			{
+				pack_t u1 = _rand_real<T>::uniform(
+						simd_pack<u32>(blk + j * _rand_real<T>::words, aligned_t()));
+				pack_t u2 = _rand_real<T>::uniform(
+						simd_pack<u32>(blk + (h + j) * _rand_real<T>::words, aligned_t()));
+
+				// 1 - u1 is in (0, 1], so that the log is finite
+				pack_t rho = sqrt(m2 * log(one - u1)) * sigma;
+				pack_t theta = two_pi * u2;
+
+				fmadd(rho, cos(theta), mu).store(dst + j, unaligned_t());
+				fmadd(rho, sin(theta), mu).store(dst + h + j, unaligned_t());
+			}
+		}
+	};
+
+
+	/**
+	 * Fills an array with values uniformly distributed in [lb, ub).
+	 *
+	 * @tparam T    The value type (f32 or f64).
+	 * @param rng   The generator.
+	 * @param n     The number of values.
+	 * @param a     The output array.
+	 * @param lb    The lower bound.
+	 * @param ub    The upper bound.
+	 */
+	template<typename T, class RNG>
+	inline void fill_uniform(RNG& rng, int n, T *a, const T lb, const T ub)
+	{
+		_rand_fill(rng, n, a, _rand_uniform_op<T>(lb, ub));
+	}
+
+	/**
+	 * Fills an array with normally distributed values.
+	 *
+	 * @tparam T      The value type (f32 or f64).
+	 * @param rng     The generator.
+	 * @param n       The number of values.
+	 * @param a       The output array.
+	 * @param mu      The mean.
+	 * @param sigma   The standard deviation.
+	 */
+	template<typename T, class RNG>
+	inline void fill_normal(RNG& rng, int n, T *a, const T mu, const T sigma)
+	{
+		_rand_fill(rng, n, a, _rand_normal_op<T>(mu, sigma));
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_RAND_H_ */
@@ -0,0 +1,311 @@
+/**
+ * @file simd_scan.h
+ *
+ * @brief Inclusive and exclusive scans (prefix sums) of arrays.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_SCAN_H_
+#define LSIMD_SIMD_SCAN_H_
+
+#include "simd_arith.h"
+
+namespace lsimd
+{
+	/**
+	 * @defgroup scan_generic Prefix Sums
+	 * @ingroup  stats_module
+	 *
+	 * @brief Inclusive and exclusive scans of arrays, e.g. to turn
+	 *        counts into the offsets of a CSR matrix, or a histogram
+	 *        into a cumulative one.
+	 *
+	 * Each pack is scanned in registers with prefix_sum, and the sum
+	 * of all preceding entries is carried in a broadcast pack, which
+	 * costs a single addition per pack on the critical path.
+	 *
+	 * The multi-threaded versions take two passes over each group of
+	 * fixed blocks (see scan_blocking): the first computes the sum of
+	 * each block, and the second scans each block starting from the
+	 * sum of all preceding ones. Both x and y may refer to the same
+	 * array.
+	 */
+	/** @{ */
+
+	/**
+	 * Blocking parameters of the multi-threaded scans.
+	 */
+	template<typename T>
+	struct scan_blocking
+	{
+		/**
+		 * The number of entries in a block, which is fixed so that
+		 * the results do not depend on the number of threads.
+		 */
+		static const int mt_block = 1 << 14;
+
+		/**
+		 * The number of blocks in a group. The blocks of a group are
+		 * summed and then scanned before moving on to the next group,
+		 * so that the second pass finds them in cache.
+		 */
+		static const int mt_group = 32;
+
+		/**
+		 * The minimum number of entries for which the multi-threaded
+		 * scans go parallel (below which they take a single pass).
+		 */
+		static const int mt_threshold = 1 << 18;
+	};
+
+
+	// y[i] = init + x[0] + ... + x[i], returns init + x[0] + ... + x[n-1]
+
+	template<typename T>
+	inline T _scan_incl(int n, const T *x, T *y, const T init)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		int i = 0;
+		T s = init;
+
+		if (n >= 2 * w)
+		{
+			pack_t c(init);
+
+			for (; i + 2 * w <= n; i += 2 * w)
+			{
+				pack_t q0 = prefix_sum(pack_t(x + i, unaligned_t()));
+				pack_t q1 = prefix_sum(pack_t(x + i + w, unaligned_t()));
+
+				(c + q0).store(y + i, unaligned_t());
+				c = c + q0.template bsx<pack_t::pack_width - 1>();
+				(c + q1).store(y + i + w, unaligned_t());
+				c = c + q1.template bsx<pack_t::pack_width - 1>();
+			}
+			s = c.to_scalar();
+		}
+
+		for (; i < n; ++i) y[i] = (s += x[i]);
+		return s;
+	}
+
+	// y[i] = init + x[0] + ... + x[i-1], returns init + x[0] + ... + x[n-1]
+
+	template<typename T>
+	inline T _scan_excl(int n, const T *x, T *y, const T init)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		int i = 0;
+		T s = init;
+
+		if (n >= 2 * w)
+		{
+			pack_t c(init);
+
+			for (; i + 2 * w <= n; i += 2 * w)
+			{
+				pack_t q0 = prefix_sum(pack_t(x + i, unaligned_t()));
+				pack_t q1 = prefix_sum(pack_t(x + i + w, unaligned_t()));
+
+				(c + q0.template shift_back<1>()).store(y + i, unaligned_t());
+				c = c + q0.template bsx<pack_t::pack_width - 1>();
+				(c + q1.template shift_back<1>()).store(y + i + w, unaligned_t());
+				c = c + q1.template bsx<pack_t::pack_width - 1>();
+			}
+			s = c.to_scalar();
+		}
+
+		for (; i < n; ++i)
+		{
+			const T v = x[i];
+			y[i] = s;
+			s += v;
+		}
+		return s;
+	}
+
+	// the sum of x[0 .. n)
+
+	template<typename T>
+	inline T _scan_sum(int n, const T *x)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		int i = 0;
+		T s(0);
+
+		if (n >= 4 * w)
+		{
+			pack_t s0(x, unaligned_t());
+			pack_t s1(x + w, unaligned_t());
+			pack_t s2(x + 2 * w, unaligned_t());
+			pack_t s3(x + 3 * w, unaligned_t());
+
+			for (i = 4 * w; i + 4 * w <= n; i += 4 * w)
+			{
+				s0 = s0 + pack_t(x + i, unaligned_t());
+				s1 = s1 + pack_t(x + i + w, unaligned_t());
+				s2 = s2 + pack_t(x + i + 2 * w, unaligned_t());
+				s3 = s3 + pack_t(x + i + 3 * w, unaligned_t());
+			}
+			s = ((s0 + s1) + (s2 + s3)).sum();
+		}
+
+		for (; i < n; ++i) s += x[i];
+		return s;
+	}
+
+	template<typename T, bool Incl>
+	inline T _scan_mt(int n, const T *x, T *y, const T init)
+	{
+		const int bs = scan_blocking<T>::mt_block;
+		const int gs = scan_blocking<T>::mt_group;
+
+		if (n < scan_blocking<T>::mt_threshold)
+		{
+			return Incl ? _scan_incl(n, x, y, init) : _scan_excl(n, x, y, init);
+		}
+
+		T offs[scan_blocking<T>::mt_group];
+		T s = init;
+
+		for (int i0 = 0; i0 < n; i0 += bs * gs)
+		{
+			const int r = n - i0;
+			const int nb = r < bs * gs ? (r + bs - 1) / bs : gs;
+
+#ifdef LSIMD_HAS_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+			for (int b = 0; b < nb; ++b)
+			{
+				const int i = i0 + b * bs;
+				offs[b] = _scan_sum(bs < n - i ? bs : n - i, x + i);
+			}
+
+			for (int b = 0; b < nb; ++b)
+			{
+				const T t = offs[b];
+				offs[b] = s;
+				s += t;
+			}
+
+#ifdef LSIMD_HAS_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+			for (int b = 0; b < nb; ++b)
+			{
+				const int i = i0 + b * bs;
+				const int m = bs < n - i ? bs : n - i;
+
+				if (Incl)
+					_scan_incl(m, x + i, y + i, offs[b]);
+				else
+					_scan_excl(m, x + i, y + i, offs[b]);
+			}
+		}
+
+		return s;
+	}
+
+
+	/**
+	 * Computes the inclusive scan of an array.
+	 *
+	 * @param n     The number of entries.
+	 * @param x     The input array (of length n).
+	 * @param y     The output array (of length n), with
+	 *              y[i] = init + x[0] + ... + x[i].
+	 * @param init  The value to start from.
+	 *
+	 * @return      The total, as init + x[0] + ... + x[n-1].
+	 */
+	template<typename T>
+	inline T inclusive_scan(int n, const T *x, T *y, const T init = T(0))
+	{
+		return _scan_incl(n, x, y, init);
+	}
+
+	/**
+	 * Computes the exclusive scan of an array.
+	 *
+	 * @param n     The number of entries.
+	 * @param x     The input array (of length n).
+	 * @param y     The output array (of length n), with
+	 *              y[i] = init + x[0] + ... + x[i-1].
+	 * @param init  The value to start from.
+	 *
+	 * @return      The total, as init + x[0] + ... + x[n-1], which
+	 *              is the entry that would follow y[n-1] (e.g. the
+	 *              number of non-zeros, for the offsets of CSR rows).
+	 */
+	template<typename T>
+	inline T exclusive_scan(int n, const T *x, T *y, const T init = T(0))
+	{
+		return _scan_excl(n, x, y, init);
+	}
+
+	/**
+	 * Multi-threaded version of inclusive_scan.
+	 *
+	 * @remark  For real values, the results may differ from those of
+	 *          inclusive_scan by rounding errors, as the blocks are
+	 *          summed separately.
+	 */
+	template<typename T>
+	inline T inclusive_scan_mt(int n, const T *x, T *y, const T init = T(0))
+	{
+		return _scan_mt<T, true>(n, x, y, init);
+	}
+
+	/**
+	 * Multi-threaded version of exclusive_scan.
+	 *
+	 * @remark  For real values, the results may differ from those of
+	 *          exclusive_scan by rounding errors, as the blocks are
+	 *          summed separately.
+	 */
+	template<typename T>
+	inline T exclusive_scan_mt(int n, const T *x, T *y, const T init = T(0))
+	{
+		return _scan_mt<T, false>(n, x, y, init);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_SCAN_H_ */
@@ -0,0 +1,324 @@
+/**
+ * @file simd_softmax.h
+ *
+ * @brief Numerically stable softmax and log-sum-exp over arrays.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_SOFTMAX_H_
+#define LSIMD_SIMD_SOFTMAX_H_
+
+#include "simd_arith.h"
+#include "simd_math.h"
+#include <cmath>
+#include <limits>
+
+namespace lsimd
+{
+	/**
+	 * @defgroup stats_module Statistics Module
+	 *
+	 * @brief Reductions and normalizations over arrays.
+	 */
+
+	/**
+	 * @defgroup softmax_generic Softmax and Log-Sum-Exp
+	 * @ingroup  stats_module
+	 *
+	 * @brief Softmax and log-sum-exp of arrays, computed without
+	 *        overflow.
+	 *
+	 * Both subtract the maximum m before exponentiation, as
+	 * logsumexp(x) = m + log(sum_i exp(x[i] - m)) and
+	 * softmax(x)[i] = exp(x[i] - m) / sum_j exp(x[j] - m).
+	 *
+	 * The default routines take two passes over the input: one for
+	 * the maximum, and one for the sum of exponentials (which softmax
+	 * stores and rescales). The _online variants find the maximum and
+	 * the sum in a single pass, rescaling the partial sums of each lane
+	 * whenever its maximum grows (once per four packs). This saves a
+	 * pass over memory, at the cost of about one more exp per four
+	 * packs, and, for softmax, an exp per entry in the output pass.
+	 * They pay off when the input is too large for cache and exp is
+	 * vectorized (e.g. with SVML), while the two-pass routines are
+	 * faster otherwise.
+	 *
+	 * Entries equal to -inf are allowed (and get zero probability).
+	 * The arrays need not be aligned.
+	 */
+	/** @{ */
+
+	// the running maxima start from the lowest finite value instead of
+	// -inf, so that differences between them are never inf - inf
+
+	template<typename T>
+	inline T _softmax_floor()
+	{
+		return -(std::numeric_limits<T>::max)();
+	}
+
+	template<typename T>
+	inline T _array_max(int n, const T *x)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t m0(_softmax_floor<T>());
+		pack_t m1 = m0;
+		pack_t m2 = m0;
+		pack_t m3 = m0;
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			m0 = vmax(m0, pack_t(x + i, unaligned_t()));
+			m1 = vmax(m1, pack_t(x + i + w, unaligned_t()));
+			m2 = vmax(m2, pack_t(x + i + 2 * w, unaligned_t()));
+			m3 = vmax(m3, pack_t(x + i + 3 * w, unaligned_t()));
+		}
+
+		for (; i + w <= n; i += w)
+		{
+			m0 = vmax(m0, pack_t(x + i, unaligned_t()));
+		}
+
+		T m = (vmax(vmax(m0, m1), vmax(m2, m3)).max)();
+		for (; i < n; ++i)
+		{
+			if (x[i] > m) m = x[i];
+		}
+
+		return m;
+	}
+
+	// the sum of exp(x[i] - m), which are also written to y if Store
+
+	template<typename T, bool Store>
+	inline T _exp_sum(int n, const T *x, const T m, T *y)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t mp(m);
+		pack_t s0 = zero_t();
+		pack_t s1 = zero_t();
+
+		int i = 0;
+		for (; i + 2 * w <= n; i += 2 * w)
+		{
+			pack_t e0 = exp(pack_t(x + i, unaligned_t()) - mp);
+			pack_t e1 = exp(pack_t(x + i + w, unaligned_t()) - mp);
+
+			if (Store)
+			{
+				e0.store(y + i, unaligned_t());
+				e1.store(y + i + w, unaligned_t());
+			}
+
+			s0 = s0 + e0;
+			s1 = s1 + e1;
+		}
+
+		for (; i + w <= n; i += w)
+		{
+			pack_t e0 = exp(pack_t(x + i, unaligned_t()) - mp);
+			if (Store) e0.store(y + i, unaligned_t());
+			s0 = s0 + e0;
+		}
+
+		T s = (s0 + s1).sum();
+		for (; i < n; ++i)
+		{
+			T e = std::exp(x[i] - m);
+			if (Store) y[i] = e;
+			s += e;
+		}
+
+		return s;
+	}
+
+	template<typename T>
+	inline void _array_scale(int n, T *y, const T c)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		const pack_t cp(c);
+
+		int i = 0;
+		for (; i + 2 * w <= n; i += 2 * w)
+		{
+			(pack_t(y + i, unaligned_t()) * cp).store(y + i, unaligned_t());
+			(pack_t(y + i + w, unaligned_t()) * cp).store(y + i + w, unaligned_t());
+		}
+
+		for (; i < n; ++i) y[i] *= c;
+	}
+
+	// the maximum m and the sum of exp(x[i] - m) in a single pass
+
+	template<typename T>
+	inline void _online_max_sum(int n, const T *x, T& m, T& s)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t mp(_softmax_floor<T>());
+		pack_t sp = zero_t();
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			pack_t v0(x + i, unaligned_t());
+			pack_t v1(x + i + w, unaligned_t());
+			pack_t v2(x + i + 2 * w, unaligned_t());
+			pack_t v3(x + i + 3 * w, unaligned_t());
+
+			pack_t mn = vmax(mp, vmax(vmax(v0, v1), vmax(v2, v3)));
+
+			pack_t e01 = exp(v0 - mn) + exp(v1 - mn);
+			pack_t e23 = exp(v2 - mn) + exp(v3 - mn);
+			sp = fmadd(sp, exp(mp - mn), e01 + e23);
+			mp = mn;
+		}
+
+		for (; i + w <= n; i += w)
+		{
+			pack_t v(x + i, unaligned_t());
+			pack_t mn = vmax(mp, v);
+
+			sp = fmadd(sp, exp(mp - mn), exp(v - mn));
+			mp = mn;
+		}
+
+		// merge the lanes and the remaining entries
+
+		T mt = (mp.max)();
+		for (int j = i; j < n; ++j)
+		{
+			if (x[j] > mt) mt = x[j];
+		}
+
+		T st = (sp * exp(mp - pack_t(mt))).sum();
+		for (; i < n; ++i)
+		{
+			st += std::exp(x[i] - mt);
+		}
+
+		m = mt;
+		s = st;
+	}
+
+
+	/**
+	 * Computes the log-sum-exp of an array, in two passes.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The input array.
+	 *
+	 * @return   log(sum_i exp(x[i])), which is -inf when n == 0.
+	 */
+	template<typename T>
+	inline T logsumexp(int n, const T *x)
+	{
+		const T m = _array_max(n, x);
+		return m + std::log(_exp_sum<T, false>(n, x, m, (T*)0));
+	}
+
+	/**
+	 * Computes the log-sum-exp of an array, in a single pass.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The input array.
+	 *
+	 * @return   log(sum_i exp(x[i])), which is -inf when n == 0.
+	 */
+	template<typename T>
+	inline T logsumexp_online(int n, const T *x)
+	{
+		T m, s;
+		_online_max_sum(n, x, m, s);
+		return m + std::log(s);
+	}
+
+	/**
+	 * Computes the softmax of an array, where the exponentials are
+	 * written to y in the second pass, and rescaled in place.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The input array.
+	 * @param y  The output array (which can be x itself).
+	 */
+	template<typename T>
+	inline void softmax(int n, const T *x, T *y)
+	{
+		const T m = _array_max(n, x);
+		const T s = _exp_sum<T, true>(n, x, m, y);
+		_array_scale(n, y, T(1) / s);
+	}
+
+	/**
+	 * Computes the softmax of an array, where the maximum and the sum
+	 * are found in a single pass, and the output is written in another.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The input array.
+	 * @param y  The output array (which can be x itself).
+	 */
+	template<typename T>
+	inline void softmax_online(int n, const T *x, T *y)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		T m, s;
+		_online_max_sum(n, x, m, s);
+
+		const pack_t mp(m);
+		const pack_t cp(T(1) / s);
+
+		int i = 0;
+		for (; i + 2 * w <= n; i += 2 * w)
+		{
+			pack_t e0 = exp(pack_t(x + i, unaligned_t()) - mp);
+			pack_t e1 = exp(pack_t(x + i + w, unaligned_t()) - mp);
+			(e0 * cp).store(y + i, unaligned_t());
+			(e1 * cp).store(y + i + w, unaligned_t());
+		}
+
+		const T c = T(1) / s;
+		for (; i < n; ++i) y[i] = std::exp(x[i] - m) * c;
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_SOFTMAX_H_ */
@@ -0,0 +1,569 @@
+/**
+ * @file simd_sort.h
+ *
+ * @brief Sorting of arrays with SIMD sorting networks.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_SORT_H_
+#define LSIMD_SIMD_SORT_H_
+
+#include "simd_arith.h"
+#include <light_simd/sse/sse_sort.h>
+#include <vector>
+
+namespace lsimd
+{
+	/**
+	 * @defgroup sort_generic Sorting
+	 * @ingroup  stats_module
+	 *
+	 * @brief Sorting of f32, f64 and i32 arrays, and of keys with
+	 *        values, in ascending order.
+	 *
+	 * Large arrays are partitioned by quicksort (with a median-of-3
+	 * pivot and a branch-free partition loop) until the parts fit in
+	 * L1 cache (see sort_blocking). Each part is then sorted by merge
+	 * sort: the sorting networks first turn blocks of four packs into
+	 * sorted runs of two packs, and the runs are then merged pairwise,
+	 * a pack at a time with bitonic_merge, through a buffer.
+	 *
+	 * As in introsort, the quicksort falls back to heap sort on parts
+	 * that are split too unevenly, so that the time is O(n log n) in
+	 * the worst case. The sort is not stable, and NaN keys are not
+	 * supported.
+	 */
+	/** @{ */
+
+	/**
+	 * Sorts the entries at each position across four packs, and
+	 * transposes the result, so that each pack comes out sorted in
+	 * ascending order.
+	 *
+	 * @remark  This is a building block of sorting, and not a sort of
+	 *          four independent packs: each output pack holds entries
+	 *          from all the input packs. Together, the output packs
+	 *          hold a permutation of the 4 x pack_width inputs.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(simd_pack<T, Kind>& a, simd_pack<T, Kind>& b,
+			simd_pack<T, Kind>& c, simd_pack<T, Kind>& d)
+	{
+		sort_lanes(a.impl, b.impl, c.impl, d.impl);
+	}
+
+	/**
+	 * Sorts the keys as sort_lanes(a, b, c, d), and moves the values
+	 * (of the same pack type, as bit patterns) along with them.
+	 *
+	 * @remark  As with sort_lanes(a, b, c, d), the keys (and values)
+	 *          of the four packs get mixed.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(simd_pack<T, Kind>& a, simd_pack<T, Kind>& b,
+			simd_pack<T, Kind>& c, simd_pack<T, Kind>& d,
+			simd_pack<T, Kind>& va, simd_pack<T, Kind>& vb,
+			simd_pack<T, Kind>& vc, simd_pack<T, Kind>& vd)
+	{
+		sort_lanes(a.impl, b.impl, c.impl, d.impl, va.impl, vb.impl, vc.impl, vd.impl);
+	}
+
+	/**
+	 * Merges two sorted packs, so that a holds the smaller half and b
+	 * the larger half of the entries, both in ascending order.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(simd_pack<T, Kind>& a, simd_pack<T, Kind>& b)
+	{
+		bitonic_merge(a.impl, b.impl);
+	}
+
+	/**
+	 * Merges two packs of sorted keys, and moves the values along
+	 * with them.
+	 */
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(simd_pack<T, Kind>& a, simd_pack<T, Kind>& b,
+			simd_pack<T, Kind>& va, simd_pack<T, Kind>& vb)
+	{
+		bitonic_merge(a.impl, b.impl, va.impl, vb.impl);
+	}
+
+
+	/**
+	 * Blocking parameters of the sorting routines.
+	 */
+	template<typename T>
+	struct sort_blocking
+	{
+		/**
+		 * The size (in bytes) of the keys of a part sorted by merge
+		 * sort (which, with the buffer, fit in a 32 KB L1 cache).
+		 */
+		static const int leaf_bytes = 1 << 14;
+
+		/**
+		 * The maximum number of entries in a part sorted by merge sort.
+		 */
+		static int leaf_size()
+		{
+			return leaf_bytes / (int)sizeof(T);
+		}
+	};
+
+
+	// the arrays being sorted: keys only, or keys with values
+
+	template<typename T>
+	struct _sort_keys
+	{
+		typedef T key_type;
+		typedef simd_pack<T> pack_t;
+		static const int width = (int)pack_t::pack_width;
+
+		struct reg
+		{
+			pack_t k;
+		};
+
+		T *k;
+
+		_sort_keys(T *k_) : k(k_) { }
+
+		_sort_keys operator + (int i) const { return _sort_keys(k + i); }
+
+		T key(int i) const { return k[i]; }
+		void set(int i, const _sort_keys& s, int j) const { k[i] = s.k[j]; }
+
+		void swap(int i, int j) const
+		{
+			const T t = k[i]; k[i] = k[j]; k[j] = t;
+		}
+
+		void load(int i, reg& r) const { r.k = pack_t(k + i, unaligned_t()); }
+		void store(int i, const reg& r) const { r.k.store(k + i, unaligned_t()); }
+
+		static void merge(reg& a, reg& b) { bitonic_merge(a.k, b.k); }
+		static void sort4(reg& a, reg& b, reg& c, reg& d) { sort_lanes(a.k, b.k, c.k, d.k); }
+	};
+
+	// the values are moved in packs of the key type, as bit patterns
+
+	template<typename T, typename V>
+	struct _sort_kvs
+	{
+		typedef T key_type;
+		typedef simd_pack<T> pack_t;
+		static const int width = (int)pack_t::pack_width;
+
+		struct reg
+		{
+			pack_t k;
+			pack_t v;
+		};
+
+		T *k;
+		V *v;
+
+		_sort_kvs(T *k_, V *v_) : k(k_), v(v_) { }
+
+		_sort_kvs operator + (int i) const { return _sort_kvs(k + i, v + i); }
+
+		T key(int i) const { return k[i]; }
+
+		void set(int i, const _sort_kvs& s, int j) const
+		{
+			k[i] = s.k[j];
+			v[i] = s.v[j];
+		}
+
+		void swap(int i, int j) const
+		{
+			const T tk = k[i]; k[i] = k[j]; k[j] = tk;
+			const V tv = v[i]; v[i] = v[j]; v[j] = tv;
+		}
+
+		void load(int i, reg& r) const
+		{
+			r.k = pack_t(k + i, unaligned_t());
+			r.v = pack_t(reinterpret_cast<const T*>(v + i), unaligned_t());
+		}
+
+		void store(int i, const reg& r) const
+		{
+			r.k.store(k + i, unaligned_t());
+			r.v.store(reinterpret_cast<T*>(v + i), unaligned_t());
+		}
+
+		static void merge(reg& a, reg& b) { bitonic_merge(a.k, b.k, a.v, b.v); }
+
+		static void sort4(reg& a, reg& b, reg& c, reg& d)
+		{
+			sort_lanes(a.k, b.k, c.k, d.k, a.v, b.v, c.v, d.v);
+		}
+	};
+
+	template<class S>
+	inline void _sort_copy(int n, S src, S dst)
+	{
+		for (int i = 0; i < n; ++i) dst.set(i, src, i);
+	}
+
+	template<class S>
+	inline void _sort_insertion(int n, S x)
+	{
+		for (int i = 1; i < n; ++i)
+		{
+			for (int j = i; j > 0 && x.key(j) < x.key(j - 1); --j) x.swap(j, j - 1);
+		}
+	}
+
+	template<class S>
+	inline void _sort_sift_down(int n, S x, int i)
+	{
+		for (int c = 2 * i + 1; c < n; c = 2 * i + 1)
+		{
+			if (c + 1 < n && x.key(c) < x.key(c + 1)) ++c;
+			if (!(x.key(i) < x.key(c))) break;
+			x.swap(i, c);
+			i = c;
+		}
+	}
+
+	template<class S>
+	inline void _sort_heap(int n, S x)
+	{
+		for (int i = n / 2 - 1; i >= 0; --i) _sort_sift_down(n, x, i);
+		for (int h = n - 1; h > 0; --h)
+		{
+			x.swap(0, h);
+			_sort_sift_down(h, x, 0);
+		}
+	}
+
+	// a merge of two sorted runs, whose lengths are multiples of the
+	// pack width, which takes the next pack from the run with the
+	// smaller head
+
+	template<class S>
+	struct _sort_merger
+	{
+		typedef typename S::reg reg;
+		static const int w = S::width;
+
+		S a, b, out;
+		int na, nb, ia, ib, o;
+		reg ra, rb;
+
+		_sort_merger(int na_, S a_, int nb_, S b_, S out_)
+		: a(a_), b(b_), out(out_), na(na_), nb(nb_), ia(w), ib(w), o(0)
+		{
+			a.load(0, ra);
+			b.load(0, rb);
+		}
+
+		// outputs a pack, and returns whether both runs have packs left
+
+		bool step()
+		{
+			S::merge(ra, rb);
+			out.store(o, ra);
+			o += w;
+
+			if (ia == na || ib == nb) return false;
+
+			// the choice is made without a branch, as it is unpredictable
+
+			const bool ta = !(b.key(ib) < a.key(ia));
+			(ta ? a + ia : b + ib).load(0, ra);
+			ia += ta ? w : 0;
+			ib += ta ? 0 : w;
+			return true;
+		}
+
+		// merges in the rest of the other run
+
+		void finish()
+		{
+			for (; ia < na; ia += w, o += w)
+			{
+				a.load(ia, ra);
+				S::merge(ra, rb);
+				out.store(o, ra);
+			}
+
+			for (; ib < nb; ib += w, o += w)
+			{
+				b.load(ib, ra);
+				S::merge(ra, rb);
+				out.store(o, ra);
+			}
+
+			out.store(o, rb);
+		}
+	};
+
+	template<class S>
+	inline void _sort_merge(int na, S a, int nb, S b, S out)
+	{
+		_sort_merger<S> m(na, a, nb, b, out);
+		while (m.step()) { }
+		m.finish();
+	}
+
+	// two merges at a time, whose chains of bitonic merges (each bound
+	// by their latencies) are interleaved
+
+	template<class S>
+	inline void _sort_merge2(int na, S a, int nb, S b, S out,
+			int na2, S a2, int nb2, S b2, S out2)
+	{
+		_sort_merger<S> m(na, a, nb, b, out);
+		_sort_merger<S> m2(na2, a2, nb2, b2, out2);
+
+		bool g = true, g2 = true;
+		while (g && g2)
+		{
+			g = m.step();
+			g2 = m2.step();
+		}
+
+		while (g) g = m.step();
+		while (g2) g2 = m2.step();
+
+		m.finish();
+		m2.finish();
+	}
+
+	// merge sort with a buffer of length n
+
+	template<class S>
+	inline void _sort_merge_sort(int n, S x, S buf)
+	{
+		const int w = S::width;
+		const int m = n - n % (4 * w);
+
+		// the number of merge passes, from which the networks write
+		// to where the last pass ends in x
+
+		int np = 0;
+		for (int r = 2 * w; r < m; r *= 2) ++np;
+
+		S src = np % 2 ? buf : x;
+		S dst = np % 2 ? x : buf;
+
+		for (int i = 0; i < m; i += 4 * w)
+		{
+			typename S::reg a, b, c, d;
+			x.load(i, a);
+			x.load(i + w, b);
+			x.load(i + 2 * w, c);
+			x.load(i + 3 * w, d);
+
+			S::sort4(a, b, c, d);
+			S::merge(a, b);
+			S::merge(c, d);
+
+			src.store(i, a);
+			src.store(i + w, b);
+			src.store(i + 2 * w, c);
+			src.store(i + 3 * w, d);
+		}
+
+		for (int r = 2 * w; r < m; r *= 2)
+		{
+			// the pairs of full runs, two at a time
+
+			int i = 0;
+			for (; i + 4 * r <= m; i += 4 * r)
+			{
+				_sort_merge2(r, src + i, r, src + (i + r), dst + i,
+						r, src + (i + 2 * r), r, src + (i + 3 * r), dst + (i + 2 * r));
+			}
+
+			for (; i < m; i += 2 * r)
+			{
+				const int na = r < m - i ? r : m - i;
+				const int nb = r < m - i - na ? r : m - i - na;
+
+				if (nb > 0)
+					_sort_merge(na, src + i, nb, src + (i + na), dst + i);
+				else
+					_sort_copy(na, src + i, dst + i);
+			}
+
+			const S t = src; src = dst; dst = t;
+		}
+
+		// the remaining entries are sorted on their own, and merged
+		// in from the back
+
+		if (m < n)
+		{
+			const int t = n - m;
+			_sort_copy(t, x + m, buf);
+			_sort_insertion(t, buf);
+
+			int i = m - 1, j = t - 1, o = n - 1;
+			while (j >= 0)
+			{
+				if (i >= 0 && buf.key(j) < x.key(i))
+					x.set(o--, x, i--);
+				else
+					x.set(o--, buf, j--);
+			}
+		}
+	}
+
+	// quicksort down to the leaves, with a buffer of the leaf size
+
+	template<class S>
+	inline void _sort_quick(int n, S x, S buf, int depth)
+	{
+		typedef typename S::key_type T;
+		const int leaf = sort_blocking<T>::leaf_size();
+
+		while (n > leaf)
+		{
+			if (depth-- == 0)
+			{
+				_sort_heap(n, x);
+				return;
+			}
+
+			// the median of the first, the middle and the last entries
+
+			const T a = x.key(0), b = x.key(n / 2), c = x.key(n - 1);
+			const T p = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+			int j = 0;
+			for (int i = 0; i < n; ++i)
+			{
+				const bool lt = x.key(i) < p;
+				x.swap(i, j);
+				j += lt;
+			}
+
+			// no entry is less than p, so the entries equal to p are
+			// split off (and need no further sorting)
+
+			int i0 = j;
+			if (j == 0)
+			{
+				for (int i = 0; i < n; ++i)
+				{
+					const bool le = !(p < x.key(i));
+					x.swap(i, i0);
+					i0 += le;
+				}
+			}
+
+			// recurses on the smaller part, and loops on the larger one
+
+			if (j < n - i0)
+			{
+				_sort_quick(j, x, buf, depth);
+				x = x + i0;
+				n -= i0;
+			}
+			else
+			{
+				_sort_quick(n - i0, x + i0, buf, depth);
+				n = j;
+			}
+		}
+
+		_sort_merge_sort(n, x, buf);
+	}
+
+	template<class S>
+	inline void _sort(int n, S x, S buf)
+	{
+		int depth = 0;
+		for (int s = n; s > 1; s >>= 1) depth += 2;
+
+		_sort_quick(n, x, buf, depth);
+	}
+
+
+	/**
+	 * Sorts an array in ascending order.
+	 *
+	 * @param n   The number of entries.
+	 * @param x   The array (of f32, f64 or i32) to sort in place.
+	 */
+	template<typename T>
+	inline void sort(int n, T *x)
+	{
+		if (n < 2) return;
+
+		const int leaf = sort_blocking<T>::leaf_size();
+		std::vector<T> buf((size_t)(n < leaf ? n : leaf));
+
+		_sort(n, _sort_keys<T>(x), _sort_keys<T>(&buf[0]));
+	}
+
+	/**
+	 * Sorts keys in ascending order, and moves the values along with
+	 * them (e.g. the indices of the scores to rank).
+	 *
+	 * @param n     The number of entries.
+	 * @param keys  The keys (of f32, f64 or i32) to sort in place.
+	 * @param vals  The values, of a type with the size of the keys
+	 *              (e.g. i32 with f32 keys, or i64 with f64 keys),
+	 *              which is checked at compile time.
+	 */
+	template<typename T, typename V>
+	inline void sort_kv(int n, T *keys, V *vals)
+	{
+		// the values are moved in packs of T (as bit patterns), which
+		// would overrun the value array if the sizes differed
+
+		static_assert(sizeof(V) == sizeof(T), "sort_kv: the values must have the size of the keys");
+
+		if (n < 2) return;
+
+		const int leaf = sort_blocking<T>::leaf_size();
+		const size_t nb = (size_t)(n < leaf ? n : leaf);
+		std::vector<T> kbuf(nb);
+		std::vector<V> vbuf(nb);
+
+		_sort(n, _sort_kvs<T, V>(keys, vals), _sort_kvs<T, V>(&kbuf[0], &vbuf[0]));
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_SORT_H_ */
@@ -0,0 +1,446 @@
+/**
+ * @file simd_sum.h
+ *
+ * @brief Plain, compensated and pairwise sums and dot products.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_SUM_H_
+#define LSIMD_SIMD_SUM_H_
+
+#include "simd_arith.h"
+
+namespace lsimd
+{
+	/**
+	 * @defgroup sum_generic Accurate Summation
+	 * @ingroup  stats_module
+	 *
+	 * @brief Sums and dot products of arrays, in several modes that
+	 *        trade speed for accuracy.
+	 *
+	 * All modes keep four pack accumulators (to hide the latency of
+	 * additions), and differ in how the rounding errors are handled:
+	 *
+	 * - plain (without a tag): the error grows with n, as that of a
+	 *   sequential sum of n / (4 * pack_width) terms per lane.
+	 * - kahan_t: Kahan's compensated summation, with a compensation
+	 *   pack per accumulator, which makes the error independent of n
+	 *   for terms of similar magnitudes (but not under cancellation
+	 *   of terms much larger than the running sum).
+	 * - compensated_t: the error of each addition (and product, for
+	 *   dot) is recovered exactly (TwoSum, and TwoProduct with FMA or
+	 *   Dekker's splitting), and accumulated separately, as in the
+	 *   Sum2 and Dot2 algorithms of Ogita, Rump and Oishi. The result
+	 *   is as accurate as if computed in twice the working precision
+	 *   and then rounded.
+	 * - pairwise_t: the packs of blocks are summed as a balanced tree,
+	 *   with an error growing with log(n), at nearly the cost of plain.
+	 *
+	 * @remark  The compensated modes must not be compiled with options
+	 *          that allow reassociation (e.g. -ffast-math), which
+	 *          would optimize the compensations away.
+	 */
+	/** @{ */
+
+	/**
+	 * The tag of Kahan's compensated summation.
+	 */
+	struct kahan_t { };
+
+	/**
+	 * The tag of summation with error-free transformations (Sum2
+	 * and Dot2).
+	 */
+	struct compensated_t { };
+
+	/**
+	 * The tag of pairwise (tree) summation.
+	 */
+	struct pairwise_t { };
+
+	/**
+	 * Blocking parameters of the summation routines.
+	 */
+	template<typename T>
+	struct sum_blocking
+	{
+		/**
+		 * The number of entries at the leaves of pairwise summation,
+		 * which are summed directly.
+		 */
+		static const int pairwise_block = 256;
+	};
+
+
+	// the splitting factor of Dekker's product, 2^ceil(p/2) + 1
+
+	template<typename T> struct _sum_split;
+	template<> struct _sum_split<f32> { static f32 get() { return 4097.0f; } };
+	template<> struct _sum_split<f64> { static f64 get() { return 134217729.0; } };
+
+	// a + b = s + e exactly (Knuth's TwoSum), where s may alias a or b
+
+	template<typename P>
+	LSIMD_ENSURE_INLINE
+	inline void _two_sum(const P& a, const P& b, P& s, P& e)
+	{
+		const P t = a + b;
+		const P z = t - a;
+		e = (a - (t - z)) + (b - z);
+		s = t;
+	}
+
+	// a * b = p - r exactly (TwoProduct)
+
+	template<typename T, typename Kind>
+	LSIMD_ENSURE_INLINE
+	inline void _two_prod(const simd_pack<T, Kind>& a, const simd_pack<T, Kind>& b,
+			simd_pack<T, Kind>& p, simd_pack<T, Kind>& r)
+	{
+		p = a * b;
+
+#ifdef LSIMD_HAS_FMA
+		r = fnmadd(a, b, p);
+#else
+		typedef simd_pack<T, Kind> pack_t;
+		const pack_t f(_sum_split<T>::get());
+
+		const pack_t ca = f * a;
+		const pack_t ah = ca - (ca - a);
+		const pack_t al = a - ah;
+
+		const pack_t cb = f * b;
+		const pack_t bh = cb - (cb - b);
+		const pack_t bl = b - bh;
+
+		r = (((p - ah * bh) - ah * bl) - al * bh) - al * bl;
+#endif
+	}
+
+	// the sum of the entries of the packs s[0 .. 4) and c[0 .. 4),
+	// the former summed with compensation
+
+	template<typename T, typename Kind>
+	inline T _sum_final(const simd_pack<T, Kind> *s, const simd_pack<T, Kind> *c)
+	{
+		const int w = (int)simd_pack<T, Kind>::pack_width;
+
+		LSIMD_ALIGN_SSE T a[4 * 4];
+		for (int k = 0; k < 4; ++k) s[k].store(a + k * w, aligned_t());
+
+		T r(0), e, ce(0);
+		for (int i = 0; i < 4 * w; ++i)
+		{
+			_two_sum(r, a[i], r, e);
+			ce += e;
+		}
+
+		return r + (ce + ((c[0] + c[1]) + (c[2] + c[3])).sum());
+	}
+
+	// copies x[0 .. m) to the beginning of buf (of 4 packs),
+	// and fills the remaining entries with zeros
+
+	template<typename T>
+	inline void _sum_pad(int m, const T *x, T *buf, int len)
+	{
+		int i = 0;
+		for (; i < m; ++i) buf[i] = x[i];
+		for (; i < len; ++i) buf[i] = T(0);
+	}
+
+
+	/********************************************
+	 *
+	 *  Plain and pairwise
+	 *
+	 ********************************************/
+
+	// the sum of x[0 .. n) as a pack, with n a multiple of 4 packs
+
+	template<typename T>
+	inline simd_pack<T> _sum_packs(int n, const T *x)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t s0 = zero_t(), s1 = zero_t(), s2 = zero_t(), s3 = zero_t();
+
+		for (int i = 0; i < n; i += 4 * w)
+		{
+			s0 = s0 + pack_t(x + i, unaligned_t());
+			s1 = s1 + pack_t(x + i + w, unaligned_t());
+			s2 = s2 + pack_t(x + i + 2 * w, unaligned_t());
+			s3 = s3 + pack_t(x + i + 3 * w, unaligned_t());
+		}
+
+		return (s0 + s1) + (s2 + s3);
+	}
+
+	// the pairwise sum of x[0 .. n) as a pack, with n a multiple of 4 packs
+
+	template<typename T>
+	inline simd_pack<T> _sum_pairwise(int n, const T *x)
+	{
+		const int q = 4 * (int)simd_pack<T>::pack_width;
+
+		if (n <= sum_blocking<T>::pairwise_block)
+		{
+			return _sum_packs(n, x);
+		}
+
+		const int h = (n / 2) - (n / 2) % q;
+		return _sum_pairwise(h, x) + _sum_pairwise(n - h, x + h);
+	}
+
+	/**
+	 * Computes the sum of an array.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The input array.
+	 *
+	 * @return   The sum of x[0 .. n).
+	 */
+	template<typename T>
+	inline T sum(int n, const T *x)
+	{
+		const int q = 4 * (int)simd_pack<T>::pack_width;
+		const int m = n - n % q;
+
+		T s = _sum_packs(m, x).sum();
+		for (int i = m; i < n; ++i) s += x[i];
+		return s;
+	}
+
+	/**
+	 * Computes the sum of an array by pairwise summation.
+	 */
+	template<typename T>
+	inline T sum(int n, const T *x, pairwise_t)
+	{
+		const int q = 4 * (int)simd_pack<T>::pack_width;
+		const int m = n - n % q;
+
+		T s = _sum_pairwise(m, x).sum();
+		for (int i = m; i < n; ++i) s += x[i];
+		return s;
+	}
+
+	/**
+	 * Computes the dot product of two arrays.
+	 *
+	 * @param n  The number of entries.
+	 * @param x  The first input array.
+	 * @param y  The second input array.
+	 *
+	 * @return   The sum of x[i] * y[i] over [0, n).
+	 */
+	template<typename T>
+	inline T dot(int n, const T *x, const T *y)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t s0 = zero_t(), s1 = zero_t(), s2 = zero_t(), s3 = zero_t();
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			s0 = fmadd(pack_t(x + i, unaligned_t()), pack_t(y + i, unaligned_t()), s0);
+			s1 = fmadd(pack_t(x + i + w, unaligned_t()), pack_t(y + i + w, unaligned_t()), s1);
+			s2 = fmadd(pack_t(x + i + 2 * w, unaligned_t()), pack_t(y + i + 2 * w, unaligned_t()), s2);
+			s3 = fmadd(pack_t(x + i + 3 * w, unaligned_t()), pack_t(y + i + 3 * w, unaligned_t()), s3);
+		}
+
+		T s = ((s0 + s1) + (s2 + s3)).sum();
+		for (; i < n; ++i) s += x[i] * y[i];
+		return s;
+	}
+
+
+	/********************************************
+	 *
+	 *  Compensated
+	 *
+	 ********************************************/
+
+	template<typename T>
+	struct _sum_kahan_step
+	{
+		typedef simd_pack<T> pack_t;
+
+		// the compensations are kept negated (as in Kahan's paper)
+
+		LSIMD_ENSURE_INLINE
+		static void run(const pack_t& x, pack_t& s, pack_t& c)
+		{
+			const pack_t y = x - c;
+			const pack_t t = s + y;
+			c = (t - s) - y;
+			s = t;
+		}
+	};
+
+	template<typename T>
+	struct _sum_comp_step
+	{
+		typedef simd_pack<T> pack_t;
+
+		LSIMD_ENSURE_INLINE
+		static void run(const pack_t& x, pack_t& s, pack_t& c)
+		{
+			pack_t e;
+			_two_sum(s, x, s, e);
+			c = c + e;
+		}
+	};
+
+	// the entries that do not fill 4 packs are padded with zeros,
+	// which add nothing (and no error) to the sums
+
+	template<typename T, class Step>
+	inline void _sum_comp(int n, const T *x, simd_pack<T> *s, simd_pack<T> *c)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		for (int k = 0; k < 4; ++k)
+		{
+			s[k] = pack_t(zero_t());
+			c[k] = pack_t(zero_t());
+		}
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			Step::run(pack_t(x + i, unaligned_t()), s[0], c[0]);
+			Step::run(pack_t(x + i + w, unaligned_t()), s[1], c[1]);
+			Step::run(pack_t(x + i + 2 * w, unaligned_t()), s[2], c[2]);
+			Step::run(pack_t(x + i + 3 * w, unaligned_t()), s[3], c[3]);
+		}
+
+		if (i < n)
+		{
+			LSIMD_ALIGN_SSE T b[4 * 4];
+			_sum_pad(n - i, x + i, b, 4 * w);
+
+			for (int k = 0; k < 4; ++k)
+			{
+				Step::run(pack_t(b + k * w, aligned_t()), s[k], c[k]);
+			}
+		}
+	}
+
+	/**
+	 * Computes the sum of an array by Kahan's compensated summation.
+	 */
+	template<typename T>
+	inline T sum(int n, const T *x, kahan_t)
+	{
+		simd_pack<T> s[4], c[4];
+		_sum_comp<T, _sum_kahan_step<T> >(n, x, s, c);
+
+		for (int k = 0; k < 4; ++k) c[k] = simd_pack<T>(zero_t()) - c[k];
+		return _sum_final(s, c);
+	}
+
+	/**
+	 * Computes the sum of an array with error-free transformations,
+	 * as accurately as in twice the working precision.
+	 */
+	template<typename T>
+	inline T sum(int n, const T *x, compensated_t)
+	{
+		simd_pack<T> s[4], c[4];
+		_sum_comp<T, _sum_comp_step<T> >(n, x, s, c);
+		return _sum_final(s, c);
+	}
+
+	template<typename T>
+	LSIMD_ENSURE_INLINE
+	inline void _dot_comp_step(const simd_pack<T>& x, const simd_pack<T>& y,
+			simd_pack<T>& s, simd_pack<T>& c)
+	{
+		simd_pack<T> p, r, e;
+		_two_prod(x, y, p, r);
+		_two_sum(s, p, s, e);
+		c = c + (e - r);
+	}
+
+	/**
+	 * Computes the dot product of two arrays with error-free
+	 * transformations, as accurately as in twice the working
+	 * precision.
+	 */
+	template<typename T>
+	inline T dot(int n, const T *x, const T *y, compensated_t)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		pack_t s[4], c[4];
+		for (int k = 0; k < 4; ++k)
+		{
+			s[k] = pack_t(zero_t());
+			c[k] = pack_t(zero_t());
+		}
+
+		int i = 0;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			_dot_comp_step(pack_t(x + i, unaligned_t()), pack_t(y + i, unaligned_t()), s[0], c[0]);
+			_dot_comp_step(pack_t(x + i + w, unaligned_t()), pack_t(y + i + w, unaligned_t()), s[1], c[1]);
+			_dot_comp_step(pack_t(x + i + 2 * w, unaligned_t()), pack_t(y + i + 2 * w, unaligned_t()), s[2], c[2]);
+			_dot_comp_step(pack_t(x + i + 3 * w, unaligned_t()), pack_t(y + i + 3 * w, unaligned_t()), s[3], c[3]);
+		}
+
+		if (i < n)
+		{
+			LSIMD_ALIGN_SSE T a[4 * 4];
+			LSIMD_ALIGN_SSE T b[4 * 4];
+			_sum_pad(n - i, x + i, a, 4 * w);
+			_sum_pad(n - i, y + i, b, 4 * w);
+
+			for (int k = 0; k < 4; ++k)
+			{
+				_dot_comp_step(pack_t(a + k * w, aligned_t()), pack_t(b + k * w, aligned_t()), s[k], c[k]);
+			}
+		}
+
+		return _sum_final(s, c);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_SUM_H_ */
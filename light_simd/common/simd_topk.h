@@ -0,0 +1,281 @@
+/**
+ * @file simd_topk.h
+ *
+ * @brief Selection of the k smallest (or largest) entries of arrays.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SIMD_TOPK_H_
+#define LSIMD_SIMD_TOPK_H_
+
+#include "simd_arith.h"
+
+namespace lsimd
+{
+	/**
+	 * @defgroup topk_generic Top-k Selection
+	 * @ingroup  stats_module
+	 *
+	 * @brief Selection of the k smallest (or largest) scores, e.g. of
+	 *        the k nearest neighbors from a row of distances.
+	 *
+	 * The selected entries are kept in a binary heap (in the output
+	 * arrays), whose root is the k-th best score so far. The scores
+	 * are compared against this bound a block of four packs at a time
+	 * (reduced with vmin or vmax first), and only the lanes that pass
+	 * the comparison mask are offered to the heap. As the bound
+	 * tightens quickly, almost all blocks of a long row are dismissed
+	 * with a single comparison.
+	 *
+	 * The results are sorted from the best, with ties resolved in
+	 * favor of lower indices. NaN scores are not supported.
+	 */
+	/** @{ */
+
+	/**
+	 * The minimum number of matrix entries for which topk_rows_mt
+	 * goes parallel.
+	 */
+	const int topk_mt_threshold = 1 << 16;
+
+	// the orders of the selections, with which an entry a is better
+	// than b if before(a, b)
+
+	struct _topk_min
+	{
+		template<typename T>
+		static bool before(T a, T b) { return a < b; }
+
+		template<typename T>
+		static simd_pack<T> reduce(const simd_pack<T>& a, const simd_pack<T>& b) { return vmin(a, b); }
+
+		template<typename T>
+		static int mask(const simd_pack<T>& a, const simd_pack<T>& b) { return mask_lt(a, b); }
+	};
+
+	struct _topk_max
+	{
+		template<typename T>
+		static bool before(T a, T b) { return a > b; }
+
+		template<typename T>
+		static simd_pack<T> reduce(const simd_pack<T>& a, const simd_pack<T>& b) { return vmax(a, b); }
+
+		template<typename T>
+		static int mask(const simd_pack<T>& a, const simd_pack<T>& b) { return mask_gt(a, b); }
+	};
+
+	// whether (va, ia) is better than (vb, ib)
+
+	template<class Ord, typename T>
+	inline bool _topk_before(T va, int ia, T vb, int ib)
+	{
+		return Ord::before(va, vb) || (!Ord::before(vb, va) && ia < ib);
+	}
+
+	// restores the heap (with the worst entry at the root) below i
+
+	template<class Ord, typename T>
+	inline void _topk_sift_down(int k, T *val, int *idx, int i)
+	{
+		const T v = val[i];
+		const int id = idx[i];
+
+		for (int c = 2 * i + 1; c < k; c = 2 * i + 1)
+		{
+			if (c + 1 < k && _topk_before<Ord>(val[c], idx[c], val[c + 1], idx[c + 1])) ++c;
+			if (!_topk_before<Ord>(v, id, val[c], idx[c])) break;
+
+			val[i] = val[c];
+			idx[i] = idx[c];
+			i = c;
+		}
+
+		val[i] = v;
+		idx[i] = id;
+	}
+
+	// offers the entries in the lanes of mask m, starting at x[i0]
+
+	template<class Ord, typename T>
+	inline void _topk_offer(int k, const T *x, int i0, int m, T *val, int *idx)
+	{
+		for (int b = 0; m; ++b, m >>= 1)
+		{
+			if ((m & 1) && Ord::before(x[i0 + b], val[0]))
+			{
+				val[0] = x[i0 + b];
+				idx[0] = i0 + b;
+				_topk_sift_down<Ord>(k, val, idx, 0);
+			}
+		}
+	}
+
+	template<class Ord, typename T>
+	inline int _topk(int n, const T *x, int k, int *idx, T *val)
+	{
+		typedef simd_pack<T> pack_t;
+		const int w = (int)pack_t::pack_width;
+
+		if (k > n) k = n;
+		if (k <= 0) return 0;
+
+		// the first k entries form the initial heap
+
+		for (int i = 0; i < k; ++i)
+		{
+			val[i] = x[i];
+			idx[i] = i;
+		}
+
+		for (int i = k / 2 - 1; i >= 0; --i) _topk_sift_down<Ord>(k, val, idx, i);
+
+		// the rest are filtered by the bound at the root
+
+		pack_t bp(val[0]);
+
+		int i = k;
+		for (; i + 4 * w <= n; i += 4 * w)
+		{
+			const pack_t v0(x + i, unaligned_t());
+			const pack_t v1(x + i + w, unaligned_t());
+			const pack_t v2(x + i + 2 * w, unaligned_t());
+			const pack_t v3(x + i + 3 * w, unaligned_t());
+
+			const pack_t r = Ord::reduce(Ord::reduce(v0, v1), Ord::reduce(v2, v3));
+
+			if (Ord::mask(r, bp))
+			{
+				_topk_offer<Ord>(k, x, i, Ord::mask(v0, bp), val, idx);
+				_topk_offer<Ord>(k, x, i + w, Ord::mask(v1, bp), val, idx);
+				_topk_offer<Ord>(k, x, i + 2 * w, Ord::mask(v2, bp), val, idx);
+				_topk_offer<Ord>(k, x, i + 3 * w, Ord::mask(v3, bp), val, idx);
+				bp = pack_t(val[0]);
+			}
+		}
+
+		for (; i < n; ++i)
+		{
+			_topk_offer<Ord>(k, x, i, 1, val, idx);
+		}
+
+		// sort by moving the root to the end of the shrinking heap
+
+		for (int h = k - 1; h > 0; --h)
+		{
+			const T tv = val[0]; val[0] = val[h]; val[h] = tv;
+			const int ti = idx[0]; idx[0] = idx[h]; idx[h] = ti;
+			_topk_sift_down<Ord>(h, val, idx, 0);
+		}
+
+		return k;
+	}
+
+
+	/**
+	 * Selects the k smallest entries of an array.
+	 *
+	 * @param n        The number of entries.
+	 * @param x        The input array (e.g. of distances).
+	 * @param k        The number of entries to select.
+	 * @param out_idx  The indices of the selected entries.
+	 * @param out_val  The values of the selected entries.
+	 *
+	 * @return         The number of selected entries, i.e. min(k, n),
+	 *                 which are written in ascending order of values.
+	 */
+	template<typename T>
+	inline int topk(int n, const T *x, int k, int *out_idx, T *out_val)
+	{
+		return _topk<_topk_min>(n, x, k, out_idx, out_val);
+	}
+
+	/**
+	 * Selects the k largest entries of an array.
+	 *
+	 * @param n        The number of entries.
+	 * @param x        The input array (e.g. of similarities).
+	 * @param k        The number of entries to select.
+	 * @param out_idx  The indices of the selected entries.
+	 * @param out_val  The values of the selected entries.
+	 *
+	 * @return         The number of selected entries, i.e. min(k, n),
+	 *                 which are written in descending order of values.
+	 */
+	template<typename T>
+	inline int topk_max(int n, const T *x, int k, int *out_idx, T *out_val)
+	{
+		return _topk<_topk_max>(n, x, k, out_idx, out_val);
+	}
+
+	/**
+	 * Selects the k smallest entries of each row of a matrix (e.g. a
+	 * matrix of distances computed by cdist, with a row per query).
+	 *
+	 * @param m        The number of rows.
+	 * @param n        The number of columns.
+	 * @param x        The base address of the input matrix.
+	 * @param ldx      The offset between consecutive rows of x.
+	 * @param k        The number of entries to select per row.
+	 * @param out_idx  The base address of the m x min(k, n) indices.
+	 * @param out_val  The base address of the m x min(k, n) values.
+	 * @param ldo      The offset between consecutive rows of the outputs.
+	 */
+	template<typename T>
+	inline void topk_rows(int m, int n, const T *x, int ldx, int k, int *out_idx, T *out_val, int ldo)
+	{
+		for (int i = 0; i < m; ++i)
+		{
+			_topk<_topk_min>(n, x + i * ldx, k, out_idx + i * ldo, out_val + i * ldo);
+		}
+	}
+
+	/**
+	 * Multi-threaded version of topk_rows, where each thread takes
+	 * a share of the rows.
+	 */
+	template<typename T>
+	inline void topk_rows_mt(int m, int n, const T *x, int ldx, int k, int *out_idx, T *out_val, int ldo)
+	{
+#ifdef LSIMD_HAS_OPENMP
+		const bool par = double(m) * double(n) >= double(topk_mt_threshold);
+#pragma omp parallel for schedule(static) if(par)
+#endif
+		for (int i = 0; i < m; ++i)
+		{
+			_topk<_topk_min>(n, x + i * ldx, k, out_idx + i * ldo, out_val + i * ldo);
+		}
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SIMD_TOPK_H_ */
@@ -77,6 +77,13 @@ namespace lsimd
 	};
 
 
+	template<typename T, int N, typename Kind, class Op>
+	struct simd_vec_expr;
+
+	template<typename T, int N, typename Kind>
+	struct vexpr_scale;
+
+
 	/**
 	 * @brief Generic fixed-size vector class.
 	 *
@@ -281,11 +288,14 @@ namespace lsimd
 		 *
 		 * @param   s  An SIMD pack filled with the same scale value.
 		 *
-		 * @return  The resultant vector.
+		 * @return  The resultant vector, which is evaluated lazily
+		 *          (see simd_vec_expr).
 		 */
-		LSIMD_ENSURE_INLINE simd_vec operator * (const pack_type& s) const
+		LSIMD_ENSURE_INLINE
+		simd_vec_expr<T, N, Kind, vexpr_scale<T, N, Kind> > operator * (const pack_type& s) const
 		{
-			return impl * s.impl;
+			return simd_vec_expr<T, N, Kind, vexpr_scale<T, N, Kind> >(
+					vexpr_scale<T, N, Kind>(impl, s.impl));
 		}
 
 		/**
@@ -301,6 +311,40 @@ namespace lsimd
 			return *this;
 		}
 
+		/**
+		 * Adds the value of an expression to this vector.
+		 *
+		 * Each term of the expression is accumulated to this vector
+		 * directly, without evaluating the expression first.
+		 *
+		 * @param   e  The vector expression.
+		 *
+		 * @return  The reference to this vector.
+		 */
+		template<class Op>
+		LSIMD_ENSURE_INLINE simd_vec& operator += (const simd_vec_expr<T, N, Kind, Op>& e)
+		{
+			e.op.add_to(impl);
+			return *this;
+		}
+
+		/**
+		 * Subtracts the value of an expression from this vector.
+		 *
+		 * Each term of the expression is subtracted from this vector
+		 * directly, without evaluating the expression first.
+		 *
+		 * @param   e  The vector expression.
+		 *
+		 * @return  The reference to this vector.
+		 */
+		template<class Op>
+		LSIMD_ENSURE_INLINE simd_vec& operator -= (const simd_vec_expr<T, N, Kind, Op>& e)
+		{
+			e.op.sub_from(impl);
+			return *this;
+		}
+
 		// stats
 
 		/**
@@ -327,6 +371,261 @@ namespace lsimd
 
 	};
 
+
+	/********************************************
+	 *
+	 *  Vector expressions
+	 *
+	 ********************************************/
+
+	/**
+	 * @brief A lazily evaluated vector expression.
+	 *
+	 * Scaling a vector, multiplying a matrix with a vector, and 
+	 * adding/subtracting such terms yield expressions instead of vectors. 
+	 * When an expression is added to/subtracted from another expression 
+	 * or a vector, its terms are combined with those of the other operand
+	 * into a new expression, instead of being evaluated.
+	 *
+	 * The evaluation is done in one pass: the first term initializes
+	 * the destination, and each of the other terms is accumulated into 
+	 * it directly. In this way, each product is fused with the addition
+	 * that follows (into an FMA instruction when LSIMD_HAS_FMA is defined),
+	 * and no intermediate vectors are created.
+	 *
+	 * An expression is also a vector that holds its own value, so that 
+	 * it can be used wherever a vector is expected (including templates 
+	 * that deduce the vector type). The value of an expression that only 
+	 * serves as an operand of a larger one is never used, and is thus 
+	 * discarded by the compiler once the operators are inlined.
+	 *
+	 * @tparam T    The scalar type.
+	 * @tparam N    The vector length.
+	 * @tparam Kind The kind of architecture.
+	 * @tparam Op   The node type that implements the expression, which
+	 *              provides eval(), add_to(y) and sub_from(y), all acting 
+	 *              on the architecture-specific vector type.
+	 */
+	template<typename T, int N, typename Kind, class Op>
+	struct simd_vec_expr : public simd_vec<T, N, Kind>
+	{
+		/**
+		 * The node that implements the expression.
+		 */
+		Op op;
+
+		LSIMD_ENSURE_INLINE
+		explicit simd_vec_expr(const Op& op_) : simd_vec<T, N, Kind>(op_.eval()), op(op_) { }
+
+		/**
+		 * Gets the value of the expression.
+		 *
+		 * @return  The resultant vector.
+		 */
+		LSIMD_ENSURE_INLINE simd_vec<T, N, Kind> eval() const
+		{
+			return *this;
+		}
+	};
+
+
+	/**
+	 * Expression node: a vector.
+	 */
+	template<typename T, int N, typename Kind>
+	struct vexpr_leaf
+	{
+		typedef typename simd_vec_traits<T, N, Kind>::impl_type impl_type;
+		static const bool is_leaf = true;
+
+		impl_type v;
+
+		LSIMD_ENSURE_INLINE
+		explicit vexpr_leaf(const impl_type& v_) : v(v_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const { return v; }
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const { y += v; }
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const { y -= v; }
+	};
+
+	/**
+	 * Expression node: a vector multiplied with a scale, as v * s.
+	 */
+	template<typename T, int N, typename Kind>
+	struct vexpr_scale
+	{
+		typedef typename simd_vec_traits<T, N, Kind>::impl_type impl_type;
+		typedef typename simd<T, Kind>::impl_type pack_impl_type;
+		static const bool is_leaf = false;
+
+		impl_type v;
+		pack_impl_type s;
+
+		LSIMD_ENSURE_INLINE
+		vexpr_scale(const impl_type& v_, const pack_impl_type& s_) : v(v_), s(s_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const { return v * s; }
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const { y = fmadd(v, s, y); }
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const { y = fnmadd(v, s, y); }
+	};
+
+	/**
+	 * Expression node: the sum of two expressions, as l + r.
+	 */
+	template<class L, class R>
+	struct vexpr_add
+	{
+		typedef typename L::impl_type impl_type;
+		static const bool is_leaf = false;
+
+		L l;
+		R r;
+
+		LSIMD_ENSURE_INLINE
+		vexpr_add(const L& l_, const R& r_) : l(l_), r(r_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const
+		{
+			// start from a plain vector where possible, such that
+			// the products are all accumulated into it
+
+			if (R::is_leaf && !L::is_leaf)
+			{
+				impl_type y = r.eval();
+				l.add_to(y);
+				return y;
+			}
+			else
+			{
+				impl_type y = l.eval();
+				r.add_to(y);
+				return y;
+			}
+		}
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const
+		{
+			l.add_to(y);
+			r.add_to(y);
+		}
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const
+		{
+			l.sub_from(y);
+			r.sub_from(y);
+		}
+	};
+
+	/**
+	 * Expression node: the difference between two expressions, as l - r.
+	 */
+	template<class L, class R>
+	struct vexpr_sub
+	{
+		typedef typename L::impl_type impl_type;
+		static const bool is_leaf = false;
+
+		L l;
+		R r;
+
+		LSIMD_ENSURE_INLINE
+		vexpr_sub(const L& l_, const R& r_) : l(l_), r(r_) { }
+
+		LSIMD_ENSURE_INLINE impl_type eval() const
+		{
+			impl_type y = l.eval();
+			r.sub_from(y);
+			return y;
+		}
+
+		LSIMD_ENSURE_INLINE void add_to(impl_type& y) const
+		{
+			l.add_to(y);
+			r.sub_from(y);
+		}
+
+		LSIMD_ENSURE_INLINE void sub_from(impl_type& y) const
+		{
+			l.sub_from(y);
+			r.add_to(y);
+		}
+	};
+
+
+	/**
+	 * Adds two vector expressions.
+	 */
+	template<typename T, int N, typename Kind, class L, class R>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_add<L, R> > operator + (
+			const simd_vec_expr<T, N, Kind, L>& a, const simd_vec_expr<T, N, Kind, R>& b)
+	{
+		return simd_vec_expr<T, N, Kind, vexpr_add<L, R> >(vexpr_add<L, R>(a.op, b.op));
+	}
+
+	/**
+	 * Adds a vector expression and a vector.
+	 */
+	template<typename T, int N, typename Kind, class L>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_add<L, vexpr_leaf<T, N, Kind> > > operator + (
+			const simd_vec_expr<T, N, Kind, L>& a, const simd_vec<T, N, Kind>& b)
+	{
+		typedef vexpr_add<L, vexpr_leaf<T, N, Kind> > node_t;
+		return simd_vec_expr<T, N, Kind, node_t>(node_t(a.op, vexpr_leaf<T, N, Kind>(b.impl)));
+	}
+
+	/**
+	 * Adds a vector and a vector expression.
+	 */
+	template<typename T, int N, typename Kind, class R>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_add<vexpr_leaf<T, N, Kind>, R> > operator + (
+			const simd_vec<T, N, Kind>& a, const simd_vec_expr<T, N, Kind, R>& b)
+	{
+		typedef vexpr_add<vexpr_leaf<T, N, Kind>, R> node_t;
+		return simd_vec_expr<T, N, Kind, node_t>(node_t(vexpr_leaf<T, N, Kind>(a.impl), b.op));
+	}
+
+	/**
+	 * Subtracts a vector expression from another.
+	 */
+	template<typename T, int N, typename Kind, class L, class R>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_sub<L, R> > operator - (
+			const simd_vec_expr<T, N, Kind, L>& a, const simd_vec_expr<T, N, Kind, R>& b)
+	{
+		return simd_vec_expr<T, N, Kind, vexpr_sub<L, R> >(vexpr_sub<L, R>(a.op, b.op));
+	}
+
+	/**
+	 * Subtracts a vector from a vector expression.
+	 */
+	template<typename T, int N, typename Kind, class L>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_sub<L, vexpr_leaf<T, N, Kind> > > operator - (
+			const simd_vec_expr<T, N, Kind, L>& a, const simd_vec<T, N, Kind>& b)
+	{
+		typedef vexpr_sub<L, vexpr_leaf<T, N, Kind> > node_t;
+		return simd_vec_expr<T, N, Kind, node_t>(node_t(a.op, vexpr_leaf<T, N, Kind>(b.impl)));
+	}
+
+	/**
+	 * Subtracts a vector expression from a vector.
+	 */
+	template<typename T, int N, typename Kind, class R>
+	LSIMD_ENSURE_INLINE
+	inline simd_vec_expr<T, N, Kind, vexpr_sub<vexpr_leaf<T, N, Kind>, R> > operator - (
+			const simd_vec<T, N, Kind>& a, const simd_vec_expr<T, N, Kind, R>& b)
+	{
+		typedef vexpr_sub<vexpr_leaf<T, N, Kind>, R> node_t;
+		return simd_vec_expr<T, N, Kind, node_t>(node_t(vexpr_leaf<T, N, Kind>(a.impl), b.op));
+	}
+
 	/** @} */
 
 }
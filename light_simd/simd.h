@@ -17,7 +17,23 @@
 
 #include <light_simd/common/simd_arith.h>
 #include <light_simd/common/simd_math.h>
+#include <light_simd/common/simd_cpack.h>
 #include <light_simd/common/simd_vec.h>
 #include <light_simd/common/simd_mat.h>
+#include <light_simd/common/simd_quat.h>
+#include <light_simd/common/simd_blas.h>
+#include <light_simd/common/simd_dist.h>
+#include <light_simd/common/simd_kmeans.h>
+#include <light_simd/common/simd_fft.h>
+#include <light_simd/common/simd_conv.h>
+#include <light_simd/common/simd_rand.h>
+#include <light_simd/common/simd_softmax.h>
+#include <light_simd/common/simd_normalize.h>
+#include <light_simd/common/simd_topk.h>
+#include <light_simd/common/simd_sort.h>
+#include <light_simd/common/simd_scan.h>
+#include <light_simd/common/simd_hist.h>
+#include <light_simd/common/simd_sum.h>
+#include <light_simd/common/simd_ddpack.h>
 
 #endif 
@@ -15,7 +15,9 @@
 
 #include <light_simd/sse/sse_arith.h>
 #include <light_simd/sse/sse_math.h>
+#include <light_simd/sse/sse_cpack.h>
 #include <light_simd/sse/sse_vec.h>
 #include <light_simd/sse/sse_mat.h>
+#include <light_simd/sse/sse_quat.h>
 
 #endif /* SSE_H_ */
@@ -0,0 +1,135 @@
+/**
+ * @file sse_mat_batch_bits.h
+ *
+ * The internal implementation for applying a small matrix to a
+ * batch of vectors
+ *
+ * @author Dahua Lin
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_MAT_BATCH_BITS_H_
+#define LSIMD_SSE_MAT_BATCH_BITS_H_
+
+#include "sse_mat_comp_bits.h"
+
+namespace lsimd { namespace sse {
+
+	/********************************************
+	 *
+	 *  Matrix columns kept in registers
+	 *
+	 *  Each column is held as a vector, and each
+	 *  input vector enters the product through
+	 *  scalar broadcasts read directly from 
+	 *  memory, which takes no shuffles (unlike
+	 *  transform, which extracts entries from 
+	 *  a loaded vector).
+	 *
+	 ********************************************/
+
+	template<typename T, int M, int N> struct batch_cols;
+
+	template<typename T, int M>
+	struct batch_cols<T, M, 2>
+	{
+		sse_vec<T, M> c0, c1;
+
+		LSIMD_ENSURE_INLINE
+		explicit batch_cols(const T *a)
+		: c0(a, unaligned_t()), c1(a + M, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_vec<T, M> apply(const T *x) const
+		{
+			return fmadd(c1, sse_pack<T>(x[1]), c0 * sse_pack<T>(x[0]));
+		}
+	};
+
+	template<typename T, int M>
+	struct batch_cols<T, M, 3>
+	{
+		sse_vec<T, M> c0, c1, c2;
+
+		LSIMD_ENSURE_INLINE
+		explicit batch_cols(const T *a)
+		: c0(a, unaligned_t()), c1(a + M, unaligned_t()), c2(a + 2 * M, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_vec<T, M> apply(const T *x) const
+		{
+			return fmadd(c2, sse_pack<T>(x[2]), 
+					fmadd(c1, sse_pack<T>(x[1]), c0 * sse_pack<T>(x[0])));
+		}
+	};
+
+	template<typename T, int M>
+	struct batch_cols<T, M, 4>
+	{
+		sse_vec<T, M> c0, c1, c2, c3;
+
+		LSIMD_ENSURE_INLINE
+		explicit batch_cols(const T *a)
+		: c0(a, unaligned_t()), c1(a + M, unaligned_t())
+		, c2(a + 2 * M, unaligned_t()), c3(a + 3 * M, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_vec<T, M> apply(const T *x) const
+		{
+			return fmadd(c3, sse_pack<T>(x[3]), c2 * sse_pack<T>(x[2])) + 
+					fmadd(c1, sse_pack<T>(x[1]), c0 * sse_pack<T>(x[0]));
+		}
+	};
+
+
+	/********************************************
+	 *
+	 *  Batch transform
+	 *
+	 *  Four independent vectors are transformed 
+	 *  per iteration to hide the latency of 
+	 *  each product.
+	 *
+	 ********************************************/
+
+	template<typename T, int M, int N>
+	struct batch_transform_op
+	{
+		inline
+		static void run(const smat_core<T, M, N>& A, int n, 
+				const T *xs, int ldx, T *ys, int ldy)
+		{
+			LSIMD_ALIGN_SSE T abuf[M * N];
+			A.store(abuf, aligned_t());
+			const batch_cols<T, M, N> a(abuf);
+
+			int i = 0;
+			for (; i + 4 <= n; i += 4)
+			{
+				sse_vec<T, M> y0 = a.apply(xs);
+				sse_vec<T, M> y1 = a.apply(xs + ldx);
+				sse_vec<T, M> y2 = a.apply(xs + 2 * ldx);
+				sse_vec<T, M> y3 = a.apply(xs + 3 * ldx);
+
+				y0.store(ys, unaligned_t());
+				y1.store(ys + ldy, unaligned_t());
+				y2.store(ys + 2 * ldy, unaligned_t());
+				y3.store(ys + 3 * ldy, unaligned_t());
+
+				xs += 4 * ldx;
+				ys += 4 * ldy;
+			}
+
+			for (; i < n; ++i)
+			{
+				a.apply(xs).store(ys, unaligned_t());
+
+				xs += ldx;
+				ys += ldy;
+			}
+		}
+	};
+
+} }
+
+#endif /* SSE_MAT_BATCH_BITS_H_ */
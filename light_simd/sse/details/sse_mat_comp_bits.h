@@ -111,6 +111,24 @@ namespace lsimd { namespace sse {
 		return y;
 	}
 
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_add(const smat_core<T,M,2>& a, sse_vec<T,2> x, sse_vec<T,M> y)
+	{
+		y = fmadd(a.col0, x.template bsx_pk<0>(), y);
+		y = fmadd(a.col1, x.template bsx_pk<1>(), y);
+		return y;
+	}
+
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_sub(const smat_core<T,M,2>& a, sse_vec<T,2> x, sse_vec<T,M> y)
+	{
+		y = fnmadd(a.col0, x.template bsx_pk<0>(), y);
+		y = fnmadd(a.col1, x.template bsx_pk<1>(), y);
+		return y;
+	}
+
 
 	/********************************************
 	 *
@@ -209,6 +227,26 @@ namespace lsimd { namespace sse {
 		return y;
 	}
 
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_add(const smat_core<T,M,3>& a, sse_vec<T,3> x, sse_vec<T,M> y)
+	{
+		y = fmadd(a.col0, x.template bsx_pk<0>(), y);
+		y = fmadd(a.col1, x.template bsx_pk<1>(), y);
+		y = fmadd(a.col2, x.template bsx_pk<2>(), y);
+		return y;
+	}
+
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_sub(const smat_core<T,M,3>& a, sse_vec<T,3> x, sse_vec<T,M> y)
+	{
+		y = fnmadd(a.col0, x.template bsx_pk<0>(), y);
+		y = fnmadd(a.col1, x.template bsx_pk<1>(), y);
+		y = fnmadd(a.col2, x.template bsx_pk<2>(), y);
+		return y;
+	}
+
 
 	/********************************************
 	 *
@@ -319,6 +357,34 @@ namespace lsimd { namespace sse {
 		return y0 + y1;
 	}
 
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_add(const smat_core<T,M,4>& a, sse_vec<T,4> x, sse_vec<T,M> y)
+	{
+		// two independent chains to shorten the dependency path
+
+		sse_vec<T,M> y0 = fmadd(a.col0, x.template bsx_pk<0>(), y);
+		sse_vec<T,M> y1 = a.col2 * x.template bsx_pk<2>();
+
+		y0 = fmadd(a.col1, x.template bsx_pk<1>(), y0);
+		y1 = fmadd(a.col3, x.template bsx_pk<3>(), y1);
+
+		return y0 + y1;
+	}
+
+	template<typename T, int M>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<T,M> transform_sub(const smat_core<T,M,4>& a, sse_vec<T,4> x, sse_vec<T,M> y)
+	{
+		sse_vec<T,M> y0 = fnmadd(a.col0, x.template bsx_pk<0>(), y);
+		sse_vec<T,M> y1 = a.col2 * x.template bsx_pk<2>();
+
+		y0 = fnmadd(a.col1, x.template bsx_pk<1>(), y0);
+		y1 = fmadd(a.col3, x.template bsx_pk<3>(), y1);
+
+		return y0 - y1;
+	}
+
 
 	/********************************************
 	 *
@@ -382,6 +448,18 @@ namespace lsimd { namespace sse {
 		return sse_vec<f32,2>(p.shift_front<2>());
 	}
 
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_add(const smat_core<f32,2,2>& a, const sse_vec<f32,2>& x, const sse_vec<f32,2>& y)
+	{
+		return y + transform(a, x);
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_sub(const smat_core<f32,2,2>& a, const sse_vec<f32,2>& x, const sse_vec<f32,2>& y)
+	{
+		return y - transform(a, x);
+	}
+
 
 	/********************************************
 	 *
@@ -465,6 +543,18 @@ namespace lsimd { namespace sse {
 		return sse_vec<f32, 2>(p1.shift_front<2>());
 	}
 
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_add(const smat_core<f32,2,3>& a, const sse_vec<f32,3>& x, const sse_vec<f32,2>& y)
+	{
+		return y + transform(a, x);
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_sub(const smat_core<f32,2,3>& a, const sse_vec<f32,3>& x, const sse_vec<f32,2>& y)
+	{
+		return y - transform(a, x);
+	}
+
 
 	/********************************************
 	 *
@@ -547,6 +637,18 @@ namespace lsimd { namespace sse {
 		return sse_vec<f32, 2>(p1.shift_front<2>());
 	}
 
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_add(const smat_core<f32,2,4>& a, const sse_vec<f32,4>& x, const sse_vec<f32,2>& y)
+	{
+		return y + transform(a, x);
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32,2> transform_sub(const smat_core<f32,2,4>& a, const sse_vec<f32,4>& x, const sse_vec<f32,2>& y)
+	{
+		return y - transform(a, x);
+	}
+
 
 } }
 
@@ -254,6 +254,53 @@ namespace lsimd {  namespace sse {
 	}
 
 
+	/********************************************
+	 *
+	 *  alternating add / sub
+	 *
+	 ********************************************/
+
+	LSIMD_ENSURE_INLINE
+	inline __m128 f32_addsub(__m128 a, __m128 b) // [a0 - b0, a1 + b1, a2 - b2, a3 + b3]
+	{
+#if (defined(LSIMD_HAS_SSE3))
+		return _mm_addsub_ps(a, b);
+#else
+		return _mm_add_ps(a, _mm_xor_ps(b, _mm_setr_ps(-0.f, 0.f, -0.f, 0.f)));
+#endif
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline __m128d f64_addsub(__m128d a, __m128d b) // [a0 - b0, a1 + b1]
+	{
+#if (defined(LSIMD_HAS_SSE3))
+		return _mm_addsub_pd(a, b);
+#else
+		return _mm_add_pd(a, _mm_xor_pd(b, _mm_setr_pd(-0.0, 0.0)));
+#endif
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline __m128 f32_fmaddsub(__m128 a, __m128 b, __m128 c) // a * b -/+ c
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fmaddsub_ps(a, b, c);
+#else
+		return f32_addsub(_mm_mul_ps(a, b), c);
+#endif
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline __m128d f64_fmaddsub(__m128d a, __m128d b, __m128d c) // a * b -/+ c
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fmaddsub_pd(a, b, c);
+#else
+		return f64_addsub(_mm_mul_pd(a, b), c);
+#endif
+	}
+
+
 	/********************************************
 	 *
 	 *  sum / max / min
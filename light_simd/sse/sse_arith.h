@@ -440,6 +440,103 @@ namespace lsimd
 	}
 
 
+	/********************************************
+	 *
+	 *  Fused multiply-add
+	 *
+	 ********************************************/
+
+	/**
+	 * Calculates a * b + c in an entry-wise way.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of addends.
+	 *
+	 * @return    The resultant pack, as a * b + c.
+	 *
+	 * @remark    This function invokes the VFMADD instruction when
+	 *            LSIMD_HAS_FMA is defined (the product is then not 
+	 *            rounded before the addition), and falls back to a 
+	 *            multiplication followed by an addition otherwise.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f32pk fmadd(const sse_f32pk& a, const sse_f32pk& b, const sse_f32pk& c)
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fmadd_ps(a.v, b.v, c.v);
+#else
+		return _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v);
+#endif
+	}
+
+	/**
+	 * Calculates a * b + c in an entry-wise way.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of addends.
+	 *
+	 * @return    The resultant pack, as a * b + c.
+	 *
+	 * @remark    This function invokes the VFMADD instruction when
+	 *            LSIMD_HAS_FMA is defined.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f64pk fmadd(const sse_f64pk& a, const sse_f64pk& b, const sse_f64pk& c)
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fmadd_pd(a.v, b.v, c.v);
+#else
+		return _mm_add_pd(_mm_mul_pd(a.v, b.v), c.v);
+#endif
+	}
+
+	/**
+	 * Calculates c - a * b in an entry-wise way.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of minuends.
+	 *
+	 * @return    The resultant pack, as c - a * b.
+	 *
+	 * @remark    This function invokes the VFNMADD instruction when
+	 *            LSIMD_HAS_FMA is defined.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f32pk fnmadd(const sse_f32pk& a, const sse_f32pk& b, const sse_f32pk& c)
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fnmadd_ps(a.v, b.v, c.v);
+#else
+		return _mm_sub_ps(c.v, _mm_mul_ps(a.v, b.v));
+#endif
+	}
+
+	/**
+	 * Calculates c - a * b in an entry-wise way.
+	 *
+	 * @param a   The pack of multiplicands.
+	 * @param b   The pack of multipliers.
+	 * @param c   The pack of minuends.
+	 *
+	 * @return    The resultant pack, as c - a * b.
+	 *
+	 * @remark    This function invokes the VFNMADD instruction when
+	 *            LSIMD_HAS_FMA is defined.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f64pk fnmadd(const sse_f64pk& a, const sse_f64pk& b, const sse_f64pk& c)
+	{
+#ifdef LSIMD_HAS_FMA
+		return _mm_fnmadd_pd(a.v, b.v, c.v);
+#else
+		return _mm_sub_pd(c.v, _mm_mul_pd(a.v, b.v));
+#endif
+	}
+
+
 	/********************************************
 	 *
 	 *  Single-scalar arithmetic
@@ -758,6 +855,154 @@ namespace lsimd
 #endif
 	}
 
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] < b[i]
+	 *            (for i < 4).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_lt(const sse_f32pk& a, const sse_f32pk& b)
+	{
+		return _mm_movemask_ps(_mm_cmplt_ps(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] < b[i]
+	 *            (for i < 2).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_lt(const sse_f64pk& a, const sse_f64pk& b)
+	{
+		return _mm_movemask_pd(_mm_cmplt_pd(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] <= b[i]
+	 *            (for i < 4).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_le(const sse_f32pk& a, const sse_f32pk& b)
+	{
+		return _mm_movemask_ps(_mm_cmple_ps(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] <= b[i]
+	 *            (for i < 2).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_le(const sse_f64pk& a, const sse_f64pk& b)
+	{
+		return _mm_movemask_pd(_mm_cmple_pd(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] > b[i]
+	 *            (for i < 4).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_gt(const sse_f32pk& a, const sse_f32pk& b)
+	{
+		return _mm_movemask_ps(_mm_cmpgt_ps(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] > b[i]
+	 *            (for i < 2).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_gt(const sse_f64pk& a, const sse_f64pk& b)
+	{
+		return _mm_movemask_pd(_mm_cmpgt_pd(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] >= b[i]
+	 *            (for i < 4).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_ge(const sse_f32pk& a, const sse_f32pk& b)
+	{
+		return _mm_movemask_ps(_mm_cmpge_ps(a.v, b.v));
+	}
+
+	/**
+	 * Compares two packs in an entry-wise way.
+	 *
+	 * @param a   The left-hand-side pack.
+	 * @param b   The right-hand-side pack.
+	 *
+	 * @return    The bit mask whose i-th bit is set iff a[i] >= b[i]
+	 *            (for i < 2).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline int mask_ge(const sse_f64pk& a, const sse_f64pk& b)
+	{
+		return _mm_movemask_pd(_mm_cmpge_pd(a.v, b.v));
+	}
+
+	/**
+	 * Calculates the inclusive prefix sums of the entries.
+	 *
+	 * @param a  The input pack.
+	 *
+	 * @return   The resultant pack, as (a[0], a[0] + a[1],
+	 *           a[0] + a[1] + a[2], a[0] + a[1] + a[2] + a[3]).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f32pk prefix_sum(const sse_f32pk& a)
+	{
+		sse_f32pk t = a + a.shift_back<1>();
+		return t + t.shift_back<2>();
+	}
+
+	/**
+	 * Calculates the inclusive prefix sums of the entries.
+	 *
+	 * @param a  The input pack.
+	 *
+	 * @return   The resultant pack, as (a[0], a[0] + a[1]).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f64pk prefix_sum(const sse_f64pk& a)
+	{
+		return a + a.shift_back<1>();
+	}
+
 	/** @} */ // arith_sse
 
 }
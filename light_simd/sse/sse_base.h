@@ -32,6 +32,10 @@
 #include <smmintrin.h> 	// for SSE4 (include 4.1 & 4.2)
 #endif
 
+#ifdef LSIMD_HAS_FMA
+#include <immintrin.h> 	// for FMA (operating on SSE registers)
+#endif
+
 #define LSIMD_ALIGN_SSE LSIMD_ALIGN(16)
 
 
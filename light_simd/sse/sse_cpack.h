@@ -0,0 +1,431 @@
+/**
+ * @file sse_cpack.h
+ *
+ * @brief SSE-based complex pack classes.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_CPACK_H_
+#define LSIMD_SSE_CPACK_H_
+
+#include "sse_arith.h"
+#include <complex>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4141)
+#endif
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup complex_sse SSE Complex Packs
+	 * @ingroup packs
+	 *
+	 * @brief SSE-based packs of complex numbers.
+	 *
+	 * The complex numbers are interleaved as (re, im) pairs, which is
+	 * the memory layout of std::complex. An SSE register holds two
+	 * complex numbers of f32, or one complex number of f64.
+	 */
+	/** @{ */
+
+	template<typename T> class sse_cpack;
+
+
+#ifdef LSIMD_IN_DOXYGEN
+
+	/**
+	 * @brief An SSE pack of interleaved complex numbers.
+	 *
+	 * @tparam T   The type of real and imaginary parts.
+	 */
+	template<typename T>
+	class sse_cpack
+	{
+	public:
+		static const unsigned int count;               ///< The number of complex numbers (2 for f32, 1 for f64).
+
+		sse_cpack();                                    ///< Leaves the entries uninitialized.
+		sse_cpack( zero_t );                            ///< Sets all entries to zeros.
+		sse_cpack(T re, T im);                          ///< Sets all complex numbers to re + im * i.
+		sse_cpack(const T *a, aligned_t);               ///< Loads interleaved (re, im) pairs from aligned memory.
+		sse_cpack(const T *a, unaligned_t);             ///< Loads interleaved (re, im) pairs from unaligned memory.
+
+		void load(const T *a, aligned_t);
+		void load(const T *a, unaligned_t);
+		void store(T *a, aligned_t) const;
+		void store(T *a, unaligned_t) const;
+		template<int I> void store_entry(T *a) const;   ///< Stores the I-th complex number to a[0], a[1].
+		template<int I> sse_cpack pair(const sse_cpack& r) const;  ///< The I-th complex numbers of this and r, in this order (f32 only).
+
+		sse_cpack operator + (const sse_cpack& r) const;
+		sse_cpack operator - (const sse_cpack& r) const;
+		sse_cpack operator - () const;
+		sse_cpack operator * (const sse_pack<T>& s) const; ///< Scales all entries.
+		sse_cpack operator * (const sse_cpack& r) const;   ///< The complex product.
+		sse_cpack mul_dup(const sse_pack<T>& re, const sse_pack<T>& im) const;  ///< The product with complex numbers whose parts are replicated in both slots of re and im.
+
+		sse_cpack conj() const;                         ///< The conjugates.
+		sse_cpack reverse() const;                      ///< The complex numbers in reverse order.
+		sse_cpack mul_i() const;                        ///< The products with i, as (-im, re).
+		sse_cpack mul_conj(const sse_cpack& r) const;   ///< The product with conj(r).
+		sse_pack<T> abs2() const;                       ///< The squared magnitudes, each in both its re and im slot.
+		sse_pack<T> abs() const;                        ///< The magnitudes, each in both its re and im slot.
+		std::complex<T> sum() const;                    ///< The sum of all complex numbers.
+
+		bool test_equal(const T *r) const;
+		void dump(const char *fmt) const;
+	};
+
+#endif
+
+
+	template<> class sse_cpack<f32>
+	{
+	public:
+		static const unsigned int count = 2;
+
+		LSIMD_ENSURE_INLINE explicit sse_cpack(const __m128 p) : m_pk(p) { }
+		LSIMD_ENSURE_INLINE explicit sse_cpack(const sse_f32pk& p) : m_pk(p) { }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_cpack() { }
+
+		LSIMD_ENSURE_INLINE sse_cpack( zero_t ) : m_pk( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f32 re, const f32 im)
+		: m_pk(re, im, re, im) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f32 *a, aligned_t) : m_pk(a, aligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f32 *a, unaligned_t) : m_pk(a, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE void load(const f32 *a, aligned_t)
+		{
+			m_pk.load(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f32 *a, unaligned_t)
+		{
+			m_pk.load(a, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f32 *a, aligned_t) const
+		{
+			m_pk.store(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f32 *a, unaligned_t) const
+		{
+			m_pk.store(a, unaligned_t());
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE void store_entry(f32 *a) const
+		{
+			if (I == 0)
+				_mm_storel_pi(reinterpret_cast<__m64*>(a), m_pk.v);
+			else
+				_mm_storeh_pi(reinterpret_cast<__m64*>(a), m_pk.v);
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_cpack pair(const sse_cpack& r) const
+		{
+			return sse_cpack(I == 0 ? _mm_movelh_ps(m_pk.v, r.m_pk.v) : _mm_movehl_ps(r.m_pk.v, m_pk.v));
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE sse_cpack operator + (const sse_cpack& r) const
+		{
+			return sse_cpack(m_pk + r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator - (const sse_cpack& r) const
+		{
+			return sse_cpack(m_pk - r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator - () const
+		{
+			return sse_cpack(-m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator * (const sse_f32pk& s) const
+		{
+			return sse_cpack(m_pk * s);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator * (const sse_cpack& r) const
+		{
+			// (ar * br - ai * bi, ar * bi + ai * br)
+
+			__m128 ar = sse::f32_dup2_low(m_pk.v);
+			__m128 ai = sse::f32_dup2_high(m_pk.v);
+			__m128 bs = r.m_pk.swizzle<1,0,3,2>().v;
+
+			return sse_cpack(sse::f32_fmaddsub(ar, r.m_pk.v, _mm_mul_ps(ai, bs)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_dup(const sse_f32pk& re, const sse_f32pk& im) const
+		{
+			__m128 as = m_pk.swizzle<1,0,3,2>().v;
+			return sse_cpack(sse::f32_fmaddsub(m_pk.v, re.v, _mm_mul_ps(as, im.v)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack conj() const
+		{
+			return sse_cpack(_mm_xor_ps(m_pk.v, _mm_setr_ps(0.f, -0.f, 0.f, -0.f)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack reverse() const
+		{
+			return sse_cpack(m_pk.swizzle<2,3,0,1>());
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_i() const
+		{
+			return sse_cpack(_mm_xor_ps(m_pk.swizzle<1,0,3,2>().v, _mm_setr_ps(-0.f, 0.f, -0.f, 0.f)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_conj(const sse_cpack& r) const
+		{
+			// (ar * br + ai * bi, ai * br - ar * bi), computed in the
+			// (im, re) order, so that addsub applies as well
+
+			__m128 ar = sse::f32_dup2_low(m_pk.v);
+			__m128 ai = sse::f32_dup2_high(m_pk.v);
+			__m128 bs = r.m_pk.swizzle<1,0,3,2>().v;
+
+			__m128 t = sse::f32_fmaddsub(ai, r.m_pk.v, _mm_mul_ps(ar, bs));
+			return sse_cpack(t).swizzle();
+		}
+
+		LSIMD_ENSURE_INLINE sse_f32pk abs2() const
+		{
+			sse_f32pk s = m_pk * m_pk;
+			return s + s.swizzle<1,0,3,2>();
+		}
+
+		LSIMD_ENSURE_INLINE sse_f32pk abs() const
+		{
+			return sqrt(abs2());
+		}
+
+		LSIMD_ENSURE_INLINE std::complex<f32> sum() const
+		{
+			sse_f32pk s = m_pk + m_pk.dup_high();
+			return std::complex<f32>(s.to_scalar(), s.extract<1>());
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE bool test_equal(const f32 *r) const
+		{
+			return m_pk.test_equal(r);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("f32 cpack:\n");
+			std::printf("    m_pk = "); m_pk.dump(fmt); std::printf("\n");
+		}
+
+	private:
+		LSIMD_ENSURE_INLINE sse_cpack swizzle() const  // (re, im) -> (im, re)
+		{
+			return sse_cpack(m_pk.swizzle<1,0,3,2>());
+		}
+
+	public:
+		sse_f32pk m_pk;
+	};
+
+
+	template<> class sse_cpack<f64>
+	{
+	public:
+		static const unsigned int count = 1;
+
+		LSIMD_ENSURE_INLINE explicit sse_cpack(const __m128d p) : m_pk(p) { }
+		LSIMD_ENSURE_INLINE explicit sse_cpack(const sse_f64pk& p) : m_pk(p) { }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_cpack() { }
+
+		LSIMD_ENSURE_INLINE sse_cpack( zero_t ) : m_pk( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f64 re, const f64 im)
+		: m_pk(re, im) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f64 *a, aligned_t) : m_pk(a, aligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_cpack(const f64 *a, unaligned_t) : m_pk(a, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, aligned_t)
+		{
+			m_pk.load(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, unaligned_t)
+		{
+			m_pk.load(a, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, aligned_t) const
+		{
+			m_pk.store(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, unaligned_t) const
+		{
+			m_pk.store(a, unaligned_t());
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE void store_entry(f64 *a) const
+		{
+			m_pk.store(a, unaligned_t());
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE sse_cpack operator + (const sse_cpack& r) const
+		{
+			return sse_cpack(m_pk + r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator - (const sse_cpack& r) const
+		{
+			return sse_cpack(m_pk - r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator - () const
+		{
+			return sse_cpack(-m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator * (const sse_f64pk& s) const
+		{
+			return sse_cpack(m_pk * s);
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack operator * (const sse_cpack& r) const
+		{
+			// (ar * br - ai * bi, ar * bi + ai * br)
+
+			__m128d ar = sse::f64_dup_low(m_pk.v);
+			__m128d ai = sse::f64_dup_high(m_pk.v);
+			__m128d bs = r.m_pk.swizzle<1,0>().v;
+
+			return sse_cpack(sse::f64_fmaddsub(ar, r.m_pk.v, _mm_mul_pd(ai, bs)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_dup(const sse_f64pk& re, const sse_f64pk& im) const
+		{
+			__m128d as = m_pk.swizzle<1,0>().v;
+			return sse_cpack(sse::f64_fmaddsub(m_pk.v, re.v, _mm_mul_pd(as, im.v)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack conj() const
+		{
+			return sse_cpack(_mm_xor_pd(m_pk.v, _mm_setr_pd(0.0, -0.0)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack reverse() const
+		{
+			return *this;
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_i() const
+		{
+			return sse_cpack(_mm_xor_pd(m_pk.swizzle<1,0>().v, _mm_setr_pd(-0.0, 0.0)));
+		}
+
+		LSIMD_ENSURE_INLINE sse_cpack mul_conj(const sse_cpack& r) const
+		{
+			// (ar * br + ai * bi, ai * br - ar * bi), computed in the
+			// (im, re) order, so that addsub applies as well
+
+			__m128d ar = sse::f64_dup_low(m_pk.v);
+			__m128d ai = sse::f64_dup_high(m_pk.v);
+			__m128d bs = r.m_pk.swizzle<1,0>().v;
+
+			__m128d t = sse::f64_fmaddsub(ai, r.m_pk.v, _mm_mul_pd(ar, bs));
+			return sse_cpack(t).swizzle();
+		}
+
+		LSIMD_ENSURE_INLINE sse_f64pk abs2() const
+		{
+			sse_f64pk s = m_pk * m_pk;
+			return s + s.swizzle<1,0>();
+		}
+
+		LSIMD_ENSURE_INLINE sse_f64pk abs() const
+		{
+			return sqrt(abs2());
+		}
+
+		LSIMD_ENSURE_INLINE std::complex<f64> sum() const
+		{
+			return std::complex<f64>(m_pk.to_scalar(), m_pk.extract<1>());
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE bool test_equal(const f64 *r) const
+		{
+			return m_pk.test_equal(r[0], r[1]);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("f64 cpack:\n");
+			std::printf("    m_pk = "); m_pk.dump(fmt); std::printf("\n");
+		}
+
+	private:
+		LSIMD_ENSURE_INLINE sse_cpack swizzle() const  // (re, im) -> (im, re)
+		{
+			return sse_cpack(m_pk.swizzle<1,0>());
+		}
+
+	public:
+		sse_f64pk m_pk;
+	};
+
+	/** @} */
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
@@ -0,0 +1,355 @@
+/**
+ * @file sse_ddpack.h
+ *
+ * @brief SSE-based packs of double-double numbers.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_DDPACK_H_
+#define LSIMD_SSE_DDPACK_H_
+
+#include "sse_arith.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4141)
+#endif
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup dd_sse SSE Double-Double Packs
+	 * @ingroup packs
+	 *
+	 * @brief SSE-based packs of double-double numbers.
+	 *
+	 * A double-double number is the unevaluated sum hi + lo of two
+	 * f64 values with |lo| <= ulp(hi) / 2, which carries 106 bits of
+	 * significand (about 32 decimal digits), with the exponent range
+	 * of f64. A pack holds two of them, as a pack of high parts and
+	 * a pack of low parts, so that the arithmetic is entry-wise.
+	 *
+	 * The operations are built on the error-free transformations
+	 * TwoSum and TwoProduct (with FMA when LSIMD_HAS_FMA is defined,
+	 * and Dekker's splitting otherwise), and follow the accurate
+	 * variants of the QD library of Hida, Li and Bailey. The relative
+	 * error of each operation is within a few units of 2^-104.
+	 *
+	 * @remark  Only finite values are supported, and the operations
+	 *          must not be compiled with options that allow
+	 *          reassociation (e.g. -ffast-math).
+	 */
+	/** @{ */
+
+	namespace sse
+	{
+		// a + b = s + e exactly
+
+		LSIMD_ENSURE_INLINE
+		inline void f64_two_sum(const sse_f64pk& a, const sse_f64pk& b, sse_f64pk& s, sse_f64pk& e)
+		{
+			const sse_f64pk t = a + b;
+			const sse_f64pk z = t - a;
+			e = (a - (t - z)) + (b - z);
+			s = t;
+		}
+
+		// a + b = s + e exactly, given |a| >= |b| (or a = 0)
+
+		LSIMD_ENSURE_INLINE
+		inline void f64_fast_two_sum(const sse_f64pk& a, const sse_f64pk& b, sse_f64pk& s, sse_f64pk& e)
+		{
+			const sse_f64pk t = a + b;
+			e = b - (t - a);
+			s = t;
+		}
+
+		// a * b = p + e exactly (barring underflow)
+
+		LSIMD_ENSURE_INLINE
+		inline void f64_two_prod(const sse_f64pk& a, const sse_f64pk& b, sse_f64pk& p, sse_f64pk& e)
+		{
+			const sse_f64pk t = a * b;
+#ifdef LSIMD_HAS_FMA
+			e = _mm_fmsub_pd(a.v, b.v, t.v);
+#else
+			const sse_f64pk f(134217729.0);  // 2^27 + 1
+
+			const sse_f64pk ca = f * a;
+			const sse_f64pk ah = ca - (ca - a);
+			const sse_f64pk al = a - ah;
+
+			const sse_f64pk cb = f * b;
+			const sse_f64pk bh = cb - (cb - b);
+			const sse_f64pk bl = b - bh;
+
+			e = ((ah * bh - t) + ah * bl + al * bh) + al * bl;
+#endif
+			p = t;
+		}
+	}
+
+
+#ifdef LSIMD_IN_DOXYGEN
+
+	/**
+	 * @brief An SSE pack of two double-double numbers.
+	 */
+	class sse_ddpack
+	{
+	public:
+		static const unsigned int count;                ///< The number of double-double numbers (2).
+
+		sse_f64pk hi;                                   ///< The high parts.
+		sse_f64pk lo;                                   ///< The low parts.
+
+		sse_ddpack();                                   ///< Leaves the entries uninitialized.
+		sse_ddpack( zero_t );                           ///< Sets all entries to zeros.
+		explicit sse_ddpack(f64 x);                     ///< Sets all entries to x.
+		sse_ddpack(f64 h, f64 l);                       ///< Sets all entries to h + l (which must be normalized).
+		explicit sse_ddpack(const sse_f64pk& h);        ///< Sets the entries to those of h.
+		sse_ddpack(const sse_f64pk& h, const sse_f64pk& l);  ///< Sets the entries to h + l (which must be normalized).
+		sse_ddpack(const f64 *a, aligned_t);            ///< Loads f64 values from aligned memory.
+		sse_ddpack(const f64 *a, unaligned_t);          ///< Loads f64 values from unaligned memory.
+
+		void load(const f64 *a, aligned_t);
+		void load(const f64 *a, unaligned_t);
+		void store(f64 *a, aligned_t) const;            ///< Stores the nearest f64 values.
+		void store(f64 *a, unaligned_t) const;          ///< Stores the nearest f64 values.
+
+		sse_ddpack operator + (const sse_ddpack& r) const;
+		sse_ddpack operator + (const sse_f64pk& r) const;
+		sse_ddpack operator - (const sse_ddpack& r) const;
+		sse_ddpack operator - (const sse_f64pk& r) const;
+		sse_ddpack operator - () const;
+		sse_ddpack operator * (const sse_ddpack& r) const;
+		sse_ddpack operator * (const sse_f64pk& r) const;
+		sse_ddpack operator / (const sse_ddpack& r) const;
+
+		f64 sum() const;                                ///< The nearest f64 value to the sum of both entries.
+		void sum(f64& h, f64& l) const;                 ///< The sum of both entries, as h + l.
+
+		bool test_equal(const f64 *h, const f64 *l) const;
+		void dump(const char *fmt) const;
+	};
+
+	sse_ddpack sqrt(const sse_ddpack& a);               ///< The square roots (of non-negative entries).
+
+#endif
+
+
+	class sse_ddpack
+	{
+	public:
+		static const unsigned int count = 2;
+
+	public:
+		LSIMD_ENSURE_INLINE sse_ddpack() { }
+
+		LSIMD_ENSURE_INLINE sse_ddpack( zero_t ) : hi( zero_t() ), lo( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE explicit sse_ddpack(const f64 x) : hi(x), lo( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_ddpack(const f64 h, const f64 l) : hi(h), lo(l) { }
+
+		LSIMD_ENSURE_INLINE explicit sse_ddpack(const sse_f64pk& h) : hi(h), lo( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_ddpack(const sse_f64pk& h, const sse_f64pk& l) : hi(h), lo(l) { }
+
+		LSIMD_ENSURE_INLINE sse_ddpack(const f64 *a, aligned_t) : hi(a, aligned_t()), lo( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_ddpack(const f64 *a, unaligned_t) : hi(a, unaligned_t()), lo( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, aligned_t)
+		{
+			hi.load(a, aligned_t());
+			lo.set_zero();
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, unaligned_t)
+		{
+			hi.load(a, unaligned_t());
+			lo.set_zero();
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, aligned_t) const
+		{
+			hi.store(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, unaligned_t) const
+		{
+			hi.store(a, unaligned_t());
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE sse_ddpack operator + (const sse_ddpack& r) const
+		{
+			// the high and the low parts are added separately,
+			// which stays accurate under cancellation
+
+			sse_f64pk s, e, t, f;
+			sse::f64_two_sum(hi, r.hi, s, e);
+			sse::f64_two_sum(lo, r.lo, t, f);
+			e = e + t;
+			sse::f64_fast_two_sum(s, e, s, e);
+			e = e + f;
+			sse::f64_fast_two_sum(s, e, s, e);
+			return sse_ddpack(s, e);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator + (const sse_f64pk& r) const
+		{
+			sse_f64pk s, e;
+			sse::f64_two_sum(hi, r, s, e);
+			e = e + lo;
+			sse::f64_fast_two_sum(s, e, s, e);
+			return sse_ddpack(s, e);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator - (const sse_ddpack& r) const
+		{
+			return *this + (-r);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator - (const sse_f64pk& r) const
+		{
+			return *this + (-r);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator - () const
+		{
+			return sse_ddpack(-hi, -lo);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator * (const sse_ddpack& r) const
+		{
+			sse_f64pk p, e;
+			sse::f64_two_prod(hi, r.hi, p, e);
+			e = fmadd(hi, r.lo, fmadd(lo, r.hi, e));
+			sse::f64_fast_two_sum(p, e, p, e);
+			return sse_ddpack(p, e);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator * (const sse_f64pk& r) const
+		{
+			sse_f64pk p, e;
+			sse::f64_two_prod(hi, r, p, e);
+			e = fmadd(lo, r, e);
+			sse::f64_fast_two_sum(p, e, p, e);
+			return sse_ddpack(p, e);
+		}
+
+		LSIMD_ENSURE_INLINE sse_ddpack operator / (const sse_ddpack& r) const
+		{
+			// three quotient digits by long division
+
+			sse_f64pk q1 = hi / r.hi;
+			sse_ddpack a = *this - r * q1;
+
+			sse_f64pk q2 = a.hi / r.hi;
+			a = a - r * q2;
+
+			const sse_f64pk q3 = a.hi / r.hi;
+
+			sse::f64_fast_two_sum(q1, q2, q1, q2);
+			return sse_ddpack(q1, q2) + q3;
+		}
+
+		LSIMD_ENSURE_INLINE f64 sum() const
+		{
+			f64 h, l;
+			sum(h, l);
+			return h;
+		}
+
+		LSIMD_ENSURE_INLINE void sum(f64& h, f64& l) const
+		{
+			sse_ddpack s = *this + sse_ddpack(hi.swizzle<1,0>(), lo.swizzle<1,0>());
+			h = s.hi.to_scalar();
+			l = s.lo.to_scalar();
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE bool test_equal(const f64 *h, const f64 *l) const
+		{
+			return hi.test_equal(h[0], h[1]) && lo.test_equal(l[0], l[1]);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("f64 ddpack:\n");
+			std::printf("    hi = "); hi.dump(fmt); std::printf("\n");
+			std::printf("    lo = "); lo.dump(fmt); std::printf("\n");
+		}
+
+	public:
+		sse_f64pk hi;
+		sse_f64pk lo;
+	};
+
+
+	/**
+	 * Calculates the square roots of double-double numbers.
+	 *
+	 * @param a  The input pack (of non-negative entries).
+	 *
+	 * @return   The resultant pack, as sqrt(a).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_ddpack sqrt(const sse_ddpack& a)
+	{
+		// one Newton step from the f64 root (Karp and Markstein),
+		// where zero entries are kept (instead of 0 / 0)
+
+		const sse_f64pk x = sqrt(a.hi);
+
+		sse_f64pk p, e;
+		sse::f64_two_prod(x, x, p, e);
+		const sse_ddpack d = a - sse_ddpack(p, e);
+
+		sse_f64pk s, c;
+		sse::f64_fast_two_sum(x, d.hi / (x + x), s, c);
+
+		const __m128d nz = _mm_cmpneq_pd(a.hi.v, _mm_setzero_pd());
+		return sse_ddpack(sse_f64pk(_mm_and_pd(s.v, nz)), sse_f64pk(_mm_and_pd(c.v, nz)));
+	}
+
+	/** @} */
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* LSIMD_SSE_DDPACK_H_ */
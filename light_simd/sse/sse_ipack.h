@@ -0,0 +1,923 @@
+/**
+ * @file sse_ipack.h
+ *
+ * @brief SSE-based packs of 32-bit integers.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_IPACK_H_
+#define LSIMD_SSE_IPACK_H_
+
+#include "sse_pack.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4141)
+#endif
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup ipacks_sse SSE Integer Packs
+	 * @ingroup packs
+	 *
+	 * @brief SSE-based packs of four 32-bit integers.
+	 *
+	 * sse_pack<i32> and sse_pack<u32> share the same layout, and
+	 * differ in the operations that depend on the signedness
+	 * (right shifts, min / max and conversions). Arithmetic wraps
+	 * around on overflow, as with the scalar unsigned types.
+	 */
+	/** @{ */
+
+#ifdef LSIMD_IN_DOXYGEN
+
+	/**
+	 * @brief An SSE pack of four 32-bit integers.
+	 *
+	 * @tparam T   The integer type (i32 or u32).
+	 */
+	template<typename T>
+	struct sse_pack
+	{
+		typedef T value_type;
+		typedef __m128i intern_type;
+		static const unsigned int pack_width = 4;
+
+		union
+		{
+			__m128i v;
+			LSIMD_ALIGN_SSE T e[4];
+		};
+
+		sse_pack();                                 ///< Leaves the entries uninitialized.
+		sse_pack(const __m128i v_);                 ///< Constructs from the builtin representation.
+		sse_pack( zero_t );                         ///< Sets all entries to zeros.
+		explicit sse_pack(const T x);               ///< Sets all entries to x.
+		sse_pack(T e0, T e1, T e2, T e3);           ///< Sets the entries to (e0, e1, e2, e3).
+		sse_pack(const T* a, aligned_t);            ///< Loads from aligned memory.
+		sse_pack(const T* a, unaligned_t);          ///< Loads from unaligned memory.
+
+		unsigned int width() const;
+		__m128i intern() const;
+
+		void set_zero();
+		void set(const T x);
+		void set(T e0, T e1, T e2, T e3);
+		void load(const T* a, aligned_t);
+		void load(const T* a, unaligned_t);
+		void store(T* a, aligned_t) const;
+		void store(T* a, unaligned_t) const;
+
+		T to_scalar() const;                        ///< The first entry.
+		template<int I> T extract() const;          ///< The I-th entry.
+		template<int I> sse_pack bsx() const;       ///< Broadcasts the I-th entry.
+		template<int I0, int I1, int I2, int I3>
+		sse_pack swizzle() const;                   ///< (e[I0], e[I1], e[I2], e[I3]).
+		template<int I> sse_pack shift_front() const;  ///< Shifts by I entries towards the low end.
+		template<int I> sse_pack shift_back() const;   ///< Shifts by I entries towards the high end.
+
+		T sum() const;                              ///< The (wrapped-around) sum of all entries.
+
+		bool test_equal(T e0, T e1, T e2, T e3) const;
+		bool test_equal(const T *r) const;
+		void dump(const char *fmt) const;
+	};
+
+#endif
+
+
+	/**
+	 * @brief SSE pack with four signed 32-bit integers.
+	 */
+	template<>
+	struct sse_pack<i32>
+	{
+		typedef i32 value_type;
+		typedef __m128i intern_type;
+		static const unsigned int pack_width = 4;
+
+		union
+		{
+			__m128i v;
+			LSIMD_ALIGN_SSE i32 e[4];
+		};
+
+		LSIMD_ENSURE_INLINE sse_pack() { }
+
+		LSIMD_ENSURE_INLINE sse_pack(const __m128i v_) : v(v_) { }
+
+		LSIMD_ENSURE_INLINE sse_pack( zero_t )
+		{
+			v = _mm_setzero_si128();
+		}
+
+		LSIMD_ENSURE_INLINE explicit sse_pack(const i32 x)
+		{
+			v = _mm_set1_epi32(x);
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const i32 e0, const i32 e1, const i32 e2, const i32 e3)
+		{
+			v = _mm_setr_epi32(e0, e1, e2, e3);
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const i32* a, aligned_t)
+		{
+			v = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const i32* a, unaligned_t)
+		{
+			v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE unsigned int width() const
+		{
+			return pack_width;
+		}
+
+		LSIMD_ENSURE_INLINE __m128i intern() const
+		{
+			return v;
+		}
+
+		LSIMD_ENSURE_INLINE void set_zero()
+		{
+			v = _mm_setzero_si128();
+		}
+
+		LSIMD_ENSURE_INLINE void set(const i32 x)
+		{
+			v = _mm_set1_epi32(x);
+		}
+
+		LSIMD_ENSURE_INLINE void set(const i32 e0, const i32 e1, const i32 e2, const i32 e3)
+		{
+			v = _mm_setr_epi32(e0, e1, e2, e3);
+		}
+
+		LSIMD_ENSURE_INLINE void load(const i32* a, aligned_t)
+		{
+			v = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE void load(const i32* a, unaligned_t)
+		{
+			v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE void store(i32* a, aligned_t) const
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(a), v);
+		}
+
+		LSIMD_ENSURE_INLINE void store(i32* a, unaligned_t) const
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a), v);
+		}
+
+		LSIMD_ENSURE_INLINE i32 to_scalar() const
+		{
+			return _mm_cvtsi128_si32(v);
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE i32 extract() const
+		{
+			return _mm_cvtsi128_si32(_mm_shuffle_epi32(v, _MM_SHUFFLE(I, I, I, I)));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack bsx() const
+		{
+			return _mm_shuffle_epi32(v, _MM_SHUFFLE(I, I, I, I));
+		}
+
+		template<int I0, int I1, int I2, int I3>
+		LSIMD_ENSURE_INLINE sse_pack swizzle() const
+		{
+			return _mm_shuffle_epi32(v, _MM_SHUFFLE(I3, I2, I1, I0));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack shift_front() const
+		{
+			return _mm_srli_si128(v, (I << 2));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack shift_back() const
+		{
+			return _mm_slli_si128(v, (I << 2));
+		}
+
+		LSIMD_ENSURE_INLINE i32 sum() const
+		{
+			__m128i t = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+			t = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(t);
+		}
+
+		// Only for debug
+
+		LSIMD_ENSURE_INLINE bool test_equal(i32 e0, i32 e1, i32 e2, i32 e3) const
+		{
+			return e[0] == e0 && e[1] == e1 && e[2] == e2 && e[3] == e3;
+		}
+
+		LSIMD_ENSURE_INLINE bool test_equal(const i32 *r) const
+		{
+			return test_equal(r[0], r[1], r[2], r[3]);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("(");
+			std::printf(fmt, e[0]); std::printf(", ");
+			std::printf(fmt, e[1]); std::printf(", ");
+			std::printf(fmt, e[2]); std::printf(", ");
+			std::printf(fmt, e[3]);
+			std::printf(")");
+		}
+
+	}; // end struct sse_pack<i32>
+
+
+	/**
+	 * @brief SSE pack with four unsigned 32-bit integers.
+	 */
+	template<>
+	struct sse_pack<u32>
+	{
+		typedef u32 value_type;
+		typedef __m128i intern_type;
+		static const unsigned int pack_width = 4;
+
+		union
+		{
+			__m128i v;
+			LSIMD_ALIGN_SSE u32 e[4];
+		};
+
+		LSIMD_ENSURE_INLINE sse_pack() { }
+
+		LSIMD_ENSURE_INLINE sse_pack(const __m128i v_) : v(v_) { }
+
+		LSIMD_ENSURE_INLINE sse_pack( zero_t )
+		{
+			v = _mm_setzero_si128();
+		}
+
+		LSIMD_ENSURE_INLINE explicit sse_pack(const u32 x)
+		{
+			v = _mm_set1_epi32((int)x);
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const u32 e0, const u32 e1, const u32 e2, const u32 e3)
+		{
+			v = _mm_setr_epi32((int)e0, (int)e1, (int)e2, (int)e3);
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const u32* a, aligned_t)
+		{
+			v = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE sse_pack(const u32* a, unaligned_t)
+		{
+			v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE unsigned int width() const
+		{
+			return pack_width;
+		}
+
+		LSIMD_ENSURE_INLINE __m128i intern() const
+		{
+			return v;
+		}
+
+		LSIMD_ENSURE_INLINE void set_zero()
+		{
+			v = _mm_setzero_si128();
+		}
+
+		LSIMD_ENSURE_INLINE void set(const u32 x)
+		{
+			v = _mm_set1_epi32((int)x);
+		}
+
+		LSIMD_ENSURE_INLINE void set(const u32 e0, const u32 e1, const u32 e2, const u32 e3)
+		{
+			v = _mm_setr_epi32((int)e0, (int)e1, (int)e2, (int)e3);
+		}
+
+		LSIMD_ENSURE_INLINE void load(const u32* a, aligned_t)
+		{
+			v = _mm_load_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE void load(const u32* a, unaligned_t)
+		{
+			v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+		}
+
+		LSIMD_ENSURE_INLINE void store(u32* a, aligned_t) const
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(a), v);
+		}
+
+		LSIMD_ENSURE_INLINE void store(u32* a, unaligned_t) const
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a), v);
+		}
+
+		LSIMD_ENSURE_INLINE u32 to_scalar() const
+		{
+			return (u32)_mm_cvtsi128_si32(v);
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE u32 extract() const
+		{
+			return (u32)_mm_cvtsi128_si32(_mm_shuffle_epi32(v, _MM_SHUFFLE(I, I, I, I)));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack bsx() const
+		{
+			return _mm_shuffle_epi32(v, _MM_SHUFFLE(I, I, I, I));
+		}
+
+		template<int I0, int I1, int I2, int I3>
+		LSIMD_ENSURE_INLINE sse_pack swizzle() const
+		{
+			return _mm_shuffle_epi32(v, _MM_SHUFFLE(I3, I2, I1, I0));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack shift_front() const
+		{
+			return _mm_srli_si128(v, (I << 2));
+		}
+
+		template<int I>
+		LSIMD_ENSURE_INLINE sse_pack shift_back() const
+		{
+			return _mm_slli_si128(v, (I << 2));
+		}
+
+		LSIMD_ENSURE_INLINE u32 sum() const
+		{
+			__m128i t = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+			t = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+			return (u32)_mm_cvtsi128_si32(t);
+		}
+
+		// Only for debug
+
+		LSIMD_ENSURE_INLINE bool test_equal(u32 e0, u32 e1, u32 e2, u32 e3) const
+		{
+			return e[0] == e0 && e[1] == e1 && e[2] == e2 && e[3] == e3;
+		}
+
+		LSIMD_ENSURE_INLINE bool test_equal(const u32 *r) const
+		{
+			return test_equal(r[0], r[1], r[2], r[3]);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("(");
+			std::printf(fmt, e[0]); std::printf(", ");
+			std::printf(fmt, e[1]); std::printf(", ");
+			std::printf(fmt, e[2]); std::printf(", ");
+			std::printf(fmt, e[3]);
+			std::printf(")");
+		}
+
+	}; // end struct sse_pack<u32>
+
+
+	// typedefs
+
+	/**
+	 * @brief A short name for sse_pack<i32>.
+	 */
+	typedef sse_pack<i32> sse_i32pk;
+
+	/**
+	 * @brief A short name for sse_pack<u32>.
+	 */
+	typedef sse_pack<u32> sse_u32pk;
+
+
+	/********************************************
+	 *
+	 *  Arithmetic and bitwise operations
+	 *
+	 ********************************************/
+
+	namespace sse
+	{
+		LSIMD_ENSURE_INLINE
+		inline __m128i i32_mullo(const __m128i a, const __m128i b)
+		{
+#ifdef LSIMD_HAS_SSE4_1
+			return _mm_mullo_epi32(a, b);
+#else
+			__m128i p02 = _mm_mul_epu32(a, b);
+			__m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+			return _mm_unpacklo_epi32(
+					_mm_shuffle_epi32(p02, _MM_SHUFFLE(0, 0, 2, 0)),
+					_mm_shuffle_epi32(p13, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+		}
+
+		// the 64-bit products of the even and the odd entries are
+		// merged with shifts and masks, which keeps the shuffle unit free
+
+		LSIMD_ENSURE_INLINE
+		inline __m128i u32_mulhi(const __m128i a, const __m128i b)
+		{
+			__m128i p02 = _mm_mul_epu32(a, b);
+			__m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+			__m128i mhi = _mm_set_epi32(-1, 0, -1, 0);
+			return _mm_or_si128(_mm_srli_epi64(p02, 32), _mm_and_si128(p13, mhi));
+		}
+
+		// flips the sign bits, so that signed comparison orders unsigned values
+
+		LSIMD_ENSURE_INLINE
+		inline __m128i u32_flip(const __m128i a)
+		{
+			return _mm_xor_si128(a, _mm_set1_epi32((int)0x80000000));
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline __m128i i32_select(const __m128i mask, const __m128i a, const __m128i b)
+		{
+			return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+		}
+	}
+
+	/**
+	 * Adds two packs in an entry-wise way (with wrap-around).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator + (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return _mm_add_epi32(a.v, b.v);
+	}
+
+	/**
+	 * Adds two packs in an entry-wise way (with wrap-around).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator + (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return _mm_add_epi32(a.v, b.v);
+	}
+
+	/**
+	 * Subtracts b from a in an entry-wise way (with wrap-around).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator - (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return _mm_sub_epi32(a.v, b.v);
+	}
+
+	/**
+	 * Subtracts b from a in an entry-wise way (with wrap-around).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator - (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return _mm_sub_epi32(a.v, b.v);
+	}
+
+	/**
+	 * Negates the entries of a pack.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator - (const sse_i32pk& a)
+	{
+		return _mm_sub_epi32(_mm_setzero_si128(), a.v);
+	}
+
+	/**
+	 * Multiplies two packs in an entry-wise way, keeping the lower
+	 * 32 bits of the products.
+	 *
+	 * @remark  This uses PMULLD when SSE4.1 is available.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator * (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return sse::i32_mullo(a.v, b.v);
+	}
+
+	/**
+	 * Multiplies two packs in an entry-wise way, keeping the lower
+	 * 32 bits of the products.
+	 *
+	 * @remark  This uses PMULLD when SSE4.1 is available.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator * (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return sse::i32_mullo(a.v, b.v);
+	}
+
+	/**
+	 * Multiplies two packs in an entry-wise way, keeping the higher
+	 * 32 bits of the 64-bit products.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk mulhi(const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return sse::u32_mulhi(a.v, b.v);
+	}
+
+	/**
+	 * Multiplies two packs in an entry-wise way, and splits each
+	 * 64-bit product into its higher and lower 32 bits.
+	 *
+	 * @param a   The first input pack.
+	 * @param b   The second input pack.
+	 * @param hi  The higher 32 bits of the products.
+	 * @param lo  The lower 32 bits of the products.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void mulhilo(const sse_u32pk& a, const sse_u32pk& b, sse_u32pk& hi, sse_u32pk& lo)
+	{
+		__m128i p02 = _mm_mul_epu32(a.v, b.v);
+		__m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+		__m128i mhi = _mm_set_epi32(-1, 0, -1, 0);
+		hi.v = _mm_or_si128(_mm_srli_epi64(p02, 32), _mm_and_si128(p13, mhi));
+		lo.v = _mm_or_si128(_mm_andnot_si128(mhi, p02), _mm_slli_epi64(p13, 32));
+	}
+
+	/**
+	 * Bitwise and.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator & (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return _mm_and_si128(a.v, b.v);
+	}
+
+	/**
+	 * Bitwise and.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator & (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return _mm_and_si128(a.v, b.v);
+	}
+
+	/**
+	 * Bitwise or.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator | (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return _mm_or_si128(a.v, b.v);
+	}
+
+	/**
+	 * Bitwise or.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator | (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return _mm_or_si128(a.v, b.v);
+	}
+
+	/**
+	 * Bitwise exclusive or.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator ^ (const sse_i32pk& a, const sse_i32pk& b)
+	{
+		return _mm_xor_si128(a.v, b.v);
+	}
+
+	/**
+	 * Bitwise exclusive or.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator ^ (const sse_u32pk& a, const sse_u32pk& b)
+	{
+		return _mm_xor_si128(a.v, b.v);
+	}
+
+	/**
+	 * Shifts all entries to the left by n bits.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator << (const sse_i32pk& a, const int n)
+	{
+		return _mm_slli_epi32(a.v, n);
+	}
+
+	/**
+	 * Shifts all entries to the left by n bits.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator << (const sse_u32pk& a, const int n)
+	{
+		return _mm_slli_epi32(a.v, n);
+	}
+
+	/**
+	 * Shifts all entries to the right by n bits, filling in
+	 * the sign bits (arithmetic shift).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk operator >> (const sse_i32pk& a, const int n)
+	{
+		return _mm_srai_epi32(a.v, n);
+	}
+
+	/**
+	 * Shifts all entries to the right by n bits, filling in
+	 * zeros (logical shift).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk operator >> (const sse_u32pk& a, const int n)
+	{
+		return _mm_srli_epi32(a.v, n);
+	}
+
+	/**
+	 * Selects the smaller values in an entry-wise way.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk vmin(const sse_i32pk& a, const sse_i32pk& b)
+	{
+#ifdef LSIMD_HAS_SSE4_1
+		return _mm_min_epi32(a.v, b.v);
+#else
+		return sse::i32_select(_mm_cmplt_epi32(a.v, b.v), a.v, b.v);
+#endif
+	}
+
+	/**
+	 * Selects the smaller values in an entry-wise way.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk vmin(const sse_u32pk& a, const sse_u32pk& b)
+	{
+#ifdef LSIMD_HAS_SSE4_1
+		return _mm_min_epu32(a.v, b.v);
+#else
+		return sse::i32_select(_mm_cmplt_epi32(sse::u32_flip(a.v), sse::u32_flip(b.v)), a.v, b.v);
+#endif
+	}
+
+	/**
+	 * Selects the larger values in an entry-wise way.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk vmax(const sse_i32pk& a, const sse_i32pk& b)
+	{
+#ifdef LSIMD_HAS_SSE4_1
+		return _mm_max_epi32(a.v, b.v);
+#else
+		return sse::i32_select(_mm_cmpgt_epi32(a.v, b.v), a.v, b.v);
+#endif
+	}
+
+	/**
+	 * Selects the larger values in an entry-wise way.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk vmax(const sse_u32pk& a, const sse_u32pk& b)
+	{
+#ifdef LSIMD_HAS_SSE4_1
+		return _mm_max_epu32(a.v, b.v);
+#else
+		return sse::i32_select(_mm_cmpgt_epi32(sse::u32_flip(a.v), sse::u32_flip(b.v)), a.v, b.v);
+#endif
+	}
+
+	/**
+	 * Calculates the inclusive prefix sums of the entries, as
+	 * (a[0], a[0] + a[1], a[0] + a[1] + a[2], a[0] + a[1] + a[2] + a[3]).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk prefix_sum(const sse_i32pk& a)
+	{
+		__m128i t = _mm_add_epi32(a.v, _mm_slli_si128(a.v, 4));
+		return _mm_add_epi32(t, _mm_slli_si128(t, 8));
+	}
+
+	/**
+	 * Calculates the inclusive prefix sums of the entries (modulo 2^32).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk prefix_sum(const sse_u32pk& a)
+	{
+		__m128i t = _mm_add_epi32(a.v, _mm_slli_si128(a.v, 4));
+		return _mm_add_epi32(t, _mm_slli_si128(t, 8));
+	}
+
+
+	/********************************************
+	 *
+	 *  Conversions
+	 *
+	 ********************************************/
+
+	/**
+	 * Converts integers to single-precision values.
+	 *
+	 * @return  The converted pack, which is exact when |a[i]| <= 2^24.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f32pk cvt_f32(const sse_i32pk& a)
+	{
+		return _mm_cvtepi32_ps(a.v);
+	}
+
+	/**
+	 * Converts the lower two integers to double-precision values.
+	 *
+	 * @return  The converted pack, as (a[0], a[1]).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f64pk cvt_f64(const sse_i32pk& a)
+	{
+		return _mm_cvtepi32_pd(a.v);
+	}
+
+	/**
+	 * Converts single-precision values to integers by rounding
+	 * to the nearest (in the current rounding mode).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk cvt_i32(const sse_f32pk& a)
+	{
+		return _mm_cvtps_epi32(a.v);
+	}
+
+	/**
+	 * Converts single-precision values to integers by truncation
+	 * (i.e. rounding towards zero).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk cvtt_i32(const sse_f32pk& a)
+	{
+		return _mm_cvttps_epi32(a.v);
+	}
+
+	/**
+	 * Converts double-precision values to integers by rounding
+	 * to the nearest (in the current rounding mode).
+	 *
+	 * @return  The converted pack, as (a[0], a[1], 0, 0).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk cvt_i32(const sse_f64pk& a)
+	{
+		return _mm_cvtpd_epi32(a.v);
+	}
+
+	/**
+	 * Converts double-precision values to integers by truncation
+	 * (i.e. rounding towards zero).
+	 *
+	 * @return  The converted pack, as (a[0], a[1], 0, 0).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk cvtt_i32(const sse_f64pk& a)
+	{
+		return _mm_cvttpd_epi32(a.v);
+	}
+
+
+	/********************************************
+	 *
+	 *  Reinterpretation and transposition
+	 *
+	 ********************************************/
+
+	/**
+	 * Reinterprets the bits of an unsigned pack as signed integers.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_i32pk as_i32(const sse_u32pk& a)
+	{
+		return a.v;
+	}
+
+	/**
+	 * Reinterprets the bits of a signed pack as unsigned integers.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk as_u32(const sse_i32pk& a)
+	{
+		return a.v;
+	}
+
+	/**
+	 * Reinterprets the bits of a single-precision pack as unsigned integers.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk as_u32(const sse_f32pk& a)
+	{
+		return _mm_castps_si128(a.v);
+	}
+
+	/**
+	 * Reinterprets the bits of a double-precision pack as unsigned integers.
+	 *
+	 * @remark  The entry a[i] occupies the integer entries 2i (lower
+	 *          32 bits) and 2i+1 (higher 32 bits).
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_u32pk as_u32(const sse_f64pk& a)
+	{
+		return _mm_castpd_si128(a.v);
+	}
+
+	/**
+	 * Reinterprets the bits of an unsigned pack as single-precision values.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f32pk as_f32(const sse_u32pk& a)
+	{
+		return _mm_castsi128_ps(a.v);
+	}
+
+	/**
+	 * Reinterprets the bits of an unsigned pack as double-precision values.
+	 *
+	 * @remark  The integer entries 2i (lower 32 bits) and 2i+1 (higher
+	 *          32 bits) make up the i-th double-precision entry.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline sse_f64pk as_f64(const sse_u32pk& a)
+	{
+		return _mm_castsi128_pd(a.v);
+	}
+
+	/**
+	 * Transposes four packs in place, regarding them as the rows
+	 * of a 4 x 4 matrix.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void transpose4(sse_u32pk& a, sse_u32pk& b, sse_u32pk& c, sse_u32pk& d)
+	{
+		__m128i t0 = _mm_unpacklo_epi32(a.v, b.v);
+		__m128i t1 = _mm_unpacklo_epi32(c.v, d.v);
+		__m128i t2 = _mm_unpackhi_epi32(a.v, b.v);
+		__m128i t3 = _mm_unpackhi_epi32(c.v, d.v);
+
+		a.v = _mm_unpacklo_epi64(t0, t1);
+		b.v = _mm_unpackhi_epi64(t0, t1);
+		c.v = _mm_unpacklo_epi64(t2, t3);
+		d.v = _mm_unpackhi_epi64(t2, t3);
+	}
+
+	/** @} */
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif /* LSIMD_SSE_IPACK_H_ */
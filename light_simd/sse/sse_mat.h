@@ -39,6 +39,7 @@
 #include "details/sse_mat_comp_bits.h"
 #include "details/sse_mat_matmul_bits.h"
 #include "details/sse_mat_sol_bits.h"
+#include "details/sse_mat_batch_bits.h"
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -447,6 +448,37 @@ namespace lsimd
 			return transform(core, v);
 		}
 
+		/**
+		 * Evaluates a matrix-vector product and adds it to a vector.
+		 *
+		 * @param v   The vector to be multiplied with.
+		 * @param y   The vector of addends.
+		 *
+		 * @return    The result, as y + this matrix * v.
+		 *
+		 * @remark    The products are accumulated to y column by column
+		 *            (using FMA instructions when available).
+		 */
+		LSIMD_ENSURE_INLINE
+		sse_vec<T, M> transform_add(const sse_vec<T, N>& v, const sse_vec<T, M>& y) const
+		{
+			return sse::transform_add(core, v, y);
+		}
+
+		/**
+		 * Evaluates a matrix-vector product and subtracts it from a vector.
+		 *
+		 * @param v   The vector to be multiplied with.
+		 * @param y   The vector of minuends.
+		 *
+		 * @return    The result, as y - this matrix * v.
+		 */
+		LSIMD_ENSURE_INLINE
+		sse_vec<T, M> transform_sub(const sse_vec<T, N>& v, const sse_vec<T, M>& y) const
+		{
+			return sse::transform_sub(core, v, y);
+		}
+
 		/**
 		 * Evaluates the trace of the matrix.
 		 *
@@ -492,6 +524,40 @@ namespace lsimd
 		return C;
 	}
 
+	/**
+	 * Transforms a batch of vectors with a matrix, as ys[i] = A * xs[i].
+	 *
+	 * @param A    A matrix of size M x N.
+	 * @param n    The number of vectors.
+	 * @param xs   The base address of the input vectors.
+	 * @param ldx  The offset between consecutive input vectors (>= N).
+	 * @param ys   The base address of the output vectors.
+	 * @param ldy  The offset between consecutive output vectors (>= M).
+	 *
+	 * @remark     The addresses need not be aligned. ys can be xs 
+	 *             when M == N and ldx == ldy.
+	 */
+	template<typename T, int M, int N>
+	inline void batch_transform(const sse_mat<T, M, N>& A, int n, const T *xs, int ldx, T *ys, int ldy)
+	{
+		sse::batch_transform_op<T, M, N>::run(A.core, n, xs, ldx, ys, ldy);
+	}
+
+	/**
+	 * Transforms a batch of packed vectors with a matrix, as 
+	 * ys[i] = A * xs[i].
+	 *
+	 * @param A    A matrix of size M x N.
+	 * @param n    The number of vectors.
+	 * @param xs   The input vectors, stored contiguously (n x N values).
+	 * @param ys   The output vectors, stored contiguously (n x M values).
+	 */
+	template<typename T, int M, int N>
+	inline void batch_transform(const sse_mat<T, M, N>& A, int n, const T *xs, T *ys)
+	{
+		sse::batch_transform_op<T, M, N>::run(A.core, n, xs, N, ys, M);
+	}
+
 	/** @} */  // mat_vec_sse
 
 
@@ -40,10 +40,12 @@
 
 #ifndef LSIMD_IN_DOXYGEN 
 
-#if defined(LSIMD_USE_INTEL_SVML) || defined(LSIMD_USE_AMD_LIBM)
-#define LSIMD_USE_MATH_FUNCTIONS
+#if !defined(LSIMD_USE_INTEL_SVML) && !defined(LSIMD_USE_AMD_LIBM)
+#define LSIMD_USE_NATIVE_MATH
 #endif
 
+#define LSIMD_USE_MATH_FUNCTIONS
+
 #ifdef LSIMD_USE_INTEL_SVML
 
 // External function prototypes
@@ -107,15 +109,15 @@ extern "C"
 #ifdef LSIMD_USE_AMD_LIBM
 
 #define LIBM_SSE_F( name ) amd_vrs4_##name##f
-#define LIBM_SSE_F( name ) amd_vrd2_##name
+#define LIBM_SSE_D( name ) amd_vrd2_##name
 
 #define DECLARE_LIBM_SSE_EXTERN1( name ) \
-	__m128  SVML_SSE_F(name)( __m128 ); \
-	__m128d SVML_SSE_D(name)( __m128d );
+	__m128  LIBM_SSE_F(name)( __m128 ); \
+	__m128d LIBM_SSE_D(name)( __m128d );
 
 #define DECLARE_LIBM_SSE_EXTERN2( name ) \
-	__m128  SVML_SSE_F(name)( __m128,  __m128  ); \
-	__m128d SVML_SSE_D(name)( __m128d, __m128d );
+	__m128  LIBM_SSE_F(name)( __m128,  __m128  ); \
+	__m128d LIBM_SSE_D(name)( __m128d, __m128d );
 
 #define LSIMD_SSE_F( name ) LIBM_SSE_F( name )
 #define LSIMD_SSE_D( name ) LIBM_SSE_D( name )
@@ -159,6 +161,104 @@ extern "C"
 
 #endif
 
+
+#ifdef LSIMD_USE_NATIVE_MATH
+
+// Without a vector math library, the functions are evaluated
+// entry by entry with the (C99) functions of the C library.
+
+#include <math.h>
+
+#define NATIVE_SSE_F( name ) lsimd::sse::native_##name##_f4
+#define NATIVE_SSE_D( name ) lsimd::sse::native_##name##_d2
+
+#define DEFINE_NATIVE_SSE1( name, ff, df ) \
+	inline __m128 native_##name##_f4( __m128 x ) \
+	{ \
+		LSIMD_ALIGN_SSE f32 a[4]; \
+		_mm_store_ps(a, x); \
+		a[0] = ff(a[0]); a[1] = ff(a[1]); a[2] = ff(a[2]); a[3] = ff(a[3]); \
+		return _mm_load_ps(a); \
+	} \
+	inline __m128d native_##name##_d2( __m128d x ) \
+	{ \
+		LSIMD_ALIGN_SSE f64 a[2]; \
+		_mm_store_pd(a, x); \
+		a[0] = df(a[0]); a[1] = df(a[1]); \
+		return _mm_load_pd(a); \
+	}
+
+#define DEFINE_NATIVE_SSE2( name, ff, df ) \
+	inline __m128 native_##name##_f4( __m128 x, __m128 y ) \
+	{ \
+		LSIMD_ALIGN_SSE f32 a[4]; \
+		LSIMD_ALIGN_SSE f32 b[4]; \
+		_mm_store_ps(a, x); \
+		_mm_store_ps(b, y); \
+		a[0] = ff(a[0], b[0]); a[1] = ff(a[1], b[1]); a[2] = ff(a[2], b[2]); a[3] = ff(a[3], b[3]); \
+		return _mm_load_ps(a); \
+	} \
+	inline __m128d native_##name##_d2( __m128d x, __m128d y ) \
+	{ \
+		LSIMD_ALIGN_SSE f64 a[2]; \
+		LSIMD_ALIGN_SSE f64 b[2]; \
+		_mm_store_pd(a, x); \
+		_mm_store_pd(b, y); \
+		a[0] = df(a[0], b[0]); a[1] = df(a[1], b[1]); \
+		return _mm_load_pd(a); \
+	}
+
+#define LSIMD_SSE_F( name ) NATIVE_SSE_F( name )
+#define LSIMD_SSE_D( name ) NATIVE_SSE_D( name )
+
+#define LSIMD_HAS_SSE_ERF
+
+namespace lsimd { namespace sse {
+
+	inline f32 native_exp10f(f32 x) { return ::powf(10.f, x); }
+	inline f64 native_exp10(f64 x) { return ::pow(10.0, x); }
+
+	DEFINE_NATIVE_SSE1( cbrt, ::cbrtf, ::cbrt )
+	DEFINE_NATIVE_SSE2( pow, ::powf, ::pow )
+	DEFINE_NATIVE_SSE2( hypot, ::hypotf, ::hypot )
+
+	DEFINE_NATIVE_SSE1( exp, ::expf, ::exp )
+	DEFINE_NATIVE_SSE1( exp2, ::exp2f, ::exp2 )
+	DEFINE_NATIVE_SSE1( exp10, native_exp10f, native_exp10 )
+	DEFINE_NATIVE_SSE1( expm1, ::expm1f, ::expm1 )
+
+	DEFINE_NATIVE_SSE1( log, ::logf, ::log )
+	DEFINE_NATIVE_SSE1( log2, ::log2f, ::log2 )
+	DEFINE_NATIVE_SSE1( log10, ::log10f, ::log10 )
+	DEFINE_NATIVE_SSE1( log1p, ::log1pf, ::log1p )
+
+	DEFINE_NATIVE_SSE1( sin, ::sinf, ::sin )
+	DEFINE_NATIVE_SSE1( cos, ::cosf, ::cos )
+	DEFINE_NATIVE_SSE1( tan, ::tanf, ::tan )
+
+	DEFINE_NATIVE_SSE1( asin, ::asinf, ::asin )
+	DEFINE_NATIVE_SSE1( acos, ::acosf, ::acos )
+	DEFINE_NATIVE_SSE1( atan, ::atanf, ::atan )
+	DEFINE_NATIVE_SSE2( atan2, ::atan2f, ::atan2 )
+
+	DEFINE_NATIVE_SSE1( sinh, ::sinhf, ::sinh )
+	DEFINE_NATIVE_SSE1( cosh, ::coshf, ::cosh )
+	DEFINE_NATIVE_SSE1( tanh, ::tanhf, ::tanh )
+
+	DEFINE_NATIVE_SSE1( asinh, ::asinhf, ::asinh )
+	DEFINE_NATIVE_SSE1( acosh, ::acoshf, ::acosh )
+	DEFINE_NATIVE_SSE1( atanh, ::atanhf, ::atanh )
+
+	DEFINE_NATIVE_SSE1( erf, ::erff, ::erf )
+	DEFINE_NATIVE_SSE1( erfc, ::erfcf, ::erfc )
+
+} }
+
+#undef DEFINE_NATIVE_SSE1
+#undef DEFINE_NATIVE_SSE2
+
+#endif  /* LSIMD_USE_NATIVE_MATH */
+
 #endif // LSIMD_IN_DOXYGEN
 
 
@@ -182,7 +282,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as x^(1/3).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk cbrt( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk cbrt( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(cbrt)(x.v);
 	}
@@ -194,7 +294,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as x^(1/3).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk cbrt( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk cbrt( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(cbrt)(x.v);
 	}
@@ -207,7 +307,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as x^y.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk pow( const sse_f32pk& x, const sse_f32pk& e )
+	LSIMD_ENSURE_INLINE inline sse_f32pk pow( const sse_f32pk& x, const sse_f32pk& e )
 	{
 		return LSIMD_SSE_F(pow)(x.v, e.v);
 	}
@@ -220,7 +320,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as x^y.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk pow( const sse_f64pk& x, const sse_f64pk& e )
+	LSIMD_ENSURE_INLINE inline sse_f64pk pow( const sse_f64pk& x, const sse_f64pk& e )
 	{
 		return LSIMD_SSE_D(pow)(x.v, e.v);
 	}
@@ -233,7 +333,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sqrt(x^2 + y^2).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk hypot( const sse_f32pk& x, const sse_f32pk& y )
+	LSIMD_ENSURE_INLINE inline sse_f32pk hypot( const sse_f32pk& x, const sse_f32pk& y )
 	{
 		return LSIMD_SSE_F(hypot)(x.v, y.v);
 	}
@@ -246,7 +346,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sqrt(x^2 + y^2).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk hypot( const sse_f64pk& x, const sse_f64pk& y )
+	LSIMD_ENSURE_INLINE inline sse_f64pk hypot( const sse_f64pk& x, const sse_f64pk& y )
 	{
 		return LSIMD_SSE_D(hypot)(x.v, y.v);
 	}
@@ -258,7 +358,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as e^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk exp( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk exp( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(exp)(x.v);
 	}
@@ -270,7 +370,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as e^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk exp( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk exp( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(exp)(x.v);
 	}
@@ -282,7 +382,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as 2^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk exp2( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk exp2( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(exp2)(x.v);
 	}
@@ -294,7 +394,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as 2^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk exp2( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk exp2( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(exp2)(x.v);
 	}
@@ -306,7 +406,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as 10^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk exp10( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk exp10( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(exp10)(x.v);
 	}
@@ -318,7 +418,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as 10^x.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk exp10( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk exp10( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(exp10)(x.v);
 	}
@@ -330,7 +430,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as e^x - 1.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk expm1( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk expm1( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(expm1)(x.v);
 	}
@@ -342,7 +442,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as e^x - 1.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk expm1( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk expm1( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(expm1)(x.v);
 	}
@@ -354,7 +454,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as ln(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk log( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk log( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(log)(x.v);
 	}
@@ -366,7 +466,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as ln(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk log( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk log( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(log)(x.v);
 	}
@@ -378,7 +478,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as log_2(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk log2( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk log2( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(log2)(x.v);
 	}
@@ -390,7 +490,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as log_2(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk log2( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk log2( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(log2)(x.v);
 	}
@@ -402,7 +502,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as log_10(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk log10( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk log10( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(log10)(x.v);
 	}
@@ -414,7 +514,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as log_10(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk log10( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk log10( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(log10)(x.v);
 	}
@@ -426,7 +526,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as ln(1 + x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk log1p( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk log1p( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(log1p)(x.v);
 	}
@@ -438,7 +538,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as ln(1 + x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk log1p( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk log1p( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(log1p)(x.v);
 	}
@@ -450,7 +550,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk sin( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk sin( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(sin)(x.v);
 	}
@@ -462,7 +562,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk sin( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk sin( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(sin)(x.v);
 	}
@@ -474,7 +574,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as cos(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk cos( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk cos( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(cos)(x.v);
 	}
@@ -486,7 +586,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as cos(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk cos( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk cos( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(cos)(x.v);
 	}
@@ -498,7 +598,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk tan( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk tan( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(tan)(x.v);
 	}
@@ -510,7 +610,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk tan( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk tan( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(tan)(x.v);
 	}
@@ -522,7 +622,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arcsin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk asin( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk asin( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(asin)(x.v);
 	}
@@ -534,7 +634,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arcsin(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk asin( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk asin( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(asin)(x.v);
 	}
@@ -546,7 +646,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arccos(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk acos( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk acos( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(acos)(x.v);
 	}
@@ -558,7 +658,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arccos(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk acos( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk acos( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(acos)(x.v);
 	}
@@ -570,7 +670,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arctan(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk atan( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk atan( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(atan)(x.v);
 	}
@@ -582,7 +682,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arctan(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk atan( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk atan( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(atan)(x.v);
 	}
@@ -595,7 +695,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arctan(y/x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk atan2( const sse_f32pk& x, const sse_f32pk& y )
+	LSIMD_ENSURE_INLINE inline sse_f32pk atan2( const sse_f32pk& x, const sse_f32pk& y )
 	{
 		return LSIMD_SSE_F(atan2)(x.v, y.v);
 	}
@@ -608,7 +708,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as arctan(y/x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk atan2( const sse_f64pk& x, const sse_f64pk& y )
+	LSIMD_ENSURE_INLINE inline sse_f64pk atan2( const sse_f64pk& x, const sse_f64pk& y )
 	{
 		return LSIMD_SSE_D(atan2)(x.v, y.v);
 	}
@@ -621,7 +721,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sinh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk sinh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk sinh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(sinh)(x.v);
 	}
@@ -633,7 +733,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sinh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk sinh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk sinh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(sinh)(x.v);
 	}
@@ -645,7 +745,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sinh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk cosh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk cosh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(cosh)(x.v);
 	}
@@ -657,7 +757,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as sinh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk cosh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk cosh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(cosh)(x.v);
 	}
@@ -669,7 +769,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as tanh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk tanh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk tanh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(tanh)(x.v);
 	}
@@ -681,7 +781,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack, as tanh(x).
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk tanh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk tanh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(tanh)(x.v);
 	}
@@ -694,7 +794,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk asinh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk asinh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(asinh)(x.v);
 	}
@@ -706,7 +806,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk asinh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk asinh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(asinh)(x.v);
 	}
@@ -718,7 +818,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk acosh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk acosh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(acosh)(x.v);
 	}
@@ -730,7 +830,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk acosh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk acosh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(acosh)(x.v);
 	}
@@ -742,7 +842,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk atanh( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk atanh( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(atanh)(x.v);
 	}
@@ -754,7 +854,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk atanh( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk atanh( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(atanh)(x.v);
 	}
@@ -768,7 +868,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk erf( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk erf( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(erf)(x.v);
 	}
@@ -780,7 +880,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk erf( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk erf( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(erf)(x.v);
 	}
@@ -792,7 +892,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f32pk erfc( const sse_f32pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f32pk erfc( const sse_f32pk& x )
 	{
 		return LSIMD_SSE_F(erfc)(x.v);
 	}
@@ -804,7 +904,7 @@ namespace lsimd
 	 *
 	 * @return   The resultant pack.
 	 */
-	LSIMD_ENSURE_INLINE sse_f64pk erfc( const sse_f64pk& x )
+	LSIMD_ENSURE_INLINE inline sse_f64pk erfc( const sse_f64pk& x )
 	{
 		return LSIMD_SSE_D(erfc)(x.v);
 	}
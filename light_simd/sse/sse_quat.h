@@ -0,0 +1,608 @@
+/**
+ * @file sse_quat.h
+ *
+ * @brief SSE-based quaternion classes.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ * 
+ * Permission is hereby granted, free of charge, to any person 
+ * obtaining a copy of this software and associated documentation 
+ * files (the "Software"), to deal in the Software without restriction, 
+ * including without limitation the rights to use, copy, modify, merge, 
+ * publish, distribute, sublicense, and/or sell copies of the Software, 
+ * and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be 
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES 
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_QUAT_H_
+#define LSIMD_SSE_QUAT_H_
+
+#include "sse_mat.h"
+#include <cmath>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4141)
+#endif
+
+namespace lsimd
+{
+
+	/**
+	 * \addtogroup mat_vec_sse
+	 */
+	/** @{ */
+
+	template<typename T> class sse_quat;
+
+	namespace sse
+	{
+		/**
+		 * Flips the signs of selected entries of a pack.
+		 *
+		 * @tparam S0..S3  Whether the corresponding entry is negated (1) or kept (0).
+		 */
+		template<int S0, int S1, int S2, int S3>
+		LSIMD_ENSURE_INLINE
+		inline sse_f32pk flip_signs(const sse_f32pk& a)
+		{
+			return _mm_xor_ps(a.v, _mm_setr_ps(
+					S0 ? -0.f : 0.f, S1 ? -0.f : 0.f,
+					S2 ? -0.f : 0.f, S3 ? -0.f : 0.f));
+		}
+
+		template<int S0, int S1>
+		LSIMD_ENSURE_INLINE
+		inline sse_f64pk flip_signs(const sse_f64pk& a)
+		{
+			return _mm_xor_pd(a.v, _mm_setr_pd(
+					S0 ? -0.0 : 0.0, S1 ? -0.0 : 0.0));
+		}
+
+		/**
+		 * Computes the cross product of the first three entries of
+		 * a and b. The last entry of the result is a[3] * b[3] - a[3] * b[3],
+		 * which is zero for finite inputs.
+		 */
+		LSIMD_ENSURE_INLINE
+		inline sse_f32pk cross3(const sse_f32pk& a, const sse_f32pk& b)
+		{
+			return a.swizzle<1,2,0,3>() * b.swizzle<2,0,1,3>()
+				 - a.swizzle<2,0,1,3>() * b.swizzle<1,2,0,3>();
+		}
+
+		/**
+		 * Computes the cross product of (a0[0], a0[1], a1[0]) and
+		 * (b0[0], b0[1], b1[0]), writing the result to (r0, r1), with r1[1] = 0.
+		 */
+		LSIMD_ENSURE_INLINE
+		inline void cross3(const sse_f64pk& a0, const sse_f64pk& a1,
+				const sse_f64pk& b0, const sse_f64pk& b1,
+				sse_f64pk& r0, sse_f64pk& r1)
+		{
+			r0 = shuffle<1,0>(a0, a1) * shuffle<0,0>(b1, b0)
+			   - shuffle<0,0>(a1, a0) * shuffle<1,0>(b0, b1);
+
+			sse_f64pk p = a0 * b0.swizzle<1,0>();
+			r1 = shuffle<0,0>(sub_s(p, p.dup_high()), sse_f64pk::zeros());
+		}
+
+		/**
+		 * Converts a 3 x 3 rotation matrix (in column-major order) to
+		 * a unit quaternion (x, y, z, w), using Shepperd's method.
+		 */
+		template<typename T>
+		inline void rotmat_to_quat(const T *r, T *q)
+		{
+			const T r00 = r[0], r10 = r[1], r20 = r[2];
+			const T r01 = r[3], r11 = r[4], r21 = r[5];
+			const T r02 = r[6], r12 = r[7], r22 = r[8];
+
+			const T tr = r00 + r11 + r22;
+
+			if (tr > T(0))
+			{
+				T s = std::sqrt(tr + T(1)) * T(2);
+				q[0] = (r21 - r12) / s;
+				q[1] = (r02 - r20) / s;
+				q[2] = (r10 - r01) / s;
+				q[3] = T(0.25) * s;
+			}
+			else if (r00 > r11 && r00 > r22)
+			{
+				T s = std::sqrt(T(1) + r00 - r11 - r22) * T(2);
+				q[0] = T(0.25) * s;
+				q[1] = (r01 + r10) / s;
+				q[2] = (r02 + r20) / s;
+				q[3] = (r21 - r12) / s;
+			}
+			else if (r11 > r22)
+			{
+				T s = std::sqrt(T(1) + r11 - r00 - r22) * T(2);
+				q[0] = (r01 + r10) / s;
+				q[1] = T(0.25) * s;
+				q[2] = (r12 + r21) / s;
+				q[3] = (r02 - r20) / s;
+			}
+			else
+			{
+				T s = std::sqrt(T(1) + r22 - r00 - r11) * T(2);
+				q[0] = (r02 + r20) / s;
+				q[1] = (r12 + r21) / s;
+				q[2] = T(0.25) * s;
+				q[3] = (r10 - r01) / s;
+			}
+		}
+	}
+
+
+#ifdef LSIMD_IN_DOXYGEN
+
+	/**
+	 * @brief An SSE-based quaternion.
+	 *
+	 * The quaternion is represented as (x, y, z, w), where (x, y, z) is
+	 * the vector part and w is the scalar part.
+	 *
+	 * @tparam T   The type of entry values.
+	 */
+	template<typename T>
+	class sse_quat
+	{
+	public:
+		sse_quat();                                     ///< Leaves the entries uninitialized.
+		sse_quat( zero_t );                             ///< Sets all entries to zeros.
+		sse_quat(T x, T y, T z, T w);                   ///< Constructs from (x, y, z, w).
+		sse_quat(const T *a, aligned_t);                ///< Loads (x, y, z, w) from aligned memory.
+		sse_quat(const T *a, unaligned_t);              ///< Loads (x, y, z, w) from unaligned memory.
+		explicit sse_quat(const sse_mat<T, 3, 3>& R);   ///< Constructs from a rotation matrix.
+
+		static sse_quat identity();                     ///< The identity quaternion (0, 0, 0, 1).
+
+		void load(const T *a, aligned_t);
+		void load(const T *a, unaligned_t);
+		void store(T *a, aligned_t) const;
+		void store(T *a, unaligned_t) const;
+
+		T x() const;
+		T y() const;
+		T z() const;
+		T w() const;
+
+		sse_quat operator + (const sse_quat& r) const;
+		sse_quat operator - (const sse_quat& r) const;
+		sse_quat operator - () const;
+		sse_quat operator * (const sse_pack<T>& s) const; ///< Scales all entries.
+		sse_quat operator * (const sse_quat& r) const;    ///< The Hamilton product.
+
+		sse_quat conj() const;                          ///< The conjugate (-x, -y, -z, w).
+		T dot(const sse_quat& r) const;                 ///< The four-dimensional inner product.
+		sse_quat normalized() const;                    ///< Scales to unit norm through rsqrt.
+
+		sse_vec<T, 3> rotate(const sse_vec<T, 3>& v) const;  ///< Rotates v, assuming unit norm.
+		sse_mat<T, 3, 3> to_mat() const;                     ///< The rotation matrix, assuming unit norm.
+
+		bool test_equal(const T *r) const;
+		void dump(const char *fmt) const;
+	};
+
+#endif
+
+
+	template<> class sse_quat<f32>
+	{
+	public:
+		LSIMD_ENSURE_INLINE explicit sse_quat(const __m128 p) : m_pk(p) { }
+		LSIMD_ENSURE_INLINE explicit sse_quat(const sse_f32pk& p) : m_pk(p) { }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_quat() { }
+
+		LSIMD_ENSURE_INLINE sse_quat( zero_t ) : m_pk( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f32 x, const f32 y, const f32 z, const f32 w)
+		: m_pk(x, y, z, w) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f32 *a, aligned_t) : m_pk(a, aligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f32 *a, unaligned_t) : m_pk(a, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE explicit sse_quat(const sse_mat<f32, 3, 3>& R)
+		{
+			f32 r[9];
+			f32 q[4];
+			R.store(r, unaligned_t());
+			sse::rotmat_to_quat(r, q);
+			m_pk.load(q, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE static sse_quat identity()
+		{
+			return sse_quat(_mm_setr_ps(0.f, 0.f, 0.f, 1.f));
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f32 *a, aligned_t)
+		{
+			m_pk.load(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f32 *a, unaligned_t)
+		{
+			m_pk.load(a, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f32 *a, aligned_t) const
+		{
+			m_pk.store(a, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f32 *a, unaligned_t) const
+		{
+			m_pk.store(a, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE f32 x() const { return m_pk.to_scalar(); }
+		LSIMD_ENSURE_INLINE f32 y() const { return m_pk.extract<1>(); }
+		LSIMD_ENSURE_INLINE f32 z() const { return m_pk.extract<2>(); }
+		LSIMD_ENSURE_INLINE f32 w() const { return m_pk.extract<3>(); }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_quat operator + (const sse_quat& r) const
+		{
+			return sse_quat(m_pk + r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator - (const sse_quat& r) const
+		{
+			return sse_quat(m_pk - r.m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator - () const
+		{
+			return sse_quat(-m_pk);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator * (const sse_f32pk& s) const
+		{
+			return sse_quat(m_pk * s);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator * (const sse_quat& r) const
+		{
+			const sse_f32pk& a = m_pk;
+			const sse_f32pk& b = r.m_pk;
+
+			sse_f32pk t = a.bsx<3>() * b;
+			t = t + sse::flip_signs<0,0,0,1>(a.swizzle<0,1,2,0>() * b.swizzle<3,3,3,0>());
+			t = t + sse::flip_signs<0,0,0,1>(a.swizzle<1,2,0,1>() * b.swizzle<2,0,1,1>());
+			t = t - a.swizzle<2,0,1,2>() * b.swizzle<1,2,0,2>();
+
+			return sse_quat(t);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat conj() const
+		{
+			return sse_quat(sse::flip_signs<1,1,1,0>(m_pk));
+		}
+
+		LSIMD_ENSURE_INLINE f32 dot(const sse_quat& r) const
+		{
+			return (m_pk * r.m_pk).sum();
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat normalized() const
+		{
+			sse_f32pk s = m_pk * m_pk;
+			s = s + s.swizzle<1,0,3,2>();
+			s = s + s.swizzle<2,3,0,1>();
+			return sse_quat(m_pk * rsqrt(s));
+		}
+
+		LSIMD_ENSURE_INLINE sse_vec<f32, 3> rotate(const sse_vec<f32, 3>& v) const
+		{
+			// v' = v + w * t + u x t, with t = 2 (u x v)
+
+			sse_f32pk t = sse::cross3(m_pk, v.m_pk);
+			t = t + t;
+
+			return sse_vec<f32, 3>(v.m_pk + m_pk.bsx<3>() * t + sse::cross3(m_pk, t));
+		}
+
+		LSIMD_ENSURE_INLINE sse_mat<f32, 3, 3> to_mat() const
+		{
+			const sse_f32pk& q = m_pk;
+			sse_f32pk d = q + q;
+
+			sse_f32pk c0 = _mm_setr_ps(1.f, 0.f, 0.f, 0.f);
+			sse_f32pk c1 = _mm_setr_ps(0.f, 1.f, 0.f, 0.f);
+			sse_f32pk c2 = _mm_setr_ps(0.f, 0.f, 1.f, 0.f);
+
+			c0 = c0 + sse::flip_signs<1,0,0,0>(q.swizzle<1,0,0,3>() * d.swizzle<1,1,2,3>())
+					+ sse::flip_signs<1,0,1,1>(q.swizzle<2,3,3,3>() * d.swizzle<2,2,1,3>());
+
+			c1 = c1 + sse::flip_signs<0,1,0,0>(q.swizzle<0,0,1,3>() * d.swizzle<1,0,2,3>())
+					+ sse::flip_signs<1,1,0,1>(q.swizzle<3,2,3,3>() * d.swizzle<2,2,0,3>());
+
+			c2 = c2 + sse::flip_signs<0,0,1,0>(q.swizzle<0,1,0,3>() * d.swizzle<2,2,0,3>())
+					+ sse::flip_signs<0,1,1,1>(q.swizzle<3,3,1,3>() * d.swizzle<1,0,1,3>());
+
+			return sse::smat_core<f32, 3, 3>(
+					sse_vec<f32, 3>(c0), sse_vec<f32, 3>(c1), sse_vec<f32, 3>(c2));
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE bool test_equal(const f32 *r) const
+		{
+			return m_pk.test_equal(r);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("f32 quat:\n");
+			std::printf("    m_pk = "); m_pk.dump(fmt); std::printf("\n");
+		}
+
+	public:
+		sse_f32pk m_pk;
+	};
+
+
+	template<> class sse_quat<f64>
+	{
+	public:
+		LSIMD_ENSURE_INLINE explicit sse_quat(const sse_f64pk& pk0, const sse_f64pk& pk1)
+		: m_pk0(pk0), m_pk1(pk1) { }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_quat() { }
+
+		LSIMD_ENSURE_INLINE sse_quat( zero_t ) : m_pk0( zero_t() ), m_pk1( zero_t() ) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f64 x, const f64 y, const f64 z, const f64 w)
+		: m_pk0(x, y), m_pk1(z, w) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f64 *a, aligned_t)
+		: m_pk0(a, aligned_t()), m_pk1(a + 2, aligned_t()) { }
+
+		LSIMD_ENSURE_INLINE sse_quat(const f64 *a, unaligned_t)
+		: m_pk0(a, unaligned_t()), m_pk1(a + 2, unaligned_t()) { }
+
+		LSIMD_ENSURE_INLINE explicit sse_quat(const sse_mat<f64, 3, 3>& R)
+		{
+			f64 r[9];
+			f64 q[4];
+			R.store(r, unaligned_t());
+			sse::rotmat_to_quat(r, q);
+			load(q, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE static sse_quat identity()
+		{
+			return sse_quat(sse_f64pk(zero_t()), sse_f64pk(0.0, 1.0));
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, aligned_t)
+		{
+			m_pk0.load(a, aligned_t());
+			m_pk1.load(a + 2, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void load(const f64 *a, unaligned_t)
+		{
+			m_pk0.load(a, unaligned_t());
+			m_pk1.load(a + 2, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, aligned_t) const
+		{
+			m_pk0.store(a, aligned_t());
+			m_pk1.store(a + 2, aligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE void store(f64 *a, unaligned_t) const
+		{
+			m_pk0.store(a, unaligned_t());
+			m_pk1.store(a + 2, unaligned_t());
+		}
+
+		LSIMD_ENSURE_INLINE f64 x() const { return m_pk0.to_scalar(); }
+		LSIMD_ENSURE_INLINE f64 y() const { return m_pk0.extract<1>(); }
+		LSIMD_ENSURE_INLINE f64 z() const { return m_pk1.to_scalar(); }
+		LSIMD_ENSURE_INLINE f64 w() const { return m_pk1.extract<1>(); }
+
+	public:
+		LSIMD_ENSURE_INLINE sse_quat operator + (const sse_quat& r) const
+		{
+			return sse_quat(m_pk0 + r.m_pk0, m_pk1 + r.m_pk1);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator - (const sse_quat& r) const
+		{
+			return sse_quat(m_pk0 - r.m_pk0, m_pk1 - r.m_pk1);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator - () const
+		{
+			return sse_quat(-m_pk0, -m_pk1);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator * (const sse_f64pk& s) const
+		{
+			return sse_quat(m_pk0 * s, m_pk1 * s);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat operator * (const sse_quat& r) const
+		{
+			const sse_f64pk& a0 = m_pk0;
+			const sse_f64pk& a1 = m_pk1;
+			const sse_f64pk& b0 = r.m_pk0;
+			const sse_f64pk& b1 = r.m_pk1;
+
+			// r = a.wwww * b + a.xyzx * b.wwwx [+++-] + a.yzxy * b.zxyy [+++-] - a.zxyz * b.yzxz
+
+			sse_f64pk aw = a1.bsx<1>();
+			sse_f64pk t0 = aw * b0;
+			sse_f64pk t1 = aw * b1;
+
+			t0 = t0 + a0 * b1.bsx<1>();
+			t1 = t1 + sse::flip_signs<0,1>(shuffle<0,0>(a1, a0) * shuffle<1,0>(b1, b0));
+
+			t0 = t0 + shuffle<1,0>(a0, a1) * shuffle<0,0>(b1, b0);
+			t1 = t1 + sse::flip_signs<0,1>(a0 * b0.bsx<1>());
+
+			t0 = t0 - shuffle<0,0>(a1, a0) * shuffle<1,0>(b0, b1);
+			t1 = t1 - shuffle<1,0>(a0, a1) * shuffle<0,0>(b0, b1);
+
+			return sse_quat(t0, t1);
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat conj() const
+		{
+			return sse_quat(sse::flip_signs<1,1>(m_pk0), sse::flip_signs<1,0>(m_pk1));
+		}
+
+		LSIMD_ENSURE_INLINE f64 dot(const sse_quat& r) const
+		{
+			return (m_pk0 * r.m_pk0 + m_pk1 * r.m_pk1).sum();
+		}
+
+		LSIMD_ENSURE_INLINE sse_quat normalized() const
+		{
+			sse_f64pk s = m_pk0 * m_pk0 + m_pk1 * m_pk1;
+			s = rsqrt(s + s.swizzle<1,0>());
+			return sse_quat(m_pk0 * s, m_pk1 * s);
+		}
+
+		LSIMD_ENSURE_INLINE sse_vec<f64, 3> rotate(const sse_vec<f64, 3>& v) const
+		{
+			// v' = v + w * t + u x t, with t = 2 (u x v)
+
+			sse_f64pk t0, t1;
+			sse::cross3(m_pk0, m_pk1, v.m_pk0, v.m_pk1, t0, t1);
+			t0 = t0 + t0;
+			t1 = t1 + t1;
+
+			sse_f64pk c0, c1;
+			sse::cross3(m_pk0, m_pk1, t0, t1, c0, c1);
+
+			sse_f64pk w = m_pk1.bsx<1>();
+			return sse_vec<f64, 3>(v.m_pk0 + w * t0 + c0, v.m_pk1 + w * t1 + c1);
+		}
+
+		LSIMD_ENSURE_INLINE sse_mat<f64, 3, 3> to_mat() const
+		{
+			// the entries are computed in scalars, as the (x, y), (z, w)
+			// layout does not match the columns of a 3 x 3 matrix
+
+			const f64 qx = x(), qy = y(), qz = z(), qw = w();
+
+			const f64 xx = qx * qx, yy = qy * qy, zz = qz * qz;
+			const f64 xy = qx * qy, xz = qx * qz, yz = qy * qz;
+			const f64 wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+			return sse::smat_core<f64, 3, 3>(
+					sse_vec<f64, 3>(1.0 - 2.0 * (yy + zz), 2.0 * (xy + wz), 2.0 * (xz - wy)),
+					sse_vec<f64, 3>(2.0 * (xy - wz), 1.0 - 2.0 * (xx + zz), 2.0 * (yz + wx)),
+					sse_vec<f64, 3>(2.0 * (xz + wy), 2.0 * (yz - wx), 1.0 - 2.0 * (xx + yy)));
+		}
+
+	public:
+		LSIMD_ENSURE_INLINE bool test_equal(const f64 *r) const
+		{
+			return m_pk0.test_equal(r[0], r[1]) && m_pk1.test_equal(r[2], r[3]);
+		}
+
+		LSIMD_ENSURE_INLINE void dump(const char *fmt) const
+		{
+			std::printf("f64 quat:\n");
+			std::printf("    m_pk0 = "); m_pk0.dump(fmt); std::printf("\n");
+			std::printf("    m_pk1 = "); m_pk1.dump(fmt); std::printf("\n");
+		}
+
+	public:
+		sse_f64pk m_pk0;
+		sse_f64pk m_pk1;
+	};
+
+
+	/**
+	 * Normalized linear interpolation between two unit quaternions.
+	 *
+	 * @param a   The quaternion at t = 0.
+	 * @param b   The quaternion at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The normalized value of (1 - t) * a + t * b, where b is
+	 *            negated when necessary so as to take the shorter arc.
+	 */
+	template<typename T>
+	inline sse_quat<T> nlerp(const sse_quat<T>& a, const sse_quat<T>& b, const T t)
+	{
+		const T tb = a.dot(b) < T(0) ? -t : t;
+		return (a * sse_pack<T>(T(1) - t) + b * sse_pack<T>(tb)).normalized();
+	}
+
+	/**
+	 * Spherical linear interpolation between two unit quaternions.
+	 *
+	 * @param a   The quaternion at t = 0.
+	 * @param b   The quaternion at t = 1.
+	 * @param t   The interpolation coefficient, in [0, 1].
+	 *
+	 * @return    The interpolated rotation along the shorter arc.
+	 *
+	 * @remark    When a and b are nearly parallel, this function falls
+	 *            back to nlerp, which is numerically more stable there.
+	 */
+	template<typename T>
+	inline sse_quat<T> slerp(const sse_quat<T>& a, const sse_quat<T>& b, const T t)
+	{
+		T c = a.dot(b);
+		T sgn = T(1);
+		if (c < T(0))
+		{
+			c = -c;
+			sgn = T(-1);
+		}
+
+		if (c > T(0.9995))
+		{
+			return nlerp(a, b, t);
+		}
+
+		const T th = std::acos(c);
+		const T rs = T(1) / std::sin(th);
+
+		const T wa = std::sin((T(1) - t) * th) * rs;
+		const T wb = std::sin(t * th) * rs * sgn;
+
+		return a * sse_pack<T>(wa) + b * sse_pack<T>(wb);
+	}
+
+	/** @} */
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
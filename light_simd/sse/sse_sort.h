@@ -0,0 +1,432 @@
+/**
+ * @file sse_sort.h
+ *
+ * @brief In-register sorting networks on SSE packs.
+ *
+ * @author Dahua Lin
+ *
+ * @copyright
+ *
+ * Copyright (C) 2012 Dahua Lin
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifdef _MSC_VER
+#pragma once
+#endif
+
+#ifndef LSIMD_SSE_SORT_H_
+#define LSIMD_SSE_SORT_H_
+
+#include "sse_arith.h"
+#include "sse_ipack.h"
+
+namespace lsimd
+{
+
+	/**
+	 * @defgroup sort_sse SSE Sorting Networks
+	 * @ingroup packs
+	 *
+	 * @brief Bitonic sorting networks on the entries of SSE packs
+	 *        (f32, i32 and f64).
+	 *
+	 * The networks are built of compare-exchanges, which take the
+	 * entry-wise minima and maxima of two packs (with vmin / vmax),
+	 * and shuffles between them. Each compare-exchange permutes the
+	 * entries (so that, e.g., -0 and +0 are both kept).
+	 *
+	 * The key-value versions apply the same permutations to packs of
+	 * values, which are moved as bit patterns (and thus can be of any
+	 * type of the same size as the keys, e.g. i32 with f32 keys).
+	 */
+	/** @{ */
+
+	namespace sse
+	{
+		// the bit patterns of the 4-lane packs, as seen by the shuffles
+
+		LSIMD_ENSURE_INLINE
+		inline __m128 ps_bits(const sse_f32pk& a) { return a.v; }
+
+		LSIMD_ENSURE_INLINE
+		inline __m128 ps_bits(const sse_i32pk& a) { return _mm_castsi128_ps(a.v); }
+
+		LSIMD_ENSURE_INLINE
+		inline void set_ps_bits(sse_f32pk& a, const __m128 v) { a.v = v; }
+
+		LSIMD_ENSURE_INLINE
+		inline void set_ps_bits(sse_i32pk& a, const __m128 v) { a.v = _mm_castps_si128(v); }
+
+		// the lanes where a < b
+
+		LSIMD_ENSURE_INLINE
+		inline __m128 lt_bits(const sse_f32pk& a, const sse_f32pk& b)
+		{
+			return _mm_cmplt_ps(a.v, b.v);
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline __m128 lt_bits(const sse_i32pk& a, const sse_i32pk& b)
+		{
+			return _mm_castsi128_ps(_mm_cmplt_epi32(a.v, b.v));
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline __m128 ps_select(const __m128 mask, const __m128 a, const __m128 b)
+		{
+#ifdef LSIMD_HAS_SSE4_1
+			return _mm_blendv_ps(b, a, mask);
+#else
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#endif
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline __m128d pd_select(const __m128d mask, const __m128d a, const __m128d b)
+		{
+#ifdef LSIMD_HAS_SSE4_1
+			return _mm_blendv_pd(b, a, mask);
+#else
+			return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+#endif
+		}
+
+		// compare-exchanges: (a, b) <- (a < b ? a : b, a < b ? b : a)
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_cx(P& a, P& b)
+		{
+			const P t = vmin(a, b);
+			b = vmax(b, a);
+			a = t;
+		}
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_cx(P& a, P& b, P& va, P& vb)
+		{
+			const __m128 m = lt_bits(a, b);
+			sort_cx(a, b);
+
+			const __m128 x = ps_bits(va);
+			const __m128 y = ps_bits(vb);
+			set_ps_bits(va, ps_select(m, x, y));
+			set_ps_bits(vb, ps_select(m, y, x));
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline void sort_cx(sse_f64pk& a, sse_f64pk& b, sse_f64pk& va, sse_f64pk& vb)
+		{
+			const __m128d m = _mm_cmplt_pd(a.v, b.v);
+			sort_cx(a, b);
+
+			const __m128d x = va.v;
+			va.v = pd_select(m, x, vb.v);
+			vb.v = pd_select(m, vb.v, x);
+		}
+
+		// the shuffles of the networks on 4-lane packs
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_transpose(P& a, P& b, P& c, P& d)
+		{
+			const __m128 t0 = _mm_unpacklo_ps(ps_bits(a), ps_bits(b));
+			const __m128 t1 = _mm_unpacklo_ps(ps_bits(c), ps_bits(d));
+			const __m128 t2 = _mm_unpackhi_ps(ps_bits(a), ps_bits(b));
+			const __m128 t3 = _mm_unpackhi_ps(ps_bits(c), ps_bits(d));
+
+			set_ps_bits(a, _mm_movelh_ps(t0, t1));
+			set_ps_bits(b, _mm_movehl_ps(t1, t0));
+			set_ps_bits(c, _mm_movelh_ps(t2, t3));
+			set_ps_bits(d, _mm_movehl_ps(t3, t2));
+		}
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_reverse(P& a)
+		{
+			const __m128 x = ps_bits(a);
+			set_ps_bits(a, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 1, 2, 3)));
+		}
+
+		// (a, b) <- ((a0, a1, b0, b1), (a2, a3, b2, b3))
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_halves(P& a, P& b)
+		{
+			const __m128 x = ps_bits(a);
+			const __m128 y = ps_bits(b);
+			set_ps_bits(a, _mm_movelh_ps(x, y));
+			set_ps_bits(b, _mm_movehl_ps(y, x));
+		}
+
+		// (a, b) <- ((a0, a2, b0, b2), (a1, a3, b1, b3))
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_evens(P& a, P& b)
+		{
+			const __m128 x = ps_bits(a);
+			const __m128 y = ps_bits(b);
+			set_ps_bits(a, _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0)));
+			set_ps_bits(b, _mm_shuffle_ps(x, y, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+
+		// (a, b) <- ((a0, b0, a2, b2), (a1, b1, a3, b3)), undoing sort_evens
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_interleave(P& a, P& b)
+		{
+			const __m128 u0 = _mm_unpacklo_ps(ps_bits(a), ps_bits(b));
+			const __m128 u1 = _mm_unpackhi_ps(ps_bits(a), ps_bits(b));
+			set_ps_bits(a, _mm_movelh_ps(u0, u1));
+			set_ps_bits(b, _mm_movehl_ps(u1, u0));
+		}
+
+		// the shuffles of the networks on 2-lane packs
+
+		LSIMD_ENSURE_INLINE
+		inline void sort_transpose(sse_f64pk& a, sse_f64pk& b)
+		{
+			const __m128d x = a.v;
+			a.v = _mm_unpacklo_pd(x, b.v);
+			b.v = _mm_unpackhi_pd(x, b.v);
+		}
+
+		LSIMD_ENSURE_INLINE
+		inline void sort_reverse(sse_f64pk& a)
+		{
+			a.v = _mm_shuffle_pd(a.v, a.v, 1);
+		}
+
+		// the networks on 4-lane packs
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_lanes4(P& a, P& b, P& c, P& d)
+		{
+			sort_cx(a, b);
+			sort_cx(c, d);
+			sort_cx(a, c);
+			sort_cx(b, d);
+			sort_cx(b, c);
+			sort_transpose(a, b, c, d);
+		}
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void sort_lanes4(P& a, P& b, P& c, P& d, P& va, P& vb, P& vc, P& vd)
+		{
+			sort_cx(a, b, va, vb);
+			sort_cx(c, d, vc, vd);
+			sort_cx(a, c, va, vc);
+			sort_cx(b, d, vb, vd);
+			sort_cx(b, c, vb, vc);
+			sort_transpose(a, b, c, d);
+			sort_transpose(va, vb, vc, vd);
+		}
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void bitonic_merge4(P& a, P& b)
+		{
+			sort_reverse(b);
+			sort_cx(a, b);
+			sort_halves(a, b);
+			sort_cx(a, b);
+			sort_evens(a, b);
+			sort_cx(a, b);
+			sort_interleave(a, b);
+		}
+
+		template<class P>
+		LSIMD_ENSURE_INLINE
+		inline void bitonic_merge4(P& a, P& b, P& va, P& vb)
+		{
+			sort_reverse(b);
+			sort_reverse(vb);
+			sort_cx(a, b, va, vb);
+			sort_halves(a, b);
+			sort_halves(va, vb);
+			sort_cx(a, b, va, vb);
+			sort_evens(a, b);
+			sort_evens(va, vb);
+			sort_cx(a, b, va, vb);
+			sort_interleave(a, b);
+			sort_interleave(va, vb);
+		}
+	}
+
+
+	/**
+	 * Sorts the 4 x 4 block of the entries of four packs column-wise
+	 * (with a network of 5 compare-exchanges), and transposes it, so
+	 * that each pack comes out sorted, with entries from all packs.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_f32pk& a, sse_f32pk& b, sse_f32pk& c, sse_f32pk& d)
+	{
+		sse::sort_lanes4(a, b, c, d);
+	}
+
+	/**
+	 * Sorts the 4 x 4 block of the entries of four packs column-wise
+	 * (with a network of 5 compare-exchanges), and transposes it, so
+	 * that each pack comes out sorted, with entries from all packs.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_i32pk& a, sse_i32pk& b, sse_i32pk& c, sse_i32pk& d)
+	{
+		sse::sort_lanes4(a, b, c, d);
+	}
+
+	/**
+	 * Sorts the 2 x 2 blocks (a, b) and (c, d) column-wise, and
+	 * transposes them, so that each pack comes out sorted, with
+	 * entries from the other pack of its block.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_f64pk& a, sse_f64pk& b, sse_f64pk& c, sse_f64pk& d)
+	{
+		sse::sort_cx(a, b);
+		sse::sort_cx(c, d);
+		sse::sort_transpose(a, b);
+		sse::sort_transpose(c, d);
+	}
+
+	/**
+	 * Sorts the keys as sort_lanes(a, b, c, d) (mixing the packs),
+	 * and moves the values along with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_f32pk& a, sse_f32pk& b, sse_f32pk& c, sse_f32pk& d,
+			sse_f32pk& va, sse_f32pk& vb, sse_f32pk& vc, sse_f32pk& vd)
+	{
+		sse::sort_lanes4(a, b, c, d, va, vb, vc, vd);
+	}
+
+	/**
+	 * Sorts the keys as sort_lanes(a, b, c, d) (mixing the packs),
+	 * and moves the values along with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_i32pk& a, sse_i32pk& b, sse_i32pk& c, sse_i32pk& d,
+			sse_i32pk& va, sse_i32pk& vb, sse_i32pk& vc, sse_i32pk& vd)
+	{
+		sse::sort_lanes4(a, b, c, d, va, vb, vc, vd);
+	}
+
+	/**
+	 * Sorts the keys as sort_lanes(a, b, c, d) (mixing the packs),
+	 * and moves the values along with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void sort_lanes(sse_f64pk& a, sse_f64pk& b, sse_f64pk& c, sse_f64pk& d,
+			sse_f64pk& va, sse_f64pk& vb, sse_f64pk& vc, sse_f64pk& vd)
+	{
+		sse::sort_cx(a, b, va, vb);
+		sse::sort_cx(c, d, vc, vd);
+		sse::sort_transpose(a, b);
+		sse::sort_transpose(c, d);
+		sse::sort_transpose(va, vb);
+		sse::sort_transpose(vc, vd);
+	}
+
+	/**
+	 * Merges two sorted packs (8 entries), so that a holds the
+	 * smallest 4 and b the largest 4, both in ascending order.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_f32pk& a, sse_f32pk& b)
+	{
+		sse::bitonic_merge4(a, b);
+	}
+
+	/**
+	 * Merges two sorted packs (8 entries), so that a holds the
+	 * smallest 4 and b the largest 4, both in ascending order.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_i32pk& a, sse_i32pk& b)
+	{
+		sse::bitonic_merge4(a, b);
+	}
+
+	/**
+	 * Merges two sorted packs (4 entries), so that a holds the
+	 * smallest 2 and b the largest 2, both in ascending order.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_f64pk& a, sse_f64pk& b)
+	{
+		sse::sort_reverse(b);
+		sse::sort_cx(a, b);
+		sse::sort_transpose(a, b);
+		sse::sort_cx(a, b);
+		sse::sort_transpose(a, b);
+	}
+
+	/**
+	 * Merges two packs of sorted keys, and moves the values along
+	 * with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_f32pk& a, sse_f32pk& b, sse_f32pk& va, sse_f32pk& vb)
+	{
+		sse::bitonic_merge4(a, b, va, vb);
+	}
+
+	/**
+	 * Merges two packs of sorted keys, and moves the values along
+	 * with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_i32pk& a, sse_i32pk& b, sse_i32pk& va, sse_i32pk& vb)
+	{
+		sse::bitonic_merge4(a, b, va, vb);
+	}
+
+	/**
+	 * Merges two packs of sorted keys, and moves the values along
+	 * with them.
+	 */
+	LSIMD_ENSURE_INLINE
+	inline void bitonic_merge(sse_f64pk& a, sse_f64pk& b, sse_f64pk& va, sse_f64pk& vb)
+	{
+		sse::sort_reverse(b);
+		sse::sort_reverse(vb);
+		sse::sort_cx(a, b, va, vb);
+		sse::sort_transpose(a, b);
+		sse::sort_transpose(va, vb);
+		sse::sort_cx(a, b, va, vb);
+		sse::sort_transpose(a, b);
+		sse::sort_transpose(va, vb);
+	}
+
+	/** @} */
+}
+
+#endif /* LSIMD_SSE_SORT_H_ */
@@ -1369,6 +1369,93 @@ namespace lsimd
 		sse_f64pk m_pk1;
 	};
 
+
+	/********************************************
+	 *
+	 *  Fused multiply-add
+	 *
+	 ********************************************/
+
+	/**
+	 * Calculates a * s + c.
+	 *
+	 * @param a   The vector to be scaled.
+	 * @param s   A pack filled with the same scale.
+	 * @param c   The vector of addends.
+	 *
+	 * @return    The resultant vector, as a * s + c.
+	 */
+	template<int N>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32, N> fmadd(const sse_vec<f32, N>& a, const sse_f32pk& s, const sse_vec<f32, N>& c)
+	{
+		return sse_vec<f32, N>(fmadd(a.m_pk, s, c.m_pk));
+	}
+
+	/**
+	 * Calculates c - a * s.
+	 *
+	 * @param a   The vector to be scaled.
+	 * @param s   A pack filled with the same scale.
+	 * @param c   The vector of minuends.
+	 *
+	 * @return    The resultant vector, as c - a * s.
+	 */
+	template<int N>
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f32, N> fnmadd(const sse_vec<f32, N>& a, const sse_f32pk& s, const sse_vec<f32, N>& c)
+	{
+		return sse_vec<f32, N>(fnmadd(a.m_pk, s, c.m_pk));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 1> fmadd(const sse_vec<f64, 1>& a, const sse_f64pk& s, const sse_vec<f64, 1>& c)
+	{
+		return sse_vec<f64, 1>(fmadd(a.m_pk, s, c.m_pk));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 1> fnmadd(const sse_vec<f64, 1>& a, const sse_f64pk& s, const sse_vec<f64, 1>& c)
+	{
+		return sse_vec<f64, 1>(fnmadd(a.m_pk, s, c.m_pk));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 2> fmadd(const sse_vec<f64, 2>& a, const sse_f64pk& s, const sse_vec<f64, 2>& c)
+	{
+		return sse_vec<f64, 2>(fmadd(a.m_pk, s, c.m_pk));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 2> fnmadd(const sse_vec<f64, 2>& a, const sse_f64pk& s, const sse_vec<f64, 2>& c)
+	{
+		return sse_vec<f64, 2>(fnmadd(a.m_pk, s, c.m_pk));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 3> fmadd(const sse_vec<f64, 3>& a, const sse_f64pk& s, const sse_vec<f64, 3>& c)
+	{
+		return sse_vec<f64, 3>(fmadd(a.m_pk0, s, c.m_pk0), fmadd(a.m_pk1, s, c.m_pk1));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 3> fnmadd(const sse_vec<f64, 3>& a, const sse_f64pk& s, const sse_vec<f64, 3>& c)
+	{
+		return sse_vec<f64, 3>(fnmadd(a.m_pk0, s, c.m_pk0), fnmadd(a.m_pk1, s, c.m_pk1));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 4> fmadd(const sse_vec<f64, 4>& a, const sse_f64pk& s, const sse_vec<f64, 4>& c)
+	{
+		return sse_vec<f64, 4>(fmadd(a.m_pk0, s, c.m_pk0), fmadd(a.m_pk1, s, c.m_pk1));
+	}
+
+	LSIMD_ENSURE_INLINE
+	inline sse_vec<f64, 4> fnmadd(const sse_vec<f64, 4>& a, const sse_f64pk& s, const sse_vec<f64, 4>& c)
+	{
+		return sse_vec<f64, 4>(fnmadd(a.m_pk0, s, c.m_pk0), fnmadd(a.m_pk1, s, c.m_pk1));
+	}
+
 	/** @} */
 
 }
@@ -39,6 +39,10 @@ namespace lsimd
 	extern ::ltest::test_suite lsimd_main_suite;
 	extern void add_test_packs();
 
+	template<typename T> struct tname_of { static const char *get() { return sizeof(T) == 4 ? "f32" : "f64"; } };
+	template<> struct tname_of<i32> { static const char *get() { return "i32"; } };
+	template<> struct tname_of<u32> { static const char *get() { return "u32"; } };
+
 	template<typename T>
 	class tcase_base : public ltest::test_case
 	{
@@ -47,7 +51,7 @@ namespace lsimd
 	public:
 		tcase_base(const char *nam)
 		{
-			std::sprintf(m_name, "%s [f%d]", nam, int(8 * sizeof(T)));
+			std::sprintf(m_name, "%s [%s]", nam, tname_of<T>::get());
 		}
 
 		const char *name() const
@@ -133,6 +137,19 @@ namespace lsimd
 		}
 	}
 
+	/**
+	 * Fills random integers in [lb, ub], e.g. small ones for which
+	 * the results of the tested functions are exact.
+	 */
+	template<typename T>
+	inline void fill_rand_int(int n, T *a, int lb, int ub)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			a[i] = T(lb + std::rand() % (ub - lb + 1));
+		}
+	}
+
 	template<typename T>
 	inline bool test_equal(int n, const T *a, const T *b)
 	{
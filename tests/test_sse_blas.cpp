@@ -0,0 +1,230 @@
+/**
+ * @file test_sse_blas.cpp
+ *
+ * Test the correctness of matrix-vector routines (gemv, ger)
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <vector>
+#include <limits>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  problem setting
+ *
+ *  Entries are small integers, so that all
+ *  results are exact regardless of the order
+ *  of summation.
+ *
+ ************************************************/
+
+template<typename T>
+struct blas_problem
+{
+	int m;
+	int n;
+	int lda;
+
+	std::vector<T> a;
+	std::vector<T> x;	// length m
+	std::vector<T> y;	// length n
+	std::vector<T> u;	// length n
+	std::vector<T> v;	// length m
+
+	blas_problem(int m_, int n_, int lda_)
+	: m(m_), n(n_), lda(lda_)
+	, a((size_t)(lda_ * n_)), x((size_t)m_), y((size_t)n_), u((size_t)n_), v((size_t)m_)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			for (int i = 0; i < lda; ++i)
+				a[(size_t)(i + j * lda)] = T((i * 7 + j * 3) % 5 - 2);
+		}
+
+		for (int i = 0; i < m; ++i) x[(size_t)i] = T(i % 3 - 1);
+		for (int i = 0; i < m; ++i) v[(size_t)i] = T(i % 4 - 2);
+		for (int j = 0; j < n; ++j) y[(size_t)j] = T(j % 5 - 2);
+		for (int j = 0; j < n; ++j) u[(size_t)j] = T(j % 3);
+	}
+
+	T at(int i, int j) const
+	{
+		return a[(size_t)(i + j * lda)];
+	}
+
+	// r = alpha * A * u + beta * v
+	void ref_gemv(T alpha, T beta, std::vector<T>& r) const
+	{
+		r.resize((size_t)m);
+		for (int i = 0; i < m; ++i)
+		{
+			T s(0);
+			for (int j = 0; j < n; ++j) s += at(i, j) * u[(size_t)j];
+			r[(size_t)i] = alpha * s + beta * v[(size_t)i];
+		}
+	}
+
+	// r = alpha * A^T * x + beta * y
+	void ref_gemv_t(T alpha, T beta, std::vector<T>& r) const
+	{
+		r.resize((size_t)n);
+		for (int j = 0; j < n; ++j)
+		{
+			T s(0);
+			for (int i = 0; i < m; ++i) s += at(i, j) * x[(size_t)i];
+			r[(size_t)j] = alpha * s + beta * y[(size_t)j];
+		}
+	}
+
+	// r = A + alpha * x * y^T
+	void ref_ger(T alpha, std::vector<T>& r) const
+	{
+		r = a;
+		for (int j = 0; j < n; ++j)
+		{
+			for (int i = 0; i < m; ++i)
+				r[(size_t)(i + j * lda)] += alpha * x[(size_t)i] * y[(size_t)j];
+		}
+	}
+};
+
+
+template<typename T>
+void verify_gemv(int m, int n, int lda, bool mt)
+{
+	blas_problem<T> p(m, n, lda);
+
+	std::vector<T> r0;
+	std::vector<T> r(p.v);
+
+	p.ref_gemv(T(2), T(-1), r0);
+
+	if (mt)
+		gemv_mt(m, n, T(2), &(p.a[0]), lda, &(p.u[0]), T(-1), &(r[0]));
+	else
+		gemv(m, n, T(2), &(p.a[0]), lda, &(p.u[0]), T(-1), &(r[0]));
+
+	ASSERT_VEC_EQ( m, &(r[0]), &(r0[0]) );
+
+	// beta = 0 ignores the initial content of y
+
+	p.ref_gemv(T(1), T(0), r0);
+	for (int i = 0; i < m; ++i) r[(size_t)i] = std::numeric_limits<T>::infinity();
+
+	if (mt)
+		gemv_mt(m, n, T(1), &(p.a[0]), lda, &(p.u[0]), T(0), &(r[0]));
+	else
+		gemv(m, n, T(1), &(p.a[0]), lda, &(p.u[0]), T(0), &(r[0]));
+
+	ASSERT_VEC_EQ( m, &(r[0]), &(r0[0]) );
+}
+
+template<typename T>
+void verify_gemv_t(int m, int n, int lda, bool mt)
+{
+	blas_problem<T> p(m, n, lda);
+
+	std::vector<T> r0;
+	std::vector<T> r(p.y);
+
+	p.ref_gemv_t(T(2), T(3), r0);
+
+	if (mt)
+		gemv_t_mt(m, n, T(2), &(p.a[0]), lda, &(p.x[0]), T(3), &(r[0]));
+	else
+		gemv_t(m, n, T(2), &(p.a[0]), lda, &(p.x[0]), T(3), &(r[0]));
+
+	ASSERT_VEC_EQ( n, &(r[0]), &(r0[0]) );
+}
+
+template<typename T>
+void verify_ger(int m, int n, int lda, bool mt)
+{
+	blas_problem<T> p(m, n, lda);
+
+	std::vector<T> r0;
+	std::vector<T> r(p.a);
+
+	p.ref_ger(T(-2), r0);
+
+	if (mt)
+		ger_mt(m, n, T(-2), &(p.x[0]), &(p.y[0]), &(r[0]), lda);
+	else
+		ger(m, n, T(-2), &(p.x[0]), &(p.y[0]), &(r[0]), lda);
+
+	ASSERT_VEC_EQ( lda * n, &(r[0]), &(r0[0]) );
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( gemv )
+{
+	verify_gemv<T>(1, 1, 1, false);
+	verify_gemv<T>(8, 4, 8, false);
+	verify_gemv<T>(37, 23, 41, false);
+	verify_gemv<T>(2100, 7, 2103, false);
+}
+
+GCASE( gemv_t )
+{
+	verify_gemv_t<T>(1, 1, 1, false);
+	verify_gemv_t<T>(8, 4, 8, false);
+	verify_gemv_t<T>(37, 23, 41, false);
+	verify_gemv_t<T>(2100, 7, 2103, false);
+}
+
+GCASE( ger )
+{
+	verify_ger<T>(1, 1, 1, false);
+	verify_ger<T>(8, 4, 8, false);
+	verify_ger<T>(37, 23, 41, false);
+	verify_ger<T>(2100, 7, 2103, false);
+}
+
+GCASE( blas_mt )
+{
+	verify_gemv<T>(37, 23, 41, true);
+	verify_gemv<T>(2100, 67, 2103, true);
+
+	verify_gemv_t<T>(37, 23, 41, true);
+	verify_gemv_t<T>(2100, 67, 2103, true);
+
+	verify_ger<T>(37, 23, 41, true);
+	verify_ger<T>(2100, 67, 2103, true);
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( gemv );
+	ADD_TEST( gemv_t );
+	ADD_TEST( ger );
+	ADD_TEST( blas_mt );
+}
+
@@ -0,0 +1,153 @@
+/**
+ * @file test_sse_conv.cpp
+ *
+ * Test the correctness of the FIR and convolution functions
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ *  (all values are small integers, such that
+ *   the results are exact)
+ *
+ ************************************************/
+
+// the outputs lo <= i < hi of the full convolution
+
+template<typename T>
+void ref_conv(int n, const T *x, const T *h, int k, T *y, int lo, int hi)
+{
+	for (int i = lo; i < hi; ++i)
+	{
+		T s(0);
+		for (int j = 0; j < k; ++j)
+		{
+			if (i - j >= 0 && i - j < n) s += h[j] * x[i - j];
+		}
+		y[i - lo] = s;
+	}
+}
+
+const int MaxLen = 50;
+const int MaxTaps = 12;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( fir )
+{
+	T x[MaxLen + MaxTaps];
+	T h[MaxTaps];
+	T y[MaxLen];
+	T r[MaxLen];
+
+	fill_rand_int(MaxLen + MaxTaps, x, -9, 9);
+	fill_rand_int(MaxTaps, h, -9, 9);
+
+	for (int k = 1; k <= MaxTaps; ++k)
+	{
+		for (int n = 0; n <= MaxLen; ++n)
+		{
+			// fir(n) is the full convolution at k - 1, ..., n + k - 2
+			ref_conv(n + k - 1, x, h, k, r, k - 1, n + k - 1);
+
+			fir(n, x, h, k, y);
+			ASSERT_VEC_EQ( n, y, r );
+		}
+	}
+}
+
+GCASE( fir_fixed )
+{
+	T x[MaxLen + 7];
+	T h[7];
+	T y[MaxLen];
+	T r[MaxLen];
+
+	fill_rand_int(MaxLen + 7, x, -9, 9);
+	fill_rand_int(7, h, -9, 9);
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		ref_conv(n + 2, x, h, 3, r, 2, n + 2);
+		fir<3>(n, x, h, y);
+		ASSERT_VEC_EQ( n, y, r );
+
+		ref_conv(n + 4, x, h, 5, r, 4, n + 4);
+		fir<5>(n, x, h, y);
+		ASSERT_VEC_EQ( n, y, r );
+
+		ref_conv(n + 6, x, h, 7, r, 6, n + 6);
+		fir<7>(n, x, h, y);
+		ASSERT_VEC_EQ( n, y, r );
+	}
+}
+
+GCASE( conv1d )
+{
+	T x[MaxLen];
+	T h[MaxTaps];
+	T y[MaxLen + MaxTaps];
+	T r[MaxLen + MaxTaps];
+
+	fill_rand_int(MaxLen, x, -9, 9);
+	fill_rand_int(MaxTaps, h, -9, 9);
+
+	for (int k = 1; k <= MaxTaps; ++k)
+	{
+		for (int n = 1; n <= MaxLen; ++n)
+		{
+			if (n >= k)
+			{
+				ref_conv(n, x, h, k, r, k - 1, n);
+				conv1d(n, x, h, k, y, conv_valid_t());
+				ASSERT_VEC_EQ( n - k + 1, y, r );
+			}
+
+			const int c = (k - 1) / 2;
+			ref_conv(n, x, h, k, r, c, c + n);
+			conv1d(n, x, h, k, y, conv_same_t());
+			ASSERT_VEC_EQ( n, y, r );
+
+			ref_conv(n, x, h, k, r, 0, n + k - 1);
+			conv1d(n, x, h, k, y, conv_full_t());
+			ASSERT_VEC_EQ( n + k - 1, y, r );
+		}
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( fir );
+	ADD_TEST( fir_fixed );
+	ADD_TEST( conv1d );
+}
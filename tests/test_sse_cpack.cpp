@@ -0,0 +1,381 @@
+/**
+ * @file test_sse_cpack.cpp
+ *
+ * Test the correctness of sse_cpack classes and complex array functions
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <complex>
+
+using namespace lsimd;
+using namespace ltest;
+
+// explicit instantiation for thorough syntax check
+
+template struct lsimd::simd_cpack<f32, sse_kind>;
+template struct lsimd::simd_cpack<f64, sse_kind>;
+
+template struct lsimd::simd_cpack_soa<f32, sse_kind>;
+template struct lsimd::simd_cpack_soa<f64, sse_kind>;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ *  (all values are small integers, such that
+ *   the results are exact)
+ *
+ ************************************************/
+
+template<typename T>
+inline void ref_cmul(const T *a, const T *b, T *r)
+{
+	r[0] = a[0] * b[0] - a[1] * b[1];
+	r[1] = a[0] * b[1] + a[1] * b[0];
+}
+
+
+/************************************************
+ *
+ *  packs
+ *
+ ************************************************/
+
+GCASE( zero )
+{
+	T r[4] = {T(0), T(0), T(0), T(0)};
+
+	simd_cpack<T, sse_kind> c = zero_t();
+	ASSERT_SIMD_EQ( c, r );
+}
+
+GCASE( load_store )
+{
+	const int n = 2 * (int)simd_cpack<T, sse_kind>::count;
+
+	LSIMD_ALIGN_SSE T a[5] = {T(1), T(2), T(3), T(4), T(5)};
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	ASSERT_SIMD_EQ( ca, a );
+
+	simd_cpack<T, sse_kind> cu(a + 1, unaligned_t());
+	ASSERT_SIMD_EQ( cu, a + 1 );
+
+	T b[4] = {T(3), T(-2), T(3), T(-2)};
+	simd_cpack<T, sse_kind> cs(T(3), T(-2));
+	ASSERT_SIMD_EQ( cs, b );
+
+	simd_cpack<T, sse_kind> cc(std::complex<T>(T(3), T(-2)));
+	ASSERT_SIMD_EQ( cc, b );
+
+	T c[5] = {T(-1), T(-1), T(-1), T(-1), T(-1)};
+	ca.store(c + 1, unaligned_t());
+	ASSERT_VEC_EQ( n, a, c + 1 );
+
+	std::complex<T> z[2];
+	z[0] = std::complex<T>(T(1), T(2));
+	z[1] = std::complex<T>(T(3), T(4));
+
+	simd_cpack<T, sse_kind> cz(z, unaligned_t());
+	ASSERT_SIMD_EQ( cz, a );
+
+	std::complex<T> zr[2];
+	cz.store(zr, unaligned_t());
+	for (int i = 0; i < n / 2; ++i) ASSERT_TRUE( zr[i] == z[i] );
+}
+
+GCASE( add_sub )
+{
+	simd_cpack<T, sse_kind> a(T(1), T(2));
+	simd_cpack<T, sse_kind> b(T(5), T(-3));
+
+	T r1[4] = {T(6), T(-1), T(6), T(-1)};
+	T r2[4] = {T(-4), T(5), T(-4), T(5)};
+	T r3[4] = {T(-1), T(-2), T(-1), T(-2)};
+	T r4[4] = {T(3), T(6), T(3), T(6)};
+
+	ASSERT_SIMD_EQ( a + b, r1 );
+	ASSERT_SIMD_EQ( a - b, r2 );
+	ASSERT_SIMD_EQ( -a, r3 );
+	simd_pack<T, sse_kind> s(T(3));
+	ASSERT_SIMD_EQ( a * s, r4 );
+}
+
+GCASE( mul )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	LSIMD_ALIGN_SSE T b[4] = {T(5), T(-6), T(7), T(2)};
+	T r[4];
+	ref_cmul(a, b, r);
+	ref_cmul(a + 2, b + 2, r + 2);
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	simd_cpack<T, sse_kind> cb(b, aligned_t());
+
+	ASSERT_SIMD_EQ( ca * cb, r );
+}
+
+GCASE( conj )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	T r[4] = {T(1), T(-2), T(-3), T(-4)};
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	ASSERT_SIMD_EQ( ca.conj(), r );
+}
+
+GCASE( reverse )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	T r2[4] = {T(-3), T(4), T(1), T(2)};
+	const T *r = simd_cpack<T, sse_kind>::count == 2 ? r2 : a;
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	ASSERT_SIMD_EQ( ca.reverse(), r );
+}
+
+GCASE( mul_i )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	T r[4] = {T(-2), T(1), T(-4), T(-3)};
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	ASSERT_SIMD_EQ( ca.mul_i(), r );
+}
+
+GCASE( store_entry )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+
+	T b[2] = {T(0), T(0)};
+	ca.template store_entry<0>(b);
+	ASSERT_VEC_EQ( 2, a, b );
+
+	if (simd_cpack<T, sse_kind>::count == 2)
+	{
+		ca.template store_entry<1>(b);
+		ASSERT_VEC_EQ( 2, a + 2, b );
+	}
+}
+
+GCASE( mul_conj )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	LSIMD_ALIGN_SSE T b[4] = {T(5), T(-6), T(7), T(2)};
+	T bc[4] = {T(5), T(6), T(7), T(-2)};
+	T r[4];
+	ref_cmul(a, bc, r);
+	ref_cmul(a + 2, bc + 2, r + 2);
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	simd_cpack<T, sse_kind> cb(b, aligned_t());
+
+	ASSERT_SIMD_EQ( ca.mul_conj(cb), r );
+}
+
+GCASE( abs )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(3), T(-4), T(-5), T(12)};
+	T r2[4] = {T(25), T(25), T(169), T(169)};
+	T r[4] = {T(5), T(5), T(13), T(13)};
+
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+	ASSERT_SIMD_EQ( ca.abs2(), r2 );
+	ASSERT_SIMD_EQ( ca.abs(), r );
+}
+
+GCASE( sum )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(-3), T(4)};
+	simd_cpack<T, sse_kind> ca(a, aligned_t());
+
+	std::complex<T> s = ca.sum();
+
+	if (simd_cpack<T, sse_kind>::count == 2)
+	{
+		ASSERT_EQ( s.real(), T(-2) );
+		ASSERT_EQ( s.imag(), T(6) );
+	}
+	else
+	{
+		ASSERT_EQ( s.real(), T(1) );
+		ASSERT_EQ( s.imag(), T(2) );
+	}
+}
+
+GCASE( soa )
+{
+	const unsigned int w = simd<T, sse_kind>::pack_width;
+
+	LSIMD_ALIGN_SSE T ar[4] = {T(1), T(-3), T(2), T(0)};
+	LSIMD_ALIGN_SSE T ai[4] = {T(2), T(4), T(-1), T(5)};
+	LSIMD_ALIGN_SSE T br[4] = {T(5), T(7), T(3), T(-2)};
+	LSIMD_ALIGN_SSE T bi[4] = {T(-6), T(2), T(3), T(1)};
+
+	simd_cpack_soa<T, sse_kind> a(ar, ai, aligned_t());
+	simd_cpack_soa<T, sse_kind> b(br, bi, aligned_t());
+
+	T rr[4], ri[4];
+	T r2[4];
+	(a * b).store(rr, ri, unaligned_t());
+	a.abs2().store(r2, unaligned_t());
+
+	for (unsigned int i = 0; i < w; ++i)
+	{
+		T x[2] = {ar[i], ai[i]};
+		T y[2] = {br[i], bi[i]};
+		T z[2];
+		ref_cmul(x, y, z);
+
+		ASSERT_EQ( rr[i], z[0] );
+		ASSERT_EQ( ri[i], z[1] );
+		ASSERT_EQ( r2[i], ar[i] * ar[i] + ai[i] * ai[i] );
+	}
+
+	a.mul_conj(b).store(rr, ri, unaligned_t());
+
+	for (unsigned int i = 0; i < w; ++i)
+	{
+		T x[2] = {ar[i], ai[i]};
+		T y[2] = {br[i], -bi[i]};
+		T z[2];
+		ref_cmul(x, y, z);
+
+		ASSERT_EQ( rr[i], z[0] );
+		ASSERT_EQ( ri[i], z[1] );
+	}
+}
+
+
+/************************************************
+ *
+ *  array functions
+ *
+ ************************************************/
+
+const int CArrLen = 11;
+
+GCASE( array_cmul )
+{
+	T a[2 * CArrLen];
+	T b[2 * CArrLen];
+	fill_rand_int(2 * CArrLen, a, -9, 9);
+	fill_rand_int(2 * CArrLen, b, -9, 9);
+
+	std::complex<T> za[CArrLen];
+	std::complex<T> zb[CArrLen];
+	std::complex<T> zr[CArrLen];
+	std::complex<T> zc[CArrLen];
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		za[i] = std::complex<T>(a[2 * i], a[2 * i + 1]);
+		zb[i] = std::complex<T>(b[2 * i], b[2 * i + 1]);
+		zc[i] = std::complex<T>(T(i), T(1));
+	}
+
+	cmul(CArrLen, za, zb, zr);
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		T r0[2];
+		ref_cmul(a + 2 * i, b + 2 * i, r0);
+		ASSERT_EQ( zr[i].real(), r0[0] );
+		ASSERT_EQ( zr[i].imag(), r0[1] );
+	}
+
+	cmac(CArrLen, za, zb, zc);
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		T r0[2];
+		ref_cmul(a + 2 * i, b + 2 * i, r0);
+		ASSERT_EQ( zc[i].real(), r0[0] + T(i) );
+		ASSERT_EQ( zc[i].imag(), r0[1] + T(1) );
+	}
+}
+
+GCASE( array_cmul_split )
+{
+	T are[CArrLen], aim[CArrLen];
+	T bre[CArrLen], bim[CArrLen];
+	T rre[CArrLen], rim[CArrLen];
+
+	fill_rand_int(CArrLen, are, -9, 9);
+	fill_rand_int(CArrLen, aim, -9, 9);
+	fill_rand_int(CArrLen, bre, -9, 9);
+	fill_rand_int(CArrLen, bim, -9, 9);
+
+	cmul(CArrLen, are, aim, bre, bim, rre, rim);
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		T x[2] = {are[i], aim[i]};
+		T y[2] = {bre[i], bim[i]};
+		T z[2];
+		ref_cmul(x, y, z);
+
+		ASSERT_EQ( rre[i], z[0] );
+		ASSERT_EQ( rim[i], z[1] );
+	}
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		rre[i] = T(i);
+		rim[i] = T(1);
+	}
+
+	cmac(CArrLen, are, aim, bre, bim, rre, rim);
+
+	for (int i = 0; i < CArrLen; ++i)
+	{
+		T x[2] = {are[i], aim[i]};
+		T y[2] = {bre[i], bim[i]};
+		T z[2];
+		ref_cmul(x, y, z);
+
+		ASSERT_EQ( rre[i], z[0] + T(i) );
+		ASSERT_EQ( rim[i], z[1] + T(1) );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( zero );
+	ADD_TEST( load_store );
+	ADD_TEST( add_sub );
+
+	ADD_TEST( mul );
+	ADD_TEST( conj );
+	ADD_TEST( reverse );
+	ADD_TEST( mul_i );
+	ADD_TEST( store_entry );
+	ADD_TEST( mul_conj );
+	ADD_TEST( abs );
+	ADD_TEST( sum );
+
+	ADD_TEST( soa );
+
+	ADD_TEST( array_cmul );
+	ADD_TEST( array_cmul_split );
+}
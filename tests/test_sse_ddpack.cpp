@@ -0,0 +1,370 @@
+/**
+ * @file test_sse_ddpack.cpp
+ *
+ * Test the correctness of double-double packs and reductions
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  auxiliary functions
+ *
+ ************************************************/
+
+typedef simd_pack<f64> pack_t;
+typedef dd_pack<> ddpack_t;
+
+inline f64 pow2(int e)
+{
+	return std::ldexp(1.0, e);
+}
+
+// a pack with the entries h0 + l0 and h1 + l1 (normalized)
+
+inline ddpack_t make_dd(f64 h0, f64 l0, f64 h1, f64 l1)
+{
+	LSIMD_ALIGN_SSE f64 h[2] = {h0, h1};
+	LSIMD_ALIGN_SSE f64 l[2] = {l0, l1};
+	return ddpack_t(pack_t(h, aligned_t())) + pack_t(l, aligned_t());
+}
+
+// random entries in [1, 2), with random low parts
+
+inline ddpack_t rand_dd()
+{
+	f64 h[2], l[2];
+	fill_rand(2, h, 1.0, 2.0);
+	fill_rand(2, l, -1.0, 1.0);
+	return make_dd(h[0], l[0] * pow2(-53), h[1], l[1] * pow2(-53));
+}
+
+inline bool dd_equal(const ddpack_t& a, f64 h0, f64 l0, f64 h1, f64 l1)
+{
+	LSIMD_ALIGN_SSE f64 h[2] = {h0, h1};
+	LSIMD_ALIGN_SSE f64 l[2] = {l0, l1};
+	return a.impl.test_equal(h, l);
+}
+
+// |r - e| <= tol * |e| entry-wisely (evaluated in double-double)
+
+inline bool dd_near(const ddpack_t& r, const ddpack_t& e, double tol)
+{
+	LSIMD_ALIGN_SSE f64 d[2];
+	LSIMD_ALIGN_SSE f64 v[2];
+	(r - e).store(d, aligned_t());
+	e.store(v, aligned_t());
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (!(std::fabs(d[i]) <= tol * std::fabs(v[i]))) return false;
+	}
+	return true;
+}
+
+const double dd_tol = 1.0e-30;
+
+// large integers that cancel in pairs, among small integers and tiny
+// multiples of 2^-50, such that all partial sums are representable in
+// double-double precision, while the tiny terms are lost in f64.
+//
+// The exact result is set to h + l (with y, the same of the products).
+
+void fill_grid(int n, f64 *x, f64 *y, f64& h, f64& l)
+{
+	const f64 big = y ? pow2(15) : pow2(30);
+	const f64 tiny = y ? pow2(-25) : pow2(-50);
+
+	long long si = 0;
+	long long st = 0;
+
+	for (int i = 0; i < n; ++i)
+	{
+		const int r = std::rand() % 8;
+		const int v = std::rand() % 17 - 8;
+		const int u = std::rand() % 5 - 2;
+
+		if (r < 4 || i + 1 == n)
+		{
+			x[i] = f64(v);
+			if (y) y[i] = f64(u);
+			si += y ? (long long)v * u : v;
+		}
+		else if (r < 6)
+		{
+			x[i] = f64(v) * tiny;
+			if (y) y[i] = tiny * u;
+			st += y ? (long long)v * u : v;
+		}
+		else
+		{
+			const f64 b = big * (std::rand() % 4 + 1) * (std::rand() % 2 ? 1 : -1);
+			x[i] = b;
+			x[i + 1] = -b;
+			if (y) y[i] = y[i + 1] = big;
+			++ i;
+		}
+	}
+
+	const f64 a = f64(si);
+	const f64 b = f64(st) * pow2(-50);
+	h = a + b;
+	l = b - (h - a);
+}
+
+// a sum in extended precision, with the sum of magnitudes
+
+long double ref_sum(int n, const f64 *x, const f64 *y, long double& a)
+{
+	long double s = 0;
+	a = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		const long double v = y ? (long double)x[i] * (long double)y[i] : (long double)x[i];
+		s += v;
+		a += std::fabs(v);
+	}
+	return s;
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( dd_construct )
+{
+	LSIMD_ALIGN_SSE f64 a[2] = {1.5, -2.5};
+	LSIMD_ALIGN_SSE f64 r[2];
+
+	ASSERT_TRUE( dd_equal(ddpack_t(zero_t()), 0, 0, 0, 0) );
+	ASSERT_TRUE( dd_equal(ddpack_t(3.0), 3.0, 0, 3.0, 0) );
+	ASSERT_TRUE( dd_equal(ddpack_t(1.0, pow2(-60)), 1.0, pow2(-60), 1.0, pow2(-60)) );
+	ASSERT_TRUE( dd_equal(ddpack_t(a, aligned_t()), 1.5, 0, -2.5, 0) );
+	ASSERT_TRUE( dd_equal(ddpack_t(a, unaligned_t()), 1.5, 0, -2.5, 0) );
+
+	ddpack_t p = zero_t();
+	p.load(a, aligned_t());
+	ASSERT_TRUE( dd_equal(p, 1.5, 0, -2.5, 0) );
+
+	make_dd(4.0, pow2(-60), -1.0, -pow2(-70)).store(r, aligned_t());
+	ASSERT_EQ( r[0], 4.0 );
+	ASSERT_EQ( r[1], -1.0 );
+}
+
+GCASE( dd_add_sub )
+{
+	const f64 e = pow2(-60);
+
+	// exact cases, lost in f64
+
+	ddpack_t a = make_dd(1.0, e, 3.0, -e);
+	ASSERT_TRUE( dd_equal(a + ddpack_t(-1.0), e, 0, 2.0, -e) );
+	ASSERT_TRUE( dd_equal(a - ddpack_t(1.0), e, 0, 2.0, -e) );
+	ASSERT_TRUE( dd_equal(a + pack_t(-1.0), e, 0, 2.0, -e) );
+	ASSERT_TRUE( dd_equal(a - pack_t(3.0), -2.0, e, -pow2(-60), 0) );
+	ASSERT_TRUE( dd_equal(a - a, 0, 0, 0, 0) );
+	ASSERT_TRUE( dd_equal(-a, -1.0, -e, -3.0, e) );
+	ASSERT_TRUE( dd_equal(ddpack_t(1.0) + pack_t(pow2(-80)), 1.0, pow2(-80), 1.0, pow2(-80)) );
+
+	// the low parts cancel only partially
+
+	ddpack_t b = make_dd(1.0, pow2(-70), 1.0, pow2(-70)) - make_dd(1.0, pow2(-71), 1.0, -pow2(-71));
+	ASSERT_TRUE( dd_equal(b, pow2(-71), 0, 3 * pow2(-71), 0) );
+
+	for (int t = 0; t < 1000; ++t)
+	{
+		ddpack_t x = rand_dd();
+		ddpack_t y = rand_dd();
+
+		ASSERT_TRUE( dd_near((x + y) - y, x, dd_tol) );
+		ASSERT_TRUE( dd_near((x - y) + y, x, dd_tol) );
+	}
+}
+
+GCASE( dd_mul )
+{
+	// (1 + 2^-30)^2 = 1 + 2^-29 + 2^-60, from two f64 values
+
+	const f64 a = 1.0 + pow2(-30);
+	ASSERT_TRUE( dd_equal(ddpack_t(a) * pack_t(a), 1.0 + pow2(-29), pow2(-60), 1.0 + pow2(-29), pow2(-60)) );
+
+	// (1 + 2^-60)^2 = 1 + 2^-59 + 2^-120
+
+	ddpack_t b(1.0, pow2(-60));
+	ASSERT_TRUE( dd_equal(b * b, 1.0, pow2(-59) + pow2(-120), 1.0, pow2(-59) + pow2(-120)) );
+
+	// products of integers exactly in long double
+
+	for (int t = 0; t < 1000; ++t)
+	{
+		const f64 x = f64(std::rand()) * f64(std::rand() % 1024 + 1);
+		const f64 y = f64(std::rand() % (1 << 22) + 1);
+
+		LSIMD_ALIGN_SSE f64 h[2];
+		LSIMD_ALIGN_SSE f64 l[2];
+		ddpack_t p = ddpack_t(x) * pack_t(-y);
+		p.hi().store(h, aligned_t());
+		p.lo().store(l, aligned_t());
+
+		const long double r = -(long double)x * (long double)y;
+		ASSERT_EQ( h[0], f64(r) );
+		ASSERT_EQ( (long double)h[0] + (long double)l[0], r );
+		ASSERT_EQ( (long double)h[1] + (long double)l[1], r );
+	}
+}
+
+GCASE( dd_div )
+{
+	// 1 / 3, as 3 * q = 1 (up to the rounding of q)
+
+	ddpack_t q = ddpack_t(1.0) / ddpack_t(3.0);
+	ASSERT_TRUE( dd_near(q * pack_t(3.0), ddpack_t(1.0), dd_tol) );
+	ASSERT_TRUE( dd_equal(ddpack_t(6.0, pow2(-60)) / ddpack_t(2.0), 3.0, pow2(-61), 3.0, pow2(-61)) );
+
+	for (int t = 0; t < 1000; ++t)
+	{
+		ddpack_t x = rand_dd();
+		ddpack_t y = rand_dd();
+
+		ASSERT_TRUE( dd_near((x / y) * y, x, dd_tol) );
+		ASSERT_TRUE( dd_near((x * y) / y, x, dd_tol) );
+	}
+}
+
+GCASE( dd_sqrt )
+{
+	ASSERT_TRUE( dd_equal(sqrt(make_dd(0.0, 0.0, 4.0, 0.0)), 0, 0, 2.0, 0) );
+
+	// sqrt(1 + 2^-59 + 2^-120) = 1 + 2^-60
+
+	ddpack_t b(1.0, pow2(-60));
+	ASSERT_TRUE( dd_near(sqrt(b * b), b, dd_tol) );
+
+	ddpack_t r = sqrt(ddpack_t(2.0));
+	ASSERT_TRUE( dd_near(r * r, ddpack_t(2.0), dd_tol) );
+
+	for (int t = 0; t < 1000; ++t)
+	{
+		ddpack_t x = rand_dd();
+
+		r = sqrt(x);
+		ASSERT_TRUE( dd_near(r * r, x, dd_tol) );
+		ASSERT_TRUE( dd_near(sqrt(x * x), x, dd_tol) );
+	}
+}
+
+GCASE( dd_hsum )
+{
+	f64 h, l;
+
+	make_dd(1.0, pow2(-60), pow2(-70), 0.0).sum(h, l);
+	ASSERT_EQ( h, 1.0 );
+	ASSERT_EQ( l, pow2(-60) + pow2(-70) );
+
+	make_dd(pow2(80), 1.0, -pow2(80), 0.5).sum(h, l);
+	ASSERT_EQ( h, 1.5 );
+	ASSERT_EQ( l, 0.0 );
+
+	ASSERT_EQ( make_dd(2.0, pow2(-60), 3.0, 0.0).sum(), 5.0 );
+}
+
+GCASE( dd_sum )
+{
+	const int ns[10] = {0, 1, 2, 3, 7, 8, 9, 31, 1000, 100003};
+
+	for (int k = 0; k < 10; ++k)
+	{
+		const int n = ns[k];
+		std::vector<f64> x((size_t)n + 1);
+
+		// exact, with cancellation
+
+		f64 h, l, r;
+		fill_grid(n, &x[0], 0, h, l);
+
+		ASSERT_EQ( dd_sum(n, &x[0], &r), h );
+		ASSERT_EQ( r, l );
+		ASSERT_EQ( dd_sum(n, &x[0]), h );
+
+		// random values, against long double
+
+		fill_rand(n, &x[0], -1.0, 1.0);
+
+		long double a;
+		const long double s = ref_sum(n, &x[0], 0, a);
+		const f64 v = dd_sum(n, &x[0], &r);
+
+		ASSERT_TRUE( std::fabs((long double)v - s) <= 1.2e-16 * std::fabs(s) + 1.1e-19 * n * a );
+		ASSERT_TRUE( std::fabs((long double)v + r - s) <= 1.1e-19 * n * a );
+	}
+}
+
+GCASE( dd_dot )
+{
+	const int ns[10] = {0, 1, 2, 3, 7, 8, 9, 31, 1000, 100003};
+
+	for (int k = 0; k < 10; ++k)
+	{
+		const int n = ns[k];
+		std::vector<f64> x((size_t)n + 1), y((size_t)n + 1);
+
+		// exact, with cancellation
+
+		f64 h, l, r;
+		fill_grid(n, &x[0], &y[0], h, l);
+
+		ASSERT_EQ( dd_dot(n, &x[0], &y[0], &r), h );
+		ASSERT_EQ( r, l );
+		ASSERT_EQ( dd_dot(n, &x[0], &y[0]), h );
+
+		// random values, against long double
+
+		fill_rand(n, &x[0], -1.0, 1.0);
+		fill_rand(n, &y[0], -1.0, 1.0);
+
+		long double a;
+		const long double s = ref_sum(n, &x[0], &y[0], a);
+		const f64 v = dd_dot(n, &x[0], &y[0], &r);
+
+		ASSERT_TRUE( std::fabs((long double)v - s) <= 1.2e-16 * std::fabs(s) + 2.2e-19 * n * a );
+		ASSERT_TRUE( std::fabs((long double)v + r - s) <= 2.2e-19 * n * a );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( dd_construct );
+	ADD_TEST( dd_add_sub );
+	ADD_TEST( dd_mul );
+	ADD_TEST( dd_div );
+	ADD_TEST( dd_sqrt );
+	ADD_TEST( dd_hsum );
+	ADD_TEST( dd_sum );
+	ADD_TEST( dd_dot );
+}
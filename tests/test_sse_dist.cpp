@@ -0,0 +1,277 @@
+/**
+ * @file test_sse_dist.cpp
+ *
+ * Test the correctness of pairwise distances
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+double ref_dot(int d, const T *x, const T *y)
+{
+	double s = 0;
+	for (int k = 0; k < d; ++k) s += double(x[k]) * double(y[k]);
+	return s;
+}
+
+template<typename T>
+double ref_dist(int d, const T *x, const T *y, dist_sqeuclidean_t)
+{
+	double s = 0;
+	for (int k = 0; k < d; ++k)
+	{
+		const double v = double(x[k]) - double(y[k]);
+		s += v * v;
+	}
+	return s;
+}
+
+template<typename T>
+double ref_dist(int d, const T *x, const T *y, dist_euclidean_t)
+{
+	return std::sqrt(ref_dist(d, x, y, dist_sqeuclidean_t()));
+}
+
+template<typename T>
+double ref_dist(int d, const T *x, const T *y, dist_cosine_t)
+{
+	const double nx = ref_dot(d, x, x);
+	const double ny = ref_dot(d, y, y);
+	return nx > 0 && ny > 0 ? 1.0 - ref_dot(d, x, y) / std::sqrt(nx * ny) : 1.0;
+}
+
+template<typename T>
+double ref_dist(int d, const T *x, const T *y, dist_dot_t)
+{
+	return ref_dot(d, x, y);
+}
+
+// the bounds of the errors of the norm trick, which scale with
+// ||x||^2 + ||y||^2 (where the Euclidean distance, as a square root,
+// has an error of sqrt(tol) near zero)
+
+template<typename T>
+double err_bound(int d, const T *x, const T *y, double tol, dist_sqeuclidean_t)
+{
+	return tol * (ref_dot(d, x, x) + ref_dot(d, y, y) + 1.0);
+}
+
+template<typename T>
+double err_bound(int d, const T *x, const T *y, double tol, dist_euclidean_t)
+{
+	return std::sqrt(err_bound(d, x, y, tol, dist_sqeuclidean_t()));
+}
+
+template<typename T>
+double err_bound(int d, const T *x, const T *y, double tol, dist_cosine_t)
+{
+	return tol;
+}
+
+template<typename T>
+double err_bound(int d, const T *x, const T *y, double tol, dist_dot_t)
+{
+	return tol * (std::sqrt(ref_dot(d, x, x) * ref_dot(d, y, y)) + 1.0);
+}
+
+template<typename T>
+inline double tol_of()
+{
+	return sizeof(T) == 4 ? 1.0e-5 : 1.0e-13;
+}
+
+template<typename T, typename Metric>
+bool cdist_ok(int m, int n, int d, const T *x, int ldx, const T *y, int ldy,
+		const T *r, int ldr, Metric tag)
+{
+	for (int i = 0; i < m; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			const T *xi = x + i * ldx;
+			const T *yj = y + j * ldy;
+
+			const double e = std::fabs(double(r[i * ldr + j]) - ref_dist(d, xi, yj, tag));
+			if (!(e <= err_bound(d, xi, yj, tol_of<T>(), tag))) return false;
+		}
+	}
+	return true;
+}
+
+template<typename T, typename Metric>
+bool test_cdist(int m, int n, int d, Metric tag)
+{
+	const int ldx = d + 3;
+	const int ldy = d + 1;
+	const int ldr = n + 2;
+
+	T *x = new T[m * ldx + 1];
+	T *y = new T[n * ldy + 1];
+	T *r = new T[m * ldr + 1];
+	T *r2 = new T[m * ldr + 1];
+	T *ny = new T[n + 1];
+
+	fill_rand(m * ldx + 1, x, T(-1), T(1));
+	fill_rand(n * ldy + 1, y, T(-1), T(1));
+
+	// a pair of equal vectors, and a zero vector
+
+	if (m > 1 && n > 1)
+	{
+		for (int k = 0; k < d; ++k) y[ldy + k] = x[ldx + k];
+		for (int k = 0; k < d; ++k) y[k] = T(0);
+	}
+
+	cdist(m, n, d, x, ldx, y, ldy, r, ldr, tag);
+	bool ok = cdist_ok(m, n, d, x, ldx, y, ldy, r, ldr, tag);
+
+	// with precomputed quantities of y, and in parallel
+
+	dist_norms(n, d, y, ldy, ny, tag);
+	cdist_mt(m, n, d, x, ldx, y, ldy, ny, r2, ldr, tag);
+	for (int i = 0; i < m; ++i)
+	{
+		for (int j = 0; j < n; ++j) ok = ok && r2[i * ldr + j] == r[i * ldr + j];
+	}
+
+	delete[] ny;
+	delete[] r2;
+	delete[] r;
+	delete[] y;
+	delete[] x;
+
+	return ok;
+}
+
+template<typename T, typename Metric>
+bool test_pdist(int m, int d, Metric tag)
+{
+	const int ldx = d + 2;
+	const int ldr = m + 1;
+
+	T *x = new T[m * ldx + 1];
+	T *r = new T[m * ldr + 1];
+	fill_rand(m * ldx + 1, x, T(-1), T(1));
+
+	pdist(m, d, x, ldx, r, ldr, tag);
+	bool ok = cdist_ok(m, m, d, x, ldx, x, ldx, r, ldr, tag);
+
+	for (int i = 0; i < m; ++i)
+	{
+		for (int j = 0; j < m; ++j) ok = ok && r[i * ldr + j] == r[j * ldr + i];
+	}
+
+	delete[] r;
+	delete[] x;
+
+	return ok;
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( cdist )
+{
+	const int ms[4] = {1, 3, 4, 9};
+	const int ns[4] = {1, 2, 5, 8};
+	const int ds[6] = {1, 3, 4, 8, 17, 64};
+
+	for (int a = 0; a < 4; ++a)
+	{
+		for (int b = 0; b < 4; ++b)
+		{
+			for (int c = 0; c < 6; ++c)
+			{
+				const int m = ms[a];
+				const int n = ns[b];
+				const int d = ds[c];
+
+				ASSERT_TRUE( (test_cdist<T>(m, n, d, dist_sqeuclidean_t())) );
+				ASSERT_TRUE( (test_cdist<T>(m, n, d, dist_euclidean_t())) );
+				ASSERT_TRUE( (test_cdist<T>(m, n, d, dist_cosine_t())) );
+				ASSERT_TRUE( (test_cdist<T>(m, n, d, dist_dot_t())) );
+			}
+		}
+	}
+
+	// multiple tiles of y (enough for cdist_mt to go parallel)
+
+	const int d = 1000;
+	const int n = dist_blocking<T>::tile_cols(d) * 2 + 3;
+	ASSERT_TRUE( (test_cdist<T>(250, n, d, dist_sqeuclidean_t())) );
+	ASSERT_TRUE( (test_cdist<T>(6, n, d, dist_cosine_t())) );
+}
+
+GCASE( pdist )
+{
+	const int ms[5] = {1, 2, 5, 8, 13};
+	const int ds[4] = {1, 4, 7, 32};
+
+	for (int a = 0; a < 5; ++a)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			const int m = ms[a];
+			const int d = ds[c];
+
+			ASSERT_TRUE( (test_pdist<T>(m, d, dist_sqeuclidean_t())) );
+			ASSERT_TRUE( (test_pdist<T>(m, d, dist_euclidean_t())) );
+			ASSERT_TRUE( (test_pdist<T>(m, d, dist_cosine_t())) );
+			ASSERT_TRUE( (test_pdist<T>(m, d, dist_dot_t())) );
+		}
+	}
+
+	// multiple tiles, and exact zeros on the diagonal
+
+	const int d = 1000;
+	const int m = dist_blocking<T>::tile_cols(d) + 7;
+	ASSERT_TRUE( (test_pdist<T>(m, d, dist_euclidean_t())) );
+
+	T *x = new T[m * d];
+	T *r = new T[m * m];
+	fill_rand(m * d, x, T(-1), T(1));
+
+	pdist(m, d, x, d, r, m, dist_euclidean_t());
+	for (int i = 0; i < m; ++i) ASSERT_EQ( r[i * m + i], T(0) );
+
+	delete[] r;
+	delete[] x;
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( cdist );
+	ADD_TEST( pdist );
+}
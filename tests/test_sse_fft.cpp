@@ -0,0 +1,221 @@
+/**
+ * @file test_sse_fft.cpp
+ *
+ * Test the correctness of the FFT functions
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <complex>
+#include <cmath>
+
+using namespace lsimd;
+using namespace ltest;
+
+// explicit instantiation for thorough syntax check
+
+template class lsimd::fft_plan<f32>;
+template class lsimd::fft_plan<f64>;
+
+template class lsimd::rfft_plan<f32>;
+template class lsimd::rfft_plan<f64>;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+void ref_dft(int n, const std::complex<T> *x, std::complex<T> *y, bool inv)
+{
+	const double pi = 3.14159265358979323846;
+	const double sg = inv ? 2.0 : -2.0;
+
+	for (int k = 0; k < n; ++k)
+	{
+		double sr = 0, si = 0;
+		for (int j = 0; j < n; ++j)
+		{
+			const double a = sg * pi * double((long)j * k % n) / double(n);
+			const double c = std::cos(a), s = std::sin(a);
+			sr += double(x[j].real()) * c - double(x[j].imag()) * s;
+			si += double(x[j].real()) * s + double(x[j].imag()) * c;
+		}
+		y[k] = std::complex<T>(T(sr), T(si));
+	}
+}
+
+template<typename T>
+inline void fill_rand_complex(int n, std::complex<T> *x)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		x[i] = std::complex<T>(
+			T(std::rand()) / T(RAND_MAX) - T(0.5),
+			T(std::rand()) / T(RAND_MAX) - T(0.5));
+	}
+}
+
+// the maximum error relative to the l2-norm of the reference
+
+template<typename T>
+double fft_rel_err(int n, const std::complex<T> *a, const std::complex<T> *r)
+{
+	double e = 0, s = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		const double d = std::abs(std::complex<double>(a[i]) - std::complex<double>(r[i]));
+		if (d > e) e = d;
+		s += std::norm(std::complex<double>(r[i]));
+	}
+	return e / std::sqrt(s);
+}
+
+template<typename T>
+inline double fft_tol()
+{
+	return sizeof(T) == 4 ? 1.0e-5 : 1.0e-13;
+}
+
+const int MaxLogN = 12;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( fft_forward )
+{
+	for (int e = 0; e <= MaxLogN; ++e)
+	{
+		const int n = 1 << e;
+		std::complex<T> *x = new std::complex<T>[n];
+		std::complex<T> *y = new std::complex<T>[n];
+		std::complex<T> *r = new std::complex<T>[n];
+
+		fill_rand_complex(n, x);
+		ref_dft(n, x, r, false);
+
+		fft(n, x, y);
+		ASSERT_TRUE( fft_rel_err(n, y, r) < fft_tol<T>() );
+
+		fft(n, x);
+		ASSERT_TRUE( fft_rel_err(n, x, r) < fft_tol<T>() );
+
+		delete[] x;
+		delete[] y;
+		delete[] r;
+	}
+}
+
+GCASE( fft_backward )
+{
+	for (int e = 0; e <= MaxLogN; ++e)
+	{
+		const int n = 1 << e;
+		std::complex<T> *x = new std::complex<T>[n];
+		std::complex<T> *y = new std::complex<T>[n];
+		std::complex<T> *r = new std::complex<T>[n];
+
+		fill_rand_complex(n, x);
+		ref_dft(n, x, r, true);
+
+		ifft(n, x, y);
+		ASSERT_TRUE( fft_rel_err(n, y, r) < fft_tol<T>() );
+
+		ifft(n, x);
+		ASSERT_TRUE( fft_rel_err(n, x, r) < fft_tol<T>() );
+
+		delete[] x;
+		delete[] y;
+		delete[] r;
+	}
+}
+
+GCASE( fft_roundtrip )
+{
+	const int n = 1 << 16;
+	std::complex<T> *x = new std::complex<T>[n];
+	std::complex<T> *y = new std::complex<T>[n];
+
+	fill_rand_complex(n, x);
+
+	fft_plan<T> plan(n);
+	plan.forward(x, y);
+	plan.backward(y, y);
+
+	for (int i = 0; i < n; ++i) y[i] /= T(n);
+	ASSERT_TRUE( fft_rel_err(n, y, x) < fft_tol<T>() );
+
+	delete[] x;
+	delete[] y;
+}
+
+GCASE( rfft )
+{
+	for (int e = 2; e <= MaxLogN; ++e)
+	{
+		const int n = 1 << e;
+		T *x = new T[n];
+		T *xr = new T[n];
+		std::complex<T> *z = new std::complex<T>[n];
+		std::complex<T> *r = new std::complex<T>[n];
+		std::complex<T> *y = new std::complex<T>[n / 2 + 1];
+
+		for (int i = 0; i < n; ++i)
+		{
+			x[i] = T(std::rand()) / T(RAND_MAX) - T(0.5);
+			z[i] = std::complex<T>(x[i], T(0));
+		}
+		ref_dft(n, z, r, false);
+
+		rfft(n, x, y);
+		ASSERT_TRUE( fft_rel_err(n / 2 + 1, y, r) < fft_tol<T>() );
+
+		irfft(n, y, xr);
+
+		double e_max = 0, s = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			const double d = std::fabs(double(xr[i]) / n - double(x[i]));
+			if (d > e_max) e_max = d;
+			s += double(x[i]) * double(x[i]);
+		}
+		ASSERT_TRUE( e_max / std::sqrt(s) < fft_tol<T>() );
+
+		delete[] x;
+		delete[] xr;
+		delete[] z;
+		delete[] r;
+		delete[] y;
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( fft_forward );
+	ADD_TEST( fft_backward );
+	ADD_TEST( fft_roundtrip );
+	ADD_TEST( rfft );
+}
@@ -0,0 +1,163 @@
+/**
+ * @file test_sse_hist.cpp
+ *
+ * Test the correctness of histograms
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T, typename C>
+int ref_histogram(int n, const T *x, T lo, T hi, int nbins, C *counts)
+{
+	const T s = T(nbins) / (hi - lo);
+	const T tm = T(nbins - 1);
+
+	int r = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		const T v = x[i];
+		if (v >= lo && v <= hi)
+		{
+			const T t = (v - lo) * s;
+			++ counts[(int)(t < tm ? t : tm)];
+			++ r;
+		}
+	}
+	return r;
+}
+
+// values around [lo, hi], including both ends, a few outliers and NaNs
+
+template<typename T>
+void fill_vals(int n, T *x, T lo, T hi)
+{
+	fill_rand(n, x, lo, hi);
+
+	for (int i = 0; i < n; i += 7)
+	{
+		switch (std::rand() % 6)
+		{
+		case 0: x[i] = lo; break;
+		case 1: x[i] = hi; break;
+		case 2: x[i] = lo - T(1); break;
+		case 3: x[i] = hi + T(1); break;
+		case 4: x[i] = std::numeric_limits<T>::quiet_NaN(); break;
+		case 5: x[i] = -std::numeric_limits<T>::infinity(); break;
+		}
+	}
+}
+
+// the counts of type C (int by default), initialized to c0
+
+template<typename T, typename C = int>
+bool test_hist(int n, T lo, T hi, int nbins, bool mt, C c0 = C(3))
+{
+	std::vector<T> x((size_t)n + 1);
+	fill_vals(n, &x[0], lo, hi);
+
+	// the counts are added to
+
+	std::vector<C> c((size_t)nbins, c0), rc((size_t)nbins, c0);
+
+	const int rr = ref_histogram(n, &x[0], lo, hi, nbins, &rc[0]);
+	const int r = mt ? histogram_mt(n, &x[0], lo, hi, nbins, &c[0]) :
+			histogram(n, &x[0], lo, hi, nbins, &c[0]);
+
+	if (r != rr) return false;
+	for (int j = 0; j < nbins; ++j) if (c[j] != rc[j]) return false;
+	return true;
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( histogram )
+{
+	const int nbs[6] = {1, 3, 8, 10, 100, hist_blocking<T>::max_sub_bins + 3};
+
+	for (int n = 0; n <= 50; ++n)
+	{
+		for (int k = 0; k < 6; ++k)
+		{
+			ASSERT_TRUE( test_hist<T>(n, T(0), T(1), nbs[k], false) );
+			ASSERT_TRUE( test_hist<T>(n, T(-2.5), T(7), nbs[k], false) );
+		}
+	}
+
+	for (int k = 0; k < 6; ++k)
+	{
+		ASSERT_TRUE( test_hist<T>(10000, T(-1), T(1), nbs[k], false) );
+	}
+
+	// integer values over unit bins
+
+	const int n = 1000;
+	const int nb = 20;
+	std::vector<T> x((size_t)n);
+	std::vector<int> c((size_t)nb, 0);
+
+	for (int i = 0; i < n; ++i) x[i] = T(i % (nb + 5));
+
+	ASSERT_EQ( histogram(n, &x[0], T(0), T(nb), nb, &c[0]), 840 );
+	ASSERT_EQ( c[0], 40 );
+	ASSERT_EQ( c[nb - 2], 40 );
+	ASSERT_EQ( c[nb - 1], 80 );
+
+	// 64-bit counts, beyond the range of int
+
+	const i64 big = (i64(1) << 31) - 5;
+	ASSERT_TRUE( test_hist<T>(10000, T(-1), T(1), 10, false, big) );
+	ASSERT_TRUE( test_hist<T>(10000, T(-1), T(1), hist_blocking<T>::max_sub_bins + 3, false, big) );
+}
+
+GCASE( histogram_mt )
+{
+	const int ns[3] = {1000, 3 * hist_blocking<T>::mt_size + 17, 40 * hist_blocking<T>::mt_size + 5};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		ASSERT_TRUE( test_hist<T>(ns[i], T(-1), T(1), 10, true) );
+		ASSERT_TRUE( test_hist<T>(ns[i], T(0), T(100), hist_blocking<T>::max_sub_bins + 3, true) );
+		ASSERT_TRUE( test_hist<T>(ns[i], T(-1), T(1), 10, true, (i64(1) << 32) + 1) );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( histogram );
+	ADD_TEST( histogram_mt );
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_sse_ipack.cpp
+ *
+ * Test the correctness of the packs of 32-bit integers
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+
+using namespace lsimd;
+using namespace ltest;
+
+static_assert( simd<i32, sse_kind>::pack_width == 4, "Incorrect simd pack_width" );
+static_assert( simd<u32, sse_kind>::pack_width == 4, "Incorrect simd pack_width" );
+
+
+/************************************************
+ *
+ *  basics
+ *
+ ************************************************/
+
+GCASE( load_store )
+{
+	LSIMD_ALIGN_SSE T a[5] = {T(1), T(-2), T(3), T(5), T(-4)};
+	LSIMD_ALIGN_SSE T t[5];
+
+	simd_pack<T, sse_kind> pa(a, aligned_t());
+	ASSERT_SIMD_EQ( pa, a );
+
+	simd_pack<T, sse_kind> pu(a + 1, unaligned_t());
+	ASSERT_SIMD_EQ( pu, a + 1 );
+
+	clear_zeros(5, t);
+	pa.store(t, aligned_t());
+	ASSERT_VEC_EQ( 4, t, a );
+
+	clear_zeros(5, t);
+	pu.store(t + 1, unaligned_t());
+	ASSERT_VEC_EQ( 4, t + 1, a + 1 );
+
+	T z[4] = {T(0), T(0), T(0), T(0)};
+	simd_pack<T, sse_kind> p0 = zero_t();
+	ASSERT_SIMD_EQ( p0, z );
+
+	T r[4] = {T(7), T(7), T(7), T(7)};
+	simd_pack<T, sse_kind> p1(T(7));
+	ASSERT_SIMD_EQ( p1, r );
+}
+
+GCASE( entries )
+{
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(-2), T(3), T(5)};
+	simd_pack<T, sse_kind> p(a, aligned_t());
+
+	ASSERT_EQ( p.to_scalar(), a[0] );
+	ASSERT_EQ( p.template extract<0>(), a[0] );
+	ASSERT_EQ( p.template extract<1>(), a[1] );
+	ASSERT_EQ( p.template extract<2>(), a[2] );
+	ASSERT_EQ( p.template extract<3>(), a[3] );
+
+	T b2[4] = {a[2], a[2], a[2], a[2]};
+	ASSERT_SIMD_EQ( p.template bsx<2>(), b2 );
+
+	T s[4] = {a[3], a[0], a[2], a[1]};
+	simd_pack<T, sse_kind> q = p.impl.template swizzle<3, 0, 2, 1>();
+	ASSERT_SIMD_EQ( q, s );
+
+	ASSERT_EQ( p.sum(), T(7) );
+}
+
+
+/************************************************
+ *
+ *  arithmetic and bitwise operations
+ *
+ ************************************************/
+
+template<typename T>
+inline void fill_rand_bits(int n, T *a)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		a[i] = T(((u32)std::rand() << 16) ^ (u32)std::rand());
+	}
+}
+
+GCASE( arith )
+{
+	// products of the signed values are computed with wrap-around
+	// on unsigned values, to avoid undefined behavior in the reference
+
+	LSIMD_ALIGN_SSE T a[4];
+	LSIMD_ALIGN_SSE T b[4];
+	T r[4];
+
+	for (int k = 0; k < 100; ++k)
+	{
+		fill_rand_bits(4, a);
+		fill_rand_bits(4, b);
+
+		simd_pack<T, sse_kind> pa(a, aligned_t());
+		simd_pack<T, sse_kind> pb(b, aligned_t());
+
+		for (int i = 0; i < 4; ++i) r[i] = T((u32)a[i] + (u32)b[i]);
+		ASSERT_SIMD_EQ( pa + pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = T((u32)a[i] - (u32)b[i]);
+		ASSERT_SIMD_EQ( pa - pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = T((u32)a[i] * (u32)b[i]);
+		ASSERT_SIMD_EQ( pa * pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] < b[i] ? a[i] : b[i];
+		ASSERT_SIMD_EQ( vmin(pa, pb), r );
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] > b[i] ? a[i] : b[i];
+		ASSERT_SIMD_EQ( vmax(pa, pb), r );
+	}
+}
+
+GCASE( bitwise )
+{
+	LSIMD_ALIGN_SSE T a[4];
+	LSIMD_ALIGN_SSE T b[4];
+	T r[4];
+
+	for (int k = 0; k < 100; ++k)
+	{
+		fill_rand_bits(4, a);
+		fill_rand_bits(4, b);
+
+		simd_pack<T, sse_kind> pa(a, aligned_t());
+		simd_pack<T, sse_kind> pb(b, aligned_t());
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] & b[i];
+		ASSERT_SIMD_EQ( pa & pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] | b[i];
+		ASSERT_SIMD_EQ( pa | pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] ^ b[i];
+		ASSERT_SIMD_EQ( pa ^ pb, r );
+
+		for (int i = 0; i < 4; ++i) r[i] = T((u32)a[i] << 7);
+		ASSERT_SIMD_EQ( pa << 7, r );
+
+		// the right shift is arithmetic for i32 and logical for u32
+
+		for (int i = 0; i < 4; ++i) r[i] = a[i] >> 13;
+		ASSERT_SIMD_EQ( pa >> 13, r );
+	}
+}
+
+template<typename T> class mulhilo_tests;
+
+SCASE( mulhilo, u32 )
+{
+	LSIMD_ALIGN_SSE u32 a[4];
+	LSIMD_ALIGN_SSE u32 b[4];
+	u32 rh[4];
+	u32 rl[4];
+
+	for (int k = 0; k < 100; ++k)
+	{
+		fill_rand_bits(4, a);
+		fill_rand_bits(4, b);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			u64 p = (u64)a[i] * (u64)b[i];
+			rh[i] = (u32)(p >> 32);
+			rl[i] = (u32)p;
+		}
+
+		simd_pack<u32, sse_kind> pa(a, aligned_t());
+		simd_pack<u32, sse_kind> pb(b, aligned_t());
+		simd_pack<u32, sse_kind> hi, lo;
+
+		mulhilo(pa, pb, hi, lo);
+		ASSERT_SIMD_EQ( hi, rh );
+		ASSERT_SIMD_EQ( lo, rl );
+		ASSERT_SIMD_EQ( mulhi(pa, pb), rh );
+	}
+}
+
+template<typename T> class transpose_tests;
+
+SCASE( transpose, u32 )
+{
+	LSIMD_ALIGN_SSE u32 a[16];
+	u32 r[16];
+
+	for (int i = 0; i < 16; ++i) a[i] = (u32)i;
+	for (int i = 0; i < 4; ++i)
+		for (int j = 0; j < 4; ++j) r[i * 4 + j] = a[j * 4 + i];
+
+	simd_pack<u32, sse_kind> p0(a, aligned_t());
+	simd_pack<u32, sse_kind> p1(a + 4, aligned_t());
+	simd_pack<u32, sse_kind> p2(a + 8, aligned_t());
+	simd_pack<u32, sse_kind> p3(a + 12, aligned_t());
+
+	transpose4(p0, p1, p2, p3);
+	ASSERT_SIMD_EQ( p0, r );
+	ASSERT_SIMD_EQ( p1, r + 4 );
+	ASSERT_SIMD_EQ( p2, r + 8 );
+	ASSERT_SIMD_EQ( p3, r + 12 );
+}
+
+
+/************************************************
+ *
+ *  conversions
+ *
+ ************************************************/
+
+template<typename T> class convert_tests;
+
+SCASE( convert, i32 )
+{
+	LSIMD_ALIGN_SSE i32 a[4] = {3, -7, 16777216, -1};
+
+	f32 rf[4] = {3.f, -7.f, 16777216.f, -1.f};
+	ASSERT_SIMD_EQ( cvt_f32(simd_pack<i32>(a, aligned_t())), rf );
+
+	f64 rd[2] = {3.0, -7.0};
+	ASSERT_SIMD_EQ( cvt_f64(simd_pack<i32>(a, aligned_t())), rd );
+
+	LSIMD_ALIGN_SSE f32 x[4] = {2.5f, -2.7f, 1.2f, -0.5f};
+	i32 rr[4] = {2, -3, 1, 0};
+	i32 rt[4] = {2, -2, 1, 0};
+	ASSERT_SIMD_EQ( cvt_i32(simd_pack<f32>(x, aligned_t())), rr );
+	ASSERT_SIMD_EQ( cvtt_i32(simd_pack<f32>(x, aligned_t())), rt );
+
+	LSIMD_ALIGN_SSE f64 y[2] = {-3.5, 6.7};
+	i32 dr[4] = {-4, 7, 0, 0};
+	i32 dt[4] = {-3, 6, 0, 0};
+	ASSERT_SIMD_EQ( cvt_i32(simd_pack<f64>(y, aligned_t())), dr );
+	ASSERT_SIMD_EQ( cvtt_i32(simd_pack<f64>(y, aligned_t())), dt );
+
+	// reinterpretation
+
+	u32 ru[4] = {3u, 0xFFFFFFF9u, 16777216u, 0xFFFFFFFFu};
+	ASSERT_SIMD_EQ( as_u32(simd_pack<i32>(a, aligned_t())), ru );
+	ASSERT_SIMD_EQ( as_i32(as_u32(simd_pack<i32>(a, aligned_t()))), a );
+
+	u32 one_f[4] = {0x3F800000u, 0x3F800000u, 0x3F800000u, 0x3F800000u};
+	u32 one_d[4] = {0u, 0x3FF00000u, 0u, 0x3FF00000u};
+	f32 r1f[4] = {1.f, 1.f, 1.f, 1.f};
+	f64 r1d[2] = {1.0, 1.0};
+	ASSERT_SIMD_EQ( as_f32(simd_pack<u32>(one_f, unaligned_t())), r1f );
+	ASSERT_SIMD_EQ( as_f64(simd_pack<u32>(one_d, unaligned_t())), r1d );
+	ASSERT_SIMD_EQ( as_u32(simd_pack<f64>(1.0)), one_d );
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<i32>() );
+	tp->add( new H<u32>() );
+
+	return tp;
+}
+
+
+void lsimd::add_test_packs()
+{
+	lsimd_main_suite.add( make_tpack<load_store_tests>( "load_store" ) );
+	lsimd_main_suite.add( make_tpack<entries_tests>( "entries" ) );
+	lsimd_main_suite.add( make_tpack<arith_tests>( "arith" ) );
+	lsimd_main_suite.add( make_tpack<bitwise_tests>( "bitwise" ) );
+
+	test_pack *tp = new test_pack( "u32_ops" );
+	tp->add( new mulhilo_tests<u32>() );
+	tp->add( new transpose_tests<u32>() );
+	lsimd_main_suite.add( tp );
+
+	tp = new test_pack( "convert" );
+	tp->add( new convert_tests<i32>() );
+	lsimd_main_suite.add( tp );
+}
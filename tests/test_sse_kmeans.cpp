@@ -0,0 +1,242 @@
+/**
+ * @file test_sse_kmeans.cpp
+ *
+ * Test the correctness of the k-means assignment and update steps
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+double ref_sqdist(int d, const T *x, const T *y)
+{
+	double s = 0;
+	for (int j = 0; j < d; ++j)
+	{
+		const double v = double(x[j]) - double(y[j]);
+		s += v * v;
+	}
+	return s;
+}
+
+template<typename T>
+inline double tol_of()
+{
+	return sizeof(T) == 4 ? 1.0e-5 : 1.0e-13;
+}
+
+// checks the assignment of each point against the nearest centroid,
+// exactly if exact, and otherwise up to the rounding errors
+
+template<typename T>
+bool assign_ok(int n, int d, const T *x, int ldx, int k, const T *c, int ldc,
+		const int *labels, const T *dists, bool exact)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		const T *xi = x + i * ldx;
+
+		int l = 0;
+		double mv = ref_sqdist(d, xi, c);
+		for (int j = 1; j < k; ++j)
+		{
+			const double v = ref_sqdist(d, xi, c + j * ldc);
+			if (v < mv) { mv = v; l = j; }
+		}
+
+		if (labels[i] < 0 || labels[i] >= k) return false;
+
+		if (exact)
+		{
+			if (labels[i] != l || double(dists[i]) != mv) return false;
+		}
+		else
+		{
+			const double tol = tol_of<T>() * (ref_sqdist(d, xi, xi) + ref_sqdist(d, c, c) + 1.0) * 4;
+			const double vl = ref_sqdist(d, xi, c + labels[i] * ldc);
+
+			if (!(vl - mv <= tol)) return false;
+			if (!(std::fabs(double(dists[i]) - vl) <= tol)) return false;
+		}
+	}
+	return true;
+}
+
+template<typename T>
+bool test_assign(int n, int d, int k, bool ints)
+{
+	const int ldx = d + 1;
+	const int ldc = d + 2;
+
+	std::vector<T> x((size_t)n * ldx + 1), c((size_t)k * ldc + 1);
+	std::vector<int> labels((size_t)n + 1), labels2((size_t)n + 1);
+	std::vector<T> dists((size_t)n + 1), dists2((size_t)n + 1);
+
+	if (ints)
+	{
+		// small integers, for which all distances are exact (and tie often)
+
+		fill_rand_int(n * ldx, &x[0], 0, 3);
+		fill_rand_int(k * ldc, &c[0], 0, 3);
+	}
+	else
+	{
+		fill_rand(n * ldx, &x[0], T(-1), T(1));
+		fill_rand(k * ldc, &c[0], T(-1), T(1));
+	}
+
+	const T s = kmeans_assign(n, d, &x[0], ldx, k, &c[0], ldc, &labels[0], &dists[0]);
+	bool ok = assign_ok(n, d, &x[0], ldx, k, &c[0], ldc, &labels[0], &dists[0], ints);
+
+	double rs = 0;
+	for (int i = 0; i < n; ++i) rs += double(dists[i]);
+	ok = ok && std::fabs(double(s) - rs) <= tol_of<T>() * (rs + 1.0) * 4;
+
+	// the same labels and distances in parallel
+
+	const T s2 = kmeans_assign_mt(n, d, &x[0], ldx, k, &c[0], ldc, &labels2[0], &dists2[0]);
+	for (int i = 0; i < n; ++i)
+	{
+		ok = ok && labels2[i] == labels[i] && dists2[i] == dists[i];
+	}
+	ok = ok && std::fabs(double(s2) - rs) <= tol_of<T>() * (rs + 1.0) * 4;
+
+	return ok;
+}
+
+template<typename T>
+bool test_update(int n, int d, int k, bool mt)
+{
+	const int ldx = d + 3;
+	const int ldc = d + 1;
+
+	std::vector<T> x((size_t)n * ldx + 1), c((size_t)k * ldc + 1);
+	std::vector<int> labels((size_t)n + 1), counts((size_t)k + 1);
+
+	fill_rand(n * ldx, &x[0], T(-1), T(1));
+	fill_rand(k * ldc, &c[0], T(-1), T(1));
+
+	// the last cluster is left empty
+
+	for (int i = 0; i < n; ++i) labels[i] = k > 1 ? std::rand() % (k - 1) : 0;
+	const std::vector<T> c0(c);
+
+	if (mt)
+		kmeans_update_mt(n, d, &x[0], ldx, &labels[0], k, &c[0], ldc, &counts[0]);
+	else
+		kmeans_update(n, d, &x[0], ldx, &labels[0], k, &c[0], ldc, &counts[0]);
+
+	std::vector<double> s((size_t)d);
+	for (int l = 0; l < k; ++l)
+	{
+		int cnt = 0;
+		for (int j = 0; j < d; ++j) s[j] = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			if (labels[i] != l) continue;
+			++ cnt;
+			for (int j = 0; j < d; ++j) s[j] += double(x[i * ldx + j]);
+		}
+
+		if (counts[l] != cnt) return false;
+
+		for (int j = 0; j < d; ++j)
+		{
+			const double r = cnt > 0 ? s[j] / cnt : double(c0[l * ldc + j]);
+			const double tol = cnt > 0 ? tol_of<T>() * 4 * std::sqrt(double(cnt)) : 0.0;
+			if (!(std::fabs(double(c[l * ldc + j]) - r) <= tol)) return false;
+		}
+	}
+	return true;
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( kmeans_assign )
+{
+	const int ns[4] = {1, 3, 8, 37};
+	const int ds[5] = {1, 3, 4, 9, 32};
+	const int ks[6] = {1, 2, 3, 7, 8, 33};
+
+	for (int a = 0; a < 4; ++a)
+	{
+		for (int b = 0; b < 5; ++b)
+		{
+			for (int t = 0; t < 6; ++t)
+			{
+				ASSERT_TRUE( test_assign<T>(ns[a], ds[b], ks[t], false) );
+				ASSERT_TRUE( test_assign<T>(ns[a], ds[b], ks[t], true) );
+			}
+		}
+	}
+
+	// multiple blocks of points (enough for kmeans_assign_mt to go parallel)
+
+	ASSERT_TRUE( test_assign<T>(3001, 20, 16, false) );
+	ASSERT_TRUE( test_assign<T>(3001, 5, 16, true) );
+	ASSERT_TRUE( test_assign<T>(1000, 64, 300, false) );
+}
+
+GCASE( kmeans_update )
+{
+	const int ns[4] = {1, 5, 16, 100};
+	const int ds[5] = {1, 3, 4, 9, 32};
+	const int ks[4] = {1, 2, 3, 10};
+
+	for (int a = 0; a < 4; ++a)
+	{
+		for (int b = 0; b < 5; ++b)
+		{
+			for (int t = 0; t < 4; ++t)
+			{
+				ASSERT_TRUE( test_update<T>(ns[a], ds[b], ks[t], false) );
+				ASSERT_TRUE( test_update<T>(ns[a], ds[b], ks[t], true) );
+			}
+		}
+	}
+
+	// multiple partial sums
+
+	ASSERT_TRUE( test_update<T>(50000, 7, 5, true) );
+	ASSERT_TRUE( test_update<T>(20000, 16, 40, true) );
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( kmeans_assign );
+	ADD_TEST( kmeans_update );
+}
@@ -273,6 +273,131 @@ GCASE2( mtimes )
 }
 
 
+GCASE2( mtimes_expr )
+{
+	LSIMD_ALIGN_SSE T sa[MaxArrLen];
+	LSIMD_ALIGN_SSE T sb[MaxArrLen];
+	for (int i = 0; i < MaxArrLen; ++i) sa[i] = T(i+1);
+	for (int i = 0; i < MaxArrLen; ++i) sb[i] = T(2 * i - 5);
+
+	LSIMD_ALIGN_SSE T sx[N];
+	LSIMD_ALIGN_SSE T sz[N];
+	for (int j = 0; j < N; ++j) sx[j] = T(j+1);
+	for (int j = 0; j < N; ++j) sz[j] = T(3 - j);
+
+	LSIMD_ALIGN_SSE T sc[M];
+	for (int i = 0; i < M; ++i) sc[i] = T(i * i + 1);
+
+	T ax[M];
+	T bz[M];
+	for (int i = 0; i < M; ++i)
+	{
+		T u(0), v(0);
+		for (int j = 0; j < N; ++j)
+		{
+			u += sa[i + j * M] * sx[j];
+			v += sb[i + j * M] * sz[j];
+		}
+		ax[i] = u;
+		bz[i] = v;
+	}
+
+	simd_mat<T, M, N, sse_kind> a(sa, aligned_t());
+	simd_mat<T, M, N, sse_kind> b(sb, aligned_t());
+	simd_vec<T, N, sse_kind> x(sx, aligned_t());
+	simd_vec<T, N, sse_kind> z(sz, aligned_t());
+	simd_vec<T, M, sse_kind> c(sc, aligned_t());
+	simd_pack<T, sse_kind> s(T(2));
+
+	T r[M];
+
+	for (int i = 0; i < M; ++i) r[i] = ax[i] + sc[i];
+	ASSERT_SIMD_EQ( a * x + c, r );
+	ASSERT_SIMD_EQ( c + a * x, r );
+
+	for (int i = 0; i < M; ++i) r[i] = ax[i] - sc[i];
+	ASSERT_SIMD_EQ( a * x - c, r );
+
+	for (int i = 0; i < M; ++i) r[i] = sc[i] - ax[i];
+	ASSERT_SIMD_EQ( c - a * x, r );
+
+	for (int i = 0; i < M; ++i) r[i] = ax[i] + bz[i] - sc[i];
+	ASSERT_SIMD_EQ( a * x + b * z - c, r );
+
+	for (int i = 0; i < M; ++i) r[i] = ax[i] - (bz[i] - sc[i] * T(2));
+	ASSERT_SIMD_EQ( a * x - (b * z - c * s), r );
+
+	for (int i = 0; i < M; ++i) r[i] = (ax[i] + sc[i]) * T(2);
+	ASSERT_SIMD_EQ( (a * x + c) * s, r );
+
+	simd_vec<T, M, sse_kind> y = a * x + b * z;
+	for (int i = 0; i < M; ++i) r[i] = ax[i] + bz[i];
+	ASSERT_SIMD_EQ( y, r );
+
+	y += a * x - c;
+	for (int i = 0; i < M; ++i) r[i] = 2 * ax[i] + bz[i] - sc[i];
+	ASSERT_SIMD_EQ( y, r );
+
+	y -= b * z;
+	for (int i = 0; i < M; ++i) r[i] = 2 * ax[i] - sc[i];
+	ASSERT_SIMD_EQ( y, r );
+}
+
+
+
+GCASE2( batch_transform )
+{
+	const int n = 7;
+	const int ldx = N + 3;
+	const int ldy = M + 1;
+
+	LSIMD_ALIGN_SSE T sa[MaxArrLen];
+	for (int i = 0; i < MaxArrLen; ++i) sa[i] = T(i+1);
+
+	T xs[n * ldx];
+	for (int i = 0; i < n * ldx; ++i) xs[i] = T(i % 5) - T(2);
+
+	T r[n * M];
+	for (int k = 0; k < n; ++k)
+	{
+		for (int i = 0; i < M; ++i)
+		{
+			T u(0);
+			for (int j = 0; j < N; ++j) u += sa[i + j * M] * xs[k * N + j];
+			r[k * M + i] = u;
+		}
+	}
+
+	simd_mat<T, M, N, sse_kind> a(sa, aligned_t());
+
+	// packed
+
+	T ys[n * ldy];
+	batch_transform(a, n, xs, ys);
+	ASSERT_VEC_EQ( n * M, ys, r );
+
+	// strided
+
+	for (int k = 0; k < n; ++k)
+	{
+		for (int i = 0; i < M; ++i)
+		{
+			T u(0);
+			for (int j = 0; j < N; ++j) u += sa[i + j * M] * xs[k * ldx + j];
+			r[k * M + i] = u;
+		}
+	}
+
+	for (int i = 0; i < n * ldy; ++i) ys[i] = T(-1);
+	batch_transform(a, n, xs, ldx, ys, ldy);
+
+	for (int k = 0; k < n; ++k)
+	{
+		ASSERT_VEC_EQ( M, ys + k * ldy, r + k * M );
+		ASSERT_EQ( ys[k * ldy + M], T(-1) );
+	}
+}
+
 GCASE2( trace )
 {
 	LSIMD_ALIGN_SSE T sa[MaxArrLen];
@@ -340,6 +465,8 @@ void lsimd::add_test_packs()
 	ADD_TEST( arith );
 	ADD_TEST( scale );
 	ADD_TEST( mtimes );
+	ADD_TEST( mtimes_expr );
+	ADD_TEST( batch_transform );
 	ADD_TEST( trace );
 }
 
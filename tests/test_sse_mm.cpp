@@ -23,11 +23,15 @@ LSIMD_ALIGN(32) f32 arr_af[MaxArrLen];
 LSIMD_ALIGN(32) f32 arr_bf[MaxArrLen];
 LSIMD_ALIGN(32) f32 arr_crf[MaxArrLen];
 LSIMD_ALIGN(32) f32 arr_c0f[MaxArrLen];
+LSIMD_ALIGN(32) f32 arr_ef[MaxArrLen];
+LSIMD_ALIGN(32) f32 arr_tf[MaxArrLen];
 
 LSIMD_ALIGN(32) f64 arr_ad[MaxArrLen];
 LSIMD_ALIGN(32) f64 arr_bd[MaxArrLen];
 LSIMD_ALIGN(32) f64 arr_crd[MaxArrLen];
 LSIMD_ALIGN(32) f64 arr_c0d[MaxArrLen];
+LSIMD_ALIGN(32) f64 arr_ed[MaxArrLen];
+LSIMD_ALIGN(32) f64 arr_td[MaxArrLen];
 
 template<typename T> struct storage_s;
 
@@ -37,6 +41,8 @@ template<> struct storage_s<f32>
 	static f32 *arr_b() { return arr_bf; }
 	static f32 *arr_cr() { return arr_crf; }
 	static f32 *arr_c0() { return arr_c0f; }
+	static f32 *arr_e() { return arr_ef; }
+	static f32 *arr_t() { return arr_tf; }
 };
 
 template<> struct storage_s<f64>
@@ -45,6 +51,8 @@ template<> struct storage_s<f64>
 	static f64 *arr_b() { return arr_bd; }
 	static f64 *arr_cr() { return arr_crd; }
 	static f64 *arr_c0() { return arr_c0d; }
+	static f64 *arr_e() { return arr_ed; }
+	static f64 *arr_t() { return arr_td; }
 };
 
 
@@ -116,6 +124,123 @@ public:
 };
 
 
+template<typename T, int M, int K, int L, int N>
+class matchain_tests : public test_case
+{
+	char m_name[128];
+
+	T *arr_a;
+	T *arr_b;
+	T *arr_e;
+	T *arr_t;
+	T *arr_cr;
+	T *arr_c0;
+
+public:
+	matchain_tests()
+	{
+		std::sprintf(m_name, "chain (%d x %d) * (%d x %d) * (%d x %d)", M, K, K, L, L, N);
+
+		arr_a = storage_s<T>::arr_a();
+		arr_b = storage_s<T>::arr_b();
+		arr_e = storage_s<T>::arr_e();
+		arr_t = storage_s<T>::arr_t();
+		arr_cr = storage_s<T>::arr_cr();
+		arr_c0 = storage_s<T>::arr_c0();
+	}
+
+	const char *name() const
+	{
+		return m_name;
+	}
+
+	void run()
+	{
+		simple_mat<T, M, K> a0(arr_a);
+		simple_mat<T, K, L> b0(arr_b);
+		simple_mat<T, L, N> e0(arr_e);
+		simple_mat<T, M, L> t0(arr_t);
+		simple_mat<T, M, N> c0(arr_c0);
+
+		for (int i = 0; i < M * K; ++i) a0[i] = T(i + 1);
+		for (int i = 0; i < K * L; ++i) b0[i] = T(i + 2);
+		for (int i = 0; i < L * N; ++i) e0[i] = T(i % 3) - T(1);
+
+		// (a * b) * e
+
+		ref_mm(a0, b0, t0);
+		ref_mm(t0, e0, c0);
+
+		simd_mat<T, M, K, sse_kind> a( arr_a, aligned_t() );
+		simd_mat<T, K, L, sse_kind> b( arr_b, aligned_t() );
+		simd_mat<T, L, N, sse_kind> e( arr_e, aligned_t() );
+
+		simd_mat<T, M, N, sse_kind> c = a * b * e;
+		c.store( arr_cr, aligned_t() );
+		ASSERT_VEC_EQ( M * N, arr_c0, arr_cr );
+
+		(a * (b * e)).store( arr_cr, aligned_t() );
+		ASSERT_VEC_EQ( M * N, arr_c0, arr_cr );
+
+		// (a * b * e) * x, with x taken from the first column of e
+
+		simple_mat<T, N, 1> x0(arr_e);
+		simple_mat<T, M, 1> y0(arr_t);
+		ref_mm(c0, x0, y0);
+
+		simd_vec<T, N, sse_kind> x( arr_e, aligned_t() );
+		simd_vec<T, M, sse_kind> y = a * b * e * x;
+		y.store( arr_cr, aligned_t() );
+		ASSERT_VEC_EQ( M, arr_t, arr_cr );
+
+		simd_vec<T, M, sse_kind> z = y + a * b * e * x - a * (b * e) * x;
+		ASSERT_SIMD_EQ( z, arr_t );
+	}
+};
+
+
+class matchain_plan_tests : public test_case
+{
+public:
+	const char *name() const
+	{
+		return "chain plan";
+	}
+
+	void run()
+	{
+		typedef mexpr_leaf<f32, 2, 4, sse_kind> m24;
+		typedef mexpr_leaf<f32, 4, 3, sse_kind> m43;
+		typedef mexpr_leaf<f32, 3, 4, sse_kind> m34;
+		typedef mexpr_leaf<f32, 4, 4, sse_kind> m44;
+		typedef mexpr_vec<f32, 4, sse_kind> v4;
+
+		// (2 x 4) * (4 x 3) * (3 x 4): (a * b) * e takes 24 + 24
+
+		typedef mexpr_chain<mexpr_chain<m24, m43>, m34> c1;
+		ASSERT_EQ( c1::length, 3 );
+		ASSERT_EQ( (mexpr_plan<c1, 0, 2>::cost), 48 );
+		ASSERT_EQ( (mexpr_plan<c1, 0, 2>::split), 1 );
+
+		// (4 x 4) * (4 x 4) * (4 x 4) * x: right to left, 3 x 16
+
+		typedef mexpr_chain<mexpr_chain<mexpr_chain<m44, m44>, m44>, v4> c2;
+		ASSERT_EQ( c2::length, 4 );
+		ASSERT_EQ( (mexpr_plan<c2, 0, 3>::cost), 48 );
+		ASSERT_EQ( (mexpr_plan<c2, 0, 3>::split), 0 );
+		ASSERT_EQ( (mexpr_plan<c2, 1, 3>::split), 1 );
+		ASSERT_EQ( (mexpr_plan<c2, 2, 3>::split), 2 );
+
+		// (4 x 2) * (2 x 4) * (4 x 2): a * (b * e) takes 16 + 16
+
+		typedef mexpr_leaf<f32, 4, 2, sse_kind> m42;
+		typedef mexpr_chain<mexpr_chain<m42, m24>, m42> c3;
+		ASSERT_EQ( (mexpr_plan<c3, 0, 2>::cost), 32 );
+		ASSERT_EQ( (mexpr_plan<c3, 0, 2>::split), 0 );
+	}
+};
+
+
 template<typename T>
 void add_cases_to_matmul_tpack(test_pack* tp)
 {
@@ -157,6 +282,21 @@ void add_cases_to_matmul_tpack(test_pack* tp)
 }
 
 
+template<typename T>
+void add_cases_to_matchain_tpack(test_pack* tp)
+{
+	tp->add( new matchain_tests<T, 2, 2, 2, 2>() );
+	tp->add( new matchain_tests<T, 3, 3, 3, 3>() );
+	tp->add( new matchain_tests<T, 4, 4, 4, 4>() );
+
+	tp->add( new matchain_tests<T, 2, 4, 3, 4>() );
+	tp->add( new matchain_tests<T, 4, 2, 4, 2>() );
+	tp->add( new matchain_tests<T, 3, 4, 2, 3>() );
+	tp->add( new matchain_tests<T, 4, 3, 4, 3>() );
+	tp->add( new matchain_tests<T, 2, 3, 4, 2>() );
+}
+
+
 test_pack* matmul_tpack_f32()
 {
 	test_pack *tp = new test_pack( "matmul_f32" );
@@ -172,10 +312,28 @@ test_pack* matmul_tpack_f64()
 }
 
 
+test_pack* matchain_tpack_f32()
+{
+	test_pack *tp = new test_pack( "matchain_f32" );
+	tp->add( new matchain_plan_tests() );
+	add_cases_to_matchain_tpack<f32>(tp);
+	return tp;
+}
+
+test_pack* matchain_tpack_f64()
+{
+	test_pack *tp = new test_pack( "matchain_f64" );
+	add_cases_to_matchain_tpack<f64>(tp);
+	return tp;
+}
+
+
 void lsimd::add_test_packs()
 {
 	lsimd_main_suite.add( matmul_tpack_f32() );
 	lsimd_main_suite.add( matmul_tpack_f64() );
+	lsimd_main_suite.add( matchain_tpack_f32() );
+	lsimd_main_suite.add( matchain_tpack_f64() );
 }
 
 
@@ -0,0 +1,259 @@
+/**
+ * @file test_sse_normalize.cpp
+ *
+ * Test the correctness of standardization and layer/batch normalization
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+void ref_mean_var(int n, const T *x, int inc, double& mean, double& var)
+{
+	double s = 0;
+	for (int i = 0; i < n; ++i) s += double(x[i * inc]);
+	mean = n > 0 ? s / n : 0.0;
+
+	double s2 = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		const double d = double(x[i * inc]) - mean;
+		s2 += d * d;
+	}
+	var = n > 0 ? s2 / n : 0.0;
+}
+
+// y = (x - mean) / sqrt(var + eps) * g + b, with g = 1 and b = 0 if absent
+
+template<typename T>
+void ref_normalize(int n, const T *x, const T *g, const T *b, double eps, double *r)
+{
+	double mean, var;
+	ref_mean_var(n, x, 1, mean, var);
+
+	const double inv = 1.0 / std::sqrt(var + eps);
+	for (int i = 0; i < n; ++i)
+	{
+		r[i] = (double(x[i]) - mean) * inv;
+		if (g) r[i] = r[i] * double(g[i]) + double(b[i]);
+	}
+}
+
+template<typename T>
+inline double tol_of()
+{
+	return sizeof(T) == 4 ? 2.0e-5 : 1.0e-12;
+}
+
+template<typename T>
+bool vec_approx(int n, const T *y, const double *r, double tol)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		if (!(std::fabs(double(y[i]) - r[i]) <= tol * (std::fabs(r[i]) + 1.0))) return false;
+	}
+	return true;
+}
+
+const int MaxLen = 100;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( mean_var )
+{
+	T x[MaxLen];
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		fill_rand(n, x, T(-2), T(5));
+
+		T m, v;
+		double rm, rv;
+		mean_var(n, x, m, v);
+		ref_mean_var(n, x, 1, rm, rv);
+
+		ASSERT_TRUE( std::fabs(double(m) - rm) <= tol_of<T>() * 5.0 );
+		ASSERT_TRUE( std::fabs(double(v) - rv) <= tol_of<T>() * (rv + 1.0) );
+	}
+
+	// a large offset, which defeats the sum-of-squares formula in f32
+
+	const int n = 10000;
+	T *a = new T[n];
+	fill_rand(n, a, T(-1), T(1));
+	for (int i = 0; i < n; ++i) a[i] += T(10000);
+
+	T m, v;
+	double rm, rv;
+	mean_var(n, a, m, v);
+	ref_mean_var(n, a, 1, rm, rv);
+
+	ASSERT_TRUE( std::fabs(double(m) - rm) <= tol_of<T>() * rm );
+	ASSERT_TRUE( std::fabs(double(v) - rv) <= 1.0e-3 * rv );
+
+	delete[] a;
+}
+
+GCASE( standardize )
+{
+	T x[MaxLen];
+	T y[MaxLen];
+	T g[MaxLen];
+	T b[MaxLen];
+	double r[MaxLen];
+
+	const T eps = T(1.0e-5);
+
+	for (int n = 1; n <= MaxLen; ++n)
+	{
+		fill_rand(n, x, T(-3), T(7));
+		fill_rand(n, g, T(0.5), T(2));
+		fill_rand(n, b, T(-1), T(1));
+
+		ref_normalize(n, x, (const T*)0, (const T*)0, double(eps), r);
+		standardize(n, x, y, eps);
+		ASSERT_TRUE( vec_approx(n, y, r, tol_of<T>()) );
+
+		ref_normalize(n, x, g, b, double(eps), r);
+		layernorm(n, x, g, b, y, eps);
+		ASSERT_TRUE( vec_approx(n, y, r, tol_of<T>()) );
+
+		// in place
+
+		layernorm(n, x, g, b, x, eps);
+		ASSERT_TRUE( vec_approx(n, x, r, tol_of<T>()) );
+	}
+
+	// a constant array is mapped to zeros
+
+	for (int i = 0; i < MaxLen; ++i) x[i] = T(3);
+	standardize(MaxLen, x, y, eps);
+	for (int i = 0; i < MaxLen; ++i) ASSERT_EQ( y[i], T(0) );
+}
+
+GCASE( rows )
+{
+	// large enough for the _mt variants to go parallel
+
+	const int m = 301;
+	const int n = 229;
+	const int ldx = 232;
+	const int ldy = 230;
+	const T eps = T(1.0e-3);
+
+	T *x = new T[m * ldx];
+	T *y = new T[m * ldy];
+	T *y2 = new T[m * ldy];
+	T g[n];
+	T b[n];
+	double r[n];
+
+	fill_rand(m * ldx, x, T(-4), T(9));
+	fill_rand(n, g, T(0.5), T(2));
+	fill_rand(n, b, T(-1), T(1));
+
+	standardize_rows(m, n, x, ldx, y, ldy, eps);
+	standardize_rows_mt(m, n, x, ldx, y2, ldy, eps);
+	for (int i = 0; i < m; ++i)
+	{
+		ref_normalize(n, x + i * ldx, (const T*)0, (const T*)0, double(eps), r);
+		ASSERT_TRUE( vec_approx(n, y + i * ldy, r, tol_of<T>()) );
+		ASSERT_VEC_EQ( n, y2 + i * ldy, y + i * ldy );
+	}
+
+	layernorm_rows(m, n, x, ldx, g, b, y, ldy, eps);
+	layernorm_rows_mt(m, n, x, ldx, g, b, y2, ldy, eps);
+	for (int i = 0; i < m; ++i)
+	{
+		ref_normalize(n, x + i * ldx, g, b, double(eps), r);
+		ASSERT_TRUE( vec_approx(n, y + i * ldy, r, tol_of<T>()) );
+		ASSERT_VEC_EQ( n, y2 + i * ldy, y + i * ldy );
+	}
+
+	delete[] y2;
+	delete[] y;
+	delete[] x;
+}
+
+GCASE( batchnorm )
+{
+	const int m = 29;
+	const int n = 23;
+	const int ldx = 25;
+	const int ldy = 24;
+	const T eps = T(1.0e-3);
+
+	T *x = new T[m * ldx];
+	T *y = new T[m * ldy];
+	T mean[n];
+	T var[n];
+	T g[n];
+	T b[n];
+
+	fill_rand(m * ldx, x, T(-4), T(9));
+	for (int i = 0; i < m * ldx; ++i) x[i] += T(100);
+	fill_rand(n, g, T(0.5), T(2));
+	fill_rand(n, b, T(-1), T(1));
+
+	mean_var_cols(m, n, x, ldx, mean, var);
+	batchnorm(m, n, x, ldx, mean, var, g, b, y, ldy, eps);
+
+	for (int j = 0; j < n; ++j)
+	{
+		double rm, rv;
+		ref_mean_var(m, x + j, ldx, rm, rv);
+
+		ASSERT_TRUE( std::fabs(double(mean[j]) - rm) <= tol_of<T>() * rm );
+		ASSERT_TRUE( std::fabs(double(var[j]) - rv) <= tol_of<T>() * 10.0 * rv );
+
+		const double a = double(g[j]) / std::sqrt(rv + double(eps));
+		for (int i = 0; i < m; ++i)
+		{
+			const double ri = (double(x[i * ldx + j]) - rm) * a + double(b[j]);
+			ASSERT_TRUE( std::fabs(double(y[i * ldy + j]) - ri) <= tol_of<T>() * 10.0 * (std::fabs(ri) + 1.0) );
+		}
+	}
+
+	delete[] y;
+	delete[] x;
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( mean_var );
+	ADD_TEST( standardize );
+	ADD_TEST( rows );
+	ADD_TEST( batchnorm );
+}
@@ -0,0 +1,497 @@
+/**
+ * @file test_sse_quat.cpp
+ *
+ * Test the correctness of sse_quat classes and quaternion array functions
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+
+using namespace lsimd;
+using namespace ltest;
+
+// explicit instantiation for thorough syntax check
+
+template struct lsimd::simd_quat<f32, sse_kind>;
+template struct lsimd::simd_quat<f64, sse_kind>;
+
+template struct lsimd::simd_quat_pack<f32, sse_kind>;
+template struct lsimd::simd_quat_pack<f64, sse_kind>;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+inline void ref_qmul(const T *a, const T *b, T *r)
+{
+	r[0] = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+	r[1] = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+	r[2] = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+	r[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+}
+
+template<typename T>
+inline void ref_qrotate(const T *q, const T *v, T *r)
+{
+	// r = q * (v, 0) * conj(q)
+
+	T qv[4] = {v[0], v[1], v[2], T(0)};
+	T qc[4] = {-q[0], -q[1], -q[2], q[3]};
+	T t[4];
+	T u[4];
+	ref_qmul(q, qv, t);
+	ref_qmul(t, qc, u);
+
+	r[0] = u[0];
+	r[1] = u[1];
+	r[2] = u[2];
+}
+
+template<typename T>
+inline void rand_unit_quat(T *q)
+{
+	double s = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		q[i] = rand_val(T(-1), T(1));
+		s += double(q[i]) * double(q[i]);
+	}
+
+	s = 1.0 / std::sqrt(s);
+	for (int i = 0; i < 4; ++i) q[i] = T(q[i] * s);
+}
+
+template<typename T>
+inline T qtol()
+{
+	return sizeof(T) == 4 ? T(1.0e-5) : T(1.0e-12);
+}
+
+
+/************************************************
+ *
+ *  basic
+ *
+ ************************************************/
+
+GCASE( zero )
+{
+	T r[4] = {T(0), T(0), T(0), T(0)};
+
+	simd_quat<T, sse_kind> q = zero_t();
+	ASSERT_SIMD_EQ( q, r );
+}
+
+GCASE( load_store )
+{
+	LSIMD_ALIGN_SSE T a[5] = {T(1), T(2), T(3), T(4), T(5)};
+
+	simd_quat<T, sse_kind> qa(a, aligned_t());
+	ASSERT_SIMD_EQ( qa, a );
+
+	simd_quat<T, sse_kind> qu(a + 1, unaligned_t());
+	ASSERT_SIMD_EQ( qu, a + 1 );
+
+	simd_quat<T, sse_kind> qe(T(1), T(2), T(3), T(4));
+	ASSERT_SIMD_EQ( qe, a );
+
+	ASSERT_EQ( qe.x(), T(1) );
+	ASSERT_EQ( qe.y(), T(2) );
+	ASSERT_EQ( qe.z(), T(3) );
+	ASSERT_EQ( qe.w(), T(4) );
+
+	LSIMD_ALIGN_SSE T b[4] = {T(-1), T(-1), T(-1), T(-1)};
+	qa.store(b, aligned_t());
+	ASSERT_VEC_EQ( 4, a, b );
+
+	T c[5] = {T(-1), T(-1), T(-1), T(-1), T(-1)};
+	qa.store(c + 1, unaligned_t());
+	ASSERT_VEC_EQ( 4, a, c + 1 );
+
+	T r1[4] = {T(0), T(0), T(0), T(1)};
+	simd_quat<T, sse_kind> qi = simd_quat<T, sse_kind>::identity();
+	ASSERT_SIMD_EQ( qi, r1 );
+}
+
+GCASE( conj )
+{
+	simd_quat<T, sse_kind> q(T(1), T(-2), T(3), T(4));
+	T r[4] = {T(-1), T(2), T(-3), T(4)};
+
+	ASSERT_SIMD_EQ( q.conj(), r );
+}
+
+GCASE( dot )
+{
+	simd_quat<T, sse_kind> a(T(1), T(2), T(3), T(4));
+	simd_quat<T, sse_kind> b(T(5), T(-6), T(7), T(2));
+
+	ASSERT_EQ( a.dot(b), T(5 - 12 + 21 + 8) );
+}
+
+
+/************************************************
+ *
+ *  composition and normalization
+ *
+ ************************************************/
+
+GCASE( mul )
+{
+	T a[4] = {T(1), T(2), T(3), T(4)};
+	T b[4] = {T(-2), T(5), T(1), T(3)};
+	T r[4];
+	ref_qmul(a, b, r);
+
+	simd_quat<T, sse_kind> qa(a, unaligned_t());
+	simd_quat<T, sse_kind> qb(b, unaligned_t());
+
+	ASSERT_SIMD_EQ( qa * qb, r );
+
+	ref_qmul(b, a, r);
+	ASSERT_SIMD_EQ( qb * qa, r );
+
+	simd_quat<T, sse_kind> qi = simd_quat<T, sse_kind>::identity();
+	ASSERT_SIMD_EQ( qa * qi, a );
+	ASSERT_SIMD_EQ( qi * qa, a );
+}
+
+GCASE( normalize )
+{
+	T a[4] = {T(1), T(2), T(-2), T(4)};
+	T r[4] = {T(0.2), T(0.4), T(-0.4), T(0.8)};
+
+	simd_quat<T, sse_kind> q(a, unaligned_t());
+	T b[4];
+	q.normalized().store(b, unaligned_t());
+
+	ASSERT_VEC_APPROX( 4, b, r, qtol<T>() );
+}
+
+
+/************************************************
+ *
+ *  rotation
+ *
+ ************************************************/
+
+GCASE( rotate )
+{
+	for (int k = 0; k < 20; ++k)
+	{
+		T q[4];
+		rand_unit_quat(q);
+
+		T v[3];
+		fill_rand(3, v, T(-2), T(2));
+
+		T r0[3];
+		ref_qrotate(q, v, r0);
+
+		simd_quat<T, sse_kind> sq(q, unaligned_t());
+		simd_vec<T, 3, sse_kind> sv(v, unaligned_t());
+
+		T r[3];
+		sq.rotate(sv).store(r, unaligned_t());
+
+		ASSERT_VEC_APPROX( 3, r, r0, 4 * qtol<T>() );
+	}
+}
+
+GCASE( to_mat )
+{
+	for (int k = 0; k < 20; ++k)
+	{
+		T q[4];
+		rand_unit_quat(q);
+
+		T v[3];
+		fill_rand(3, v, T(-2), T(2));
+
+		T r0[3];
+		ref_qrotate(q, v, r0);
+
+		simd_quat<T, sse_kind> sq(q, unaligned_t());
+		simd_vec<T, 3, sse_kind> sv(v, unaligned_t());
+
+		T r[3];
+		(sq.to_mat() * sv).store(r, unaligned_t());
+
+		ASSERT_VEC_APPROX( 3, r, r0, 4 * qtol<T>() );
+	}
+}
+
+GCASE( from_mat )
+{
+	for (int k = 0; k < 20; ++k)
+	{
+		T q[4];
+		rand_unit_quat(q);
+
+		// the four branches of the conversion are hit by
+		// making different entries dominant
+
+		if (k % 4 < 3)
+		{
+			q[k % 4] *= T(4);
+			T s = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+			for (int i = 0; i < 4; ++i) q[i] /= s;
+		}
+
+		simd_quat<T, sse_kind> sq(q, unaligned_t());
+		simd_quat<T, sse_kind> sq2(sq.to_mat());
+
+		T r[4];
+		sq2.store(r, unaligned_t());
+
+		if (r[0] * q[0] + r[1] * q[1] + r[2] * q[2] + r[3] * q[3] < T(0))
+		{
+			for (int i = 0; i < 4; ++i) r[i] = -r[i];
+		}
+
+		ASSERT_VEC_APPROX( 4, r, q, 4 * qtol<T>() );
+	}
+}
+
+
+/************************************************
+ *
+ *  interpolation
+ *
+ ************************************************/
+
+GCASE( nlerp )
+{
+	const double th = 0.6;
+	const double s = std::sin(th);
+	const double c = std::cos(th);
+
+	simd_quat<T, sse_kind> a(T(0), T(0), T(0), T(1));
+	simd_quat<T, sse_kind> b(T(s), T(0), T(0), T(c));
+
+	const double h = 1.0 / std::sqrt(s * s + (1 + c) * (1 + c));
+
+	T r[4];
+	T r0[4] = {T(s * h), T(0), T(0), T((1 + c) * h)};
+	nlerp(a, b, T(0.5)).store(r, unaligned_t());
+	ASSERT_VEC_APPROX( 4, r, r0, qtol<T>() );
+
+	// takes the shorter arc
+	nlerp(a, -b, T(0.5)).store(r, unaligned_t());
+	ASSERT_VEC_APPROX( 4, r, r0, qtol<T>() );
+}
+
+GCASE( slerp )
+{
+	// rotations around the z axis by 0 and 2 * theta
+
+	const double th = 0.6;
+
+	simd_quat<T, sse_kind> a(T(0), T(0), T(0), T(1));
+	simd_quat<T, sse_kind> b(T(0), T(0), T(std::sin(th)), T(std::cos(th)));
+
+	T r[4];
+	const T ts[3] = {T(0.0), T(0.25), T(1.0)};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		double ht = th * double(ts[i]);
+		T r0[4] = {T(0), T(0), T(std::sin(ht)), T(std::cos(ht))};
+
+		slerp(a, b, ts[i]).store(r, unaligned_t());
+		ASSERT_VEC_APPROX( 4, r, r0, qtol<T>() );
+
+		slerp(a, -b, ts[i]).store(r, unaligned_t());
+		ASSERT_VEC_APPROX( 4, r, r0, qtol<T>() );
+	}
+
+	// nearly parallel inputs
+	slerp(a, a, T(0.3)).store(r, unaligned_t());
+	T r1[4] = {T(0), T(0), T(0), T(1)};
+	ASSERT_VEC_APPROX( 4, r, r1, qtol<T>() );
+}
+
+
+/************************************************
+ *
+ *  array functions
+ *
+ ************************************************/
+
+const int QArrLen = 11;
+const int QLd = 13;
+
+GCASE( array_mul )
+{
+	T a[4 * QLd];
+	T b[4 * QLd];
+	T r[4 * QLd];
+
+	fill_rand(4 * QLd, a, T(-1), T(1));
+	fill_rand(4 * QLd, b, T(-1), T(1));
+
+	quat_mul(QArrLen, a, QLd, b, QLd, r, QLd);
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		T qa[4] = {a[i], a[QLd + i], a[2 * QLd + i], a[3 * QLd + i]};
+		T qb[4] = {b[i], b[QLd + i], b[2 * QLd + i], b[3 * QLd + i]};
+		T qr[4] = {r[i], r[QLd + i], r[2 * QLd + i], r[3 * QLd + i]};
+		T qr0[4];
+		ref_qmul(qa, qb, qr0);
+
+		ASSERT_VEC_APPROX( 4, qr, qr0, qtol<T>() );
+	}
+}
+
+GCASE( array_normalize )
+{
+	T a[4 * QLd];
+	T r[4 * QLd];
+
+	fill_rand(4 * QLd, a, T(0.5), T(2));
+
+	quat_normalize(QArrLen, a, QLd, r, QLd);
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		T s = T(0);
+		for (int j = 0; j < 4; ++j) s += a[j * QLd + i] * a[j * QLd + i];
+		s = std::sqrt(s);
+
+		T ri[4] = {r[i], r[QLd + i], r[2 * QLd + i], r[3 * QLd + i]};
+		T ri0[4] = {a[i] / s, a[QLd + i] / s, a[2 * QLd + i] / s, a[3 * QLd + i] / s};
+
+		ASSERT_VEC_APPROX( 4, ri, ri0, qtol<T>() );
+	}
+}
+
+GCASE( array_rotate )
+{
+	T q[4 * QLd];
+	T v[3 * QLd];
+	T r[3 * QLd];
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		T qi[4];
+		rand_unit_quat(qi);
+		for (int j = 0; j < 4; ++j) q[j * QLd + i] = qi[j];
+	}
+	fill_rand(3 * QLd, v, T(-2), T(2));
+
+	quat_rotate(QArrLen, q, QLd, v, QLd, r, QLd);
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		T qi[4] = {q[i], q[QLd + i], q[2 * QLd + i], q[3 * QLd + i]};
+		T vi[3] = {v[i], v[QLd + i], v[2 * QLd + i]};
+		T ri[3] = {r[i], r[QLd + i], r[2 * QLd + i]};
+		T ri0[3];
+		ref_qrotate(qi, vi, ri0);
+
+		ASSERT_VEC_APPROX( 3, ri, ri0, 4 * qtol<T>() );
+	}
+}
+
+GCASE( array_interp )
+{
+	T a[4 * QLd];
+	T b[4 * QLd];
+	T r[4 * QLd];
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		T qa[4];
+		T qb[4];
+		rand_unit_quat(qa);
+		rand_unit_quat(qb);
+
+		// make some pairs nearly parallel
+		if (i % 3 == 0)
+		{
+			for (int j = 0; j < 4; ++j) qb[j] = qa[j];
+		}
+
+		for (int j = 0; j < 4; ++j)
+		{
+			a[j * QLd + i] = qa[j];
+			b[j * QLd + i] = qb[j];
+		}
+	}
+
+	const T t = T(0.3);
+
+	quat_slerp(QArrLen, a, QLd, b, QLd, t, r, QLd);
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		simd_quat<T, sse_kind> qa(a[i], a[QLd + i], a[2 * QLd + i], a[3 * QLd + i]);
+		simd_quat<T, sse_kind> qb(b[i], b[QLd + i], b[2 * QLd + i], b[3 * QLd + i]);
+
+		T r0[4];
+		T ri[4] = {r[i], r[QLd + i], r[2 * QLd + i], r[3 * QLd + i]};
+		slerp(qa, qb, t).store(r0, unaligned_t());
+
+		ASSERT_VEC_APPROX( 4, ri, r0, 4 * qtol<T>() );
+	}
+
+	quat_nlerp(QArrLen, a, QLd, b, QLd, t, r, QLd);
+
+	for (int i = 0; i < QArrLen; ++i)
+	{
+		simd_quat<T, sse_kind> qa(a[i], a[QLd + i], a[2 * QLd + i], a[3 * QLd + i]);
+		simd_quat<T, sse_kind> qb(b[i], b[QLd + i], b[2 * QLd + i], b[3 * QLd + i]);
+
+		T r0[4];
+		T ri[4] = {r[i], r[QLd + i], r[2 * QLd + i], r[3 * QLd + i]};
+		nlerp(qa, qb, t).store(r0, unaligned_t());
+
+		ASSERT_VEC_APPROX( 4, ri, r0, 4 * qtol<T>() );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( zero );
+	ADD_TEST( load_store );
+	ADD_TEST( conj );
+	ADD_TEST( dot );
+
+	ADD_TEST( mul );
+	ADD_TEST( normalize );
+
+	ADD_TEST( rotate );
+	ADD_TEST( to_mat );
+	ADD_TEST( from_mat );
+
+	ADD_TEST( nlerp );
+	ADD_TEST( slerp );
+
+	ADD_TEST( array_mul );
+	ADD_TEST( array_normalize );
+	ADD_TEST( array_rotate );
+	ADD_TEST( array_interp );
+}
+
@@ -0,0 +1,360 @@
+/**
+ * @file test_sse_rand.cpp
+ *
+ * Test the correctness of the random number generators
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+inline void ref_philox(const u32 *ctr, const u32 *key, u32 *out)
+{
+	u32 c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+	u32 k0 = key[0];
+	u32 k1 = key[1];
+
+	for (int r = 0; r < 10; ++r)
+	{
+		u64 p0 = (u64)0xD2511F53u * c[0];
+		u64 p1 = (u64)0xCD9E8D57u * c[2];
+
+		u32 t[4];
+		t[0] = (u32)(p1 >> 32) ^ c[1] ^ k0;
+		t[1] = (u32)p1;
+		t[2] = (u32)(p0 >> 32) ^ c[3] ^ k1;
+		t[3] = (u32)p0;
+		for (int i = 0; i < 4; ++i) c[i] = t[i];
+
+		k0 += 0x9E3779B9u;
+		k1 += 0xBB67AE85u;
+	}
+
+	for (int i = 0; i < 4; ++i) out[i] = c[i];
+}
+
+// the first n words of the stream, starting from the k-th block
+
+void ref_philox_stream(u64 seed, u64 stream, u64 k, int n, u32 *out)
+{
+	const u32 key[2] = {(u32)seed, (u32)(seed >> 32)};
+
+	for (int i = 0; i < n; i += 4, ++k)
+	{
+		const u32 ctr[4] = {(u32)k, (u32)(k >> 32), (u32)stream, (u32)(stream >> 32)};
+		u32 b[4];
+		ref_philox(ctr, key, b);
+		for (int j = 0; j < 4 && i + j < n; ++j) out[i + j] = b[j];
+	}
+}
+
+void ref_xoshiro_stream(u64 seed, int n, u32 *out)
+{
+	u32 s[8][4];
+	for (int l = 0; l < 8; ++l)
+	{
+		u64 a = xoshiro128p::_splitmix64(seed);
+		u64 b = xoshiro128p::_splitmix64(seed);
+		s[l][0] = (u32)a;
+		s[l][1] = (u32)(a >> 32);
+		s[l][2] = (u32)b;
+		s[l][3] = (u32)(b >> 32);
+	}
+
+	for (int i = 0; i < n; ++i)
+	{
+		u32 *q = s[i % 8];
+		out[i] = q[0] + q[3];
+
+		const u32 t = q[1] << 9;
+		q[2] ^= q[0];
+		q[3] ^= q[1];
+		q[1] ^= q[2];
+		q[0] ^= q[3];
+		q[2] ^= t;
+		q[3] = (q[3] << 11) | (q[3] >> 21);
+	}
+}
+
+inline f32 ref_uniform(const u32 *w, f32)
+{
+	return f32(w[0] >> 8) * 5.9604644775390625e-8f;
+}
+
+inline f64 ref_uniform(const u32 *w, f64)
+{
+	return (f64(w[1] >> 12) * 4294967296.0 + f64(w[0])) * 2.220446049250313080847e-16;
+}
+
+const int MaxLen = 100;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+template<typename T> class philox_tests;
+
+SCASE( philox, u32 )
+{
+	// known-answer tests of Random123
+
+	const u32 c0[4] = {0u, 0u, 0u, 0u};
+	const u32 r0[4] = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+
+	const u32 c1[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+	const u32 k1[2] = {0xa4093822u, 0x299f31d0u};
+	const u32 r1[4] = {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u};
+
+	u32 b[4];
+	ref_philox(c0, c0, b);
+	ASSERT_VEC_EQ( 4, b, r0 );
+
+	ref_philox(c1, k1, b);
+	ASSERT_VEC_EQ( 4, b, r1 );
+
+	philox4x32 g0;
+	ASSERT_SIMD_EQ( g0.next(), r0 );
+
+	philox4x32 g1(0x299f31d0a4093822ull, 0x0370734413198a2eull);
+	g1.set_counter(0x85a308d3243f6a88ull);
+	ASSERT_SIMD_EQ( g1.next(), r1 );
+
+	// streams
+
+	u32 r[MaxLen];
+	u32 x[MaxLen];
+
+	ref_philox_stream(12345, 7, 0, MaxLen, r);
+
+	philox4x32 g(12345, 7);
+	for (int i = 0; i < MaxLen; i += 4)
+	{
+		ASSERT_SIMD_EQ( g.next(), r + i );
+	}
+
+	g.seed(12345, 7);
+	g.next();
+	g.next();
+	g.next_block(x);
+	ASSERT_VEC_EQ( rand_block_size, x, r + 8 );
+
+	g.seed(12345, 7);
+	g.next();
+	g.next_blocks(x, 3);
+	ASSERT_VEC_EQ( 3 * rand_block_size, x, r + 4 );
+	ASSERT_SIMD_EQ( g.next(), r + 52 );
+
+	// a carry into the higher word of the counter
+
+	ref_philox_stream(99, 0, 0xFFFFFFFEull, 16, r);
+	g.seed(99);
+	g.set_counter(0xFFFFFFFEull);
+	g.next_block(x);
+	ASSERT_VEC_EQ( 16, x, r );
+}
+
+template<typename T> class xoshiro_tests;
+
+SCASE( xoshiro, u32 )
+{
+	u32 r[MaxLen];
+	u32 x[MaxLen];
+
+	ref_xoshiro_stream(2012, MaxLen, r);
+
+	xoshiro128p g(2012);
+	for (int i = 0; i < MaxLen; i += 4)
+	{
+		ASSERT_SIMD_EQ( g.next(), r + i );
+	}
+
+	g.seed(2012);
+	g.next();
+	g.next_block(x);
+	ASSERT_VEC_EQ( rand_block_size, x, r + 4 );
+
+	g.seed(2012);
+	g.next();
+	g.next();
+	g.next_blocks(x, 4);
+	ASSERT_VEC_EQ( 4 * rand_block_size, x, r + 8 );
+	ASSERT_SIMD_EQ( g.next(), r + 72 );
+}
+
+template<typename T> class fill_words_tests;
+
+SCASE( fill_words, u32 )
+{
+	u32 r[MaxLen + rand_block_size];
+	u32 x[MaxLen];
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		ref_philox_stream(5, 0, 0, MaxLen + rand_block_size, r);
+
+		philox4x32 g(5);
+		fill(g, n, x);
+		ASSERT_VEC_EQ( n, x, r );
+
+		// the remaining part of the last block is discarded
+
+		const int nb = (n + rand_block_size - 1) / rand_block_size;
+		ASSERT_SIMD_EQ( g.next(), r + nb * rand_block_size );
+	}
+}
+
+GCASE( uniform )
+{
+	const int w = (int)simd_pack<T>::pack_width;
+	const int m = 4 / w;  // words per value
+
+	u32 s[MaxLen * 2 + rand_block_size];
+	T r[MaxLen];
+	T x[MaxLen];
+
+	ref_philox_stream(17, 3, 0, MaxLen * 2 + rand_block_size, s);
+
+	for (int i = 0; i < MaxLen; ++i) r[i] = ref_uniform(s + i * m, T());
+
+	// packs
+
+	philox4x32 g(17, 3);
+	for (int i = 0; i + w <= MaxLen; i += w)
+	{
+		ASSERT_SIMD_EQ( uniform<T>(g), r + i );
+	}
+
+	// arrays
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		g.seed(17, 3);
+		fill_uniform(g, n, x, T(0), T(1));
+		ASSERT_VEC_EQ( n, x, r );
+	}
+
+	g.seed(17, 3);
+	fill_uniform(g, MaxLen, x, T(-2), T(3));
+	for (int i = 0; i < MaxLen; ++i)
+	{
+		const double e = std::fabs(double(x[i]) - double(r[i] * T(5) + T(-2)));
+		ASSERT_TRUE( e <= (sizeof(T) == 4 ? 1.0e-6 : 1.0e-15) );
+	}
+
+	// range
+
+	const int n = 10000;
+	T *a = new T[n];
+	xoshiro128p gx(1);
+	fill_uniform(gx, n, a, T(0), T(1));
+
+	double mean = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		ASSERT_TRUE( a[i] >= T(0) && a[i] < T(1) );
+		mean += a[i];
+	}
+	mean /= n;
+	delete[] a;
+
+	ASSERT_TRUE( std::fabs(mean - 0.5) < 0.02 );
+}
+
+GCASE( normal )
+{
+	const int m = rand_block_size * sizeof(f32) / sizeof(T);  // values per block
+	const int h = m / 2;
+	const double tol = sizeof(T) == 4 ? 1.0e-4 : 1.0e-11;
+
+	u32 s[MaxLen * 2 + rand_block_size];
+	T r[MaxLen + rand_block_size];
+	T x[MaxLen];
+
+	ref_philox_stream(23, 0, 0, MaxLen * 2 + rand_block_size, s);
+
+	const int wpv = rand_block_size / m;
+	for (int b = 0; b < MaxLen; b += m)
+	{
+		for (int i = 0; i < h; ++i)
+		{
+			double u1 = (double)ref_uniform(s + (b + i) * wpv, T());
+			double u2 = (double)ref_uniform(s + (b + h + i) * wpv, T());
+			double rho = std::sqrt(-2.0 * std::log(1.0 - u1));
+			double theta = 6.283185307179586 * u2;
+
+			r[b + i] = T(1) + T(2) * T(rho * std::cos(theta));
+			r[b + h + i] = T(1) + T(2) * T(rho * std::sin(theta));
+		}
+	}
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		philox4x32 g(23);
+		fill_normal(g, n, x, T(1), T(2));
+		for (int i = 0; i < n; ++i)
+		{
+			ASSERT_TRUE( std::fabs(double(x[i]) - double(r[i])) <= tol );
+		}
+	}
+
+	// moments
+
+	const int n = 100000;
+	T *a = new T[n];
+	xoshiro128p gx(7);
+	fill_normal(gx, n, a, T(0), T(1));
+
+	double s1 = 0;
+	double s2 = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		s1 += a[i];
+		s2 += double(a[i]) * double(a[i]);
+	}
+	delete[] a;
+
+	const double mean = s1 / n;
+	const double var = s2 / n - mean * mean;
+	ASSERT_TRUE( std::fabs(mean) < 0.02 );
+	ASSERT_TRUE( std::fabs(var - 1.0) < 0.02 );
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	test_pack *tp = new test_pack( "words" );
+	tp->add( new philox_tests<u32>() );
+	tp->add( new xoshiro_tests<u32>() );
+	tp->add( new fill_words_tests<u32>() );
+	lsimd_main_suite.add( tp );
+
+	ADD_TEST( uniform );
+	ADD_TEST( normal );
+}
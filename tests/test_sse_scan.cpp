@@ -0,0 +1,185 @@
+/**
+ * @file test_sse_scan.cpp
+ *
+ * Test the correctness of in-register and array prefix sums
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  auxiliary functions
+ *
+ ************************************************/
+
+// y[i] = init + x[0] + ... + x[i] (or x[i-1]) in double precision
+
+void ref_scan(int n, const double *x, double *y, double init, bool incl)
+{
+	double s = init;
+	for (int i = 0; i < n; ++i)
+	{
+		if (incl) s += x[i];
+		y[i] = s;
+		if (!incl) s += x[i];
+	}
+}
+
+template<typename T>
+inline double tol_of()
+{
+	return sizeof(T) == 4 ? 1.0e-6 : 1.0e-14;
+}
+
+template<typename T>
+bool scan_ok(int n, const T *x, const T *y, T r, T init, bool incl, bool exact)
+{
+	std::vector<double> dx((size_t)n + 1), dy((size_t)n + 1);
+	double ds = double(init), da = std::fabs(double(init));
+
+	for (int i = 0; i < n; ++i)
+	{
+		dx[i] = double(x[i]);
+		ds += dx[i];
+		da += std::fabs(dx[i]);
+	}
+	ref_scan(n, &dx[0], &dy[0], double(init), incl);
+
+	const double tol = exact ? 0.0 : tol_of<T>() * (da + 1.0) * 4;
+
+	for (int i = 0; i < n; ++i)
+	{
+		if (!(std::fabs(double(y[i]) - dy[i]) <= tol)) return false;
+	}
+	return std::fabs(double(r) - ds) <= tol;
+}
+
+template<typename T>
+bool test_scan(int n, bool incl, bool mt, bool ints)
+{
+	std::vector<T> x((size_t)n + 1), y((size_t)n + 1);
+
+	if (ints)
+		fill_rand_int(n, &x[0], -100, 99);    // all prefix sums are exact
+	else
+		fill_rand(n, &x[0], T(-1), T(1));
+
+	const T init = T(7);
+	T r;
+
+	if (incl)
+		r = mt ? inclusive_scan_mt(n, &x[0], &y[0], init) : inclusive_scan(n, &x[0], &y[0], init);
+	else
+		r = mt ? exclusive_scan_mt(n, &x[0], &y[0], init) : exclusive_scan(n, &x[0], &y[0], init);
+
+	if (!scan_ok(n, &x[0], &y[0], r, init, incl, ints)) return false;
+
+	// in place
+
+	std::vector<T> z(x);
+
+	if (incl)
+		r = mt ? inclusive_scan_mt(n, &z[0], &z[0], init) : inclusive_scan(n, &z[0], &z[0], init);
+	else
+		r = mt ? exclusive_scan_mt(n, &z[0], &z[0], init) : exclusive_scan(n, &z[0], &z[0], init);
+
+	return scan_ok(n, &x[0], &z[0], r, init, incl, ints);
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( prefix_sum )
+{
+	const int w = (int)simd_pack<T>::pack_width;
+
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(-2), T(5), T(10)};
+	LSIMD_ALIGN_SSE T r[4];
+	T e[4];
+
+	T s(0);
+	for (int i = 0; i < w; ++i) e[i] = (s += a[i]);
+
+	prefix_sum(simd_pack<T>(a, aligned_t())).store(r, aligned_t());
+	ASSERT_VEC_EQ( w, r, e );
+}
+
+GCASE( inclusive_scan )
+{
+	for (int n = 0; n <= 100; ++n)
+	{
+		ASSERT_TRUE( test_scan<T>(n, true, false, false) );
+		ASSERT_TRUE( test_scan<T>(n, true, false, true) );
+	}
+
+	ASSERT_TRUE( test_scan<T>(100003, true, false, false) );
+	ASSERT_TRUE( test_scan<T>(100003, true, false, true) );
+}
+
+GCASE( exclusive_scan )
+{
+	for (int n = 0; n <= 100; ++n)
+	{
+		ASSERT_TRUE( test_scan<T>(n, false, false, false) );
+		ASSERT_TRUE( test_scan<T>(n, false, false, true) );
+	}
+
+	ASSERT_TRUE( test_scan<T>(100003, false, false, false) );
+	ASSERT_TRUE( test_scan<T>(100003, false, false, true) );
+}
+
+GCASE( scan_mt )
+{
+	// a single block, a partial last block, enough blocks to go parallel,
+	// and more than two groups of blocks (with a partial last group), such
+	// that the sums are carried across the groups
+
+	const int bs = scan_blocking<T>::mt_block;
+	const int gs = scan_blocking<T>::mt_group;
+	const int ns[5] = {100, bs, 3 * bs + 17, scan_blocking<T>::mt_threshold + 5, 2 * bs * gs + 3 * bs + 17};
+
+	for (int k = 0; k < 5; ++k)
+	{
+		ASSERT_TRUE( test_scan<T>(ns[k], true, true, false) );
+		ASSERT_TRUE( test_scan<T>(ns[k], true, true, true) );
+		ASSERT_TRUE( test_scan<T>(ns[k], false, true, false) );
+		ASSERT_TRUE( test_scan<T>(ns[k], false, true, true) );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+	tp->add( new H<i32>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( prefix_sum );
+	ADD_TEST( inclusive_scan );
+	ADD_TEST( exclusive_scan );
+	ADD_TEST( scan_mt );
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_sse_softmax.cpp
+ *
+ * Test the correctness of softmax and log-sum-exp
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <cmath>
+#include <limits>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+template<typename T>
+double ref_logsumexp(int n, const T *x)
+{
+	double m = -std::numeric_limits<double>::infinity();
+	for (int i = 0; i < n; ++i) if (double(x[i]) > m) m = double(x[i]);
+
+	double s = 0;
+	for (int i = 0; i < n; ++i) s += std::exp(double(x[i]) - m);
+	return m + std::log(s);
+}
+
+template<typename T>
+void ref_softmax(int n, const T *x, double *r)
+{
+	const double l = ref_logsumexp(n, x);
+	for (int i = 0; i < n; ++i) r[i] = std::exp(double(x[i]) - l);
+}
+
+template<typename T>
+inline double rel_tol()
+{
+	return sizeof(T) == 4 ? 1.0e-5 : 1.0e-13;
+}
+
+template<typename T>
+bool softmax_ok(int n, const T *y, const double *r)
+{
+	const double tol = rel_tol<T>();
+	for (int i = 0; i < n; ++i)
+	{
+		if (!(std::fabs(double(y[i]) - r[i]) <= tol * r[i] + 1.0e-300)) return false;
+	}
+	return true;
+}
+
+template<typename T>
+bool logsumexp_ok(T v, double r)
+{
+	// the absolute error of log(s) is the relative error of s
+	return std::fabs(double(v) - r) <= rel_tol<T>() * (std::fabs(r) + 1.0);
+}
+
+const int MaxLen = 100;
+const int LongLen = 32768;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( logsumexp )
+{
+	T x[MaxLen];
+
+	for (int n = 1; n <= MaxLen; ++n)
+	{
+		fill_rand(n, x, T(-20), T(20));
+		const double r = ref_logsumexp(n, x);
+
+		ASSERT_TRUE( logsumexp_ok(logsumexp(n, x), r) );
+		ASSERT_TRUE( logsumexp_ok(logsumexp_online(n, x), r) );
+	}
+
+	// empty arrays
+
+	const T ninf = -std::numeric_limits<T>::infinity();
+	ASSERT_EQ( logsumexp(0, x), ninf );
+	ASSERT_EQ( logsumexp_online(0, x), ninf );
+
+	// long rows, with the maximum growing along the row
+
+	T *a = new T[LongLen];
+	fill_rand(LongLen, a, T(-20), T(20));
+	for (int i = 0; i < LongLen; ++i) a[i] += T(i) * T(0.01);
+
+	const double rl = ref_logsumexp(LongLen, a);
+	ASSERT_TRUE( logsumexp_ok(logsumexp(LongLen, a), rl) );
+	ASSERT_TRUE( logsumexp_ok(logsumexp_online(LongLen, a), rl) );
+
+	delete[] a;
+}
+
+GCASE( logsumexp_stable )
+{
+	T x[MaxLen];
+
+	for (int n = 1; n <= MaxLen; ++n)
+	{
+		// exp would overflow (or underflow) without the shift
+
+		const double c = (n % 2) ? 1000.0 : -1000.0;
+		fill_rand(n, x, T(c - 20.0), T(c + 20.0));
+
+		const double r = ref_logsumexp(n, x);
+		ASSERT_TRUE( logsumexp_ok(logsumexp(n, x), r) );
+		ASSERT_TRUE( logsumexp_ok(logsumexp_online(n, x), r) );
+
+		// entries of -inf contribute nothing
+
+		const T ninf = -std::numeric_limits<T>::infinity();
+		for (int i = 0; i < n; i += 3) x[i] = ninf;
+
+		const double r2 = ref_logsumexp(n, x);
+		if (n > 1)
+		{
+			ASSERT_TRUE( logsumexp_ok(logsumexp(n, x), r2) );
+			ASSERT_TRUE( logsumexp_ok(logsumexp_online(n, x), r2) );
+		}
+		else
+		{
+			ASSERT_EQ( logsumexp(n, x), ninf );
+			ASSERT_EQ( logsumexp_online(n, x), ninf );
+		}
+	}
+}
+
+GCASE( softmax )
+{
+	T x[MaxLen];
+	T y[MaxLen];
+	double r[MaxLen];
+
+	for (int n = 1; n <= MaxLen; ++n)
+	{
+		fill_rand(n, x, T(-20), T(20));
+		if (n % 4 == 0) x[n / 2] = -std::numeric_limits<T>::infinity();
+		ref_softmax(n, x, r);
+
+		softmax(n, x, y);
+		ASSERT_TRUE( softmax_ok(n, y, r) );
+
+		softmax_online(n, x, y);
+		ASSERT_TRUE( softmax_ok(n, y, r) );
+
+		// large offsets (the reference is recomputed, as the shifted
+		// entries are rounded)
+
+		for (int i = 0; i < n; ++i) x[i] += T(1000);
+		ref_softmax(n, x, r);
+
+		softmax(n, x, y);
+		ASSERT_TRUE( softmax_ok(n, y, r) );
+
+		softmax_online(n, x, y);
+		ASSERT_TRUE( softmax_ok(n, y, r) );
+
+		// in place
+
+		softmax(n, x, x);
+		ASSERT_TRUE( softmax_ok(n, x, r) );
+	}
+
+	// long rows
+
+	T *a = new T[LongLen];
+	T *b = new T[LongLen];
+	double *rl = new double[LongLen];
+
+	fill_rand(LongLen, a, T(-20), T(20));
+	ref_softmax(LongLen, a, rl);
+
+	softmax(LongLen, a, b);
+	ASSERT_TRUE( softmax_ok(LongLen, b, rl) );
+
+	softmax_online(LongLen, a, b);
+	ASSERT_TRUE( softmax_ok(LongLen, b, rl) );
+
+	delete[] rl;
+	delete[] b;
+	delete[] a;
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( logsumexp );
+	ADD_TEST( logsumexp_stable );
+	ADD_TEST( softmax );
+}
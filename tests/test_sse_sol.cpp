@@ -122,6 +122,77 @@ GCASE1( solve )
 }
 
 
+GCASE1( solve_expr )
+{
+	T tol = sizeof(T) == 4 ? T(5.0e-5) : T(1.0e-12);
+
+	LSIMD_ALIGN_SSE T av[N * N];
+	LSIMD_ALIGN_SSE T bv[N];
+	LSIMD_ALIGN_SSE T xv[N];
+	LSIMD_ALIGN_SSE T yv[N];
+
+	special_fill_mat(N, av);
+	for (int i = 0; i < N; ++i) bv[i] = T(i+1);
+
+	simd_mat<T, N, N, sse_kind> A(av, aligned_t());
+	simd_vec<T, N, sse_kind> b(bv, aligned_t());
+
+	// right hand sides given as vector expressions
+
+	solve(A, A * b).store(xv, aligned_t());
+	ASSERT_VEC_APPROX(N, xv, bv, tol);
+
+	solve(A, b * simd_pack<T, sse_kind>(T(2))).store(xv, aligned_t());
+	(A * simd_vec<T, N, sse_kind>(xv, aligned_t())).store(yv, aligned_t());
+	for (int i = 0; i < N; ++i) bv[i] *= T(2);
+	ASSERT_VEC_APPROX(N, yv, bv, tol);
+}
+
+
+GCASE1( chain_args )
+{
+	LSIMD_ALIGN_SSE T av[N * N];
+	LSIMD_ALIGN_SSE T bv[N * N];
+	LSIMD_ALIGN_SSE T cv[N];
+	LSIMD_ALIGN_SSE T rv[N * N];
+
+	special_fill_mat(N, av);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int i = 0; i < N; ++i) bv[i + j * N] = T(i == j ? 2 : (i == j + 1 ? 1 : 0));
+	}
+	for (int i = 0; i < N; ++i) cv[i] = T(i+1);
+
+	simd_mat<T, N, N, sse_kind> A(av, aligned_t());
+	simd_mat<T, N, N, sse_kind> B(bv, aligned_t());
+	simd_vec<T, N, sse_kind> c(cv, aligned_t());
+	simd_pack<T, sse_kind> s(T(2));
+
+	// products passed where matrices are expected, against the
+	// product evaluated at the architecture-specific level
+
+	simd_mat<T, N, N, sse_kind> P(A.impl * B.impl);
+
+	ASSERT_EQ( det(A * B), det(P) );
+
+	inv(P).store(rv, aligned_t());
+	ASSERT_SIMD_EQ( inv(A * B), rv );
+
+	simd_mat<T, N, N, sse_kind> R;
+	ASSERT_EQ( inv_and_det(A * B, R), det(P) );
+	ASSERT_SIMD_EQ( R, rv );
+
+	(P * s).store(rv, aligned_t());
+	ASSERT_SIMD_EQ( (A * B) * s, rv );
+
+	solve(P, c).store(rv, aligned_t());
+	ASSERT_SIMD_EQ( solve(A * B, c), rv );
+
+	solve(A, P).store(rv, aligned_t());
+	ASSERT_SIMD_EQ( solve(A, A * B), rv );
+}
+
+
 GCASE2( solve_mat )
 {
 	T tol = sizeof(T) == 4 ? T(5.0e-4) : T(1.0e-12);
@@ -194,6 +265,38 @@ test_pack* solve_tpack()
 	return tp;
 }
 
+test_pack* chain_args_tpack()
+{
+	test_pack *tp = new test_pack( "chain_args" );
+
+	tp->add( new chain_args_tests<f32, 2>() );
+	tp->add( new chain_args_tests<f64, 2>() );
+
+	tp->add( new chain_args_tests<f32, 3>() );
+	tp->add( new chain_args_tests<f64, 3>() );
+
+	tp->add( new chain_args_tests<f32, 4>() );
+	tp->add( new chain_args_tests<f64, 4>() );
+
+	return tp;
+}
+
+test_pack* solve_expr_tpack()
+{
+	test_pack *tp = new test_pack( "solve_expr" );
+
+	tp->add( new solve_expr_tests<f32, 2>() );
+	tp->add( new solve_expr_tests<f64, 2>() );
+
+	tp->add( new solve_expr_tests<f32, 3>() );
+	tp->add( new solve_expr_tests<f64, 3>() );
+
+	tp->add( new solve_expr_tests<f32, 4>() );
+	tp->add( new solve_expr_tests<f64, 4>() );
+
+	return tp;
+}
+
 
 test_pack* solve_mat_tpack()
 {
@@ -232,6 +335,8 @@ void lsimd::add_test_packs()
 	lsimd_main_suite.add( det_tpack() );
 	lsimd_main_suite.add( inv_tpack() );
 	lsimd_main_suite.add( solve_tpack() );
+	lsimd_main_suite.add( solve_expr_tpack() );
+	lsimd_main_suite.add( chain_args_tpack() );
 	lsimd_main_suite.add( solve_mat_tpack() );
 }
 
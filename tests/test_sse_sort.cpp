@@ -0,0 +1,315 @@
+/**
+ * @file test_sse_sort.cpp
+ *
+ * Test the correctness of sorting networks and array sorting
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  auxiliary functions
+ *
+ ************************************************/
+
+// the values moved along with keys of type T
+
+template<typename T> struct kv_val;
+template<> struct kv_val<f32> { typedef i32 type; };
+template<> struct kv_val<f64> { typedef i64 type; };
+template<> struct kv_val<i32> { typedef i32 type; };
+
+// integer-valued keys in [-range, range), so that all types can hold them
+
+template<typename T>
+void fill_keys(int n, T *x, int range)
+{
+	for (int i = 0; i < n; ++i) x[i] = T(std::rand() % (2 * range) - range);
+}
+
+template<typename T>
+bool is_sorted_perm(int n, const T *r, const T *x)
+{
+	std::vector<T> s(x, x + n);
+	std::sort(s.begin(), s.end());
+
+	for (int i = 0; i < n; ++i) if (r[i] != s[i]) return false;
+	return true;
+}
+
+// whether the keys are sorted, and the values are a permutation of
+// the indices with keys[i] = x[vals[i]]
+
+template<typename T, typename V>
+bool is_sorted_kv(int n, const T *keys, const V *vals, const T *x)
+{
+	if (!is_sorted_perm(n, keys, x)) return false;
+
+	std::vector<bool> used((size_t)n, false);
+	for (int i = 0; i < n; ++i)
+	{
+		const V v = vals[i];
+		if (v < 0 || v >= n || used[(size_t)v] || keys[i] != x[v]) return false;
+		used[(size_t)v] = true;
+	}
+	return true;
+}
+
+// the patterns of the arrays to sort
+
+const int NumPatterns = 7;
+
+template<typename T>
+void fill_pattern(int n, T *x, int pat)
+{
+	switch (pat)
+	{
+	case 0: fill_keys(n, x, 1 << 20); break;                        // random
+	case 1: fill_keys(n, x, 4); break;                              // few distinct
+	case 2: for (int i = 0; i < n; ++i) x[i] = T(i); break;         // sorted
+	case 3: for (int i = 0; i < n; ++i) x[i] = T(n - i); break;     // reversed
+	case 4: for (int i = 0; i < n; ++i) x[i] = T(3); break;         // constant
+	case 5: for (int i = 0; i < n; ++i) x[i] = T(i < n / 2 ? i : n - i); break;  // organ pipe
+	case 6:                                                          // sorted, with a few swaps
+		for (int i = 0; i < n; ++i) x[i] = T(i);
+		for (int t = 0; t < 3 && n > 0; ++t) std::swap(x[std::rand() % n], x[std::rand() % n]);
+		break;
+	}
+}
+
+template<typename T>
+bool test_sort(int n, int pat)
+{
+	std::vector<T> x((size_t)n + 1), r((size_t)n + 1);
+	fill_pattern(n, &x[0], pat);
+
+	r = x;
+	lsimd::sort(n, &r[0]);
+	return is_sorted_perm(n, &r[0], &x[0]);
+}
+
+template<typename T>
+bool test_sort_kv(int n, int pat)
+{
+	typedef typename kv_val<T>::type V;
+
+	std::vector<T> x((size_t)n + 1), keys((size_t)n + 1);
+	std::vector<V> vals((size_t)n + 1);
+	fill_pattern(n, &x[0], pat);
+
+	keys = x;
+	for (int i = 0; i < n; ++i) vals[i] = V(i);
+
+	sort_kv(n, &keys[0], &vals[0]);
+	return is_sorted_kv(n, &keys[0], &vals[0], &x[0]);
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( sort_lanes )
+{
+	typedef typename kv_val<T>::type V;
+	const int w = (int)simd_pack<T>::pack_width;
+
+	for (int t = 0; t < 100; ++t)
+	{
+		LSIMD_ALIGN_SSE T x[16];
+		LSIMD_ALIGN_SSE T r[16];
+		LSIMD_ALIGN_SSE V v[16];
+		fill_keys(4 * w, x, t % 2 ? 3 : 1000);
+		for (int i = 0; i < 4 * w; ++i) v[i] = V(i);
+
+		simd_pack<T> a(x, aligned_t()), b(x + w, aligned_t()), c(x + 2 * w, aligned_t()), d(x + 3 * w, aligned_t());
+		sort_lanes(a, b, c, d);
+		a.store(r, aligned_t());
+		b.store(r + w, aligned_t());
+		c.store(r + 2 * w, aligned_t());
+		d.store(r + 3 * w, aligned_t());
+
+		// the four packs are permuted into sorted packs
+
+		for (int k = 0; k < 4; ++k)
+		{
+			for (int i = 1; i < w; ++i) ASSERT_TRUE( !(r[k * w + i] < r[k * w + i - 1]) );
+		}
+		std::sort(r, r + 4 * w);
+		ASSERT_TRUE( is_sorted_perm(4 * w, r, x) );
+
+		// with values
+
+		const T *pv = reinterpret_cast<const T*>(v);
+		a = simd_pack<T>(x, aligned_t());
+		b = simd_pack<T>(x + w, aligned_t());
+		c = simd_pack<T>(x + 2 * w, aligned_t());
+		d = simd_pack<T>(x + 3 * w, aligned_t());
+		simd_pack<T> va(pv, aligned_t()), vb(pv + w, aligned_t()), vc(pv + 2 * w, aligned_t()), vd(pv + 3 * w, aligned_t());
+
+		sort_lanes(a, b, c, d, va, vb, vc, vd);
+		a.store(r, aligned_t());
+		b.store(r + w, aligned_t());
+		c.store(r + 2 * w, aligned_t());
+		d.store(r + 3 * w, aligned_t());
+
+		LSIMD_ALIGN_SSE V rv[16];
+		T *prv = reinterpret_cast<T*>(rv);
+		va.store(prv, aligned_t());
+		vb.store(prv + w, aligned_t());
+		vc.store(prv + 2 * w, aligned_t());
+		vd.store(prv + 3 * w, aligned_t());
+
+		for (int k = 0; k < 4; ++k)
+		{
+			for (int i = 1; i < w; ++i) ASSERT_TRUE( !(r[k * w + i] < r[k * w + i - 1]) );
+		}
+		for (int i = 0; i < 4 * w; ++i) ASSERT_EQ( r[i], x[rv[i]] );
+	}
+}
+
+GCASE( bitonic_merge )
+{
+	typedef typename kv_val<T>::type V;
+	const int w = (int)simd_pack<T>::pack_width;
+
+	for (int t = 0; t < 200; ++t)
+	{
+		LSIMD_ALIGN_SSE T x[8];
+		LSIMD_ALIGN_SSE T r[8];
+		LSIMD_ALIGN_SSE V v[8];
+		LSIMD_ALIGN_SSE V rv[8];
+
+		fill_keys(2 * w, x, t % 2 ? 3 : 1000);
+		std::sort(x, x + w);
+		std::sort(x + w, x + 2 * w);
+		for (int i = 0; i < 2 * w; ++i) v[i] = V(i);
+
+		simd_pack<T> a(x, aligned_t()), b(x + w, aligned_t());
+		bitonic_merge(a, b);
+		a.store(r, aligned_t());
+		b.store(r + w, aligned_t());
+
+		for (int i = 1; i < 2 * w; ++i) ASSERT_TRUE( !(r[i] < r[i - 1]) );
+		ASSERT_TRUE( is_sorted_perm(2 * w, r, x) );
+
+		// with values
+
+		const T *pv = reinterpret_cast<const T*>(v);
+		T *prv = reinterpret_cast<T*>(rv);
+
+		a = simd_pack<T>(x, aligned_t());
+		b = simd_pack<T>(x + w, aligned_t());
+		simd_pack<T> va(pv, aligned_t()), vb(pv + w, aligned_t());
+
+		bitonic_merge(a, b, va, vb);
+		a.store(r, aligned_t());
+		b.store(r + w, aligned_t());
+		va.store(prv, aligned_t());
+		vb.store(prv + w, aligned_t());
+
+		ASSERT_TRUE( is_sorted_kv(2 * w, r, rv, x) );
+	}
+}
+
+GCASE( sort )
+{
+	for (int n = 0; n <= 200; ++n)
+	{
+		for (int p = 0; p < NumPatterns; ++p)
+		{
+			ASSERT_TRUE( test_sort<T>(n, p) );
+		}
+	}
+
+	// multiple leaves, partitioned by quicksort
+
+	const int leaf = sort_blocking<T>::leaf_size();
+	const int ns[5] = {leaf - 1, leaf, leaf + 1, 3 * leaf + 5, 20 * leaf + 7};
+
+	for (int k = 0; k < 5; ++k)
+	{
+		for (int p = 0; p < NumPatterns; ++p)
+		{
+			ASSERT_TRUE( test_sort<T>(ns[k], p) );
+		}
+	}
+}
+
+GCASE( sort_kv )
+{
+	for (int n = 0; n <= 200; ++n)
+	{
+		for (int p = 0; p < NumPatterns; ++p)
+		{
+			ASSERT_TRUE( test_sort_kv<T>(n, p) );
+		}
+	}
+
+	const int leaf = sort_blocking<T>::leaf_size();
+	const int ns[3] = {leaf + 1, 3 * leaf + 5, 20 * leaf + 7};
+
+	for (int k = 0; k < 3; ++k)
+	{
+		for (int p = 0; p < NumPatterns; ++p)
+		{
+			ASSERT_TRUE( test_sort_kv<T>(ns[k], p) );
+		}
+	}
+}
+
+template<typename T> class signed_zeros_tests;
+
+SCASE( signed_zeros, f32 )
+{
+	// both zeros are kept (as a permutation of the entries)
+
+	const int n = 1000;
+	std::vector<f32> x((size_t)n);
+	for (int i = 0; i < n; ++i) x[i] = i % 3 == 0 ? -0.0f : (i % 3 == 1 ? 0.0f : f32(i % 7) - 3.0f);
+
+	lsimd::sort(n, &x[0]);
+
+	int nneg = 0;
+	for (int i = 0; i < n; ++i) if (x[i] == 0.0f && (reinterpret_cast<const u32&>(x[i]) >> 31)) ++nneg;
+	ASSERT_EQ( nneg, (n + 2) / 3 );
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+	tp->add( new H<i32>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( sort_lanes );
+	ADD_TEST( bitonic_merge );
+	ADD_TEST( sort );
+	ADD_TEST( sort_kv );
+
+	test_pack *tp = new test_pack( "signed_zeros" );
+	tp->add( new signed_zeros_tests<f32>() );
+	lsimd_main_suite.add( tp );
+}
@@ -0,0 +1,217 @@
+/**
+ * @file test_sse_sum.cpp
+ *
+ * Test the accuracy of plain, compensated and pairwise sums
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  auxiliary functions
+ *
+ ************************************************/
+
+template<typename T>
+inline double eps_of()
+{
+	return sizeof(T) == 4 ? 5.97e-8 : 1.12e-16;
+}
+
+// a sum in extended precision, with the sum of magnitudes
+
+template<typename T>
+long double ref_sum(int n, const T *x, const T *y, long double& a)
+{
+	long double s = 0;
+	a = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		const long double v = y ? (long double)x[i] * (long double)y[i] : (long double)x[i];
+		s += v;
+		a += std::fabs(v);
+	}
+	return s;
+}
+
+// |r - s| <= c1 * eps * |s| + c2 * eps^2 * a, as the bounds of the
+// compensated modes (with c2 of the order of n)
+
+template<typename T>
+bool near(T r, long double s, long double a, double c1, double c2)
+{
+	const double e = eps_of<T>();
+	const long double d = std::fabs((long double)r - s);
+	return d <= c1 * e * std::fabs(s) + c2 * e * e * a;
+}
+
+// pairs of large terms that cancel (with signs and positions at random),
+// among small integers whose sum is exact in the working precision
+
+template<typename T>
+void fill_cancel(int n, T *x, T *y, long double& s)
+{
+	const T big = sizeof(T) == 4 ? T(1 << 30) : T(1LL << 60);
+
+	s = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		x[i] = T(std::rand() % 17 - 8);
+		if (y) y[i] = T(std::rand() % 5 - 2);
+		s += y ? (long double)x[i] * (long double)y[i] : (long double)x[i];
+	}
+
+	std::vector<int> p((size_t)n);
+	for (int i = 0; i < n; ++i) p[i] = i;
+	for (int i = n - 1; i > 0; --i) std::swap(p[i], p[std::rand() % (i + 1)]);
+
+	for (int t = 0; t + 1 < n / 4; t += 2)
+	{
+		const int i = p[t];
+		const int j = p[t + 1];
+
+		s -= y ? (long double)x[i] * (long double)y[i] + (long double)x[j] * (long double)y[j] :
+				(long double)x[i] + (long double)x[j];
+
+		const T b = std::rand() % 2 ? big : -big;
+		x[i] = b;
+		x[j] = -b;
+
+		if (y)
+		{
+			y[i] = T(3);
+			y[j] = T(3);
+		}
+	}
+}
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( sum )
+{
+	const int ns[8] = {0, 1, 3, 15, 16, 17, 255, 1000};
+
+	for (int k = 0; k < 8; ++k)
+	{
+		const int n = ns[k];
+		std::vector<T> x((size_t)n + 1);
+		fill_rand(n, &x[0], T(-1), T(1));
+
+		long double a;
+		const long double s = ref_sum<T>(n, &x[0], 0, a);
+		const double c = double(n + 1);
+
+		ASSERT_TRUE( near(lsimd::sum(n, &x[0]), s, a, 0, c / eps_of<T>()) );
+		ASSERT_TRUE( near(lsimd::sum(n, &x[0], pairwise_t()), s, a, 0, c / eps_of<T>()) );
+		ASSERT_TRUE( near(lsimd::sum(n, &x[0], kahan_t()), s, a, 2, 4 * c) );
+		ASSERT_TRUE( near(lsimd::sum(n, &x[0], compensated_t()), s, a, 1, 4 * c) );
+	}
+}
+
+GCASE( sum_accuracy )
+{
+	// terms of similar magnitude (with a large mean)
+
+	const int n = 1000003;
+	std::vector<T> x((size_t)n);
+	fill_rand(n, &x[0], T(1), T(2));
+
+	long double a;
+	const long double s = ref_sum<T>(n, &x[0], 0, a);
+	const double c = double(n);
+
+	ASSERT_TRUE( near(lsimd::sum(n, &x[0], kahan_t()), s, a, 2, 4 * c) );
+	ASSERT_TRUE( near(lsimd::sum(n, &x[0], compensated_t()), s, a, 1, 4 * c) );
+	ASSERT_TRUE( near(lsimd::sum(n, &x[0], pairwise_t()), s, a, 0, 2 * std::log(c) / eps_of<T>()) );
+
+	// cancellation, for which the compensated sum is exact
+
+	const int ns[4] = {7, 64, 1001, 100003};
+	for (int k = 0; k < 4; ++k)
+	{
+		long double r;
+		fill_cancel<T>(ns[k], &x[0], 0, r);
+		ASSERT_EQ( (long double)lsimd::sum(ns[k], &x[0], compensated_t()), r );
+	}
+}
+
+GCASE( dot )
+{
+	const int ns[8] = {0, 1, 3, 15, 16, 17, 255, 1000};
+
+	for (int k = 0; k < 8; ++k)
+	{
+		const int n = ns[k];
+		std::vector<T> x((size_t)n + 1), y((size_t)n + 1);
+		fill_rand(n, &x[0], T(-1), T(1));
+		fill_rand(n, &y[0], T(-1), T(1));
+
+		long double a;
+		const long double s = ref_sum<T>(n, &x[0], &y[0], a);
+		const double c = double(n + 1);
+
+		ASSERT_TRUE( near(lsimd::dot(n, &x[0], &y[0]), s, a, 0, 2 * c / eps_of<T>()) );
+		ASSERT_TRUE( near(lsimd::dot(n, &x[0], &y[0], compensated_t()), s, a, 1, 8 * c) );
+	}
+
+	// cancellation, for which the compensated dot product is exact
+
+	const int ns2[4] = {7, 64, 1001, 100003};
+	for (int k = 0; k < 4; ++k)
+	{
+		const int n = ns2[k];
+		std::vector<T> x((size_t)n), y((size_t)n);
+
+		long double r;
+		fill_cancel<T>(n, &x[0], &y[0], r);
+		ASSERT_EQ( (long double)lsimd::dot(n, &x[0], &y[0], compensated_t()), r );
+	}
+
+	// products that are not representable (in the working precision)
+
+	const int n = 100003;
+	std::vector<T> x((size_t)n), y((size_t)n);
+	fill_rand(n, &x[0], T(-1), T(1));
+	fill_rand(n, &y[0], T(-1), T(1));
+
+	long double a;
+	const long double s = ref_sum<T>(n, &x[0], &y[0], a);
+	ASSERT_TRUE( near(lsimd::dot(n, &x[0], &y[0], compensated_t()), s, a, 1, 8.0 * n) );
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( sum );
+	ADD_TEST( sum_accuracy );
+	ADD_TEST( dot );
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_sse_topk.cpp
+ *
+ * Test the correctness of comparison masks and top-k selection
+ *
+ * @author Dahua Lin
+ */
+
+
+#include "test_aux.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace lsimd;
+using namespace ltest;
+
+
+/************************************************
+ *
+ *  reference implementation
+ *
+ ************************************************/
+
+// the first k of the (value, index) pairs in the order of selection
+
+template<typename T>
+void ref_topk(int n, const T *x, int k, bool largest, int *idx, T *val)
+{
+	std::vector<std::pair<T, int> > p((size_t)n);
+	for (int i = 0; i < n; ++i) p[i] = std::make_pair(largest ? -x[i] : x[i], i);
+	std::sort(p.begin(), p.end());
+
+	for (int i = 0; i < k; ++i)
+	{
+		val[i] = largest ? -p[i].first : p[i].first;
+		idx[i] = p[i].second;
+	}
+}
+
+template<typename T>
+bool topk_ok(int n, const T *x, int k, bool largest)
+{
+	std::vector<int> idx((size_t)k + 1), ridx((size_t)k + 1);
+	std::vector<T> val((size_t)k + 1), rval((size_t)k + 1);
+
+	const int kr = k < n ? k : n;
+	ref_topk(n, x, kr, largest, &ridx[0], &rval[0]);
+
+	const int r = largest ? topk_max(n, x, k, &idx[0], &val[0]) : topk(n, x, k, &idx[0], &val[0]);
+	if (r != kr) return false;
+
+	for (int i = 0; i < kr; ++i)
+	{
+		if (idx[i] != ridx[i] || val[i] != rval[i]) return false;
+	}
+	return true;
+}
+
+const int MaxLen = 100;
+
+
+/************************************************
+ *
+ *  test cases
+ *
+ ************************************************/
+
+GCASE( masks )
+{
+	const int w = (int)simd_pack<T>::pack_width;
+
+	LSIMD_ALIGN_SSE T a[4] = {T(1), T(2), T(3), T(4)};
+	LSIMD_ALIGN_SSE T b[4] = {T(2), T(2), T(2), T(2)};
+
+	simd_pack<T> pa(a, aligned_t());
+	simd_pack<T> pb(b, aligned_t());
+
+	int rlt = 0, rle = 0, rgt = 0, rge = 0;
+	for (int i = 0; i < w; ++i)
+	{
+		if (a[i] < b[i]) rlt |= 1 << i;
+		if (a[i] <= b[i]) rle |= 1 << i;
+		if (a[i] > b[i]) rgt |= 1 << i;
+		if (a[i] >= b[i]) rge |= 1 << i;
+	}
+
+	ASSERT_EQ( mask_lt(pa, pb), rlt );
+	ASSERT_EQ( mask_le(pa, pb), rle );
+	ASSERT_EQ( mask_gt(pa, pb), rgt );
+	ASSERT_EQ( mask_ge(pa, pb), rge );
+	ASSERT_EQ( mask_lt(pb, pa), rgt );
+}
+
+GCASE( topk )
+{
+	T x[MaxLen];
+	const int ks[6] = {0, 1, 2, 5, 16, 200};
+
+	for (int n = 0; n <= MaxLen; ++n)
+	{
+		for (int t = 0; t < 6; ++t)
+		{
+			fill_rand(n, x, T(0), T(1));
+			ASSERT_TRUE( topk_ok(n, x, ks[t], false) );
+			ASSERT_TRUE( topk_ok(n, x, ks[t], true) );
+
+			fill_rand_int(n, x, 0, 6);    // with many ties
+			ASSERT_TRUE( topk_ok(n, x, ks[t], false) );
+			ASSERT_TRUE( topk_ok(n, x, ks[t], true) );
+		}
+	}
+
+	// long arrays, including sorted ones that offer every entry
+
+	const int n = 10000;
+	std::vector<T> a((size_t)n);
+
+	fill_rand(n, &a[0], T(-1), T(1));
+	ASSERT_TRUE( topk_ok(n, &a[0], 10, false) );
+	ASSERT_TRUE( topk_ok(n, &a[0], 100, true) );
+
+	for (int i = 0; i < n; ++i) a[i] = T(n - i);
+	ASSERT_TRUE( topk_ok(n, &a[0], 10, false) );
+	ASSERT_TRUE( topk_ok(n, &a[0], 10, true) );
+
+	fill_rand_int(n, &a[0], 0, 49);
+	ASSERT_TRUE( topk_ok(n, &a[0], 300, false) );
+}
+
+GCASE( topk_rows )
+{
+	// large enough for topk_rows_mt to go parallel
+
+	const int m = 40;
+	const int n = 2001;
+	const int ldx = 2003;
+	const int k = 7;
+	const int ldo = 9;
+
+	std::vector<T> x((size_t)m * ldx);
+	fill_rand(m * ldx, &x[0], T(0), T(10));
+
+	std::vector<int> idx((size_t)m * ldo), idx2((size_t)m * ldo);
+	std::vector<T> val((size_t)m * ldo), val2((size_t)m * ldo);
+	int ridx[k];
+	T rval[k];
+
+	topk_rows(m, n, &x[0], ldx, k, &idx[0], &val[0], ldo);
+	topk_rows_mt(m, n, &x[0], ldx, k, &idx2[0], &val2[0], ldo);
+
+	for (int i = 0; i < m; ++i)
+	{
+		ref_topk(n, &x[i * ldx], k, false, ridx, rval);
+		ASSERT_VEC_EQ( k, &idx[i * ldo], ridx );
+		ASSERT_VEC_EQ( k, &val[i * ldo], rval );
+		ASSERT_VEC_EQ( k, &idx2[i * ldo], ridx );
+		ASSERT_VEC_EQ( k, &val2[i * ldo], rval );
+	}
+}
+
+
+template<template<typename U> class H>
+test_pack* make_tpack( const char *name )
+{
+	test_pack *tp = new test_pack( name );
+
+	tp->add( new H<f32>() );
+	tp->add( new H<f64>() );
+
+	return tp;
+}
+
+#define ADD_TEST( name ) lsimd_main_suite.add( make_tpack<name##_tests>( #name ) )
+
+void lsimd::add_test_packs()
+{
+	ADD_TEST( masks );
+	ADD_TEST( topk );
+	ADD_TEST( topk_rows );
+}
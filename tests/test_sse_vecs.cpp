@@ -290,6 +290,41 @@ GCASE1( scale )
 	ASSERT_SIMD_EQ( va, r);
 }
 
+GCASE1( scale_expr )
+{
+	LSIMD_ALIGN_SSE T a[MaxVLen] = { T(1), T(2), T(3), T(4) };
+	LSIMD_ALIGN_SSE T b[MaxVLen] = { T(5), T(-2), T(1), T(3) };
+	LSIMD_ALIGN_SSE T c[MaxVLen] = { T(2), T(4), T(-6), T(7) };
+
+	simd_pack<T, sse_kind> s( T(2.5) );
+	simd_pack<T, sse_kind> t( T(-1.5) );
+
+	simd_vec<T, N, sse_kind> va(a, aligned_t());
+	simd_vec<T, N, sse_kind> vb(b, aligned_t());
+	simd_vec<T, N, sse_kind> vc(c, aligned_t());
+
+	T r[N];
+
+	for (int i = 0; i < N; ++i) r[i] = a[i] * T(2.5) + c[i];
+	ASSERT_SIMD_EQ( va * s + vc, r );
+	ASSERT_SIMD_EQ( vc + va * s, r );
+
+	for (int i = 0; i < N; ++i) r[i] = c[i] - a[i] * T(2.5);
+	ASSERT_SIMD_EQ( vc - va * s, r );
+
+	for (int i = 0; i < N; ++i) r[i] = a[i] * T(2.5) + b[i] * T(-1.5) - c[i];
+	ASSERT_SIMD_EQ( va * s + vb * t - vc, r );
+
+	simd_vec<T, N, sse_kind> y = vc;
+	y += va * s - vb * t;
+	for (int i = 0; i < N; ++i) r[i] = c[i] + a[i] * T(2.5) - b[i] * T(-1.5);
+	ASSERT_SIMD_EQ( y, r );
+
+	y -= va * s;
+	for (int i = 0; i < N; ++i) r[i] = c[i] - b[i] * T(-1.5);
+	ASSERT_SIMD_EQ( y, r );
+}
+
 
 
 
@@ -352,6 +387,7 @@ void lsimd::add_test_packs()
 	ADD_TEST( sub );
 	ADD_TEST( mul );
 	ADD_TEST( scale );
+	ADD_TEST( scale_expr );
 
 	ADD_TEST( sum );
 	ADD_TEST( dot );